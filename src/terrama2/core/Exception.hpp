@@ -114,6 +114,9 @@ namespace terrama2
     //! Base Verify for Semantics
     struct VerifyException: virtual UtilityException { };
 
+    //! Raised when the scratch space quota is exceeded or a scratch folder can't be created.
+    struct ScratchSpaceException: virtual UtilityException { };
+
     //#################################
 
   }  // end namespace core
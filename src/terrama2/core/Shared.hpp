@@ -61,6 +61,9 @@ namespace terrama2
     class GridSeries;
     //! Shared smart pointer for GridSeries
     typedef std::shared_ptr<terrama2::core::GridSeries> GridSeriesPtr;
+    class RasterHandle;
+    //! Shared smart pointer for RasterHandle
+    typedef std::shared_ptr<terrama2::core::RasterHandle> RasterHandlePtr;
     class OccurrenceSeries;
     //! Shared smart pointer for OccurrenceSeries
     typedef std::shared_ptr<terrama2::core::OccurrenceSeries> OccurrenceSeriesPtr;
@@ -86,6 +89,10 @@ namespace terrama2
     class Timer;
     //! Shared smart pointer for Timer
     typedef std::shared_ptr<const terrama2::core::Timer> TimerPtr;
+
+    class FileWatcher;
+    //! Shared smart pointer for FileWatcher
+    typedef std::shared_ptr<terrama2::core::FileWatcher> FileWatcherPtr;
   }
 }
 
@@ -48,6 +48,7 @@
 
 //STL
 #include <algorithm>
+#include <vector>
 
 terrama2::core::DataAccessor::DataAccessor(DataProviderPtr dataProvider, DataSeriesPtr dataSeries, Filter filter)
   : dataProvider_(dataProvider),
@@ -204,10 +205,19 @@ std::unordered_map<terrama2::core::DataSetPtr, terrama2::core::DataSetSeries > t
 
   std::unordered_map<DataSetPtr,DataSetSeries> series;
 
+  boost::local_time::local_date_time noTime(boost::posix_time::not_a_date_time);
+  {
+    std::lock_guard<std::mutex> lock(*lastDateTimeMutex_);
+    lastDateTime_ = std::make_shared<te::dt::TimeInstantTZ>(noTime);
+  }
+
   try
   {
     auto& retrieverFactory = DataRetrieverFactory::getInstance();
     DataRetrieverPtr dataRetriever = retrieverFactory.make(dataProvider_);
+
+    std::vector<DataSetPtr> datasets;
+    std::vector<std::string> uris;
     for(const auto& dataset : dataSeries_->datasetList)
     {
       //if the dataset is not active, continue to next.
@@ -217,35 +227,32 @@ std::unordered_map<terrama2::core::DataSetPtr, terrama2::core::DataSetSeries > t
       if(!intersects(dataset, filter))
         continue;
 
-      bool removeFolder = false;
       // if this data retriever is a remote server that allows to retrieve data to a file,
       // download the file to a temporary location
       // if not, just get the DataProvider uri
       std::string uri;
       if(dataRetriever->isRetrivable())
-      {
         uri = retrieveData(dataRetriever, dataset, filter);
-        removeFolder = true;
-      }
       else
         uri = dataProvider_->uri;
 
-      DataSetSeries tempSeries = getSeries(uri, filter, dataset);
-      series.emplace(dataset, tempSeries);
-
-
-      // FIXME: concurrency problems here, temp folder is the same and it's removed while others are reading #582
-      // if(removeFolder)
-      // {
-      //   QUrl url(uri.c_str());
-      //   QDir dir(url.path());
-      //   if(!dir.removeRecursively())
-      //   {
-      //     QString errMsg = QObject::tr("Data folder could not be removed.\n%1").arg(url.path());
-      //     TERRAMA2_LOG_ERROR() << errMsg.toStdString();
-      //   }
-      // }
+      datasets.push_back(dataset);
+      uris.push_back(uri);
+
+      // the downloaded files are in a scratch folder of the data retriever,
+      // the folder is removed after the data retriever is released
     }//for each dataset
+
+    // read the datasets concurrently,
+    // the results are kept in the dataset order
+    std::vector<DataSetSeries> datasetSeries(datasets.size());
+    parallelFor(datasets.size(), dataProvider_->ingestionThreads, [&](std::size_t i)
+    {
+      datasetSeries[i] = getSeries(uris[i], filter, datasets[i]);
+    });
+
+    for(std::size_t i = 0; i < datasets.size(); ++i)
+      series.emplace(datasets[i], datasetSeries[i]);
   }
   catch(const terrama2::Exception&)
   {
@@ -270,6 +277,16 @@ std::unordered_map<terrama2::core::DataSetPtr, terrama2::core::DataSetSeries > t
 }
 
 
+void terrama2::core::DataAccessor::updateLastDateTime(const te::dt::TimeInstantTZ& dateTime) const
+{
+  if(dateTime.getTimeInstantTZ().is_special())
+    return;
+
+  std::lock_guard<std::mutex> lock(*lastDateTimeMutex_);
+  if(!lastDateTime_ || lastDateTime_->getTimeInstantTZ().is_special() || *lastDateTime_ < dateTime)
+    lastDateTime_ = std::make_shared<te::dt::TimeInstantTZ>(dateTime);
+}
+
 void terrama2::core::DataAccessor::addColumns(std::shared_ptr<te::da::DataSetTypeConverter> converter, const std::shared_ptr<te::da::DataSetType>& datasetType) const
 {
   for(std::size_t i = 0, size = datasetType->size(); i < size; ++i)
@@ -48,6 +48,9 @@
 #include <terralib/datatype/TimeInstantTZ.h>
 #include <terralib/memory/DataSet.h>
 
+//STL
+#include <mutex>
+
 namespace te
 {
   namespace da
@@ -60,6 +63,8 @@ namespace terrama2
 {
   namespace core
   {
+    class FileCatalog;
+
     typedef std::string DataAccessorType;
     /*!
     \class DataAccessor
@@ -96,6 +101,8 @@ namespace terrama2
         /*!
           \brief Returns the last data timestamp found on last access.
 
+          When more than one DataSet is accessed, the latest timestamp of all DataSets is returned.
+
           \sa getSeries()
         */
         virtual std::shared_ptr< te::dt::TimeInstantTZ > lastDateTime() const {return lastDateTime_; }
@@ -103,6 +110,15 @@ namespace terrama2
         //! Returns the DataSeriesSemantics of the DataSeries.
         DataSeriesSemantics semantics() const { return dataSeries_->semantics; }
 
+        /*!
+          \brief Sets the catalog of processed files.
+
+          Accessors of files skip the files already processed and register the new or changed ones,
+          the catalog is not saved by the accessor.
+          By default no catalog is used and all files are accessed.
+        */
+        void setFileCatalog(std::shared_ptr<FileCatalog> fileCatalog) { fileCatalog_ = fileCatalog; }
+
         /*!
           \brief Get access to the filtered data of a DataSeries
 
@@ -112,6 +128,7 @@ namespace terrama2
           Any temporary folder will be removed after the process.
 
           \note The data will be converted by the data type driver based on the DataSeriesSemantics of the DataSeries.
+          \note The DataSets are accessed concurrently, the number of threads is defined by DataProvider::ingestionThreads.
 
           \param filter Filter data applied to accessed data, if empty, all data is returned.
 
@@ -120,6 +137,16 @@ namespace terrama2
         */
         virtual std::unordered_map<DataSetPtr,DataSetSeries > getSeries(const Filter& filter) const;
 
+        /*!
+          \brief Returns an identifier of the version of the stored data.
+
+          The version changes when data is added, modified or removed,
+          it's computed without reading the data, for example from the list of files or the table statistics.
+
+          The default implementation returns an empty string, the version is unknown.
+        */
+        virtual std::string dataVersion() const { return ""; }
+
         //! Utility function for converting string to double in the te::da::DataSet contruction.
         te::dt::AbstractData* stringToDouble(te::da::DataSet* dataset, const std::vector<std::size_t>& indexes, int /*dstType*/) const;
 
@@ -223,6 +250,13 @@ namespace terrama2
          */
         virtual DataSetSeries getSeries(const std::string& uri, const Filter& filter, DataSetPtr dataSet) const = 0;
 
+        /*!
+          \brief Updates the last data timestamp if dateTime is later.
+
+          Thread-safe, DataSets are accessed concurrently.
+        */
+        void updateLastDateTime(const te::dt::TimeInstantTZ& dateTime) const;
+
         /*!
           \brief Verifies if the DataSet intersects the Filter area.
 
@@ -235,6 +269,11 @@ namespace terrama2
         Filter filter_;//! Filter applied to accessed data.
 
         std::shared_ptr< te::dt::TimeInstantTZ > lastDateTime_;//!< Last data Date/Time
+        std::shared_ptr<FileCatalog> fileCatalog_;//!< Catalog of processed files, may be null.
+
+      private:
+        //! Mutex to update lastDateTime_, held by pointer so accessors stay copyable, copies share the mutex.
+        std::shared_ptr<std::mutex> lastDateTimeMutex_ = std::make_shared<std::mutex>();
     };
   }
 }
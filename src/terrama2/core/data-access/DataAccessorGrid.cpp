@@ -31,11 +31,28 @@
 #include "GridSeries.hpp"
 #include "../data-model/DataSetGrid.hpp"
 #include "../Shared.hpp"
+#include "../utility/Logger.hpp"
+#include "../utility/Utils.hpp"
+#include "../Exception.hpp"
+
+//TerraLib
+#include <terralib/raster/Band.h>
+#include <terralib/raster/BandProperty.h>
+#include <terralib/raster/Grid.h>
+#include <terralib/raster/RasterFactory.h>
+
+//Boost
+#include <boost/filesystem.hpp>
 
 //QT
 #include <QString>
 #include <QObject>
 
+//STL
+#include <ctime>
+#include <mutex>
+#include <unordered_map>
+
 terrama2::core::GridSeriesPtr terrama2::core::DataAccessorGrid::getGridSeries(const Filter& filter)
 {
   auto series = getSeries(filter);
@@ -54,3 +71,107 @@ void terrama2::core::DataAccessorGrid::addColumns(std::shared_ptr<te::da::DataSe
     converter->add(i,p->clone());
   }
 }
+
+std::vector<terrama2::core::GridInfo> terrama2::core::DataAccessorGrid::getGridInfo(const Filter& filter)
+{
+  std::vector<GridInfo> gridInfoList;
+
+  auto gridSeries = getGridSeries(filter);
+  for(const auto& item : gridSeries->handleMap())
+  {
+    GridInfo gridInfo = item.second->gridInfo();
+    if(!gridInfo.extent)
+      continue;
+
+    gridInfo.dataSet = item.first;
+    gridInfo.timestamp = item.second->timestamp();
+    gridInfoList.push_back(gridInfo);
+  }
+
+  return gridInfoList;
+}
+
+void terrama2::core::DataAccessorGrid::fillGridInfo(GridInfo& gridInfo, const te::rst::Raster* raster)
+{
+  gridInfo.numberOfColumns = raster->getNumberOfColumns();
+  gridInfo.numberOfRows = raster->getNumberOfRows();
+  gridInfo.resolutionX = raster->getResolutionX();
+  gridInfo.resolutionY = raster->getResolutionY();
+  gridInfo.extent = std::make_shared<te::gm::Envelope>(*raster->getExtent());
+  gridInfo.srid = raster->getSRID();
+  gridInfo.numberOfBands = raster->getNumberOfBands();
+
+  gridInfo.noData.clear();
+  gridInfo.dataType.clear();
+  gridInfo.valuesScale.clear();
+  gridInfo.valuesOffset.clear();
+  for(std::size_t i = 0; i < gridInfo.numberOfBands; ++i)
+  {
+    const te::rst::BandProperty* bandProperty = raster->getBand(i)->getProperty();
+    gridInfo.noData.push_back(bandProperty->m_noDataValue);
+    gridInfo.dataType.push_back(bandProperty->getType());
+    gridInfo.valuesScale.push_back(bandProperty->m_valuesScale);
+    gridInfo.valuesOffset.push_back(bandProperty->m_valuesOffset);
+  }
+}
+
+bool terrama2::core::DataAccessorGrid::useDecodedCache(DataSetPtr dataSet) const
+{
+  try
+  {
+    return QString::fromStdString(getProperty(dataSet, dataSeries_, "decoded_cache", false)).compare("true", Qt::CaseInsensitive) == 0;
+  }
+  catch(const UndefinedTagException&)
+  {
+    return false;
+  }
+}
+
+terrama2::core::GridInfo terrama2::core::DataAccessorGrid::probeGridFile(const std::string& path) const
+{
+  //! Header information of a file and its modification time when it was read.
+  struct CachedGridInfo
+  {
+    std::time_t lastWriteTime;
+    GridInfo gridInfo;
+  };
+
+  static std::mutex cacheMutex;
+  static std::unordered_map<std::string, CachedGridInfo> cache;
+
+  boost::system::error_code ec;
+  std::time_t lastWriteTime = boost::filesystem::last_write_time(path, ec);
+  if(ec)
+  {
+    QString errMsg = QObject::tr("Could not access file: %1.").arg(QString::fromStdString(path));
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw DataAccessorException() << ErrorDescription(errMsg);
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    auto it = cache.find(path);
+    if(it != cache.end() && it->second.lastWriteTime == lastWriteTime)
+      return it->second.gridInfo;
+  }
+
+  // Opening the raster only reads the header, the pixels are never requested
+  std::map<std::string, std::string> rinfo;
+  rinfo["URI"] = path;
+  std::unique_ptr<te::rst::Raster> raster(te::rst::RasterFactory::open(rinfo));
+  if(!raster)
+  {
+    QString errMsg = QObject::tr("Could not open raster file: %1.").arg(QString::fromStdString(path));
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw DataAccessorException() << ErrorDescription(errMsg);
+  }
+
+  GridInfo gridInfo;
+  gridInfo.uri = path;
+  fillGridInfo(gridInfo, raster.get());
+
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  cache[path] = CachedGridInfo{lastWriteTime, gridInfo};
+
+  return gridInfo;
+}
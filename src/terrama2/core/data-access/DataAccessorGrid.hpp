@@ -34,11 +34,49 @@
 #include "../Shared.hpp"
 #include "DataAccessor.hpp"
 #include "DcpSeries.hpp"
+#include "../Typedef.hpp"
+
+//TerraLib
+#include <terralib/datatype/TimeInstantTZ.h>
+#include <terralib/geometry/Envelope.h>
+#include <terralib/raster/Raster.h>
+
+//STL
+#include <memory>
+#include <vector>
 
 namespace terrama2
 {
   namespace core
   {
+    namespace Unpack
+    {
+      class CacheFolder;
+    }
+
+    /*!
+      \brief Geometry and band information of a grid, read without the pixel data.
+    */
+    struct GridInfo
+    {
+      DataSetGridPtr dataSet; //!< DataSet of the grid.
+      std::string uri; //!< Location of the grid, for files the absolute path.
+      unsigned int numberOfColumns = 0; //!< Number of columns.
+      unsigned int numberOfRows = 0; //!< Number of rows.
+      double resolutionX = 0; //!< Resolution in X.
+      double resolutionY = 0; //!< Resolution in Y.
+      std::shared_ptr<te::gm::Envelope> extent; //!< Extent of the grid, in the grid SRID.
+      Srid srid = 0; //!< SRID of the grid.
+      std::size_t numberOfBands = 0; //!< Number of bands.
+      std::vector<double> noData; //!< No data value of each band.
+      std::vector<int> dataType; //!< Data type of each band.
+      std::vector<double> valuesScale; //!< Scale of the stored values of each band.
+      std::vector<double> valuesOffset; //!< Offset of the stored values of each band.
+      std::shared_ptr<te::dt::TimeInstantTZ> timestamp; //!< Timestamp of the grid, null if unknown.
+      bool decodedCache = false; //!< If true, the decoded blocks are stored in the DecodedRasterCache.
+      std::shared_ptr<Unpack::CacheFolder> unpackedFolder; //!< Unpack cache folder of a file extracted from a compressed file, kept while the grid is in use.
+    };
+
     /*!
       \class DataAccessorGrid
       \brief Base class to access data from a Grid DataSeries.
@@ -64,10 +102,45 @@ namespace terrama2
         //! Default assignment operator
         DataAccessorGrid& operator=(DataAccessorGrid&& other) { DataAccessor::operator=(std::move(other)); return *this; }
 
-        //! Returns a GridSeries filtered by Filter
+        /*!
+          \brief Returns a GridSeries filtered by Filter
+
+          The default implementation reads all rasters of the series,
+          derived classes that read files should add handles to the files
+          so only the pixels in the region of the filter are read, when they are requested.
+        */
         virtual GridSeriesPtr getGridSeries(const Filter& filter);
 
+        /*!
+          \brief Returns the geometry of the grids filtered by Filter, without reading the pixels.
+
+          Should be used when only the resolution, extent, SRID or band information is needed.
+
+          The default implementation loads the GridSeries, derived classes that read files
+          should only probe the file headers.
+        */
+        virtual std::vector<GridInfo> getGridInfo(const Filter& filter);
+
+        //! Fills the grid information from an already opened raster.
+        static void fillGridInfo(GridInfo& gridInfo, const te::rst::Raster* raster);
+
       protected:
+        /*!
+          \brief Reads the grid information from the header of a raster file.
+
+          The result is cached by the file path and the last modification time of the file.
+
+          \exception DataAccessorException Raised if the file could not be opened as a raster.
+        */
+        GridInfo probeGridFile(const std::string& path) const;
+
+        /*!
+          \brief Returns true if the decoded grids of the dataset should be stored in the DecodedRasterCache.
+
+          The cache is enabled with the "decoded_cache" tag set to "true" in the data series semantics or the dataset format.
+        */
+        bool useDecodedCache(DataSetPtr dataSet) const;
+
         // Doc in base class
         virtual void addColumns(std::shared_ptr<te::da::DataSetTypeConverter> converter, const std::shared_ptr<te::da::DataSetType>& datasetType) const override;
     };
@@ -37,10 +37,14 @@
 #include "SynchronizedDataSet.hpp"
 
 //STL
+#include <limits>
 #include <vector>
 
 //TerraLib
 #include <terralib/dataaccess/utils/Utils.h>
+#include <terralib/datatype/DateTimeProperty.h>
+#include <terralib/memory/DataSet.h>
+#include <terralib/memory/DataSetItem.h>
 
 //Qt
 #include <QString>
@@ -57,11 +61,16 @@ void terrama2::core::GridSeries::addGridSeries(std::unordered_map<DataSetPtr,Dat
       DataSetGridPtr dataSet = std::dynamic_pointer_cast<const DataSetGrid>(item.first);
 
       auto teDataSet = item.second.syncDataSet;
+      std::size_t rpos = te::da::GetFirstPropertyPos(teDataSet->dataset().get(), te::dt::RASTER_TYPE);
+      std::size_t tpos = te::da::GetFirstPropertyPos(teDataSet->dataset().get(), te::dt::DATETIME_TYPE);
       for(size_t i = 0; i < teDataSet->size(); ++i)
       {
-        std::size_t rpos = te::da::GetFirstPropertyPos(teDataSet->dataset().get(), te::dt::RASTER_TYPE);
         std::shared_ptr<te::rst::Raster> raster = teDataSet->getRaster(i, rpos);
-        rasterMap_.emplace(dataSet, raster);
+        std::shared_ptr<te::dt::TimeInstantTZ> timestamp;
+        if(tpos != std::numeric_limits<std::size_t>::max() && !teDataSet->isNull(i, tpos))
+          timestamp = std::dynamic_pointer_cast<te::dt::TimeInstantTZ>(teDataSet->getDateTime(i, tpos));
+
+        addRasterHandle(dataSet, std::make_shared<RasterHandle>(raster, timestamp));
       }
     }
     catch(const std::bad_cast& )
@@ -72,3 +81,70 @@ void terrama2::core::GridSeries::addGridSeries(std::unordered_map<DataSetPtr,Dat
     }//bad cast
   }
 }
+
+void terrama2::core::GridSeries::addRasterHandle(DataSetGridPtr dataSet, RasterHandlePtr handle)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  handleMap_.emplace(dataSet, handle);
+  rasterMapRead_ = false;
+}
+
+std::unordered_multimap<terrama2::core::DataSetGridPtr, terrama2::core::RasterHandlePtr>
+terrama2::core::GridSeries::handleMap() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return handleMap_;
+}
+
+const std::unordered_multimap<terrama2::core::DataSetGridPtr, std::shared_ptr<te::rst::Raster> >&
+terrama2::core::GridSeries::gridMap() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if(!rasterMapRead_)
+  {
+    rasterMap_.clear();
+    for(const auto& item : handleMap_)
+      rasterMap_.emplace(item.first, item.second->raster());
+
+    rasterMapRead_ = true;
+  }
+
+  return rasterMap_;
+}
+
+const std::unordered_map<terrama2::core::DataSetPtr, terrama2::core::DataSetSeries>&
+terrama2::core::GridSeries::getSeries()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if(!dataSeriesMap_.empty() || handleMap_.empty())
+    return dataSeriesMap_;
+
+  for(const auto& item : handleMap_)
+  {
+    auto raster = item.second->raster();
+    if(!raster)
+      continue;
+
+    auto& series = dataSeriesMap_[item.first];
+    if(!series.syncDataSet)
+    {
+      std::vector<te::rst::BandProperty*> bands;
+      for(std::size_t i = 0; i < raster->getNumberOfBands(); ++i)
+        bands.push_back(new te::rst::BandProperty(*raster->getBand(i)->getProperty()));
+
+      series.dataSet = item.first;
+      series.teDataSetType = std::make_shared<te::da::DataSetType>("grid");
+      series.teDataSetType->add(new te::rst::RasterProperty(new te::rst::Grid(*raster->getGrid()), bands, {}));
+      series.teDataSetType->add(new te::dt::DateTimeProperty("file_timestamp", te::dt::TIME_INSTANT_TZ));
+      series.syncDataSet = std::make_shared<SynchronizedDataSet>(std::make_shared<te::mem::DataSet>(series.teDataSetType.get()));
+    }
+
+    auto dataSet = std::dynamic_pointer_cast<te::mem::DataSet>(series.syncDataSet->dataset());
+    te::mem::DataSetItem* dataSetItem = new te::mem::DataSetItem(dataSet.get());
+    dataSetItem->setRaster(0, static_cast<te::rst::Raster*>(raster->clone()));
+    dataSetItem->setDateTime(1, item.second->timestamp() ? static_cast<te::dt::DateTime*>(item.second->timestamp()->clone()) : nullptr);
+    dataSet->add(dataSetItem);
+  }
+
+  return dataSeriesMap_;
+}
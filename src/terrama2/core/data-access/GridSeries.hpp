@@ -33,11 +33,15 @@
 //TerraMA2
 #include "../data-model/DataSetGrid.hpp"
 #include "DataSetSeries.hpp"
+#include "RasterHandle.hpp"
 #include "SeriesAggregation.hpp"
 
 //TerraLib
 #include <terralib/raster.h>
 
+//STL
+#include <mutex>
+
 namespace terrama2
 {
   namespace core
@@ -46,19 +50,41 @@ namespace terrama2
       \class GridSeries
       \brief A GridSeries represents a set of data grids.
 
-      The GridSeries aggregates the te::rst::Raster of each grid.
+      The GridSeries aggregates a RasterHandle of each grid,
+      the rasters of raster files are only read when requested.
     */
     class GridSeries : public SeriesAggregation
     {
       public:
-        //! Add a group of DataSet data to the GridSeries.
+        //! Add a group of DataSet data to the GridSeries, the rasters of the DataSet data are already read.
         void addGridSeries(std::unordered_map<DataSetPtr,DataSetSeries> seriesMap);
-        //! Returns a map of DataSetGrid data.
-        inline const std::unordered_multimap<DataSetGridPtr, std::shared_ptr<te::rst::Raster> >& gridMap() const { return rasterMap_; }
 
-      private:
-        std::unordered_multimap<DataSetGridPtr, std::shared_ptr<te::rst::Raster> > rasterMap_;//!< Map of DataSetGrid data.
+        //! Adds the handle of a raster of the DataSetGrid.
+        void addRasterHandle(DataSetGridPtr dataSet, RasterHandlePtr handle);
+
+        //! Returns a copy of the handles of the rasters of each DataSetGrid, handles may be added concurrently.
+        std::unordered_multimap<DataSetGridPtr, RasterHandlePtr> handleMap() const;
+
+        /*!
+          \brief Returns a map of DataSetGrid data.
 
+          The rasters not yet read are read on the first call.
+        */
+        const std::unordered_multimap<DataSetGridPtr, std::shared_ptr<te::rst::Raster> >& gridMap() const;
+
+        /*!
+          \brief Returns a map of DataSet data.
+
+          If the grids were added as handles, a DataSet with the raster and the timestamp
+          of each grid is created on the first call, the rasters are copied in this case.
+        */
+        virtual const std::unordered_map<DataSetPtr,DataSetSeries>& getSeries() override;
+
+      private:
+        std::unordered_multimap<DataSetGridPtr, RasterHandlePtr> handleMap_;//!< Map of DataSetGrid raster handles.
+        mutable std::unordered_multimap<DataSetGridPtr, std::shared_ptr<te::rst::Raster> > rasterMap_;//!< Map of DataSetGrid data.
+        mutable bool rasterMapRead_ = false;//!< If the rasters of the handles were already read.
+        mutable std::mutex mutex_;//!< Synchronizes the access to the handles and the reading of the rasters.
     };
   }
 }
@@ -0,0 +1,321 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/core/data-access/RasterHandle.cpp
+
+  \brief Lightweight reference to a raster whose pixels are read on demand.
+
+  \author Jano Simas
+*/
+
+#include "RasterHandle.hpp"
+#include "../utility/Logger.hpp"
+#include "../utility/DecodedRasterCache.hpp"
+#include "../utility/RasterBlockCache.hpp"
+#include "../Exception.hpp"
+
+//TerraLib
+#include <terralib/common/Enums.h>
+#include <terralib/datatype/Enums.h>
+#include <terralib/raster/Band.h>
+#include <terralib/raster/BandProperty.h>
+#include <terralib/raster/Grid.h>
+#include <terralib/raster/RasterFactory.h>
+
+//QT
+#include <QString>
+#include <QObject>
+
+//STL
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <map>
+
+namespace
+{
+  //! Windows read by the handles of the process, a window is kept while a handle holds its raster.
+  std::map<std::string, std::weak_ptr<te::rst::Raster> > windows;
+  std::mutex windowsMutex;
+}
+
+const unsigned int terrama2::core::RasterHandle::windowMargin;
+const unsigned int terrama2::core::RasterHandle::blockSize;
+
+terrama2::core::RasterHandle::RasterHandle(const GridInfo& gridInfo, std::shared_ptr<te::dt::TimeInstantTZ> timestamp)
+  : gridInfo_(gridInfo),
+    timestamp_(timestamp),
+    numberOfColumns_(gridInfo.numberOfColumns),
+    numberOfRows_(gridInfo.numberOfRows)
+{
+}
+
+terrama2::core::RasterHandle::RasterHandle(std::shared_ptr<te::rst::Raster> raster, std::shared_ptr<te::dt::TimeInstantTZ> timestamp)
+  : timestamp_(timestamp),
+    raster_(raster)
+{
+  if(raster)
+  {
+    DataAccessorGrid::fillGridInfo(gridInfo_, raster.get());
+    numberOfColumns_ = gridInfo_.numberOfColumns;
+    numberOfRows_ = gridInfo_.numberOfRows;
+  }
+}
+
+bool terrama2::core::RasterHandle::setWindow(const te::gm::Envelope& envelope, Srid srid)
+{
+  if(!gridInfo_.extent)
+    return false;
+
+  te::gm::Envelope window(envelope);
+  if(srid != gridInfo_.srid)
+    window.transform(srid, gridInfo_.srid);
+
+  if(!window.intersects(*gridInfo_.extent))
+    return false;
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  // rasters already read are not changed
+  if(raster_)
+    return true;
+
+  const te::gm::Envelope& extent = *gridInfo_.extent;
+  auto toIndex = [](double value, unsigned int size)
+  {
+    return static_cast<unsigned int>(std::max(0., std::min(std::floor(value), static_cast<double>(size))));
+  };
+
+  // rows grow from north to south
+  unsigned int firstColumn = toIndex((window.getLowerLeftX() - extent.getLowerLeftX()) / gridInfo_.resolutionX - windowMargin, gridInfo_.numberOfColumns);
+  unsigned int lastColumn = toIndex((window.getUpperRightX() - extent.getLowerLeftX()) / gridInfo_.resolutionX + windowMargin + 1, gridInfo_.numberOfColumns);
+  unsigned int firstRow = toIndex((extent.getUpperRightY() - window.getUpperRightY()) / gridInfo_.resolutionY - windowMargin, gridInfo_.numberOfRows);
+  unsigned int lastRow = toIndex((extent.getUpperRightY() - window.getLowerLeftY()) / gridInfo_.resolutionY + windowMargin + 1, gridInfo_.numberOfRows);
+
+  if(lastColumn <= firstColumn || lastRow <= firstRow)
+    return false;
+
+  firstColumn_ = firstColumn;
+  firstRow_ = firstRow;
+  numberOfColumns_ = lastColumn - firstColumn;
+  numberOfRows_ = lastRow - firstRow;
+
+  return true;
+}
+
+std::shared_ptr<te::rst::Raster> terrama2::core::RasterHandle::raster() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if(!raster_ && !gridInfo_.uri.empty())
+    raster_ = readWindow();
+
+  return raster_;
+}
+
+std::shared_ptr<te::rst::Raster> terrama2::core::RasterHandle::readWindow() const
+{
+  const std::string fileIdentity = RasterBlockCache::fileIdentity(gridInfo_.uri);
+  if(fileIdentity.empty())
+  {
+    QString errMsg = QObject::tr("Could not access file: %1.").arg(QString::fromStdString(gridInfo_.uri));
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw DataAccessorException() << ErrorDescription(errMsg);
+  }
+
+  // handles of the same window of a file share the raster read
+  const std::string windowKey = fileIdentity + "|" + std::to_string(firstColumn_) + "," + std::to_string(firstRow_)
+                                + "," + std::to_string(numberOfColumns_) + "," + std::to_string(numberOfRows_);
+  {
+    std::lock_guard<std::mutex> lock(windowsMutex);
+    auto it = windows.find(windowKey);
+    if(it != windows.end())
+    {
+      auto window = it->second.lock();
+      if(window)
+        return window;
+    }
+  }
+
+  const te::gm::Envelope& extent = *gridInfo_.extent;
+  double minX = extent.getLowerLeftX() + firstColumn_ * gridInfo_.resolutionX;
+  double maxY = extent.getUpperRightY() - firstRow_ * gridInfo_.resolutionY;
+  te::gm::Envelope* windowExtent = new te::gm::Envelope(minX, maxY - numberOfRows_ * gridInfo_.resolutionY,
+                                                        minX + numberOfColumns_ * gridInfo_.resolutionX, maxY);
+  te::rst::Grid* grid = new te::rst::Grid(numberOfColumns_, numberOfRows_, gridInfo_.resolutionX, gridInfo_.resolutionY,
+                                          windowExtent, gridInfo_.srid);
+
+  // the window has the data type of the cached blocks, so rows are copied without conversion
+  std::vector<int> dataTypes;
+  std::vector<te::rst::BandProperty*> bands;
+  for(std::size_t bandIdx = 0; bandIdx < gridInfo_.numberOfBands; ++bandIdx)
+  {
+    int dataType = RasterBlock::storageType(bandIdx < gridInfo_.dataType.size() ? gridInfo_.dataType[bandIdx] : te::dt::DOUBLE_TYPE);
+    dataTypes.push_back(dataType);
+
+    te::rst::BandProperty* bandProperty = new te::rst::BandProperty(bandIdx, dataType);
+    bandProperty->m_blkh = 1;
+    bandProperty->m_blkw = numberOfColumns_;
+    bandProperty->m_nblocksx = 1;
+    bandProperty->m_nblocksy = numberOfRows_;
+    if(bandIdx < gridInfo_.noData.size())
+      bandProperty->m_noDataValue = gridInfo_.noData[bandIdx];
+    // quantized values are read as stored, readers apply the scale and offset
+    if(bandIdx < gridInfo_.valuesScale.size())
+      bandProperty->m_valuesScale = gridInfo_.valuesScale[bandIdx];
+    if(bandIdx < gridInfo_.valuesOffset.size())
+      bandProperty->m_valuesOffset = gridInfo_.valuesOffset[bandIdx];
+    bands.push_back(bandProperty);
+  }
+
+  std::shared_ptr<te::rst::Raster> window(te::rst::RasterFactory::make("MEM", grid, bands, {}));
+  if(!window)
+  {
+    QString errMsg = QObject::tr("Could not create raster for file: %1.").arg(QString::fromStdString(gridInfo_.uri));
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw DataAccessorException() << ErrorDescription(errMsg);
+  }
+
+  // the file is only opened if a block is not in the cache
+  std::unique_ptr<te::rst::Raster> file;
+  auto openFile = [this, &file]()
+  {
+    if(file)
+      return;
+
+    std::map<std::string, std::string> rinfo;
+    rinfo["URI"] = gridInfo_.uri;
+    // the file is opened read-only, pixel blocks are read only when requested
+    file.reset(te::rst::RasterFactory::open(rinfo, te::common::RAccess));
+    if(!file)
+    {
+      QString errMsg = QObject::tr("Could not open raster file: %1.").arg(QString::fromStdString(gridInfo_.uri));
+      TERRAMA2_LOG_ERROR() << errMsg;
+      throw DataAccessorException() << ErrorDescription(errMsg);
+    }
+  };
+
+  // decoded blocks may also be stored in the local disk cache, identified by the content of the file
+  const std::string sourceIdentity = gridInfo_.decodedCache ? DecodedRasterCache::sourceIdentity(gridInfo_.uri) : std::string();
+
+  // the file is read in square blocks, shared with other readers through the cache
+  const unsigned int blocksX = (gridInfo_.numberOfColumns + blockSize - 1) / blockSize;
+  const unsigned int firstBlockX = firstColumn_ / blockSize;
+  const unsigned int lastBlockX = (firstColumn_ + numberOfColumns_ - 1) / blockSize;
+  const unsigned int lastRow = firstRow_ + numberOfRows_ - 1;
+  for(std::size_t bandIdx = 0; bandIdx < gridInfo_.numberOfBands; ++bandIdx)
+  {
+    te::rst::Band* windowBand = window->getBand(bandIdx);
+    const int dataType = dataTypes[bandIdx];
+    const std::size_t pixelSize = RasterBlock(dataType).pixelSize();
+    std::vector<unsigned char> row(static_cast<std::size_t>(numberOfColumns_) * pixelSize);
+
+    for(unsigned int blockY = firstRow_ / blockSize; blockY <= lastRow / blockSize; ++blockY)
+    {
+      const unsigned int blockRow = blockY * blockSize;
+      const unsigned int blockRows = std::min(blockSize, gridInfo_.numberOfRows - blockRow);
+
+      // the blocks of the row of blocks stay pinned while their rows are copied
+      std::vector<RasterBlockPtr> rowBlocks;
+      for(unsigned int blockX = firstBlockX; blockX <= lastBlockX; ++blockX)
+      {
+        const unsigned int blockColumn = blockX * blockSize;
+        const unsigned int blockColumns = std::min(blockSize, gridInfo_.numberOfColumns - blockColumn);
+
+        RasterBlockKey key;
+        key.fileIdentity = fileIdentity;
+        key.band = bandIdx;
+        key.block = static_cast<std::size_t>(blockY) * blocksX + blockX;
+
+        auto decode = [&]()
+        {
+          openFile();
+          const te::rst::Band* fileBand = file->getBand(bandIdx);
+
+          RasterBlock block(dataType, static_cast<std::size_t>(blockColumns) * blockRows);
+          double value;
+          for(unsigned int row = 0; row < blockRows; ++row)
+          {
+            for(unsigned int col = 0; col < blockColumns; ++col)
+            {
+              fileBand->getValue(blockColumn + col, blockRow + row, value);
+              block.setValue(static_cast<std::size_t>(row) * blockColumns + col, value);
+            }
+          }
+
+          return block;
+        };
+
+        rowBlocks.push_back(RasterBlockCache::getInstance().get(key, [&]()
+        {
+          if(sourceIdentity.empty())
+            return decode();
+
+          RasterBlockKey sourceKey = key;
+          sourceKey.fileIdentity = sourceIdentity;
+          return DecodedRasterCache::getInstance().get(sourceKey, dataType, decode);
+        }));
+      }
+
+      // each row of the window is assembled from the parts of the blocks inside the window
+      const unsigned int beginRow = std::max(blockRow, firstRow_);
+      const unsigned int endRow = std::min(blockRow + blockRows, firstRow_ + numberOfRows_);
+      for(unsigned int rowIdx = beginRow; rowIdx < endRow; ++rowIdx)
+      {
+        for(unsigned int blockX = firstBlockX; blockX <= lastBlockX; ++blockX)
+        {
+          const RasterBlock& block = *rowBlocks[blockX - firstBlockX];
+          const unsigned int blockColumn = blockX * blockSize;
+          const unsigned int blockColumns = std::min(blockSize, gridInfo_.numberOfColumns - blockColumn);
+          const unsigned int beginColumn = std::max(blockColumn, firstColumn_);
+          const unsigned int endColumn = std::min(blockColumn + blockColumns, firstColumn_ + numberOfColumns_);
+
+          std::memcpy(row.data() + static_cast<std::size_t>(beginColumn - firstColumn_) * pixelSize,
+                      block.data() + (static_cast<std::size_t>(rowIdx - blockRow) * blockColumns + (beginColumn - blockColumn)) * pixelSize,
+                      static_cast<std::size_t>(endColumn - beginColumn) * pixelSize);
+        }
+
+        windowBand->write(0, static_cast<int>(rowIdx - firstRow_), row.data());
+      }
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(windowsMutex);
+  // windows no longer in use are forgotten
+  for(auto it = windows.begin(); it != windows.end();)
+  {
+    if(it->second.expired())
+      it = windows.erase(it);
+    else
+      ++it;
+  }
+
+  // another handle may have read the same window meanwhile
+  auto it = windows.find(windowKey);
+  if(it != windows.end())
+  {
+    auto shared = it->second.lock();
+    if(shared)
+      return shared;
+  }
+
+  windows[windowKey] = window;
+  return window;
+}
@@ -0,0 +1,135 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/core/data-access/RasterHandle.hpp
+
+  \brief Lightweight reference to a raster whose pixels are read on demand.
+
+  \author Jano Simas
+*/
+
+#ifndef __TERRAMA2_CORE_DATA_ACCESS_RASTER_HANDLE_HPP__
+#define __TERRAMA2_CORE_DATA_ACCESS_RASTER_HANDLE_HPP__
+
+//TerraMA2
+#include "DataAccessorGrid.hpp"
+#include "../Typedef.hpp"
+
+//TerraLib
+#include <terralib/datatype/TimeInstantTZ.h>
+#include <terralib/geometry/Envelope.h>
+#include <terralib/raster/Raster.h>
+
+//STL
+#include <memory>
+#include <mutex>
+
+namespace terrama2
+{
+  namespace core
+  {
+    /*!
+      \brief Reference to a raster of a grid series.
+
+      A handle to a raster file holds only the grid information,
+      the pixels are read the first time the raster is requested.
+
+      A pixel window can be set before the first access,
+      only the pixels of the window are read, so the memory used
+      depends on the area of interest and not on the size of the file.
+
+      Handles can also wrap rasters already read, in this case the window is not applied.
+    */
+    class RasterHandle
+    {
+      public:
+        /*!
+          \brief Handle to a raster file.
+
+          \param gridInfo Grid information, the uri must be the path of the file.
+          \param timestamp Timestamp of the raster, may be null.
+        */
+        RasterHandle(const GridInfo& gridInfo, std::shared_ptr<te::dt::TimeInstantTZ> timestamp);
+
+        //! Handle to a raster already read.
+        RasterHandle(std::shared_ptr<te::rst::Raster> raster, std::shared_ptr<te::dt::TimeInstantTZ> timestamp);
+
+        //! Grid information of the complete raster.
+        const GridInfo& gridInfo() const { return gridInfo_; }
+
+        //! Timestamp of the raster, may be null.
+        std::shared_ptr<te::dt::TimeInstantTZ> timestamp() const { return timestamp_; }
+
+        /*!
+          \brief Restricts the pixels read to the envelope.
+
+          The window is expanded by a margin of pixels so interpolations at the border
+          of the envelope have all neighbours.
+
+          \param envelope Envelope of the area of interest.
+          \param srid SRID of the envelope.
+          \return False if the envelope doesn't intersect the raster.
+        */
+        bool setWindow(const te::gm::Envelope& envelope, Srid srid);
+
+        /*!
+          \brief Returns the raster.
+
+          For raster files, the pixels of the window are read in memory on the first call,
+          following calls return the same raster.
+
+          Handles of the same window of a file share the raster, it must not be modified.
+
+          \exception DataAccessorException Raised if the file could not be read.
+        */
+        std::shared_ptr<te::rst::Raster> raster() const;
+
+        //! Number of pixels of margin around the window.
+        static const unsigned int windowMargin = 2;
+
+        //! Size, in pixels, of the side of the blocks read from the file.
+        static const unsigned int blockSize = 256;
+
+      private:
+        /*!
+          \brief Reads the pixels of the window from the file.
+
+          The file is read in blocks through the RasterBlockCache,
+          windows of the same file read by other handles share the decoded blocks.
+          The window keeps the data type of the blocks and is assembled row by row.
+        */
+        std::shared_ptr<te::rst::Raster> readWindow() const;
+
+        GridInfo gridInfo_;
+        std::shared_ptr<te::dt::TimeInstantTZ> timestamp_;
+        unsigned int firstColumn_ = 0; //!< First column of the window.
+        unsigned int firstRow_ = 0; //!< First row of the window.
+        unsigned int numberOfColumns_ = 0; //!< Number of columns of the window.
+        unsigned int numberOfRows_ = 0; //!< Number of rows of the window.
+
+        mutable std::mutex mutex_; //!< Synchronizes the first read.
+        mutable std::shared_ptr<te::rst::Raster> raster_; //!< Raster read, null until the first access.
+    };
+  }
+}
+
+#endif // __TERRAMA2_CORE_DATA_ACCESS_RASTER_HANDLE_HPP__
@@ -48,8 +48,11 @@ namespace terrama2
     class SeriesAggregation
     {
       public:
+        //! Default destructor.
+        virtual ~SeriesAggregation() = default;
+
         //! Returns a map of DataSet data.
-        const std::unordered_map<DataSetPtr,DataSetSeries >& getSeries();
+        virtual const std::unordered_map<DataSetPtr,DataSetSeries >& getSeries();
       protected:
         std::unordered_map<DataSetPtr,DataSetSeries > dataSeriesMap_;//!< Map of DataSet data.
     };
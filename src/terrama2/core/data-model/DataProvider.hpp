@@ -74,7 +74,8 @@ namespace terrama2
           "description" : STRING,
           "intent" : INT,
           "uri" : STRING,
-          "active" : BOOL
+          "active" : BOOL,
+          "ingestion_threads" : INT (optional)
         }
       \endcode
 
@@ -89,6 +90,7 @@ namespace terrama2
       DataProviderIntent intent = DataProviderIntent::PROCESS_INTENT; //!< Intent os the DataProvider (Collect or Process)
       std::string uri; //!< URI to access the DataProvider data.
       bool active = true; //!< DataProvider status.
+      uint32_t ingestionThreads = 0; //!< Maximum number of threads reading the data concurrently, 0 to use the number of cores.
 
       //! Comparison operator for DataProvider
       inline bool operator==(const DataProvider& rhs){ return id == rhs.id; }
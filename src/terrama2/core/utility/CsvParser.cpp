@@ -0,0 +1,570 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/core/utility/CsvParser.cpp
+
+  \brief Parser of delimited text files into typed TerraLib datasets.
+
+  \author Jano Simas
+*/
+
+#include "CsvParser.hpp"
+#include "Logger.hpp"
+#include "../Exception.hpp"
+
+//TerraLib
+#include <terralib/datatype/DateTimeProperty.h>
+#include <terralib/datatype/SimpleProperty.h>
+#include <terralib/datatype/StringProperty.h>
+#include <terralib/datatype/TimeInstantTZ.h>
+#include <terralib/geometry/GeometryProperty.h>
+#include <terralib/geometry/Point.h>
+#include <terralib/memory/DataSetItem.h>
+
+//Qt
+#include <QFile>
+#include <QFileInfo>
+#include <QObject>
+#include <QString>
+
+//STL
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace
+{
+  //! Minimum size of a chunk of lines parsed by a thread.
+  const std::size_t MINIMUM_CHUNK_SIZE = 1024*1024;
+
+  //! Returns the beginning of the line after the one that contains \e pos.
+  const char* nextLine(const char* pos, const char* end)
+  {
+    const char* lineBreak = static_cast<const char*>(std::memchr(pos, '\n', end - pos));
+    return lineBreak ? lineBreak + 1 : end;
+  }
+
+  //! Returns true if the remaining characters are only spaces.
+  bool onlySpaces(const char* pos)
+  {
+    while(*pos != '\0')
+    {
+      if(!std::isspace(static_cast<unsigned char>(*pos)))
+        return false;
+      ++pos;
+    }
+
+    return true;
+  }
+
+  //! Converts the text to double, empty and invalid numbers (NaN, inf) are not accepted.
+  bool toDouble(const std::string& text, double& value)
+  {
+    if(text.empty())
+      return false;
+
+    char* end = nullptr;
+    value = std::strtod(text.c_str(), &end);
+    if(end == text.c_str() || !onlySpaces(end))
+      return false;
+
+    return std::isnormal(value) || value == 0.0;
+  }
+
+  //! Converts the text to a 32 bits integer.
+  bool toInt32(const std::string& text, int32_t& value)
+  {
+    if(text.empty())
+      return false;
+
+    char* end = nullptr;
+    errno = 0;
+    long longValue = std::strtol(text.c_str(), &end, 10);
+    if(end == text.c_str() || !onlySpaces(end) || errno == ERANGE
+       || longValue < std::numeric_limits<int32_t>::min() || longValue > std::numeric_limits<int32_t>::max())
+      return false;
+
+    value = static_cast<int32_t>(longValue);
+    return true;
+  }
+}
+
+terrama2::core::CsvParser::CsvParser(const Format& format)
+  : format_(format)
+{
+}
+
+terrama2::core::CsvParser::Result terrama2::core::CsvParser::parse(const std::string& path, const Position& start) const
+{
+  QFile file(QString::fromStdString(path));
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    QString errMsg = QObject::tr("Could not open file: %1.").arg(QString::fromStdString(path));
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw DataAccessorException() << ErrorDescription(errMsg);
+  }
+
+  // the file is mapped in memory, if not possible it's read to a buffer
+  QByteArray buffer;
+  const char* begin = nullptr;
+  const char* end = nullptr;
+  qint64 size = file.size();
+  if(size > 0)
+  {
+    uchar* data = file.map(0, size);
+    if(data)
+    {
+      begin = reinterpret_cast<const char*>(data);
+    }
+    else
+    {
+      buffer = file.readAll();
+      begin = buffer.constData();
+      size = buffer.size();
+    }
+    end = begin + size;
+  }
+
+  const char* pos = begin;
+  for(std::size_t line = 0; line < format_.headerLine && pos < end; ++line)
+    pos = nextLine(pos, end);
+
+  if(pos >= end)
+  {
+    QString errMsg = QObject::tr("No header in file: %1.").arg(QString::fromStdString(path));
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw DataAccessorException() << ErrorDescription(errMsg);
+  }
+
+  const char* headerEnd = nextLine(pos, end);
+  std::vector<std::string> headers;
+  split(pos, headerEnd, headers);
+
+  pos = headerEnd;
+  for(std::size_t line = 0; line < format_.ignoredLines && pos < end; ++line)
+    pos = nextLine(pos, end);
+
+  // skip the lines already read
+  if(start.offset > 0)
+    pos = std::max(pos, begin + std::min<qint64>(start.offset, size));
+
+  // the last line may be incomplete if the file is being written
+  if(format_.completeLinesOnly)
+  {
+    while(end > pos && *(end-1) != '\n')
+      --end;
+  }
+
+  Result result;
+  result.dataSetType = std::make_shared<te::da::DataSetType>(QFileInfo(QString::fromStdString(path)).completeBaseName().toStdString());
+
+  // create the properties in the same order of the columns,
+  // the point is created at the position of the last coordinate column
+  std::vector<Column> columns(headers.size());
+  std::vector<std::size_t> positions(headers.size(), std::numeric_limits<std::size_t>::max());
+  std::size_t longitudeColumn = std::numeric_limits<std::size_t>::max();
+  std::size_t latitudeColumn = std::numeric_limits<std::size_t>::max();
+  std::size_t geometryPosition = std::numeric_limits<std::size_t>::max();
+  for(std::size_t i = 0; i < headers.size(); ++i)
+  {
+    if(format_.column)
+      columns[i] = format_.column(headers[i]);
+
+    te::dt::Property* property = nullptr;
+    switch(columns[i].type)
+    {
+      case ColumnType::IGNORE:
+        continue;
+      case ColumnType::STRING:
+        property = new te::dt::StringProperty(columns[i].name);
+        break;
+      case ColumnType::INT32:
+        property = new te::dt::SimpleProperty(columns[i].name, te::dt::INT32_TYPE);
+        break;
+      case ColumnType::DOUBLE:
+        property = new te::dt::SimpleProperty(columns[i].name, te::dt::DOUBLE_TYPE);
+        break;
+      case ColumnType::TIMESTAMP:
+        property = new te::dt::DateTimeProperty(columns[i].name, te::dt::TIME_INSTANT_TZ);
+        break;
+      case ColumnType::LONGITUDE:
+      case ColumnType::LATITUDE:
+      {
+        if(columns[i].type == ColumnType::LONGITUDE)
+          longitudeColumn = i;
+        else
+          latitudeColumn = i;
+
+        if(longitudeColumn == std::numeric_limits<std::size_t>::max()
+           || latitudeColumn == std::numeric_limits<std::size_t>::max())
+          continue;
+
+        property = new te::gm::GeometryProperty(format_.geometryName, format_.srid, te::gm::PointType);
+        break;
+      }
+    }
+
+    result.dataSetType->add(property);
+    positions[i] = result.dataSetType->size() - 1;
+
+    if(columns[i].type == ColumnType::LONGITUDE || columns[i].type == ColumnType::LATITUDE)
+    {
+      geometryPosition = positions[i];
+      positions[longitudeColumn] = geometryPosition;
+      positions[latitudeColumn] = geometryPosition;
+    }
+  }
+
+  // only one of the coordinates columns was found
+  if(geometryPosition == std::numeric_limits<std::size_t>::max())
+  {
+    if(longitudeColumn != std::numeric_limits<std::size_t>::max())
+      columns[longitudeColumn].type = ColumnType::IGNORE;
+    if(latitudeColumn != std::numeric_limits<std::size_t>::max())
+      columns[latitudeColumn].type = ColumnType::IGNORE;
+  }
+
+  result.dataSet = std::make_shared<te::mem::DataSet>(result.dataSetType.get());
+  result.end.offset = std::max<qint64>(start.offset, pos - begin);
+  result.end.lastTimestamp = start.lastTimestamp;
+
+  if(pos >= end)
+    return result;
+
+  result.end.offset = end - begin;
+
+  // split the lines in chunks aligned to the line breaks
+  std::size_t length = static_cast<std::size_t>(end - pos);
+  std::size_t numberOfChunks = std::max<std::size_t>(1, std::min<std::size_t>(std::thread::hardware_concurrency(), length / MINIMUM_CHUNK_SIZE));
+  std::vector<const char*> bounds {pos};
+  for(std::size_t i = 1; i < numberOfChunks; ++i)
+  {
+    const char* bound = nextLine(pos + length*i/numberOfChunks, end);
+    if(bound > bounds.back() && bound < end)
+      bounds.push_back(bound);
+  }
+  bounds.push_back(end);
+
+  // each chunk starts from the last timestamp already read
+  std::vector<boost::posix_time::ptime> lastTimestamps(bounds.size() - 1, start.lastTimestamp);
+
+  std::vector<std::future<std::vector<std::unique_ptr<te::mem::DataSetItem> > > > futures;
+  for(std::size_t i = 1; i + 1 < bounds.size(); ++i)
+    futures.push_back(std::async(std::launch::async, &CsvParser::parseLines, this, bounds[i], bounds[i+1],
+                                 result.dataSet.get(), std::cref(columns), std::cref(positions), std::ref(lastTimestamps[i])));
+
+  // the first chunk is parsed in this thread
+  auto items = parseLines(bounds[0], bounds[1], result.dataSet.get(), columns, positions, lastTimestamps[0]);
+  for(auto& item : items)
+    result.dataSet->add(item.release());
+
+  for(auto& future : futures)
+  {
+    auto chunkItems = future.get();
+    for(auto& item : chunkItems)
+      result.dataSet->add(item.release());
+  }
+
+  for(const auto& lastTimestamp : lastTimestamps)
+  {
+    if(!lastTimestamp.is_special() && (result.end.lastTimestamp.is_special() || lastTimestamp > result.end.lastTimestamp))
+      result.end.lastTimestamp = lastTimestamp;
+  }
+
+  return result;
+}
+
+terrama2::core::CsvParser::Position terrama2::core::CsvParser::toPosition(const FileCatalog::ReadPosition& readPosition)
+{
+  Position position;
+  position.offset = readPosition.offset;
+  if(!readPosition.lastTimestamp.empty())
+  {
+    try
+    {
+      position.lastTimestamp = boost::posix_time::from_iso_string(readPosition.lastTimestamp);
+    }
+    catch(const std::exception&)
+    {
+      // invalid timestamp, the whole file is read again
+      return Position();
+    }
+  }
+
+  return position;
+}
+
+terrama2::core::FileCatalog::ReadPosition terrama2::core::CsvParser::toReadPosition(const Position& position)
+{
+  FileCatalog::ReadPosition readPosition;
+  readPosition.offset = position.offset;
+  if(!position.lastTimestamp.is_special())
+    readPosition.lastTimestamp = boost::posix_time::to_iso_string(position.lastTimestamp);
+
+  return readPosition;
+}
+
+std::vector<std::unique_ptr<te::mem::DataSetItem> > terrama2::core::CsvParser::parseLines(const char* begin, const char* end,
+                                                                                          const te::mem::DataSet* parent,
+                                                                                          const std::vector<Column>& columns,
+                                                                                          const std::vector<std::size_t>& positions,
+                                                                                          boost::posix_time::ptime& lastTimestamp) const
+{
+  boost::local_time::time_zone_ptr zone = timezone(format_.timezone);
+  // lines up to this timestamp were already read
+  const boost::posix_time::ptime readUntil = lastTimestamp;
+
+  std::vector<std::unique_ptr<te::mem::DataSetItem> > items;
+  std::vector<std::string> values;
+
+  const char* pos = begin;
+  while(pos < end)
+  {
+    const char* lineEnd = nextLine(pos, end);
+    split(pos, lineEnd, values);
+    pos = lineEnd;
+
+    // empty line
+    if(values.size() == 1 && values.front().empty())
+      continue;
+
+    std::unique_ptr<te::mem::DataSetItem> item(new te::mem::DataSetItem(parent));
+
+    double longitude = 0;
+    double latitude = 0;
+    bool hasLongitude = false;
+    bool hasLatitude = false;
+    std::size_t geometryPosition = std::numeric_limits<std::size_t>::max();
+    boost::posix_time::ptime itemTimestamp;
+
+    for(std::size_t i = 0, size = std::min(values.size(), columns.size()); i < size; ++i)
+    {
+      const std::string& value = values[i];
+      std::size_t position = positions[i];
+      switch(columns[i].type)
+      {
+        case ColumnType::IGNORE:
+          break;
+        case ColumnType::STRING:
+          item->setString(position, value);
+          break;
+        case ColumnType::INT32:
+        {
+          int32_t intValue;
+          if(toInt32(value, intValue))
+            item->setInt32(position, intValue);
+          break;
+        }
+        case ColumnType::DOUBLE:
+        {
+          double doubleValue;
+          if(toDouble(value, doubleValue))
+            item->setDouble(position, doubleValue);
+          break;
+        }
+        case ColumnType::TIMESTAMP:
+        {
+          boost::posix_time::ptime boostDate;
+          if(parseTimestamp(value.data(), value.data() + value.size(), format_.timestampFormat, boostDate))
+          {
+            boost::local_time::local_date_time date(boostDate.date(), boostDate.time_of_day(), zone, true);
+            item->setDateTime(position, new te::dt::TimeInstantTZ(date));
+            itemTimestamp = date.utc_time();
+          }
+          else
+          {
+            TERRAMA2_LOG_WARNING() << QObject::tr("Invalid timestamp: %1.").arg(QString::fromStdString(value));
+          }
+          break;
+        }
+        case ColumnType::LONGITUDE:
+          hasLongitude = toDouble(value, longitude);
+          geometryPosition = position;
+          break;
+        case ColumnType::LATITUDE:
+          hasLatitude = toDouble(value, latitude);
+          geometryPosition = position;
+          break;
+      }
+    }
+
+    if(!itemTimestamp.is_special())
+    {
+      if(!readUntil.is_special() && itemTimestamp <= readUntil)
+        continue;
+
+      if(lastTimestamp.is_special() || itemTimestamp > lastTimestamp)
+        lastTimestamp = itemTimestamp;
+    }
+
+    if(hasLongitude && hasLatitude)
+      item->setGeometry(geometryPosition, new te::gm::Point(longitude, latitude, format_.srid));
+
+    items.push_back(std::move(item));
+  }
+
+  return items;
+}
+
+void terrama2::core::CsvParser::split(const char* begin, const char* end, std::vector<std::string>& values) const
+{
+  // remove line break
+  while(end > begin && (*(end-1) == '\n' || *(end-1) == '\r'))
+    --end;
+
+  values.clear();
+  values.emplace_back();
+
+  bool quoted = false;
+  for(const char* pos = begin; pos < end; ++pos)
+  {
+    char c = *pos;
+    if(quoted)
+    {
+      if(c != '"')
+        values.back().push_back(c);
+      else if(pos + 1 < end && *(pos+1) == '"')
+      {
+        // escaped quote
+        values.back().push_back('"');
+        ++pos;
+      }
+      else
+        quoted = false;
+    }
+    else if(c == '"')
+      quoted = true;
+    else if(c == format_.delimiter)
+      values.emplace_back();
+    else
+      values.back().push_back(c);
+  }
+}
+
+bool terrama2::core::CsvParser::parseTimestamp(const char* begin, const char* end, const std::string& format, boost::posix_time::ptime& result)
+{
+  while(begin < end && std::isspace(static_cast<unsigned char>(*begin)))
+    ++begin;
+  while(end > begin && std::isspace(static_cast<unsigned char>(*(end-1))))
+    --end;
+
+  int year = 0, month = 0, day = 0, hour = 0, minute = 0, second = 0;
+  long microseconds = 0;
+
+  const char* pos = begin;
+  for(std::size_t i = 0; i < format.size(); ++i)
+  {
+    if(format[i] != '%' || i + 1 == format.size())
+    {
+      // literal character
+      if(pos == end || *pos != format[i])
+        return false;
+
+      ++pos;
+      continue;
+    }
+
+    char specifier = format[++i];
+    int* field = nullptr;
+    switch(specifier)
+    {
+      case 'Y': field = &year; break;
+      case 'm': field = &month; break;
+      case 'd': field = &day; break;
+      case 'H': field = &hour; break;
+      case 'M': field = &minute; break;
+      case 'S': field = &second; break;
+      default:
+        return false;
+    }
+
+    int maxDigits = specifier == 'Y' ? 4 : 2;
+    int digits = 0;
+    int value = 0;
+    while(pos < end && digits < maxDigits && std::isdigit(static_cast<unsigned char>(*pos)))
+    {
+      value = value*10 + (*pos - '0');
+      ++pos;
+      ++digits;
+    }
+
+    if(digits == 0)
+      return false;
+
+    *field = value;
+
+    if(specifier == 'S' && pos < end && *pos == '.')
+    {
+      // fractional seconds
+      ++pos;
+      long scale = 100000;
+      while(pos < end && std::isdigit(static_cast<unsigned char>(*pos)))
+      {
+        microseconds += (*pos - '0') * scale;
+        scale /= 10;
+        ++pos;
+      }
+    }
+  }
+
+  if(pos != end)
+    return false;
+
+  try
+  {
+    result = boost::posix_time::ptime(boost::gregorian::date(year, month, day),
+                                      boost::posix_time::hours(hour)
+                                      + boost::posix_time::minutes(minute)
+                                      + boost::posix_time::seconds(second)
+                                      + boost::posix_time::microseconds(microseconds));
+  }
+  catch(const std::exception&)
+  {
+    // invalid date
+    return false;
+  }
+
+  return true;
+}
+
+boost::local_time::time_zone_ptr terrama2::core::CsvParser::timezone(const std::string& timezone)
+{
+  static std::mutex mutex;
+  static std::unordered_map<std::string, boost::local_time::time_zone_ptr> zones;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = zones.find(timezone);
+  if(it != zones.end())
+    return it->second;
+
+  boost::local_time::time_zone_ptr zone(new boost::local_time::posix_time_zone(timezone));
+  zones.emplace(timezone, zone);
+  return zone;
+}
@@ -0,0 +1,175 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/core/utility/CsvParser.hpp
+
+  \brief Parser of delimited text files into typed TerraLib datasets.
+
+  \author Jano Simas
+*/
+
+#ifndef __TERRAMA2_CORE_UTILITY_CSV_PARSER_HPP__
+#define __TERRAMA2_CORE_UTILITY_CSV_PARSER_HPP__
+
+//TerraMA2
+#include "../Typedef.hpp"
+#include "FileCatalog.hpp"
+
+//TerraLib
+#include <terralib/dataaccess/dataset/DataSetType.h>
+#include <terralib/memory/DataSet.h>
+#include <terralib/memory/DataSetItem.h>
+
+//Qt
+#include <QtGlobal>
+
+//Boost
+#include <boost/date_time/local_time/local_time.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+//STL
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace terrama2
+{
+  namespace core
+  {
+    /*!
+      \brief Parser of delimited text files, such as CSV and TOA5, into a typed dataset.
+
+      The file is memory-mapped and the values are converted directly to the column type,
+      large files are split in chunks of lines parsed in parallel.
+
+      \note Quoted values can't contain line breaks.
+    */
+    class CsvParser
+    {
+      public:
+        //! Type of a column of the resulting dataset.
+        enum class ColumnType
+        {
+          IGNORE, //!< The column is not part of the dataset.
+          STRING, //!< Text column.
+          INT32, //!< Integer column.
+          DOUBLE, //!< Floating point column.
+          TIMESTAMP, //!< Date and time column, parsed with the timestamp format and timezone.
+          LONGITUDE, //!< Longitude (X) of the point geometry.
+          LATITUDE //!< Latitude (Y) of the point geometry.
+        };
+
+        //! Output column for a column of the file.
+        struct Column
+        {
+          std::string name; //!< Name of the property in the resulting dataset.
+          ColumnType type = ColumnType::IGNORE; //!< Type of the property.
+        };
+
+        //! Layout of the file and conversion of its columns.
+        struct Format
+        {
+          char delimiter = ','; //!< Values delimiter.
+          std::size_t headerLine = 0; //!< Zero-based index of the line with the column names.
+          std::size_t ignoredLines = 0; //!< Number of lines ignored after the header line.
+          std::string timestampFormat = "%Y-%m-%d %H:%M:%S"; //!< Format of the timestamp, accepts %Y, %m, %d, %H, %M and %S.
+          std::string timezone = "UTC+00"; //!< Timezone of the timestamps.
+          bool completeLinesOnly = false; //!< If true, a last line without line break is not parsed, the file may be still growing.
+          std::string geometryName; //!< Name of the point property built from the LONGITUDE and LATITUDE columns.
+          Srid srid = 0; //!< SRID of the point property.
+          std::function<Column(const std::string& header)> column; //!< Returns the output column of a file column.
+        };
+
+        //! Position of the data read from a file.
+        struct Position
+        {
+          qint64 offset = 0; //!< Bytes of the file already read.
+          boost::posix_time::ptime lastTimestamp; //!< Latest timestamp read, in UTC.
+        };
+
+        //! Result of the parsing.
+        struct Result
+        {
+          std::shared_ptr<te::da::DataSetType> dataSetType; //!< Properties of the dataset.
+          std::shared_ptr<te::mem::DataSet> dataSet; //!< Parsed values.
+          Position end; //!< Position after the parsed lines.
+        };
+
+        explicit CsvParser(const Format& format);
+
+        /*!
+          \brief Parses the file.
+
+          Values that can't be converted to the column type are null.
+
+          The header is always read, the data lines are read from the start position,
+          so only the lines appended to a file already read are parsed.
+          Lines with a timestamp not after the last timestamp of the start position are ignored.
+
+          \param path Path of the file.
+          \param start Position of the data already read, by default the whole file is read.
+
+          \exception DataAccessorException Raised if the file can't be read or has no header.
+        */
+        Result parse(const std::string& path, const Position& start = Position()) const;
+
+        /*!
+          \brief Parses a timestamp with the given format.
+
+          Fractional seconds after %S are accepted.
+
+          \return False if the text doesn't match the format.
+        */
+        static bool parseTimestamp(const char* begin, const char* end, const std::string& format, boost::posix_time::ptime& result);
+
+        //! Converts the read position stored in the file catalog.
+        static Position toPosition(const FileCatalog::ReadPosition& readPosition);
+
+        //! Converts the position to be stored in the file catalog.
+        static FileCatalog::ReadPosition toReadPosition(const Position& position);
+
+        //! Returns the timezone for the posix timezone string, the timezones are created only once.
+        static boost::local_time::time_zone_ptr timezone(const std::string& timezone);
+
+      private:
+        //! Splits a line in its values, quotes are removed.
+        void split(const char* begin, const char* end, std::vector<std::string>& values) const;
+
+        /*!
+          \brief Parses the lines in the interval and creates the dataset items.
+
+          Lines with a timestamp not after \e lastTimestamp are ignored,
+          \e lastTimestamp is updated to the latest timestamp of the lines.
+        */
+        std::vector<std::unique_ptr<te::mem::DataSetItem> > parseLines(const char* begin, const char* end,
+                                                                      const te::mem::DataSet* parent,
+                                                                      const std::vector<Column>& columns,
+                                                                      const std::vector<std::size_t>& positions,
+                                                                      boost::posix_time::ptime& lastTimestamp) const;
+
+        Format format_;
+    };
+  }
+}
+
+#endif // __TERRAMA2_CORE_UTILITY_CSV_PARSER_HPP__
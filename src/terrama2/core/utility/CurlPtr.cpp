@@ -123,6 +123,21 @@ std::vector<std::string> terrama2::core::CurlPtr::getListFiles(std::string url,
   return vectorFiles;
 }
 
+int64_t terrama2::core::CurlPtr::getFileSize(std::string url)
+{
+  curl_easy_setopt(curl_, CURLOPT_URL, url.c_str());
+  curl_easy_setopt(curl_, CURLOPT_NOBODY, 1);
+
+  double size = -1;
+  if(curl_easy_perform(curl_) != CURLE_OK || curl_easy_getinfo(curl_, CURLINFO_CONTENT_LENGTH_DOWNLOAD, &size) != CURLE_OK)
+    size = -1;
+
+  // the body is downloaded in the next requests
+  curl_easy_setopt(curl_, CURLOPT_NOBODY, 0);
+
+  return size < 0 ? -1 : static_cast<int64_t>(size);
+}
+
 CURLcode terrama2::core::CurlPtr::getDownloadFiles(std::string url,
                                                    size_t(*write_response)(void *ptr, size_t size, size_t nmemb, void *data),
                                                    std::string filePath)
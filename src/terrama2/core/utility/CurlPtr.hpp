@@ -28,6 +28,7 @@
 // STL
 #include <memory>
 #include <cassert>
+#include <cstdint>
 #include <iostream>
 #include <functional>
 #include <vector>
@@ -74,6 +75,9 @@ namespace terrama2
                                                       size_t(*write_vector)(void *ptr, size_t size, size_t nmemb, void *data),
                                                       std::string block);
 
+        //! The function getFileSize returns the size, in bytes, of the file in the server, or -1 if the server doesn't report it.
+        virtual int64_t getFileSize(std::string url);
+
         //! The function getDownloadFiles performs download the filtered files and returns it succeded or not.
         virtual CURLcode getDownloadFiles(std::string url,
                                           size_t(*write_response)(void *ptr, size_t size, size_t nmemb, void *data),
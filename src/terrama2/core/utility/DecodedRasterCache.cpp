@@ -0,0 +1,254 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/core/utility/DecodedRasterCache.cpp
+
+  \brief Local disk cache of decoded raster blocks.
+
+  \author Jano Simas
+*/
+
+#include "DecodedRasterCache.hpp"
+#include "Logger.hpp"
+#include "Unpack.hpp"
+
+//Qt
+#include <QCryptographicHash>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QObject>
+#include <QSaveFile>
+
+//STL
+#include <algorithm>
+#include <tuple>
+#include <utility>
+
+namespace
+{
+  //! The modification time is the last time the folder was used.
+  const QString USED_MARKER = ".used";
+
+  //! Size, in bytes, of the files of the folder.
+  qint64 folderSize(const QString& folder)
+  {
+    qint64 size = 0;
+    QDirIterator it(folder, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while(it.hasNext())
+    {
+      it.next();
+      size += it.fileInfo().size();
+    }
+
+    return size;
+  }
+}
+
+std::string terrama2::core::DecodedRasterCache::sourceIdentity(const std::string& path, const std::string& layout)
+{
+  QByteArray contentHash = Unpack::contentHash(QFileInfo(QString::fromStdString(path)));
+  if(contentHash.isEmpty())
+    return {};
+
+  if(layout.empty())
+    return contentHash.toHex().toStdString();
+
+  QCryptographicHash hash(QCryptographicHash::Md5);
+  hash.addData(contentHash);
+  hash.addData(layout.c_str(), static_cast<int>(layout.size()));
+  return hash.result().toHex().toStdString();
+}
+
+terrama2::core::RasterBlock terrama2::core::DecodedRasterCache::get(const RasterBlockKey& key, int dataType, const std::function<RasterBlock()>& load)
+{
+  if(key.fileIdentity.empty())
+    return load();
+
+  QString sourceFolder;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sourceFolder = folder_ + "/" + QString::fromStdString(key.fileIdentity);
+  }
+  // the data type is part of the name, so blocks are never read with another pixel type
+  const QString blockPath = sourceFolder + "/" + QString::number(key.band) + "_" + QString::number(key.block)
+                            + "_" + QString::number(RasterBlock::storageType(dataType)) + ".blk";
+
+  RasterBlock block(dataType);
+  if(readBlock(blockPath, block))
+  {
+    touch(sourceFolder);
+    return block;
+  }
+
+  block = load();
+
+  bool newSource = !QFileInfo(sourceFolder).isDir();
+  if(block.dataType() != RasterBlock::storageType(dataType) || !QDir().mkpath(sourceFolder) || !writeBlock(blockPath, block))
+  {
+    // the cache is an optimization, the decoded values are still valid
+    TERRAMA2_LOG_WARNING() << QObject::tr("Could not store decoded raster block: %1.").arg(blockPath);
+    return block;
+  }
+
+  touch(sourceFolder);
+  if(newSource)
+    prune();
+
+  return block;
+}
+
+bool terrama2::core::DecodedRasterCache::readBlock(const QString& path, RasterBlock& block)
+{
+  QFile file(path);
+  if(!file.open(QIODevice::ReadOnly))
+    return false;
+
+  const qint64 size = file.size();
+  const qint64 pixelSize = static_cast<qint64>(block.pixelSize());
+  if(size <= 0 || pixelSize == 0 || size % pixelSize != 0)
+    return false;
+
+  // the pixels are read directly in the block, a file mapping would still be copied
+  RasterBlock stored(block.dataType(), static_cast<std::size_t>(size / pixelSize));
+  if(file.read(reinterpret_cast<char*>(stored.data()), size) != size)
+    return false;
+
+  block = std::move(stored);
+  return true;
+}
+
+bool terrama2::core::DecodedRasterCache::writeBlock(const QString& path, const RasterBlock& block)
+{
+  if(block.byteSize() == 0)
+    return false;
+
+  // the file is only visible after it's complete,
+  // other processes sharing the cache never read a partial block
+  QSaveFile file(path);
+  if(!file.open(QIODevice::WriteOnly))
+    return false;
+
+  const qint64 size = static_cast<qint64>(block.byteSize());
+  if(file.write(reinterpret_cast<const char*>(block.data()), size) != size)
+  {
+    file.cancelWriting();
+    return false;
+  }
+
+  return file.commit();
+}
+
+void terrama2::core::DecodedRasterCache::touch(const QString& sourceFolder)
+{
+  QDateTime now = QDateTime::currentDateTimeUtc();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = lastTouch_.find(sourceFolder);
+    if(it != lastTouch_.end() && it->second.secsTo(now) < 60)
+      return;
+
+    lastTouch_[sourceFolder] = now;
+  }
+
+  QFile file(sourceFolder + "/" + USED_MARKER);
+  if(file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    file.write(now.toString(Qt::ISODate).toUtf8());
+}
+
+void terrama2::core::DecodedRasterCache::setFolder(const std::string& folder)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  folder_ = QString::fromStdString(folder);
+  lastTouch_.clear();
+}
+
+void terrama2::core::DecodedRasterCache::setMaxSize(qint64 maxSize)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  maxSize_ = maxSize;
+  pruneLocked();
+}
+
+void terrama2::core::DecodedRasterCache::setMaxAge(qint64 maxAge)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  maxAge_ = maxAge;
+  pruneLocked();
+}
+
+void terrama2::core::DecodedRasterCache::prune()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  pruneLocked();
+}
+
+void terrama2::core::DecodedRasterCache::pruneLocked()
+{
+  QDir dir(folder_);
+  if(!dir.exists())
+    return;
+
+  const QDateTime now = QDateTime::currentDateTimeUtc();
+  std::vector<std::tuple<QDateTime, QString, qint64> > folders;
+  qint64 totalSize = 0;
+  for(const auto& entry : dir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot))
+  {
+    const QString path = entry.absoluteFilePath();
+    QFileInfo marker(path + "/" + USED_MARKER);
+    QDateTime lastUse = marker.exists() ? marker.lastModified().toUTC() : entry.lastModified().toUTC();
+    if(lastUse.secsTo(now) > maxAge_)
+    {
+      if(QDir(path).removeRecursively())
+        lastTouch_.erase(path);
+      continue;
+    }
+
+    qint64 size = folderSize(path);
+    totalSize += size;
+    folders.emplace_back(lastUse, path, size);
+  }
+
+  if(totalSize <= maxSize_)
+    return;
+
+  // least recently used first
+  std::sort(folders.begin(), folders.end());
+  for(const auto& folder : folders)
+  {
+    if(totalSize <= maxSize_)
+      break;
+
+    if(QDir(std::get<1>(folder)).removeRecursively())
+    {
+      totalSize -= std::get<2>(folder);
+      lastTouch_.erase(std::get<1>(folder));
+    }
+  }
+}
+
+void terrama2::core::DecodedRasterCache::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  QDir(folder_).removeRecursively();
+  lastTouch_.clear();
+}
@@ -0,0 +1,131 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/core/utility/DecodedRasterCache.hpp
+
+  \brief Local disk cache of decoded raster blocks.
+
+  \author Jano Simas
+*/
+
+#ifndef __TERRAMA2_CORE_UTILITY_DECODED_RASTER_CACHE_HPP__
+#define __TERRAMA2_CORE_UTILITY_DECODED_RASTER_CACHE_HPP__
+
+#include "RasterBlockCache.hpp"
+
+// TerraLib
+#include <terralib/common/Singleton.h>
+
+// QT
+#include <QDateTime>
+#include <QDir>
+#include <QString>
+
+//STL
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace terrama2
+{
+  namespace core
+  {
+    /*!
+      \brief Local disk cache of decoded raster blocks.
+
+      Compressed or encoded rasters are decoded once and their blocks are stored uncompressed,
+      each block in a file of the folder of its source, identified by the content hash of the source file.
+      A stored block is read back with a single read into a new block, so a history window sliding over
+      the same files doesn't decode them again, even after a restart of the service.
+      The pixels are copied from the file, the blocks are owned by the RasterBlockCache
+      that accounts for their memory and may outlive the file.
+
+      Folders not used for longer than the maximum age are removed,
+      the least recently used folders are removed when the cache exceeds its maximum size.
+
+      The cache is enabled by the data series with the "decoded_cache" tag,
+      the blocks are always shared with the RasterBlockCache that stays in front of it.
+    */
+    class DecodedRasterCache : public te::common::Singleton<DecodedRasterCache>
+    {
+      public:
+        /*!
+          \brief Returns the identity of the decoded content of a file.
+
+          The identity is the hash of the file content and of the \e layout,
+          the layout identifies how the content is decoded when the same file may be decoded in different ways.
+
+          \return An empty string if the file can't be read.
+        */
+        static std::string sourceIdentity(const std::string& path, const std::string& layout = std::string());
+
+        /*!
+          \brief Returns the stored block for the key, decoding and storing it if needed.
+
+          \param key Key of the block, the file identity must be a source identity.
+          \param dataType Data type of the band, blocks are stored in the storage type of the band.
+          \param load Decodes the block.
+
+          \exception Any exception thrown by load, failed loads are not stored.
+        */
+        RasterBlock get(const RasterBlockKey& key, int dataType, const std::function<RasterBlock()>& load);
+
+        //! Sets the folder of the cache, by default terrama2-decoded in the system temporary folder.
+        void setFolder(const std::string& folder);
+
+        //! Sets the maximum size, in bytes, of the cache.
+        void setMaxSize(qint64 maxSize);
+
+        //! Sets the maximum time, in seconds, a source folder is kept without being used.
+        void setMaxAge(qint64 maxAge);
+
+        //! Removes the folders older than the maximum age and the least recently used folders above the maximum size.
+        void prune();
+
+        //! Removes all stored blocks.
+        void clear();
+
+      private:
+        //! Reads the pixels of a block file, returns false if the file doesn't exist or is invalid.
+        static bool readBlock(const QString& path, RasterBlock& block);
+
+        //! Writes the pixels of a block, the file is written in a temporary file and renamed.
+        static bool writeBlock(const QString& path, const RasterBlock& block);
+
+        //! Updates the last use of the source folder, at most once a minute.
+        void touch(const QString& sourceFolder);
+
+        //! Removes the folders not respecting the limits, the lock must be held.
+        void pruneLocked();
+
+        QString folder_ = QDir::temp().absoluteFilePath("terrama2-decoded");
+        qint64 maxSize_ = 4LL*1024*1024*1024;
+        qint64 maxAge_ = 7*24*60*60;
+        std::map<QString, QDateTime> lastTouch_; //!< Last time each source folder was marked as used.
+        mutable std::mutex mutex_; //!< A mutex to synchronize the settings and the pruning.
+    };
+  } // end namespace core
+}   // end namespace terrama2
+
+#endif // __TERRAMA2_CORE_UTILITY_DECODED_RASTER_CACHE_HPP__
@@ -0,0 +1,291 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/core/utility/FileCatalog.cpp
+
+  \brief Catalog of the files already processed of a data series.
+
+  \author Jano Simas
+*/
+
+#include "FileCatalog.hpp"
+#include "Logger.hpp"
+#include "ServiceManager.hpp"
+#include "../Exception.hpp"
+
+//Qt
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QObject>
+#include <QSaveFile>
+
+//STL
+#include <algorithm>
+
+namespace
+{
+  //! Identifies a catalog file.
+  const quint32 CATALOG_MAGIC = 0x54324643;
+  //! Version of the catalog format.
+  const quint32 CATALOG_VERSION = 2;
+  //! Size of the blocks used to identify a growing file.
+  const qint64 BOUNDARY_BLOCK_SIZE = 4096;
+}
+
+terrama2::core::FileCatalog::FileCatalog(const std::string& path)
+  : path_(path)
+{
+  load();
+}
+
+std::string terrama2::core::FileCatalog::defaultPath(ProcessId processId)
+{
+  QDir dir(QString::fromStdString(ServiceManager::getInstance().dataFolder()));
+  return dir.absoluteFilePath(QString("file-catalog/%1.catalog").arg(processId)).toStdString();
+}
+
+void terrama2::core::FileCatalog::load()
+{
+  QFile file(QString::fromStdString(path_));
+  // no catalog, all files are new
+  if(!file.open(QIODevice::ReadOnly))
+    return;
+
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_5_0);
+
+  quint32 magic = 0;
+  quint32 version = 0;
+  quint32 numberOfEntries = 0;
+  stream >> magic >> version >> numberOfEntries;
+  if(magic != CATALOG_MAGIC || version < 1 || version > CATALOG_VERSION)
+  {
+    TERRAMA2_LOG_WARNING() << QObject::tr("Invalid file catalog %1, it will be rebuilt.").arg(QString::fromStdString(path_));
+    return;
+  }
+
+  std::unordered_map<std::string, Entry> entries;
+  for(quint32 i = 0; i < numberOfEntries; ++i)
+  {
+    QString key;
+    Entry entry;
+    stream >> key >> entry.size >> entry.lastModified >> entry.hash >> entry.timestamp;
+    // version 1 has no read position, the files are read completely
+    if(version > 1)
+      stream >> entry.offset >> entry.lastTimestamp >> entry.boundaryHash;
+    entries.emplace(key.toStdString(), entry);
+  }
+
+  if(stream.status() != QDataStream::Ok)
+  {
+    TERRAMA2_LOG_WARNING() << QObject::tr("Invalid file catalog %1, it will be rebuilt.").arg(QString::fromStdString(path_));
+    return;
+  }
+
+  entries_ = std::move(entries);
+}
+
+void terrama2::core::FileCatalog::save() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  QFileInfo info(QString::fromStdString(path_));
+  QDir().mkpath(info.absolutePath());
+
+  QSaveFile file(info.absoluteFilePath());
+  if(!file.open(QIODevice::WriteOnly))
+  {
+    QString errMsg = QObject::tr("Could not write file catalog %1.").arg(info.absoluteFilePath());
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw DataAccessorException() << ErrorDescription(errMsg);
+  }
+
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_5_0);
+  stream << CATALOG_MAGIC << CATALOG_VERSION << static_cast<quint32>(entries_.size());
+  for(const auto& entry : entries_)
+  {
+    stream << QString::fromStdString(entry.first) << entry.second.size << entry.second.lastModified
+           << entry.second.hash << entry.second.timestamp
+           << entry.second.offset << entry.second.lastTimestamp << entry.second.boundaryHash;
+  }
+
+  if(stream.status() != QDataStream::Ok || !file.commit())
+  {
+    QString errMsg = QObject::tr("Could not write file catalog %1.").arg(info.absoluteFilePath());
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw DataAccessorException() << ErrorDescription(errMsg);
+  }
+}
+
+bool terrama2::core::FileCatalog::isProcessed(const std::string& key, const QFileInfo& fileInfo) const
+{
+  Entry entry;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if(it == entries_.end())
+      return false;
+
+    entry = it->second;
+  }
+
+  // the tail of a growing file that wasn't read must be read
+  if(entry.offset > 0 && entry.offset < fileInfo.size())
+    return false;
+
+  if(entry.size == fileInfo.size() && entry.lastModified == fileInfo.lastModified().toMSecsSinceEpoch())
+    return true;
+
+  // the file was touched or rewritten, compare the content
+  if(entry.size != fileInfo.size())
+    return false;
+
+  QByteArray fileHash = hash(fileInfo);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  hashCache_[key] = fileHash;
+  return !fileHash.isEmpty() && fileHash == entry.hash;
+}
+
+void terrama2::core::FileCatalog::setProcessed(const std::string& key, const QFileInfo& fileInfo, const std::string& timestamp)
+{
+  Entry entry;
+  entry.size = fileInfo.size();
+  entry.lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+  entry.timestamp = QString::fromStdString(timestamp);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = hashCache_.find(key);
+    if(it != hashCache_.end())
+    {
+      entry.hash = it->second;
+      hashCache_.erase(it);
+    }
+  }
+
+  if(entry.hash.isEmpty())
+    entry.hash = hash(fileInfo);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_[key] = entry;
+}
+
+void terrama2::core::FileCatalog::setProcessed(const std::string& key, const QFileInfo& fileInfo, const std::string& timestamp, const ReadPosition& position)
+{
+  if(position.offset <= 0)
+  {
+    setProcessed(key, fileInfo, timestamp);
+    return;
+  }
+
+  Entry entry;
+  entry.size = fileInfo.size();
+  entry.lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+  entry.timestamp = QString::fromStdString(timestamp);
+  entry.offset = position.offset;
+  entry.lastTimestamp = QString::fromStdString(position.lastTimestamp);
+  entry.boundaryHash = boundaryHash(fileInfo, position.offset);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  hashCache_.erase(key);
+  entries_[key] = entry;
+}
+
+terrama2::core::FileCatalog::ReadPosition terrama2::core::FileCatalog::readPosition(const std::string& key, const QFileInfo& fileInfo) const
+{
+  Entry entry;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if(it == entries_.end())
+      return ReadPosition();
+
+    entry = it->second;
+  }
+
+  // truncated file
+  if(entry.offset <= 0 || fileInfo.size() < entry.offset)
+    return ReadPosition();
+
+  // rewritten file
+  QByteArray fileHash = boundaryHash(fileInfo, entry.offset);
+  if(fileHash.isEmpty() || fileHash != entry.boundaryHash)
+  {
+    TERRAMA2_LOG_INFO() << QObject::tr("File %1 was rewritten, it will be read again.").arg(fileInfo.absoluteFilePath());
+    return ReadPosition();
+  }
+
+  ReadPosition position;
+  position.offset = entry.offset;
+  position.lastTimestamp = entry.lastTimestamp.toStdString();
+  // the file didn't change since the last read, an unterminated last line won't be completed
+  position.finished = entry.offset < entry.size && entry.size == fileInfo.size()
+                      && entry.lastModified == fileInfo.lastModified().toMSecsSinceEpoch();
+  return position;
+}
+
+std::size_t terrama2::core::FileCatalog::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+QByteArray terrama2::core::FileCatalog::hash(const QFileInfo& fileInfo)
+{
+  QFile file(fileInfo.absoluteFilePath());
+  if(!file.open(QIODevice::ReadOnly))
+    return QByteArray();
+
+  QCryptographicHash hash(QCryptographicHash::Md5);
+  if(!hash.addData(&file))
+    return QByteArray();
+
+  return hash.result();
+}
+
+QByteArray terrama2::core::FileCatalog::boundaryHash(const QFileInfo& fileInfo, qint64 offset)
+{
+  QFile file(fileInfo.absoluteFilePath());
+  if(!file.open(QIODevice::ReadOnly))
+    return QByteArray();
+
+  QByteArray first = file.read(std::min(offset, BOUNDARY_BLOCK_SIZE));
+
+  qint64 lastBlockBegin = std::max<qint64>(0, offset - BOUNDARY_BLOCK_SIZE);
+  if(!file.seek(lastBlockBegin))
+    return QByteArray();
+
+  QByteArray last = file.read(offset - lastBlockBegin);
+  if(first.size() + last.size() != std::min(offset, BOUNDARY_BLOCK_SIZE) + offset - lastBlockBegin)
+    return QByteArray();
+
+  QCryptographicHash hash(QCryptographicHash::Md5);
+  hash.addData(first);
+  hash.addData(last);
+  return hash.result();
+}
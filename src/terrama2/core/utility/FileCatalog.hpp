@@ -0,0 +1,180 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/core/utility/FileCatalog.hpp
+
+  \brief Catalog of the files already processed of a data series.
+
+  \author Jano Simas
+*/
+
+#ifndef __TERRAMA2_CORE_UTILITY_FILE_CATALOG_HPP__
+#define __TERRAMA2_CORE_UTILITY_FILE_CATALOG_HPP__
+
+//TerraMA2
+#include "../Typedef.hpp"
+
+//Qt
+#include <QByteArray>
+#include <QString>
+
+//STL
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Forward declaration
+class QFileInfo;
+
+namespace terrama2
+{
+  namespace core
+  {
+    /*!
+      \brief Persistent catalog of the files processed of a data series.
+
+      For each file the size, last modification time, content hash and timestamp extracted from the name are stored.
+      A file is considered processed if its size and modification time didn't change,
+      or if they changed but the content hash is the same.
+
+      Files that grow by appended lines also store the position of the data already read,
+      so only the appended data is read, see readPosition().
+
+      The catalog is stored in a compact binary file, if the file is missing or invalid
+      the catalog starts empty and is rebuilt with the files processed.
+
+      Changes are only persisted when save() is called,
+      so files of a failed process are processed again.
+
+      \note Thread-safe.
+    */
+    class FileCatalog
+    {
+      public:
+        //! Information of a processed file.
+        struct Entry
+        {
+          qint64 size = 0; //!< Size of the file, in bytes.
+          qint64 lastModified = 0; //!< Last modification time, in milliseconds since epoch.
+          QByteArray hash; //!< MD5 hash of the file content.
+          QString timestamp; //!< Timestamp extracted from the file name.
+          qint64 offset = 0; //!< Bytes of the file already read, zero if the file is always read completely.
+          QString lastTimestamp; //!< Latest timestamp read from the file, in ISO format.
+          QByteArray boundaryHash; //!< MD5 hash of the first and last blocks of the data already read.
+        };
+
+        //! Position of the data read from a growing file.
+        struct ReadPosition
+        {
+          qint64 offset = 0; //!< Bytes of the file already read.
+          std::string lastTimestamp; //!< Latest timestamp read, in ISO format.
+          bool finished = false; //!< If true, the file didn't change since it was read and its unread tail must be read completely.
+        };
+
+        /*!
+          \brief Loads the catalog stored in the file.
+
+          \param path Path of the catalog file.
+        */
+        explicit FileCatalog(const std::string& path);
+
+        /*!
+          \brief Path of the catalog file of the process in the catalog folder of the service data folder.
+
+          Each process has its own catalog, processes reading the same data series don't skip each other's files.
+
+          \sa ServiceManager::dataFolder()
+        */
+        static std::string defaultPath(ProcessId processId);
+
+        /*!
+          \brief Checks if the file was processed and didn't change.
+
+          A growing file with an unread tail, like a last line without line break, is not processed.
+
+          \param key Identifier of the file in the catalog, must not depend on temporary folders.
+          \param fileInfo File to check.
+        */
+        bool isProcessed(const std::string& key, const QFileInfo& fileInfo) const;
+
+        /*!
+          \brief Registers the file as processed.
+
+          \param key Identifier of the file in the catalog, must not depend on temporary folders.
+          \param fileInfo Processed file.
+          \param timestamp Timestamp extracted from the file name, if any.
+        */
+        void setProcessed(const std::string& key, const QFileInfo& fileInfo, const std::string& timestamp = "");
+
+        /*!
+          \brief Registers the file as processed up to the read position.
+
+          The content hash of the whole file is not computed,
+          the file is identified by the blocks around the read position.
+        */
+        void setProcessed(const std::string& key, const QFileInfo& fileInfo, const std::string& timestamp, const ReadPosition& position);
+
+        /*!
+          \brief Returns the position of the data already read of a growing file.
+
+          If the file was truncated or rewritten since it was read,
+          the default position is returned and the file must be read again from the beginning.
+
+          If the file didn't change since it was read but has an unread tail,
+          the writer is considered finished and the position is marked as finished.
+
+          \param key Identifier of the file in the catalog, must not depend on temporary folders.
+          \param fileInfo File to check.
+        */
+        ReadPosition readPosition(const std::string& key, const QFileInfo& fileInfo) const;
+
+        //! Number of files in the catalog.
+        std::size_t size() const;
+
+        /*!
+          \brief Stores the catalog in the file.
+
+          The file is replaced atomically.
+
+          \exception DataAccessorException Raised if the catalog can't be stored.
+        */
+        void save() const;
+
+      private:
+        //! Reads the catalog file, invalid files are ignored.
+        void load();
+
+        //! MD5 hash of the file content, empty if the file can't be read.
+        static QByteArray hash(const QFileInfo& fileInfo);
+
+        //! MD5 hash of the first and last blocks before the offset, empty if the file can't be read.
+        static QByteArray boundaryHash(const QFileInfo& fileInfo, qint64 offset);
+
+        std::string path_;
+        std::unordered_map<std::string, Entry> entries_;
+        mutable std::unordered_map<std::string, QByteArray> hashCache_; //!< Hashes computed in isProcessed, reused in setProcessed.
+        mutable std::mutex mutex_;
+    };
+  }
+}
+
+#endif // __TERRAMA2_CORE_UTILITY_FILE_CATALOG_HPP__
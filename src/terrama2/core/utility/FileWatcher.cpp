@@ -0,0 +1,209 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/core/utility/FileWatcher.cpp
+
+  \brief Watcher of local folders that triggers processes when new files arrive.
+
+  \author Jano Simas
+*/
+
+#include "FileWatcher.hpp"
+#include "Logger.hpp"
+#include "MaskMatcher.hpp"
+
+//Qt
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+
+// STL
+#include <set>
+
+terrama2::core::FileWatcher::FileWatcher(ProcessId processId, const std::vector<Folder>& folders, int debounceInterval, int rescanInterval)
+  : processId_(processId),
+    folders_(folders)
+{
+  // the signal can be queued to other threads
+  qRegisterMetaType<ProcessId>("ProcessId");
+
+  debounceTimer_.setSingleShot(true);
+  debounceTimer_.setInterval(debounceInterval);
+  rescanTimer_.setInterval(rescanInterval);
+
+  connect(&watcher_, &QFileSystemWatcher::directoryChanged, this, &FileWatcher::directoryChangedSlot);
+  connect(&debounceTimer_, &QTimer::timeout, this, &FileWatcher::debounceSlot);
+  connect(&rescanTimer_, &QTimer::timeout, this, &FileWatcher::rescanSlot);
+
+  for(const auto& folder : folders_)
+  {
+    QString path = QString::fromStdString(folder.path);
+    if(!QDir(path).exists() || !watcher_.addPath(path))
+    {
+      TERRAMA2_LOG_WARNING() << QObject::tr("Unable to watch folder %1.").arg(path);
+      continue;
+    }
+
+    scanFolder(folder, true);
+  }
+
+  rescanTimer_.start();
+}
+
+terrama2::core::FileWatcher::FileState terrama2::core::FileWatcher::fileState(const QString& path)
+{
+  FileState state;
+  QFileInfo fileInfo(path);
+  if(fileInfo.exists())
+  {
+    state.size = fileInfo.size();
+    state.lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+  }
+
+  return state;
+}
+
+void terrama2::core::FileWatcher::scanFolder(const Folder& folder, bool initial)
+{
+  auto matcher = MaskMatcher::get(folder.mask, folder.timezone);
+
+  QDir dir(QString::fromStdString(folder.path));
+  QFileInfoList fileInfoList = dir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot | QDir::Readable | QDir::CaseSensitive);
+  std::set<QString> existingFiles;
+  for(const auto& fileInfo : fileInfoList)
+  {
+    std::shared_ptr<te::dt::TimeInstantTZ> timestamp;
+    if(!matcher->match(fileInfo.fileName().toStdString(), timestamp))
+      continue;
+
+    QString path = fileInfo.absoluteFilePath();
+    existingFiles.insert(path);
+    FileState state = fileState(path);
+
+    if(initial)
+    {
+      knownFiles_[path] = state;
+      continue;
+    }
+
+    auto it = knownFiles_.find(path);
+    if(it == knownFiles_.end() || it->second != state)
+    {
+      if(pendingFiles_.find(path) == pendingFiles_.end())
+        pendingFiles_[path] = state;
+    }
+  }
+
+  // removed files
+  QString folderPrefix = dir.absolutePath() + "/";
+  for(auto it = knownFiles_.begin(); it != knownFiles_.end();)
+  {
+    if(it->first.startsWith(folderPrefix) && existingFiles.find(it->first) == existingFiles.end())
+      it = knownFiles_.erase(it);
+    else
+      ++it;
+  }
+}
+
+void terrama2::core::FileWatcher::directoryChangedSlot(const QString& path) noexcept
+{
+  try
+  {
+    for(const auto& folder : folders_)
+    {
+      if(QDir(QString::fromStdString(folder.path)) == QDir(path))
+        scanFolder(folder, false);
+    }
+
+    if(!pendingFiles_.empty())
+      debounceTimer_.start();
+  }
+  catch(...)
+  {
+    // exception guard, slots should never emit exceptions.
+    TERRAMA2_LOG_ERROR() << QObject::tr("Unknown exception...");
+  }
+}
+
+void terrama2::core::FileWatcher::rescanSlot() noexcept
+{
+  try
+  {
+    for(const auto& folder : folders_)
+      scanFolder(folder, false);
+
+    if(!pendingFiles_.empty() && !debounceTimer_.isActive())
+      debounceTimer_.start();
+  }
+  catch(...)
+  {
+    // exception guard, slots should never emit exceptions.
+    TERRAMA2_LOG_ERROR() << QObject::tr("Unknown exception...");
+  }
+}
+
+void terrama2::core::FileWatcher::debounceSlot() noexcept
+{
+  try
+  {
+    bool ready = false;
+    bool writing = false;
+    auto it = pendingFiles_.begin();
+    while(it != pendingFiles_.end())
+    {
+      FileState state = fileState(it->first);
+      if(state.size < 0)
+      {
+        // removed before completion
+        it = pendingFiles_.erase(it);
+        continue;
+      }
+
+      if(state != it->second)
+      {
+        // still being written, check again after the interval
+        it->second = state;
+        writing = true;
+        ++it;
+        continue;
+      }
+
+      knownFiles_[it->first] = state;
+      it = pendingFiles_.erase(it);
+      ready = true;
+    }
+
+    if(writing)
+      debounceTimer_.start();
+
+    if(ready)
+    {
+      TERRAMA2_LOG_DEBUG() << QObject::tr("New data for process %1.").arg(processId_);
+      emit fileReadySignal(processId_);
+    }
+  }
+  catch(...)
+  {
+    // exception guard, slots should never emit exceptions.
+    TERRAMA2_LOG_ERROR() << QObject::tr("Unknown exception...");
+  }
+}
@@ -0,0 +1,130 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/core/utility/FileWatcher.hpp
+
+  \brief Watcher of local folders that triggers processes when new files arrive.
+
+  \author Jano Simas
+*/
+
+#ifndef __TERRAMA2_CORE_FILE_WATCHER_HPP__
+#define __TERRAMA2_CORE_FILE_WATCHER_HPP__
+
+// TerraMA2
+#include "../Typedef.hpp"
+
+//Qt
+#include <QFileSystemWatcher>
+#include <QObject>
+#include <QTimer>
+
+// STL
+#include <map>
+#include <string>
+#include <vector>
+
+namespace terrama2
+{
+  namespace core
+  {
+    /*!
+      \brief Watches local folders and emits a signal when a file that matches the mask is complete.
+
+      The folders are watched with the operating system file notifications (inotify on Linux),
+      only the folders are watched so the number of watches doesn't grow with the number of files.
+      Data appended to existing files doesn't change the folder, the folders are also rescanned periodically.
+      Bursts of changes are debounced, a file is complete when its size and modification time
+      didn't change during the debounce interval.
+
+      Files already present when the watcher is created don't trigger the process.
+    */
+    class FileWatcher : public QObject
+    {
+      Q_OBJECT
+
+      public:
+        //! A watched folder.
+        struct Folder
+        {
+          std::string path; //!< Absolute path of the folder.
+          std::string mask; //!< Mask of the files of interest.
+          std::string timezone = "UTC+00"; //!< Timezone of the dates in the mask.
+        };
+
+        /*!
+          \param processId Identifier of the process emitted with the signal.
+          \param folders Folders to watch.
+          \param debounceInterval Time, in milliseconds, a file must remain unchanged to be complete.
+          \param rescanInterval Interval, in milliseconds, between the scans for files that grew.
+        */
+        FileWatcher(ProcessId processId, const std::vector<Folder>& folders, int debounceInterval = 2000, int rescanInterval = 60000);
+
+        virtual ~FileWatcher() = default;
+        FileWatcher(const FileWatcher& other) = delete;
+        FileWatcher(FileWatcher&& other) = delete;
+        FileWatcher& operator=(const FileWatcher& other) = delete;
+        FileWatcher& operator=(FileWatcher&& other) = delete;
+
+        ProcessId processId() const { return processId_; }
+
+      signals:
+        //! Emitted when new or changed files that match the mask are complete.
+        void fileReadySignal(ProcessId processId) const;
+
+      private slots:
+        //! A file was added, removed or renamed in the folder.
+        void directoryChangedSlot(const QString& path) noexcept;
+        //! Scans all folders for files that grew.
+        void rescanSlot() noexcept;
+        //! Checks if the pending files are complete.
+        void debounceSlot() noexcept;
+
+      private:
+        //! Size and modification time of a file.
+        struct FileState
+        {
+          qint64 size = -1;
+          qint64 lastModified = -1;
+
+          bool operator==(const FileState& rhs) const { return size == rhs.size && lastModified == rhs.lastModified; }
+          bool operator!=(const FileState& rhs) const { return !(*this == rhs); }
+        };
+
+        //! Reads the state of the file.
+        static FileState fileState(const QString& path);
+
+        //! Updates the files of the folder, changed files that match the mask become pending.
+        void scanFolder(const Folder& folder, bool initial);
+
+        ProcessId processId_;
+        std::vector<Folder> folders_;
+        QFileSystemWatcher watcher_;
+        QTimer debounceTimer_;
+        QTimer rescanTimer_;
+        std::map<QString, FileState> knownFiles_; //!< State of the matching files when last processed.
+        std::map<QString, FileState> pendingFiles_; //!< State of changed files at the last check.
+    };
+  }
+}
+
+#endif //__TERRAMA2_CORE_FILE_WATCHER_HPP__
@@ -57,6 +57,8 @@ namespace terrama2
 
       \return Returns if the name is valid or not.
 
+      \note The mask is compiled only once, see MaskMatcher.
+
       \exception terrama2::Exception If it is not possible to form a date with mask.
       \exception terrama2::Exception If it was not possible to find a valid date in name.
     */
@@ -81,6 +81,8 @@ terrama2::core::DataProviderPtr terrama2::core::fromDataProviderJson(QJsonObject
   provider->uri = json["uri"].toString().toStdString();
   provider->active = json["active"].toBool();
   provider->dataProviderType = json["data_provider_type"].toString().toStdString();
+  if(json.contains("ingestion_threads"))
+    provider->ingestionThreads = static_cast<uint32_t>(json["ingestion_threads"].toInt());
 
   return providerPtr;
 }
@@ -460,6 +462,7 @@ QJsonObject terrama2::core::toJson(DataProviderPtr dataProviderPtr)
   obj.insert("uri", QString::fromStdString(dataProviderPtr->uri));
   obj.insert("active", dataProviderPtr->active);
   obj.insert("data_provider_type", QString::fromStdString(dataProviderPtr->dataProviderType));
+  obj.insert("ingestion_threads", static_cast<int32_t>(dataProviderPtr->ingestionThreads));
 
   return obj;
 }
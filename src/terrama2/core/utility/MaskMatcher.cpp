@@ -0,0 +1,224 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/core/utility/MaskMatcher.cpp
+
+  \brief Matcher of file names against a dataset mask.
+
+  \author Jano Simas
+*/
+
+// TerraMA2
+#include "MaskMatcher.hpp"
+#include "FilterUtils.hpp"
+#include "Logger.hpp"
+#include "../Exception.hpp"
+
+// Qt
+#include <QObject>
+#include <QString>
+
+// STL
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <mutex>
+
+terrama2::core::MaskMatcher::MaskMatcher(const std::string& mask, const std::string& timezone)
+{
+  if(!isValidDatedMask(mask))
+  {
+    QString errMsg = QObject::tr("The mask don't have the minimal needed parameters of a date!");
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw terrama2::core::UtilityException() << ErrorDescription(errMsg);
+  }
+
+  /*
+    yyyy  year with 4 digits        [0-9]{4}
+    yy    year with 2 digits        [0-9]{2}
+    MM    month with 2 digits       0[1-9]|1[012]
+    dd    day with 2 digits         0[1-9]|[12][0-9]|3[01]
+    hh    hout with 2 digits        [0-1][0-9]|2[0-4]
+    mm    minutes with 2 digits     [0-5][0-9]
+    ss    seconds with 2 digits     [0-5][0-9]
+    */
+
+  QString m(mask.c_str());
+
+  m.replace("yyyy", "(?<YEAR>[0-9]{4})");
+  m.replace("yy", "(?<YEAR2DIGITS>[0-9]{2})");
+  m.replace("MM", "(?<MONTH>0[1-9]|1[012])");
+  m.replace("dd", "(?<DAY>0[1-9]|[12][0-9]|3[01])");
+  m.replace("hh", "(?<HOUR>[0-1][0-9]|2[0-4])");
+  m.replace("mm", "(?<MINUTES>[0-5][0-9])");
+  m.replace("ss", "(?<SECONDS>[0-5][0-9])");
+
+  // add a extension validation in case of the name has it
+  m += "(?<EXTENSIONS>((\\.[^.]+)+\\.(gz|zip|rar|7z|tar)|\\.[^.]+))?";
+
+  expression_ = boost::regex(m.toStdString());
+
+  // the timezone is only used for masks with date
+  if(mask.find("dd") != std::string::npos)
+    zone_.reset(new boost::local_time::posix_time_zone(timezone));
+}
+
+std::shared_ptr<const terrama2::core::MaskMatcher> terrama2::core::MaskMatcher::get(const std::string& mask, const std::string& timezone)
+{
+  static std::mutex mutex;
+  static std::map<std::pair<std::string, std::string>, std::shared_ptr<const MaskMatcher> > matchers;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto key = std::make_pair(mask, timezone);
+  auto it = matchers.find(key);
+  if(it != matchers.end())
+    return it->second;
+
+  auto matcher = std::make_shared<const MaskMatcher>(mask, timezone);
+  matchers.emplace(key, matcher);
+  return matcher;
+}
+
+bool terrama2::core::MaskMatcher::match(const std::string& name, std::shared_ptr<te::dt::TimeInstantTZ>& fileTimestamp) const
+{
+  boost::match_results< std::string::const_iterator > match;
+  if(!boost::regex_match(name, match, expression_, boost::match_default))
+    return false;
+
+  if((match["YEAR"].matched || match["YEAR2DIGITS"].matched) && match["MONTH"].matched && match["DAY"].matched)
+  {
+    int year;
+    if(match["YEAR"].matched)
+    {
+      year = std::stoi(match["YEAR"].str());
+    }
+    else
+    {
+      year = std::stoi(match["YEAR2DIGITS"].str());
+
+      if(year < 80)
+        year += 2000;
+      else
+        year += 1900;
+    }
+
+    // if the name has only date part, it presumes that time is 00:00:00
+    int hour = match["HOUR"].matched ? std::stoi(match["HOUR"].str()) : 0;
+    int minutes = match["MINUTES"].matched ? std::stoi(match["MINUTES"].str()) : 0;
+    int seconds = match["SECONDS"].matched ? std::stoi(match["SECONDS"].str()) : 0;
+
+    boost::gregorian::date boostDate(year, std::stoi(match["MONTH"].str()), std::stoi(match["DAY"].str()));
+    boost::local_time::local_date_time date(boostDate, boost::posix_time::time_duration(hour, minutes, seconds), zone_, true);
+
+    fileTimestamp.reset(new te::dt::TimeInstantTZ(date));
+  }
+  else
+  {
+    fileTimestamp.reset();
+  }
+
+  return true;
+}
+
+bool terrama2::core::MaskMatcher::isValid(const std::string& name, const Filter& filter, std::shared_ptr<te::dt::TimeInstantTZ>& fileTimestamp) const
+{
+  if(!match(name, fileTimestamp))
+    return false;
+
+  if(fileTimestamp && !isValidTimestamp(filter, fileTimestamp))
+    return false;
+
+  return true;
+}
+
+terrama2::core::MaskMatcher::Index terrama2::core::MaskMatcher::index(const std::vector<std::string>& names) const
+{
+  Index index;
+  for(std::size_t i = 0; i < names.size(); ++i)
+  {
+    MatchedFile file;
+    if(!match(names[i], file.timestamp))
+      continue;
+
+    file.position = i;
+    if(file.timestamp)
+    {
+      file.utcTime = file.timestamp->getTimeInstantTZ().utc_time();
+      index.dated.push_back(file);
+    }
+    else
+      index.undated.push_back(file);
+  }
+
+  std::stable_sort(index.dated.begin(), index.dated.end(), [](const MatchedFile& a, const MatchedFile& b)
+  {
+    return a.utcTime < b.utcTime;
+  });
+
+  return index;
+}
+
+std::vector<terrama2::core::MaskMatcher::MatchedFile>
+terrama2::core::MaskMatcher::select(const Index& index, const Filter& filter, bool lastValue)
+{
+  auto begin = index.dated.cbegin();
+  auto end = index.dated.cend();
+
+  // files after discard before
+  if(filter.discardBefore)
+  {
+    auto utcTime = filter.discardBefore->getTimeInstantTZ().utc_time();
+    begin = std::upper_bound(begin, end, utcTime, [](const boost::posix_time::ptime& time, const MatchedFile& file)
+    {
+      return time < file.utcTime;
+    });
+  }
+
+  // files before discard after
+  if(filter.discardAfter)
+  {
+    auto utcTime = filter.discardAfter->getTimeInstantTZ().utc_time();
+    end = std::lower_bound(begin, end, utcTime, [](const MatchedFile& file, const boost::posix_time::ptime& time)
+    {
+      return file.utcTime < time;
+    });
+  }
+
+  // only the files with the latest timestamp
+  if(lastValue && begin != end)
+  {
+    auto utcTime = std::prev(end)->utcTime;
+    begin = std::lower_bound(begin, end, utcTime, [](const MatchedFile& file, const boost::posix_time::ptime& time)
+    {
+      return file.utcTime < time;
+    });
+  }
+
+  std::vector<MatchedFile> files(index.undated);
+  files.insert(files.end(), begin, end);
+  std::sort(files.begin(), files.end(), [](const MatchedFile& a, const MatchedFile& b)
+  {
+    return a.position < b.position;
+  });
+
+  return files;
+}
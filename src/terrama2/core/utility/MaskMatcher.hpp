@@ -0,0 +1,135 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/core/utility/MaskMatcher.hpp
+
+  \brief Matcher of file names against a dataset mask.
+
+  \author Jano Simas
+*/
+
+#ifndef __TERRAMA2_CORE_UTILITY_MASK_MATCHER_HPP__
+#define __TERRAMA2_CORE_UTILITY_MASK_MATCHER_HPP__
+
+// TerraMA2
+#include "../data-model/Filter.hpp"
+
+// Terralib
+#include <terralib/datatype/TimeInstantTZ.h>
+
+// Boost
+#include <boost/date_time/local_time/local_time.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/regex.hpp>
+
+// STL
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace terrama2
+{
+  namespace core
+  {
+    /*!
+      \brief Matches file names against a mask with date and time wildcards.
+
+      The mask is converted to a regular expression and the timezone is created only once,
+      matchers are cached by mask and timezone and can be shared by threads.
+
+      Wildcards:
+        - yyyy year with 4 digits
+        - yy   year with 2 digits
+        - MM   month with 2 digits
+        - dd   day with 2 digits
+        - hh   hour with 2 digits
+        - mm   minutes with 2 digits
+        - ss   seconds with 2 digits
+
+      \sa isValidDataSetName()
+    */
+    class MaskMatcher
+    {
+      public:
+        //! A file of a listing that matches the mask.
+        struct MatchedFile
+        {
+          std::size_t position = 0; //!< Position of the file in the listing.
+          std::shared_ptr<te::dt::TimeInstantTZ> timestamp; //!< Timestamp in the name, null if the mask has no date.
+          boost::posix_time::ptime utcTime; //!< UTC time of the timestamp, used to sort the files.
+        };
+
+        /*!
+          \brief Files of a listing that match the mask.
+
+          The files with timestamp are sorted by timestamp, so filters are applied with binary search.
+        */
+        struct Index
+        {
+          std::vector<MatchedFile> undated; //!< Files without a timestamp, in listing order.
+          std::vector<MatchedFile> dated; //!< Files with a timestamp, sorted by timestamp.
+        };
+
+        /*!
+          \brief Compiles the mask.
+
+          \exception UtilityException Raised if the mask doesn't have the minimal parameters of a date.
+        */
+        MaskMatcher(const std::string& mask, const std::string& timezone);
+
+        //! Returns the compiled matcher for the mask and timezone, matchers are compiled only once.
+        static std::shared_ptr<const MaskMatcher> get(const std::string& mask, const std::string& timezone);
+
+        /*!
+          \brief Checks if the name matches the mask and extracts the timestamp.
+
+          \param name Name of the file.
+          \param fileTimestamp Timestamp in the name, reset if the mask has no date.
+        */
+        bool match(const std::string& name, std::shared_ptr<te::dt::TimeInstantTZ>& fileTimestamp) const;
+
+        //! Checks if the name matches the mask and the timestamp is valid for the filter.
+        bool isValid(const std::string& name, const Filter& filter, std::shared_ptr<te::dt::TimeInstantTZ>& fileTimestamp) const;
+
+        //! Matches all names of the listing and sorts the files with timestamp.
+        Index index(const std::vector<std::string>& names) const;
+
+        /*!
+          \brief Selects the files of the index valid for the filter.
+
+          The time range of the filter is applied with binary search.
+
+          \param index Index of a listing.
+          \param filter Filter with the time range.
+          \param lastValue If true, only the dated files with the latest timestamp are selected.
+          \return Valid files in listing order.
+        */
+        static std::vector<MatchedFile> select(const Index& index, const Filter& filter, bool lastValue);
+
+      private:
+        boost::regex expression_;
+        boost::local_time::time_zone_ptr zone_;
+    };
+  } // end namespace core
+}   // end namespace terrama2
+
+#endif  // __TERRAMA2_CORE_UTILITY_MASK_MATCHER_HPP__
@@ -0,0 +1,255 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/core/utility/RasterBlockCache.cpp
+
+  \brief Cache of decoded raster blocks shared by all readers of the process.
+
+  \author Jano Simas
+*/
+
+#include "RasterBlockCache.hpp"
+
+// TerraLib
+#include <terralib/raster/Utils.h>
+
+//Qt
+#include <QDateTime>
+#include <QFileInfo>
+
+//STL
+#include <cstring>
+#include <iterator>
+
+namespace
+{
+  template<class T>
+  double readPixel(const unsigned char* pixel)
+  {
+    T value;
+    std::memcpy(&value, pixel, sizeof(T));
+    return static_cast<double>(value);
+  }
+
+  template<class T>
+  void writePixel(unsigned char* pixel, double value)
+  {
+    T typed = static_cast<T>(value);
+    std::memcpy(pixel, &typed, sizeof(T));
+  }
+}
+
+terrama2::core::RasterBlock::RasterBlock(int dataType, std::size_t size)
+  : dataType_(storageType(dataType)),
+    pixelSize_(static_cast<std::size_t>(te::rst::GetPixelSize(dataType_))),
+    data_(size * pixelSize_, 0)
+{
+}
+
+int terrama2::core::RasterBlock::storageType(int dataType)
+{
+  switch(dataType)
+  {
+    case te::dt::CHAR_TYPE:
+    case te::dt::UCHAR_TYPE:
+    case te::dt::INT16_TYPE:
+    case te::dt::UINT16_TYPE:
+    case te::dt::INT32_TYPE:
+    case te::dt::UINT32_TYPE:
+    case te::dt::FLOAT_TYPE:
+    case te::dt::DOUBLE_TYPE:
+      return dataType;
+    default:
+      return te::dt::DOUBLE_TYPE;
+  }
+}
+
+double terrama2::core::RasterBlock::value(std::size_t index) const
+{
+  const unsigned char* pixel = data_.data() + index * pixelSize_;
+  switch(dataType_)
+  {
+    case te::dt::CHAR_TYPE:
+      return readPixel<int8_t>(pixel);
+    case te::dt::UCHAR_TYPE:
+      return readPixel<uint8_t>(pixel);
+    case te::dt::INT16_TYPE:
+      return readPixel<int16_t>(pixel);
+    case te::dt::UINT16_TYPE:
+      return readPixel<uint16_t>(pixel);
+    case te::dt::INT32_TYPE:
+      return readPixel<int32_t>(pixel);
+    case te::dt::UINT32_TYPE:
+      return readPixel<uint32_t>(pixel);
+    case te::dt::FLOAT_TYPE:
+      return readPixel<float>(pixel);
+    default:
+      return readPixel<double>(pixel);
+  }
+}
+
+void terrama2::core::RasterBlock::setValue(std::size_t index, double value)
+{
+  unsigned char* pixel = data_.data() + index * pixelSize_;
+  switch(dataType_)
+  {
+    case te::dt::CHAR_TYPE:
+      writePixel<int8_t>(pixel, value);
+      break;
+    case te::dt::UCHAR_TYPE:
+      writePixel<uint8_t>(pixel, value);
+      break;
+    case te::dt::INT16_TYPE:
+      writePixel<int16_t>(pixel, value);
+      break;
+    case te::dt::UINT16_TYPE:
+      writePixel<uint16_t>(pixel, value);
+      break;
+    case te::dt::INT32_TYPE:
+      writePixel<int32_t>(pixel, value);
+      break;
+    case te::dt::UINT32_TYPE:
+      writePixel<uint32_t>(pixel, value);
+      break;
+    case te::dt::FLOAT_TYPE:
+      writePixel<float>(pixel, value);
+      break;
+    default:
+      writePixel<double>(pixel, value);
+      break;
+  }
+}
+
+std::string terrama2::core::RasterBlockKey::toString() const
+{
+  return fileIdentity + "|" + std::to_string(band) + "|" + std::to_string(block);
+}
+
+std::string terrama2::core::RasterBlockCache::fileIdentity(const std::string& path)
+{
+  QFileInfo fileInfo(QString::fromStdString(path));
+  if(!fileInfo.exists())
+    return {};
+
+  return fileInfo.absoluteFilePath().toStdString()
+         + ":" + std::to_string(fileInfo.size())
+         + ":" + std::to_string(fileInfo.lastModified().toMSecsSinceEpoch());
+}
+
+terrama2::core::RasterBlockPtr
+terrama2::core::RasterBlockCache::get(const RasterBlockKey& key, const std::function<RasterBlock()>& load)
+{
+  std::string keyStr = key.toString();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(keyStr);
+    if(it != entries_.end())
+    {
+      ++statistics_.hits;
+      lru_.splice(lru_.begin(), lru_, it->second.lruPosition);
+      return it->second.block;
+    }
+
+    ++statistics_.misses;
+  }
+
+  // the block is decoded without the lock,
+  // concurrent readers of the same block may decode it more than once
+  RasterBlockPtr block = std::make_shared<const RasterBlock>(load());
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(keyStr);
+  if(it != entries_.end())
+    return it->second.block;
+
+  lru_.push_front(keyStr);
+
+  Entry entry;
+  entry.block = block;
+  entry.lruPosition = lru_.begin();
+  entry.memory = block->byteSize() + 2*keyStr.size() + sizeof(Entry);
+
+  statistics_.memory += entry.memory;
+  ++statistics_.blocks;
+  entries_.emplace(keyStr, entry);
+
+  evict();
+
+  return block;
+}
+
+void terrama2::core::RasterBlockCache::setMaxMemory(std::size_t maxMemory)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  maxMemory_ = maxMemory;
+  evict();
+}
+
+terrama2::core::RasterBlockCache::Statistics terrama2::core::RasterBlockCache::statistics() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return statistics_;
+}
+
+void terrama2::core::RasterBlockCache::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.begin();
+  while(it != entries_.end())
+  {
+    auto current = it++;
+    if(current->second.block.use_count() == 1)
+      erase(current);
+  }
+
+  std::size_t memory = statistics_.memory;
+  std::size_t blocks = statistics_.blocks;
+  statistics_ = Statistics();
+  statistics_.memory = memory;
+  statistics_.blocks = blocks;
+}
+
+void terrama2::core::RasterBlockCache::evict()
+{
+  auto it = lru_.end();
+  while(statistics_.memory > maxMemory_ && it != lru_.begin())
+  {
+    --it;
+    auto entry = entries_.find(*it);
+    // blocks held by a reader are pinned
+    if(entry->second.block.use_count() > 1)
+      continue;
+
+    auto next = std::next(it);
+    erase(entry);
+    ++statistics_.evictions;
+    it = next;
+  }
+}
+
+void terrama2::core::RasterBlockCache::erase(std::unordered_map<std::string, Entry>::iterator it)
+{
+  statistics_.memory -= it->second.memory;
+  --statistics_.blocks;
+  lru_.erase(it->second.lruPosition);
+  entries_.erase(it);
+}
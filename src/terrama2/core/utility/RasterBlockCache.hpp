@@ -0,0 +1,185 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/core/utility/RasterBlockCache.hpp
+
+  \brief Cache of decoded raster blocks shared by all readers of the process.
+
+  \author Jano Simas
+*/
+
+#ifndef __TERRAMA2_CORE_UTILITY_RASTER_BLOCK_CACHE_HPP__
+#define __TERRAMA2_CORE_UTILITY_RASTER_BLOCK_CACHE_HPP__
+
+// TerraLib
+#include <terralib/common/Singleton.h>
+#include <terralib/datatype/Enums.h>
+
+//STL
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace terrama2
+{
+  namespace core
+  {
+    //! Identifies a block of a band of a raster file.
+    struct RasterBlockKey
+    {
+      std::string fileIdentity; //!< Identity of the file, as returned by RasterBlockCache::fileIdentity().
+      std::size_t band = 0; //!< Index of the band.
+      std::size_t block = 0; //!< Index of the block in the band, defined by the reader.
+
+      //! Returns a string that uniquely represents the key.
+      std::string toString() const;
+    };
+
+    /*!
+      \brief Decoded pixels of a block, stored in the data type of the band.
+
+      Bands of types that can't be stored natively, as complex types, are stored as double.
+    */
+    class RasterBlock
+    {
+      public:
+        //! Block with the pixels of the data type, initialized with zero.
+        RasterBlock(int dataType = te::dt::DOUBLE_TYPE, std::size_t size = 0);
+
+        //! Data type used to store the pixels of a band of the data type.
+        static int storageType(int dataType);
+
+        //! TerraLib data type of the pixels.
+        int dataType() const { return dataType_; }
+
+        //! Size, in bytes, of a pixel.
+        std::size_t pixelSize() const { return pixelSize_; }
+
+        //! Number of pixels.
+        std::size_t size() const { return pixelSize_ ? data_.size() / pixelSize_ : 0; }
+
+        //! Returns the value of the pixel.
+        double value(std::size_t index) const;
+
+        //! Sets the value of the pixel, converted to the data type of the block.
+        void setValue(std::size_t index, double value);
+
+        //! Raw pixels, in row-major order.
+        const unsigned char* data() const { return data_.data(); }
+
+        //! Raw pixels, in row-major order.
+        unsigned char* data() { return data_.data(); }
+
+        //! Size, in bytes, of the pixels.
+        std::size_t byteSize() const { return data_.size(); }
+
+      private:
+        int dataType_;
+        std::size_t pixelSize_;
+        std::vector<unsigned char> data_;
+    };
+
+    //! Decoded block, the block stays in the cache while a reader holds it.
+    typedef std::shared_ptr<const RasterBlock> RasterBlockPtr;
+
+    /*!
+      \brief Memory-bounded LRU cache of decoded raster blocks.
+
+      Readers of the same file share the decoded blocks,
+      so a raster used by several analyses or services is decoded only once
+      while it stays in the cache.
+
+      Blocks held by a reader are pinned and are never evicted,
+      the memory limit may be exceeded while the pinned blocks are in use.
+    */
+    class RasterBlockCache : public te::common::Singleton<RasterBlockCache>
+    {
+      public:
+        //! Usage statistics of the cache.
+        struct Statistics
+        {
+          uint64_t hits = 0; //!< Requests of blocks found in the cache.
+          uint64_t misses = 0; //!< Requests of blocks decoded by the reader.
+          uint64_t evictions = 0; //!< Blocks removed to respect the memory limit.
+          std::size_t memory = 0; //!< Memory, in bytes, used by the cached blocks.
+          std::size_t blocks = 0; //!< Number of cached blocks.
+        };
+
+        /*!
+          \brief Returns the identity of a file.
+
+          The identity is built from the path, the size and the last modification time,
+          so blocks of a file that was rewritten are not reused.
+
+          \return An empty string if the file doesn't exist.
+        */
+        static std::string fileIdentity(const std::string& path);
+
+        /*!
+          \brief Returns the cached block for the key, decoding it if needed.
+
+          \param key Key of the block.
+          \param load Decodes the block, called without holding the cache lock.
+
+          \exception Any exception thrown by load, failed loads are not cached.
+        */
+        RasterBlockPtr get(const RasterBlockKey& key, const std::function<RasterBlock()>& load);
+
+        //! Set the maximum memory, in bytes, used by the cached blocks.
+        void setMaxMemory(std::size_t maxMemory);
+
+        //! Returns the usage statistics.
+        Statistics statistics() const;
+
+        //! Removes all blocks that are not in use and resets the statistics.
+        void clear();
+
+      private:
+        //! Cached block and its position in the LRU list.
+        struct Entry
+        {
+          RasterBlockPtr block;
+          std::list<std::string>::iterator lruPosition;
+          std::size_t memory;
+        };
+
+        //! Removes the least recently used blocks that are not in use until the memory limit is respected.
+        void evict();
+
+        //! Removes the entry from all containers.
+        void erase(std::unordered_map<std::string, Entry>::iterator it);
+
+        std::unordered_map<std::string, Entry> entries_;
+        std::list<std::string> lru_; //!< Keys ordered from most recently used to least recently used.
+        Statistics statistics_;
+        std::size_t maxMemory_ = 512*1024*1024;
+        mutable std::mutex mutex_; //!< A mutex to synchronize all operations.
+    };
+  } // end namespace core
+}   // end namespace terrama2
+
+#endif // __TERRAMA2_CORE_UTILITY_RASTER_BLOCK_CACHE_HPP__
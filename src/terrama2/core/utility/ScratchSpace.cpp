@@ -0,0 +1,346 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/core/utility/ScratchSpace.cpp
+
+  \brief Temporary working folders of the executions of a service.
+
+  \author Jano Simas
+*/
+
+#include "ScratchSpace.hpp"
+#include "Logger.hpp"
+#include "ServiceManager.hpp"
+#include "Unpack.hpp"
+#include "../Exception.hpp"
+
+//Qt
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QObject>
+
+//STL
+#include <algorithm>
+#include <cstdio>
+#include <set>
+#include <vector>
+
+// POSIX
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+  //! Folder of the files shared between executions.
+  const QString SHARED_FOLDER = "shared";
+  //! Interval between the removal of expired folders.
+  const std::chrono::seconds CLEANUP_INTERVAL(10);
+}
+
+terrama2::core::ScratchFolder::ScratchFolder(const std::string& path)
+  : path_(path)
+{
+}
+
+terrama2::core::ScratchFolder::~ScratchFolder()
+{
+  ScratchSpace::getInstance().release(path_);
+}
+
+terrama2::core::ScratchSpace::ScratchSpace()
+  : rootFolder_(QDir::temp().absoluteFilePath("terrama2-scratch").toStdString())
+{
+  cleanupThread_ = std::thread(&ScratchSpace::cleanupLoop, this);
+}
+
+terrama2::core::ScratchSpace::~ScratchSpace()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+    // no execution is running, the folders are removed now
+    expiration_ = std::chrono::seconds(0);
+  }
+  condition_.notify_all();
+
+  if(cleanupThread_.joinable())
+    cleanupThread_.join();
+
+  for(const auto& released : released_)
+    QDir(QString::fromStdString(released.second)).removeRecursively();
+}
+
+std::string terrama2::core::ScratchSpace::serviceName() const
+{
+  auto& serviceManager = ServiceManager::getInstance();
+
+  std::string serviceType = serviceManager.serviceType();
+  if(serviceType.empty())
+    return "terrama2";
+
+  return serviceType + "_" + std::to_string(serviceManager.instanceId());
+}
+
+std::string terrama2::core::ScratchSpace::serviceFolder() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return rootFolder_ + "/" + serviceName();
+}
+
+terrama2::core::ScratchFolderPtr terrama2::core::ScratchSpace::createFolder(const std::string& purpose)
+{
+  checkQuota();
+
+  QString serviceFolderPath = QString::fromStdString(serviceFolder());
+
+  std::string path;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if(!orphansRemoved_)
+    {
+      removeOrphans();
+      orphansRemoved_ = true;
+    }
+
+    path = QDir(serviceFolderPath).absoluteFilePath(QString("%1-%2-%3").arg(QString::fromStdString(purpose))
+                                                                         .arg(QDateTime::currentMSecsSinceEpoch())
+                                                                         .arg(++counter_)).toStdString();
+  }
+
+  if(!QDir().mkpath(QString::fromStdString(path)))
+  {
+    QString errMsg = QObject::tr("Could not create scratch folder %1.").arg(QString::fromStdString(path));
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw ScratchSpaceException() << ErrorDescription(errMsg);
+  }
+
+  return ScratchFolderPtr(new ScratchFolder(path));
+}
+
+void terrama2::core::ScratchSpace::checkQuota(qint64 additionalSize)
+{
+  qint64 quota = 0;
+  qint64 used = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    quota = quota_;
+    used = used_;
+  }
+
+  if(quota <= 0)
+    return;
+
+  if(used < 0)
+  {
+    used = usage();
+    std::lock_guard<std::mutex> lock(mutex_);
+    used_ = used;
+  }
+
+  if(used + additionalSize > quota)
+  {
+    QString errMsg = QObject::tr("Scratch space quota exceeded: %1 of %2 bytes used.").arg(used).arg(quota);
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw ScratchSpaceException() << ErrorDescription(errMsg);
+  }
+}
+
+void terrama2::core::ScratchSpace::addUsage(qint64 size)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if(used_ >= 0)
+    used_ = std::max(used_ + size, static_cast<qint64>(0));
+}
+
+qint64 terrama2::core::ScratchSpace::usage() const
+{
+  // hard links are counted only once
+  std::set<std::pair<dev_t, ino_t> > inodes;
+  qint64 size = 0;
+
+  QDirIterator it(QString::fromStdString(serviceFolder()), QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+  while(it.hasNext())
+  {
+    struct stat info;
+    if(stat(QFile::encodeName(it.next()).constData(), &info) != 0)
+      continue;
+
+    if(inodes.emplace(info.st_dev, info.st_ino).second)
+      size += info.st_size;
+  }
+
+  return size;
+}
+
+void terrama2::core::ScratchSpace::shareFile(const std::string& filePath)
+{
+  QFileInfo fileInfo(QString::fromStdString(filePath));
+  QByteArray hash = Unpack::contentHash(fileInfo);
+  if(hash.isEmpty())
+    return;
+
+  QDir sharedDir(QString::fromStdString(serviceFolder()) + "/" + SHARED_FOLDER);
+  sharedDir.mkpath(".");
+  QString sharedPath = sharedDir.absoluteFilePath(QString(hash.toHex()));
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  QByteArray sharedName = QFile::encodeName(sharedPath);
+  QByteArray fileName = QFile::encodeName(fileInfo.absoluteFilePath());
+  if(QFileInfo(sharedPath).size() == fileInfo.size())
+  {
+    // the same content is already stored, the file is replaced by a link to it
+    QString temporaryPath = fileInfo.absoluteFilePath() + ".shared";
+    QByteArray temporaryName = QFile::encodeName(temporaryPath);
+    if(::link(sharedName.constData(), temporaryName.constData()) == 0)
+    {
+      if(std::rename(temporaryName.constData(), fileName.constData()) != 0)
+        QFile::remove(temporaryPath);
+      else if(used_ >= 0)
+        used_ = std::max(used_ - fileInfo.size(), static_cast<qint64>(0));
+    }
+  }
+  else if(::link(fileName.constData(), sharedName.constData()) != 0)
+  {
+    // the scratch folder may be in other file system, the file is just not shared
+    TERRAMA2_LOG_DEBUG() << QObject::tr("Could not share file %1.").arg(fileInfo.absoluteFilePath());
+  }
+}
+
+void terrama2::core::ScratchSpace::setRootFolder(const std::string& rootFolder)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  rootFolder_ = rootFolder;
+  orphansRemoved_ = false;
+  used_ = -1;
+}
+
+void terrama2::core::ScratchSpace::setQuota(qint64 quota)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  quota_ = quota;
+}
+
+void terrama2::core::ScratchSpace::setExpiration(std::chrono::seconds expiration)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    expiration_ = expiration;
+  }
+  condition_.notify_all();
+}
+
+void terrama2::core::ScratchSpace::release(const std::string& path)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    released_.emplace_back(std::chrono::steady_clock::now(), path);
+  }
+  condition_.notify_all();
+}
+
+void terrama2::core::ScratchSpace::removeExpired()
+{
+  std::vector<std::string> expired;
+  std::chrono::seconds expiration;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    expiration = expiration_;
+    auto now = std::chrono::steady_clock::now();
+    while(!released_.empty() && released_.front().first + expiration <= now)
+    {
+      expired.push_back(released_.front().second);
+      released_.pop_front();
+    }
+  }
+
+  for(const auto& path : expired)
+  {
+    if(!QDir(QString::fromStdString(path)).removeRecursively())
+      TERRAMA2_LOG_WARNING() << QObject::tr("Could not remove scratch folder %1.").arg(QString::fromStdString(path));
+  }
+
+  // shared files only linked by the shared folder are not used by any execution
+  QDir sharedDir(QString::fromStdString(serviceFolder()) + "/" + SHARED_FOLDER);
+  QDateTime limit = QDateTime::currentDateTime().addSecs(-expiration.count());
+
+  bool removed = !expired.empty();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for(const auto& fileInfo : sharedDir.entryInfoList(QDir::Files))
+    {
+      struct stat info;
+      if(stat(QFile::encodeName(fileInfo.absoluteFilePath()).constData(), &info) != 0)
+        continue;
+
+      if(info.st_nlink <= 1 && fileInfo.lastModified() <= limit)
+        removed = QFile::remove(fileInfo.absoluteFilePath()) || removed;
+    }
+  }
+
+  // hard links make the space freed unknown, the folder is scanned again here and not on each quota check
+  if(removed)
+  {
+    qint64 used = usage();
+    std::lock_guard<std::mutex> lock(mutex_);
+    used_ = used;
+  }
+}
+
+void terrama2::core::ScratchSpace::cleanupLoop()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while(!stop_)
+  {
+    condition_.wait_for(lock, CLEANUP_INTERVAL);
+    if(stop_)
+      break;
+
+    lock.unlock();
+    try
+    {
+      removeExpired();
+    }
+    catch(...)
+    {
+      TERRAMA2_LOG_ERROR() << QObject::tr("Could not remove expired scratch folders.");
+    }
+    lock.lock();
+  }
+}
+
+void terrama2::core::ScratchSpace::removeOrphans()
+{
+  // called before the first folder of this instance is created,
+  // all folders are from a previous run of the service
+  QDir serviceDir(QString::fromStdString(rootFolder_ + "/" + serviceName()));
+  for(const auto& entry : serviceDir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot))
+  {
+    if(entry.fileName() == SHARED_FOLDER)
+      continue;
+
+    TERRAMA2_LOG_INFO() << QObject::tr("Removing scratch folder of previous execution %1.").arg(entry.absoluteFilePath());
+    QDir(entry.absoluteFilePath()).removeRecursively();
+  }
+}
@@ -0,0 +1,193 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/core/utility/ScratchSpace.hpp
+
+  \brief Temporary working folders of the executions of a service.
+
+  \author Jano Simas
+*/
+
+#ifndef __TERRAMA2_CORE_UTILITY_SCRATCH_SPACE_HPP__
+#define __TERRAMA2_CORE_UTILITY_SCRATCH_SPACE_HPP__
+
+// TerraLib
+#include <terralib/common/Singleton.h>
+
+//Qt
+#include <QtGlobal>
+
+//STL
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace terrama2
+{
+  namespace core
+  {
+    /*!
+      \brief Working folder of an execution.
+
+      The folder is removed by the ScratchSpace when the last reference is released.
+    */
+    class ScratchFolder
+    {
+      public:
+        ~ScratchFolder();
+
+        ScratchFolder(const ScratchFolder& other) = delete;
+        ScratchFolder(ScratchFolder&& other) = delete;
+        ScratchFolder& operator=(const ScratchFolder& other) = delete;
+        ScratchFolder& operator=(ScratchFolder&& other) = delete;
+
+        //! Absolute path of the folder.
+        const std::string& path() const { return path_; }
+
+      private:
+        friend class ScratchSpace;
+
+        explicit ScratchFolder(const std::string& path);
+
+        std::string path_;
+    };
+
+    typedef std::shared_ptr<ScratchFolder> ScratchFolderPtr;
+
+    /*!
+      \brief Manages the temporary working folders of the service.
+
+      Each execution receives a unique folder in the service scratch folder,
+      the folder is removed in a background thread after it's released and expired,
+      folders left by a previous run of the service are also removed.
+
+      Files can be shared between executions, files with the same content are hard links
+      to a single copy, so repeated downloads of the same file don't use more disk space.
+
+      The disk space used by the service is limited by a quota.
+
+      \note Thread-safe.
+    */
+    class ScratchSpace : public te::common::Singleton<ScratchSpace>
+    {
+      public:
+        /*!
+          \brief Creates a unique working folder.
+
+          \param purpose Prefix of the folder name, identifies what the folder is used for.
+
+          \exception ScratchSpaceException Raised if the quota is exceeded or the folder can't be created.
+        */
+        ScratchFolderPtr createFolder(const std::string& purpose);
+
+        /*!
+          \brief Checks if there is space for more data.
+
+          The usage is tracked with addUsage(), the service folder is only scanned
+          the first time and after expired folders are removed.
+
+          \param additionalSize Size, in bytes, of the data that will be written.
+
+          \exception ScratchSpaceException Raised if the quota would be exceeded.
+        */
+        void checkQuota(qint64 additionalSize = 0);
+
+        //! Registers data written to the service folder, in bytes.
+        void addUsage(qint64 size);
+
+        //! Disk space, in bytes, used by the service folder, the folder is scanned.
+        qint64 usage() const;
+
+        /*!
+          \brief Shares the content of the file with the other executions.
+
+          If a file with the same content was shared, the file is replaced by a hard link to it.
+          Shared files not used by any execution are removed when expired.
+        */
+        void shareFile(const std::string& filePath);
+
+        //! Folder where the service folders are created, by default terrama2-scratch in the system temporary folder.
+        void setRootFolder(const std::string& rootFolder);
+
+        //! Sets the maximum disk space, in bytes, used by the service, zero means no limit.
+        void setQuota(qint64 quota);
+
+        //! Sets the time a released folder is kept before being removed.
+        void setExpiration(std::chrono::seconds expiration);
+
+        //! Folder of the service, all folders of the service are created in it.
+        std::string serviceFolder() const;
+
+        //! Removes the expired folders now.
+        void removeExpired();
+
+      protected:
+        friend class te::common::Singleton<ScratchSpace>;
+        friend class ScratchFolder;
+
+        //! Starts the cleanup thread.
+        ScratchSpace();
+
+        //! Stops the cleanup thread.
+        virtual ~ScratchSpace();
+
+        ScratchSpace(const ScratchSpace& other) = delete;
+        ScratchSpace(ScratchSpace&& other) = delete;
+        ScratchSpace& operator=(const ScratchSpace& other) = delete;
+        ScratchSpace& operator=(ScratchSpace&& other) = delete;
+
+        //! Queues the folder to be removed when expired.
+        void release(const std::string& path);
+
+      private:
+        //! Removes the expired folders until stopped.
+        void cleanupLoop();
+
+        //! Removes the folders in the service folder not created by this instance.
+        void removeOrphans();
+
+        //! Name of the service folder, identifies the service and instance.
+        std::string serviceName() const;
+
+        std::string rootFolder_;
+        qint64 quota_ = 0;
+        qint64 used_ = -1; //!< Disk space used by the service folder, negative until the folder is scanned.
+        std::chrono::seconds expiration_ {60};
+        uint64_t counter_ = 0; //!< Sequential number of the folders created.
+        bool orphansRemoved_ = false;
+
+        //! Released folders and the time they were released.
+        std::deque<std::pair<std::chrono::steady_clock::time_point, std::string> > released_;
+
+        bool stop_ = false;
+        std::thread cleanupThread_;
+        std::condition_variable condition_;
+        mutable std::mutex mutex_;
+    };
+  }
+}
+
+#endif // __TERRAMA2_CORE_UTILITY_SCRATCH_SPACE_HPP__
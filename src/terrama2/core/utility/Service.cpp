@@ -30,6 +30,7 @@
 #include "Service.hpp"
 #include "Logger.hpp"
 #include "Timer.hpp"
+#include "Utils.hpp"
 
 terrama2::core::Service::Service()
   : stop_(false)
@@ -62,6 +63,9 @@ void terrama2::core::Service::start(size_t threadNumber)
     //check for the number o threads to create
     threadNumber = verifyNumberOfThreads(threadNumber);
 
+    // the tasks of the service split their work in at most the same number of threads
+    setParallelForThreads(threadNumber);
+
     //Starts collection threads
     for(uint i = 0; i < threadNumber; ++i)
       processingThreadPool_.push_back(std::async(std::launch::async, &Service::processingTaskThread, this));
@@ -23,8 +23,14 @@
 
 #include "TimeUtils.hpp"
 #include "ServiceManager.hpp"
+#include "ScratchSpace.hpp"
+#include "RasterBlockCache.hpp"
+#include "DecodedRasterCache.hpp"
 #include "../../Version.hpp"
 
+// Qt
+#include <QDir>
+
 terrama2::core::ServiceManager::ServiceManager()
  : startTime_(terrama2::core::TimeUtils::nowUTC())
 {
@@ -84,6 +90,18 @@ int terrama2::core::ServiceManager::numberOfThreads() const
   return numberOfThreads_;
 }
 
+void terrama2::core::ServiceManager::setDataFolder(const std::string& dataFolder)
+{
+  dataFolder_ = dataFolder;
+}
+std::string terrama2::core::ServiceManager::dataFolder() const
+{
+  if(dataFolder_.empty())
+    return QDir::home().absoluteFilePath(".terrama2").toStdString();
+
+  return dataFolder_;
+}
+
 const std::shared_ptr< te::dt::TimeInstantTZ >& terrama2::core::ServiceManager::startTime() const
 {
   return startTime_;
@@ -96,6 +114,15 @@ QJsonObject terrama2::core::ServiceManager::status() const
   obj.insert("start_time", QString::fromStdString(startTime_->toString()));
   obj.insert("terrama2_version",  QString::fromStdString(TERRAMA2_VERSION_STRING));
   obj.insert("shutting_down",  isShuttingDown_);
+
+  auto rasterCache = RasterBlockCache::getInstance().statistics();
+  QJsonObject rasterCacheObj;
+  rasterCacheObj.insert("hits", static_cast<double>(rasterCache.hits));
+  rasterCacheObj.insert("misses", static_cast<double>(rasterCache.misses));
+  rasterCacheObj.insert("evictions", static_cast<double>(rasterCache.evictions));
+  rasterCacheObj.insert("memory", static_cast<double>(rasterCache.memory));
+  rasterCacheObj.insert("blocks", static_cast<double>(rasterCache.blocks));
+  obj.insert("raster_cache", rasterCacheObj);
   //TODO: Define status message
   return obj;
 }
@@ -106,6 +133,18 @@ void terrama2::core::ServiceManager::updateService(const QJsonObject& obj)
   setInstanceName(obj["instance_name"].toString().toStdString());
   setListeningPort(obj["listening_port"].toInt());
   setNumberOfThreads(obj["number_of_threads"].toInt());
+  if(obj.contains("data_folder"))
+    setDataFolder(obj["data_folder"].toString().toStdString());
+  if(obj.contains("scratch_space_quota"))
+    ScratchSpace::getInstance().setQuota(static_cast<qint64>(obj["scratch_space_quota"].toDouble()*1024*1024));
+  if(obj.contains("raster_cache_size"))
+    RasterBlockCache::getInstance().setMaxMemory(static_cast<std::size_t>(obj["raster_cache_size"].toDouble()*1024*1024));
+  if(obj.contains("decoded_cache_folder"))
+    DecodedRasterCache::getInstance().setFolder(obj["decoded_cache_folder"].toString().toStdString());
+  if(obj.contains("decoded_cache_size"))
+    DecodedRasterCache::getInstance().setMaxSize(static_cast<qint64>(obj["decoded_cache_size"].toDouble()*1024*1024));
+  if(obj.contains("decoded_cache_max_age"))
+    DecodedRasterCache::getInstance().setMaxAge(static_cast<qint64>(obj["decoded_cache_max_age"].toDouble()*60*60));
   auto logDatabaseObj = obj["log_database"].toObject();
 
   std::map<std::string, std::string> connInfo { {"PG_HOST", logDatabaseObj["PG_HOST"].toString().toStdString()},
@@ -117,6 +156,8 @@ void terrama2::core::ServiceManager::updateService(const QJsonObject& obj)
                                                 {"PG_CLIENT_ENCODING", "UTF-8"}
                                               };
   setLogConnectionInfo(connInfo);
+
+  emit serviceUpdated(obj);
 }
 
 void terrama2::core::ServiceManager::setLogConnectionInfo(std::map<std::string, std::string> connInfo)
@@ -82,6 +82,15 @@ namespace terrama2
         void setNumberOfThreads(int numberOfThreads);
         virtual int numberOfThreads() const;
 
+        //! Set the folder where the persistent state of the service is stored.
+        void setDataFolder(const std::string& dataFolder);
+        /*!
+          \brief Return the folder where the persistent state of the service is stored.
+
+          If no folder was set, the folder .terrama2 in the home of the user is used.
+        */
+        virtual std::string dataFolder() const;
+
         //! Return the Date/Time when the service was started.
         virtual const std::shared_ptr< te::dt::TimeInstantTZ >& startTime() const;
 
@@ -96,13 +105,22 @@ namespace terrama2
             - instance_name
             - listening_port
             - number_of_threads
+            - data_folder (optional)
+            - scratch_space_quota (optional, in megabytes)
+            - raster_cache_size (optional, in megabytes)
+            - decoded_cache_folder (optional)
+            - decoded_cache_size (optional, in megabytes)
+            - decoded_cache_max_age (optional, in hours)
+
+          Tags of a specific service are applied by the service when the ServiceManager::serviceUpdated signal is emitted.
         */
         void updateService(const QJsonObject& obj);
         /*!
           \brief Get the status of the service.
 
           This method will return a JSon object with the running service information.
-          This will include the ServiceInstanceId, name, the Date/Time when the service was started and the version of the service.
+          This will include the ServiceInstanceId, name, the Date/Time when the service was started and the version of the service,
+          and the statistics of the raster block cache.
         */
         virtual QJsonObject status() const;
 
@@ -120,6 +138,8 @@ namespace terrama2
         void listeningPortUpdated(int);
         void numberOfThreadsUpdated(size_t);
         void logConnectionInfoUpdated(const std::map<std::string, std::string>&);
+        //! Signal emited after the service information is updated, with all tags received.
+        void serviceUpdated(const QJsonObject&);
 
       protected:
         friend class te::common::Singleton<ServiceManager>;
@@ -138,6 +158,7 @@ namespace terrama2
         std::string serviceType_;
         int listeningPort_ = 0;
         int numberOfThreads_ = 0;
+        std::string dataFolder_;
         std::shared_ptr< te::dt::TimeInstantTZ > startTime_;
         bool serviceLoaded_ = false;
         std::map<std::string, std::string> connInfo_;
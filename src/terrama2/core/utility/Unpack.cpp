@@ -49,6 +49,14 @@
 #include <string.h>
 #include <cstddef>
 #include <sys/stat.h>
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <vector>
 
 // QT
 #include <QFileInfo>
@@ -60,6 +68,9 @@
 #include <QLocale>
 #include <QFile>
 #include <QByteArray>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDirIterator>
 
 // Quazip
 #include <quazip.h>
@@ -75,12 +86,152 @@
 #include <boost/iostreams/filter/bzip2.hpp>
 
 
+namespace
+{
+  //! Synchronizes the access to the unpack cache.
+  std::mutex cacheMutex;
+  //! Notifies the end of an extraction.
+  std::condition_variable extractionDone;
+  //! Folder of the unpack cache.
+  QString cacheFolder = QDir::temp().absoluteFilePath("terrama2-unpack");
+  //! Maximum size of the unpack cache, in bytes.
+  qint64 cacheMaxSize = 2LL*1024*1024*1024;
+  //! Maximum time, in seconds, a folder is kept in the cache without being used.
+  qint64 cacheMaxAge = 7*24*60*60;
+  //! Estimated size of the cache, in bytes, negative until the cache is scanned.
+  qint64 cacheSize = -1;
+  //! Last time the cache was scanned.
+  QDateTime lastPrune;
+  //! Number of references to each folder in use, folders in use are not removed.
+  std::map<QString, int> pinnedFolders;
+  //! Folders being extracted, a folder is extracted by one call at a time.
+  std::set<QString> extractingFolders;
+
+  //! Minimum interval, in seconds, between the scans of the cache for old folders.
+  const qint64 PRUNE_INTERVAL = 10*60;
+
+  //! Hashes of the files already read: path -> (size, last modification, hash)
+  std::map<QString, std::tuple<qint64, qint64, QByteArray> > hashes;
+  //! Paths of the hashes in insertion order, the oldest are forgotten when the limit is reached.
+  std::deque<QString> hashesOrder;
+  std::mutex hashesMutex;
+  //! Maximum number of hashes kept in memory.
+  const std::size_t MAX_HASHES = 10000;
+
+  //! Marks the files of a completely unpacked gz, bz2 or tar file.
+  const QString COMPLETE_MARKER = ".complete";
+  //! The modification time is the last time the folder was used.
+  const QString USED_MARKER = ".used";
+  //! Prefix of the folders being extracted.
+  const QString EXTRACTING_PREFIX = "unpack-";
+
+  void touch(const QString& path)
+  {
+    QFile file(path);
+    if(file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+      file.write(QDateTime::currentDateTimeUtc().toString(Qt::ISODate).toUtf8());
+  }
+
+  //! Moves the entries of the folder, subfolders that already exist are merged.
+  void moveEntries(const QString& from, const QString& to)
+  {
+    QDir().mkpath(to);
+
+    QDir fromDir(from);
+    for(const auto& entry : fromDir.entryInfoList(QDir::AllEntries | QDir::Hidden | QDir::NoDotAndDotDot))
+    {
+      QString target = to + "/" + entry.fileName();
+      if(entry.isDir() && QFileInfo(target).isDir())
+      {
+        moveEntries(entry.absoluteFilePath(), target);
+        continue;
+      }
+
+      QFile::remove(target);
+      if(!QDir().rename(entry.absoluteFilePath(), target))
+        TERRAMA2_LOG_ERROR() << QObject::tr("Could not move unpacked file %1.").arg(entry.absoluteFilePath());
+    }
+  }
+
+  //! Size, in bytes, of the files of the folder.
+  qint64 folderSize(const QString& folder)
+  {
+    qint64 size = 0;
+    QDirIterator it(folder, QDir::Files | QDir::Hidden, QDirIterator::Subdirectories);
+    while(it.hasNext())
+    {
+      it.next();
+      size += it.fileInfo().size();
+    }
+
+    return size;
+  }
+
+  /*!
+    \brief Removes the folders not used for longer than the maximum age,
+    and the least recently used folders until the cache respects its maximum size.
+
+    Folders in use are kept. Must be called with the cache mutex locked.
+  */
+  void pruneCache()
+  {
+    QDir dir(cacheFolder);
+    QDateTime now = QDateTime::currentDateTimeUtc();
+    std::vector<std::tuple<QDateTime, QString, qint64> > folders;
+    qint64 totalSize = 0;
+    for(const auto& entry : dir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot))
+    {
+      // folders being extracted
+      if(entry.fileName().startsWith(EXTRACTING_PREFIX))
+        continue;
+
+      qint64 size = folderSize(entry.absoluteFilePath());
+      totalSize += size;
+
+      if(pinnedFolders.find(entry.absoluteFilePath()) != pinnedFolders.end())
+        continue;
+
+      folders.emplace_back(QFileInfo(entry.absoluteFilePath()+"/"+USED_MARKER).lastModified().toUTC(), entry.absoluteFilePath(), size);
+    }
+
+    // least recently used first
+    std::sort(folders.begin(), folders.end());
+    for(const auto& folder : folders)
+    {
+      bool expired = std::get<0>(folder).secsTo(now) > cacheMaxAge;
+      if(!expired && totalSize <= cacheMaxSize)
+        break;
+
+      if(QDir(std::get<1>(folder)).removeRecursively())
+        totalSize -= std::get<2>(folder);
+    }
+
+    cacheSize = totalSize;
+    lastPrune = now;
+  }
+}
+
+terrama2::core::Unpack::CacheFolder::CacheFolder(const std::string& path)
+  : path_(path)
+{
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  ++pinnedFolders[QString::fromStdString(path_)];
+}
+
+terrama2::core::Unpack::CacheFolder::~CacheFolder()
+{
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  auto it = pinnedFolders.find(QString::fromStdString(path_));
+  if(it != pinnedFolders.end() && --it->second <= 0)
+    pinnedFolders.erase(it);
+}
+
 QString terrama2::core::Unpack::uncompressGz(QFileInfo fileInfo, QString temporaryFolder)
 {
   QString saveName = temporaryFolder+"/"+nameFileUncompressed(fileInfo);
 
-  std::ifstream inFile(fileInfo.absoluteFilePath().toStdString(), std::ios_base::in);
-  std::ofstream outFile(saveName.toStdString(), std::ios_base::out);
+  std::ifstream inFile(fileInfo.absoluteFilePath().toStdString(), std::ios_base::in | std::ios_base::binary);
+  std::ofstream outFile(saveName.toStdString(), std::ios_base::out | std::ios_base::binary);
   boost::iostreams::filtering_streambuf< boost::iostreams::input> inStreamBuff;
   inStreamBuff.push( boost::iostreams::gzip_decompressor());
   inStreamBuff.push( inFile );
@@ -93,8 +244,8 @@ QString terrama2::core::Unpack::uncompressBzip(QFileInfo fileInfo, QString tempo
 {
   QString saveName = temporaryFolder+"/"+nameFileUncompressed(fileInfo);
 
-  std::ifstream inFile(fileInfo.absoluteFilePath().toStdString(), std::ios_base::in);
-  std::ofstream outFile(saveName.toStdString(), std::ios_base::out);
+  std::ifstream inFile(fileInfo.absoluteFilePath().toStdString(), std::ios_base::in | std::ios_base::binary);
+  std::ofstream outFile(saveName.toStdString(), std::ios_base::out | std::ios_base::binary);
   boost::iostreams::filtering_streambuf< boost::iostreams::input> inStreamBuff;
   inStreamBuff.push(boost::iostreams::bzip2_decompressor());
   inStreamBuff.push(inFile);
@@ -103,9 +254,43 @@ QString terrama2::core::Unpack::uncompressBzip(QFileInfo fileInfo, QString tempo
   return saveName;
 }
 
-void terrama2::core::Unpack::uncompressZip(QFileInfo fileInfo, QString temporaryFolder)
+void terrama2::core::Unpack::uncompressZip(QFileInfo fileInfo, QString temporaryFolder, const MemberFilter& memberFilter)
 {
-  JlCompress::extractDir(fileInfo.absoluteFilePath(), temporaryFolder);
+  // only the accepted members not yet extracted are extracted
+  QStringList members;
+  for(const auto& member : JlCompress::getFileList(fileInfo.absoluteFilePath()))
+  {
+    if(member.endsWith("/"))
+      continue;
+
+    if(memberFilter && !memberFilter(QFileInfo(member).fileName().toStdString()))
+      continue;
+
+    if(!QFileInfo::exists(temporaryFolder+"/"+member))
+      members.push_back(member);
+  }
+
+  if(members.isEmpty())
+    return;
+
+  // extracted to a temporary folder and then moved,
+  // so a partially extracted member is never used
+  // next to the folder, so the members are moved in the same file system
+  QTemporaryDir extractDir(QFileInfo(temporaryFolder).absolutePath()+"/"+EXTRACTING_PREFIX+"XXXXXX");
+  if(!extractDir.isValid())
+  {
+    QString errMsg = QObject::tr("Could not create a temporary folder to extract %1.").arg(fileInfo.absoluteFilePath());
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw UtilityException() << ErrorDescription(errMsg);
+  }
+  QStringList extracted = JlCompress::extractFiles(fileInfo.absoluteFilePath(), members, extractDir.path());
+  if(extracted.size() != members.size())
+  {
+    QString errMsg = QObject::tr("Could not extract all files of %1.").arg(fileInfo.absoluteFilePath());
+    TERRAMA2_LOG_ERROR() << errMsg;
+  }
+
+  moveEntries(extractDir.path(), temporaryFolder);
 }
 
 bool terrama2::core::Unpack::verifyCompressFile(std::string uri)
@@ -120,44 +305,89 @@ bool terrama2::core::Unpack::verifyCompressFile(std::string uri)
 
 }
 
-std::string terrama2::core::Unpack::unpackList(std::string uri)
+terrama2::core::Unpack::CacheFolderPtr terrama2::core::Unpack::unpackList(std::string uri, const MemberFilter& memberFilter)
 {
+  QUrl url(uri.c_str());
+  QFileInfo fileInfo(url.path());
 
-  QString temporaryFolder = "/tmp/terrama2-unpack";
+  QString cache;
+  {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    cache = cacheFolder;
+  }
 
   // Create the directory where you will download the files.
-  QDir dir(temporaryFolder);
+  QDir dir(cache);
   if (!dir.exists())
-    dir.mkpath(temporaryFolder);
+    dir.mkpath(cache);
 
+  QByteArray hash = contentHash(fileInfo);
+  if(hash.isEmpty())
+  {
+    QString errMsg = QObject::tr("Could not read file %1.").arg(fileInfo.absoluteFilePath());
+    TERRAMA2_LOG_ERROR() << errMsg;
+    // empty folder, no files unpacked
+    return std::make_shared<CacheFolder>(dir.absoluteFilePath("unreadable").toStdString());
+  }
+
+  QString folder = dir.absoluteFilePath(QString(hash.toHex()));
+  // the folder is not removed from the cache while it's in use
+  auto cacheFolderPtr = std::make_shared<CacheFolder>(folder.toStdString());
+  {
+    std::unique_lock<std::mutex> lock(cacheMutex);
+    extractionDone.wait(lock, [&folder]() { return extractingFolders.find(folder) == extractingFolders.end(); });
+    extractingFolders.insert(folder);
+  }
+
+  // the cache is not locked while extracting, only calls with the same file wait
+  qint64 previousSize = folderSize(folder);
   try
   {
-    QUrl url(uri.c_str());
-    QFileInfo fileInfo(url.path());
     QString filePath = fileInfo.absoluteFilePath();
 
-    if (isGzipCompress(filePath))
+    if (isZipCompress(filePath))
     {
-      filePath = uncompressGz(fileInfo, temporaryFolder);
-      fileInfo.setFile(filePath);
+      uncompressZip(fileInfo, folder, memberFilter);
     }
-
-    if (isBzipCompress(filePath))
+    else if(!QFileInfo::exists(folder+"/"+COMPLETE_MARKER))
     {
-      filePath = uncompressBzip(fileInfo, temporaryFolder);
-      fileInfo.setFile(filePath);
-    }
+      // each call unpacks in its own folder
+      QTemporaryDir temporaryDir(dir.absoluteFilePath(EXTRACTING_PREFIX+"XXXXXX"));
+      if(!temporaryDir.isValid())
+      {
+        QString errMsg = QObject::tr("Could not create a temporary folder to unpack %1.").arg(fileInfo.absoluteFilePath());
+        TERRAMA2_LOG_ERROR() << errMsg;
+        throw UtilityException() << ErrorDescription(errMsg);
+      }
+      QString temporaryFolder = temporaryDir.path();
 
-    if (isZipCompress(filePath))
-    {
-      uncompressZip(fileInfo, temporaryFolder);
-    }
+      if (isGzipCompress(filePath))
+      {
+        filePath = uncompressGz(fileInfo, temporaryFolder);
+        fileInfo.setFile(filePath);
+      }
 
-    if (isTarCompress(filePath))
-    {
-      untar(fileInfo, temporaryFolder);
-    }
+      if (isBzipCompress(filePath))
+      {
+        filePath = uncompressBzip(fileInfo, temporaryFolder);
+        fileInfo.setFile(filePath);
+      }
+
+      if (isZipCompress(filePath))
+      {
+        JlCompress::extractDir(fileInfo.absoluteFilePath(), temporaryFolder);
+        QFile::remove(filePath);
+      }
 
+      if (isTarCompress(filePath))
+      {
+        untar(fileInfo, temporaryFolder);
+        QFile::remove(filePath);
+      }
+
+      touch(temporaryFolder+"/"+COMPLETE_MARKER);
+      moveEntries(temporaryFolder, folder);
+    }
   }
   catch(const terrama2::Exception&)
   {
@@ -171,8 +401,85 @@ std::string terrama2::core::Unpack::unpackList(std::string uri)
   {
     TERRAMA2_LOG_ERROR() << e.what();
   }
+  catch(...)
+  {
+    TERRAMA2_LOG_ERROR() << QObject::tr("Unknown exception unpacking %1.").arg(fileInfo.absoluteFilePath());
+  }
+
+  QDir().mkpath(folder);
+  touch(folder+"/"+USED_MARKER);
+  qint64 addedSize = folderSize(folder) - previousSize;
+
+  {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    extractingFolders.erase(folder);
+
+    // the cache is scanned only when it may be full or old folders may have expired
+    if(cacheSize >= 0)
+      cacheSize += addedSize;
+    if(cacheSize < 0 || cacheSize > cacheMaxSize || !lastPrune.isValid() || lastPrune.secsTo(QDateTime::currentDateTimeUtc()) > PRUNE_INTERVAL)
+      pruneCache();
+  }
+  extractionDone.notify_all();
+
+  return cacheFolderPtr;
+}
+
+void terrama2::core::Unpack::setCacheFolder(const std::string& folder)
+{
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  cacheFolder = QString::fromStdString(folder);
+  // the new folder is scanned on the next use
+  cacheSize = -1;
+}
+
+void terrama2::core::Unpack::setCacheMaxSize(qint64 maxSize)
+{
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  cacheMaxSize = maxSize;
+}
+
+void terrama2::core::Unpack::setCacheMaxAge(qint64 maxAge)
+{
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  cacheMaxAge = maxAge;
+}
+
+QByteArray terrama2::core::Unpack::contentHash(const QFileInfo& fileInfo)
+{
+  QString path = fileInfo.absoluteFilePath();
+  qint64 size = fileInfo.size();
+  qint64 lastModified = fileInfo.lastModified().toMSecsSinceEpoch();
+  {
+    std::lock_guard<std::mutex> lock(hashesMutex);
+    auto it = hashes.find(path);
+    if(it != hashes.end() && std::get<0>(it->second) == size && std::get<1>(it->second) == lastModified)
+      return std::get<2>(it->second);
+  }
+
+  QFile file(path);
+  if(!file.open(QIODevice::ReadOnly))
+    return QByteArray();
+
+  QCryptographicHash hash(QCryptographicHash::Md5);
+  if(!hash.addData(&file))
+    return QByteArray();
+
+  QByteArray result = hash.result();
+
+  std::lock_guard<std::mutex> lock(hashesMutex);
+  if(hashes.find(path) == hashes.end())
+  {
+    hashesOrder.push_back(path);
+    if(hashesOrder.size() > MAX_HASHES)
+    {
+      hashes.erase(hashesOrder.front());
+      hashesOrder.pop_front();
+    }
+  }
 
-  return temporaryFolder.toStdString();
+  hashes[path] = std::make_tuple(size, lastModified, result);
+  return result;
 }
 
 bool terrama2::core::Unpack::isGzipCompress(const QFileInfo fileinfo)
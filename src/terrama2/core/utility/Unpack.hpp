@@ -32,12 +32,16 @@
 
 // STL
 #include <cstdlib>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <string>
 
 //Boost
 #include <boost/noncopyable.hpp>
 
 // QT
+#include <QByteArray>
 #include <QFileInfo>
 
 namespace terrama2
@@ -46,16 +50,68 @@ namespace terrama2
   {
     /*!
        \brief This class is responsible for decompressing files with  gz, zip, bz2, tar, tar (tar.gz, tar.bz2) extension.
+
+       Files are unpacked to a cache folder identified by the content hash of the compressed file,
+       so a compressed file is unpacked only once, the least recently used folders are removed
+       when the cache exceeds its maximum size and folders not used for longer than the maximum age are removed.
+       Folders in use are never removed.
    */
 
     namespace Unpack
     {
+      //! Filter of the members extracted from a zip file, receives the file name of the member.
+      typedef std::function<bool(const std::string& fileName)> MemberFilter;
+
+      /*!
+        \brief Folder of the unpack cache in use.
+
+        The folder is not removed from the cache while a reference exists,
+        the reference must be kept while the unpacked files are read.
+      */
+      class CacheFolder : private boost::noncopyable
+      {
+        public:
+          explicit CacheFolder(const std::string& path);
+          ~CacheFolder();
+
+          //! Absolute path of the folder.
+          const std::string& path() const { return path_; }
+
+        private:
+          std::string path_;
+      };
+
+      typedef std::shared_ptr<CacheFolder> CacheFolderPtr;
+
       /*!
          * \brief unpackList - the descompressing a file gz, zip, bz2, tar, tar (tar.gz, tar.bz2) extension.
+         *
+         * If the file was already unpacked the cached files are used.
+         * Calls with different files unpack concurrently.
+         *
          * \param uri - It contains absolute file path.
-         * \param Returns the path of the temporary folder where the files uncompressed.
+         * \param memberFilter - If set, only the zip members accepted are extracted.
+         * \param Returns the cache folder with the files uncompressed, kept in the cache while referenced.
          */
-      std::string unpackList(std::string uri);
+      CacheFolderPtr unpackList(std::string uri, const MemberFilter& memberFilter = MemberFilter());
+
+      //! Sets the folder of the unpack cache, by default terrama2-unpack in the system temporary folder.
+      void setCacheFolder(const std::string& folder);
+
+      //! Sets the maximum size, in bytes, of the unpack cache.
+      void setCacheMaxSize(qint64 maxSize);
+
+      //! Sets the maximum time, in seconds, a folder is kept in the cache without being used.
+      void setCacheMaxAge(qint64 maxAge);
+
+      /*!
+         * \brief contentHash - MD5 hash of the file content.
+         *
+         * The hash is kept in memory, files with the same size and modification time are not read again.
+         *
+         * \return Returns the hash or an empty array if the file can't be read.
+         */
+      QByteArray contentHash(const QFileInfo& fileInfo);
 
       /*!
          * \brief verifyCompressFile - checks if the file is compressed or not.
@@ -152,11 +208,14 @@ namespace terrama2
       QString uncompressBzip(QFileInfo fileInfo, QString temporaryFolder);
       /*!
          * \brief uncompressZip - Uncompress a Zip file.
-         * \param saveName - It contains the absolute path where the file uncompressed is saved.
-         * \param fileName - It contains the absolute path of file compressed.
          *
+         * Members already extracted to the folder are not extracted again.
+         *
+         * \param fileInfo - Compressed file.
+         * \param temporaryFolder - Folder where the members are extracted.
+         * \param memberFilter - If set, only the members accepted are extracted.
          */
-      void uncompressZip(QFileInfo fileInfo, QString temporaryFolder);
+      void uncompressZip(QFileInfo fileInfo, QString temporaryFolder, const MemberFilter& memberFilter = MemberFilter());
     }
   } // end namespace core
 }   // end namespace terrama2
@@ -50,8 +50,15 @@
 #include <terralib/srs/SpatialReferenceSystem.h>
 #include <terralib/geometry/WKTReader.h>
 
+#include <algorithm>
+#include <atomic>
 #include <ctime>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 // Boost
 #include <boost/filesystem.hpp>
@@ -77,6 +84,43 @@ namespace te
   } // end of namespace common
 } // end of namespace te
 
+namespace
+{
+  std::mutex parallelForMutex;
+  std::size_t parallelForHelpers = 0; //!< Helper threads running in all parallelFor calls.
+
+  //! Maximum number of helper threads of all parallelFor calls.
+  std::size_t& maxParallelForHelpers()
+  {
+    static std::size_t maxHelpers = std::max(std::thread::hardware_concurrency(), 1u);
+    return maxHelpers;
+  }
+
+  //! Reserves up to \e wanted helper threads, released on destruction.
+  class ParallelForHelpers
+  {
+    public:
+      explicit ParallelForHelpers(std::size_t wanted)
+      {
+        std::lock_guard<std::mutex> lock(parallelForMutex);
+        std::size_t maxHelpers = maxParallelForHelpers();
+        reserved_ = parallelForHelpers < maxHelpers ? std::min(wanted, maxHelpers - parallelForHelpers) : 0;
+        parallelForHelpers += reserved_;
+      }
+
+      ~ParallelForHelpers()
+      {
+        std::lock_guard<std::mutex> lock(parallelForMutex);
+        parallelForHelpers -= reserved_;
+      }
+
+      std::size_t reserved() const { return reserved_; }
+
+    private:
+      std::size_t reserved_ = 0;
+  };
+}
+
 std::string terrama2::core::FindInTerraMA2Path(const std::string& fileName)
 {
   // 1st: look in the neighborhood of the executable
@@ -400,3 +444,69 @@ void terrama2::core::simplifyString(std::string& text)
   text.erase(std::remove_if(text.begin(), text.end(), [](char x){return !(std::isalnum(x) || x == ' ');}), text.end());
   std::replace(text.begin(), text.end(), ' ', '_');
 }
+
+void terrama2::core::setParallelForThreads(std::size_t numberOfThreads)
+{
+  if(numberOfThreads == 0)
+    numberOfThreads = std::thread::hardware_concurrency();
+
+  std::lock_guard<std::mutex> lock(parallelForMutex);
+  maxParallelForHelpers() = std::max(numberOfThreads, static_cast<std::size_t>(1));
+}
+
+void terrama2::core::parallelFor(std::size_t size, std::size_t numberOfThreads, const std::function<void(std::size_t)>& task)
+{
+  // true in threads executing tasks
+  static thread_local bool insideTask = false;
+
+  if(numberOfThreads == 0)
+    numberOfThreads = std::thread::hardware_concurrency();
+  numberOfThreads = std::min(numberOfThreads, size);
+
+  if(numberOfThreads <= 1 || insideTask)
+  {
+    for(std::size_t i = 0; i < size; ++i)
+      task(i);
+
+    return;
+  }
+
+  std::atomic<std::size_t> next(0);
+  std::vector<std::exception_ptr> exceptions(size);
+  auto worker = [&]()
+  {
+    insideTask = true;
+    for(std::size_t i = next++; i < size; i = next++)
+    {
+      try
+      {
+        task(i);
+      }
+      catch(...)
+      {
+        exceptions[i] = std::current_exception();
+      }
+    }
+    insideTask = false;
+  };
+
+  // helper threads are shared by all calls of the process,
+  // if none is available the calling thread executes all tasks
+  ParallelForHelpers helpers(numberOfThreads - 1);
+
+  std::vector<std::future<void> > futures;
+  for(std::size_t i = 0; i < helpers.reserved(); ++i)
+    futures.push_back(std::async(std::launch::async, worker));
+
+  // the calling thread also executes tasks
+  worker();
+
+  for(auto& future : futures)
+    future.get();
+
+  for(const auto& exception : exceptions)
+  {
+    if(exception)
+      std::rethrow_exception(exception);
+  }
+}
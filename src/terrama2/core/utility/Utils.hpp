@@ -37,6 +37,7 @@
 #include "../data-model/Filter.hpp"
 
 // STL
+#include <functional>
 #include <string>
 
 // Forward declaration
@@ -134,6 +135,26 @@ namespace terrama2
       Spaces are replaced by "_".
     */
     void simplifyString(std::string& text);
+
+    /*!
+      \brief Executes task(i) for every i in [0, size) using at most numberOfThreads threads.
+
+      If numberOfThreads is 0 the number of cores is used.
+      The calling thread executes tasks with helper threads shared by all calls of the process,
+      limited by setParallelForThreads(), if none is available the calling thread executes all tasks.
+      Nested calls are executed in the calling thread, so the number of threads stays bounded.
+
+      \exception Any exception thrown by the tasks is re-thrown after all tasks are finished,
+                 if more than one task fails, the exception of the lowest index is re-thrown.
+    */
+    void parallelFor(std::size_t size, std::size_t numberOfThreads, const std::function<void(std::size_t)>& task);
+
+    /*!
+      \brief Sets the maximum number of helper threads running in all parallelFor calls of the process.
+
+      If numberOfThreads is 0 the number of cores is used, the default.
+    */
+    void setParallelForThreads(std::size_t numberOfThreads);
   } // end namespace core
 }   // end namespace terrama2
 
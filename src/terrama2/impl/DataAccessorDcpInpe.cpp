@@ -32,6 +32,7 @@
 #include "../core/data-access/DataRetriever.hpp"
 #include "../core/utility/Raii.hpp"
 #include "../core/utility/FilterUtils.hpp"
+#include "../core/utility/CsvParser.hpp"
 
 //terralib
 #include <terralib/dataaccess/datasource/DataSourceFactory.h>
@@ -156,6 +157,50 @@ void terrama2::core::DataAccessorDcpInpe::addColumns(std::shared_ptr<te::da::Dat
   // the converter will add columns
 }
 
+std::shared_ptr<te::da::DataSet> terrama2::core::DataAccessorDcpInpe::readFile(DataSetPtr dataSet,
+                                                                               const std::string& filePath,
+                                                                               std::shared_ptr<te::da::DataSetType>& dataSetType,
+                                                                               FileCatalog::ReadPosition& position) const
+{
+  std::string timestampProperty = getTimestampPropertyName(dataSet);
+
+  CsvParser::Format format;
+  format.timestampFormat = "%m/%d/%Y %H:%M:%S";
+  format.timezone = getTimeZone(dataSet);
+  // with a catalog the datalogger may be writing the last line,
+  // it's read in the next collection from the stored position,
+  // or completely if the file didn't change since then
+  format.completeLinesOnly = fileCatalog_ && !position.finished;
+  format.column = [timestampProperty](const std::string& header)
+  {
+    CsvParser::Column column;
+    if(header == timestampProperty)
+    {
+      column.name = "DateTime";
+      column.type = CsvParser::ColumnType::TIMESTAMP;
+    }
+    else
+    {
+      // DCP-INPE dataset columns have the name of the dcp before every column,
+      // remove the name and keep only the column name
+      column.name = header;
+      size_t dotPos = column.name.find('.');
+      if(dotPos != std::string::npos)
+        column.name.erase(0, dotPos + 1);
+
+      column.type = CsvParser::ColumnType::DOUBLE;
+    }
+
+    return column;
+  };
+
+  CsvParser parser(format);
+  auto result = parser.parse(filePath, CsvParser::toPosition(position));
+  dataSetType = result.dataSetType;
+  position = CsvParser::toReadPosition(result.end);
+  return result.dataSet;
+}
+
 terrama2::core::DataAccessorPtr terrama2::core::DataAccessorDcpInpe::make(DataProviderPtr dataProvider, DataSeriesPtr dataSeries, const Filter& filter)
 {
   return std::make_shared<DataAccessorDcpInpe>(dataProvider, dataSeries, filter);
@@ -61,6 +61,10 @@ namespace terrama2
       virtual void adapt(DataSetPtr dataset, std::shared_ptr<te::da::DataSetTypeConverter> converter) const override;
       virtual void addColumns(std::shared_ptr<te::da::DataSetTypeConverter> converter, const std::shared_ptr<te::da::DataSetType>& datasetType) const override;
 
+      //! Reads the DCP-INPE file with the native CSV parser, only the lines appended after the position are read.
+      virtual std::shared_ptr<te::da::DataSet> readFile(DataSetPtr dataSet, const std::string& filePath, std::shared_ptr<te::da::DataSetType>& dataSetType,
+                                                        FileCatalog::ReadPosition& position) const override;
+
     private:
       /*!
         \brief Convert string to TimeInstantTZ.
@@ -33,6 +33,7 @@
 #include "../core/utility/Raii.hpp"
 #include "../core/utility/Utils.hpp"
 #include "../core/utility/FilterUtils.hpp"
+#include "../core/utility/CsvParser.hpp"
 
 //Terralib
 #include <terralib/dataaccess/datasource/DataSourceFactory.h>
@@ -49,9 +50,6 @@
 #include <QUrl>
 #include <QFileInfoList>
 #include <QDebug>
-#include <QTemporaryFile>
-#include <QTemporaryDir>
-#include <QTextStream>
 
 
 terrama2::core::DataAccessorDcpToa5::DataAccessorDcpToa5(DataProviderPtr dataProvider, DataSeriesPtr dataSeries, const Filter& filter)
@@ -174,64 +172,49 @@ void terrama2::core::DataAccessorDcpToa5::addColumns(std::shared_ptr<te::da::Dat
   // the converter will add columns
 }
 
-terrama2::core::DataSetSeries terrama2::core::DataAccessorDcpToa5::getSeries(const std::string& uri,
-                                                                   const terrama2::core::Filter& filter,
-                                                                   terrama2::core::DataSetPtr dataSet) const
-
+std::shared_ptr<te::da::DataSet> terrama2::core::DataAccessorDcpToa5::readFile(DataSetPtr dataSet,
+                                                                               const std::string& filePath,
+                                                                               std::shared_ptr<te::da::DataSetType>& dataSetType,
+                                                                               FileCatalog::ReadPosition& position) const
 {
-  std::string mask = getMask(dataSet);
-  std::string folder = getFolder(dataSet);
-
-  QTemporaryDir tempBaseDir;
-  if(!tempBaseDir.isValid())
-  {
-    QString errMsg = QObject::tr("Can't create temporary folder.");
-    TERRAMA2_LOG_ERROR() << errMsg;
-    throw DataAccessException() << ErrorDescription(errMsg);
-  }
-
-  QDir tempDir(tempBaseDir.path());
-  tempDir.mkdir(QString::fromStdString(folder));
-  tempDir.cd(QString::fromStdString(folder));
-
-  QUrl url((uri+"/"+folder+"/"+mask).c_str());
-  QFileInfo originalInfo(url.path());
-
-  QFile file(url.path());
-  QFile tempFile(tempDir.path()+"/"+originalInfo.fileName());
-  if(!file.open(QIODevice::ReadOnly))
-  {
-    QString errMsg = QObject::tr("Can't open file: dataset %1.").arg(dataSet->id);
-    TERRAMA2_LOG_ERROR() << errMsg;
-    throw DataAccessException() << ErrorDescription(errMsg);
-  }
-
-  if(!tempFile.open(QIODevice::ReadWrite))
-  {
-    QString errMsg = QObject::tr("Can't open temporary file: dataset %1.").arg(dataSet->id);
-    TERRAMA2_LOG_ERROR() << errMsg;
-    throw DataAccessException() << ErrorDescription(errMsg);
-  }
-
-  file.readLine();//ignore first line
-  tempFile.write(file.readLine()); //headers line
+  std::string recordProperty = getRecordPropertyName(dataSet);
+  std::string stationProperty = getStationPropertyName(dataSet);
+  std::string timestampProperty = getTimestampPropertyName(dataSet);
 
+  CsvParser::Format format;
+  //ignore first line, headers on the second line
+  format.headerLine = 1;
   //ignore third and fourth lines
-  file.readLine();
-  file.readLine();
-
-  //read all file
-  tempFile.write(file.readAll()); //headers line
-
-  //update file path
-  std::string tempUri = "file://"+tempBaseDir.path().toStdString();
-
-  file.close();
-  tempFile.close();
+  format.ignoredLines = 2;
+  format.timezone = getTimeZone(dataSet);
+  // with a catalog the datalogger may be writing the last line,
+  // it's read in the next collection from the stored position,
+  // or completely if the file didn't change since then
+  format.completeLinesOnly = fileCatalog_ && !position.finished;
+  format.column = [recordProperty, stationProperty, timestampProperty](const std::string& header)
+  {
+    CsvParser::Column column;
+    column.name = header;
+    if(header == recordProperty)
+      column.type = CsvParser::ColumnType::INT32;
+    else if(header == stationProperty)
+      column.type = CsvParser::ColumnType::STRING;
+    else if(header == timestampProperty)
+    {
+      column.name = "DateTime";
+      column.type = CsvParser::ColumnType::TIMESTAMP;
+    }
+    else
+      column.type = CsvParser::ColumnType::DOUBLE;
 
-  auto dataSeries = terrama2::core::DataAccessorFile::getSeries(tempUri, filter, dataSet);
+    return column;
+  };
 
-  return dataSeries;
+  CsvParser parser(format);
+  auto result = parser.parse(filePath, CsvParser::toPosition(position));
+  dataSetType = result.dataSetType;
+  position = CsvParser::toReadPosition(result.end);
+  return result.dataSet;
 }
 
 terrama2::core::DataAccessorPtr terrama2::core::DataAccessorDcpToa5::make(DataProviderPtr dataProvider, DataSeriesPtr dataSeries, const Filter& filter)
@@ -99,12 +99,13 @@ namespace terrama2
         virtual void addColumns(std::shared_ptr<te::da::DataSetTypeConverter> converter, const std::shared_ptr<te::da::DataSetType>& datasetType) const override;
 
         /*!
-         * \brief getDataSet Get a memory dataset do core::DataSet.
-         * \param uri Uri to the dataset;
-         * \param filter Filter applyed to the dataset;
-         * \param dataSet It contains description of a dataset. Ex. information of DCP-TOA5;
+         * \brief readFile Reads the TOA5 file with the native CSV parser.
+         *
+         * The header is the second line of the file, the third and fourth lines (units and processing) are ignored.
+         * Dataloggers append lines to the file, only the lines after the position are read.
          */
-        virtual DataSetSeries getSeries(const std::string& uri, const Filter& filter, DataSetPtr dataSet) const override;
+        virtual std::shared_ptr<te::da::DataSet> readFile(DataSetPtr dataSet, const std::string& filePath, std::shared_ptr<te::da::DataSetType>& dataSetType,
+                                                          FileCatalog::ReadPosition& position) const override;
 
       private:
 
@@ -28,9 +28,11 @@
  */
 
 #include "DataAccessorFile.hpp"
+#include "../core/utility/FileCatalog.hpp"
 #include "../core/utility/FilterUtils.hpp"
 #include "../core/utility/TimeUtils.hpp"
 #include "../core/utility/Logger.hpp"
+#include "../core/utility/MaskMatcher.hpp"
 #include "../core/utility/Raii.hpp"
 #include "../core/utility/Utils.hpp"
 #include "../core/utility/Unpack.hpp"
@@ -39,10 +41,14 @@
 //STL
 #include <algorithm>
 #include <limits>
+#include <vector>
 
 //QT
 #include <QUrl>
+#include <QCryptographicHash>
+#include <QDateTime>
 #include <QDir>
+#include <QFileInfo>
 
 //terralib
 #include <terralib/dataaccess/datasource/DataSourceFactory.h>
@@ -52,6 +58,7 @@
 #include <terralib/dataaccess/utils/Utils.h>
 #include <terralib/datatype/DateTimeProperty.h>
 #include <terralib/memory/DataSetItem.h>
+#include <terralib/raster/Raster.h>
 
 
 std::string terrama2::core::DataAccessorFile::getMask(DataSetPtr dataSet) const
@@ -79,106 +86,84 @@ std::shared_ptr<te::da::DataSet> terrama2::core::DataAccessorFile::createComplet
   return std::make_shared<te::mem::DataSet>(dataSetType.get());
 }
 
-void terrama2::core::DataAccessorFile::filterDataSet(std::shared_ptr<te::da::DataSet> completeDataSet, const Filter& filter) const
+terrama2::core::DataAccessorFile::FilterColumns terrama2::core::DataAccessorFile::getFilterColumns(std::shared_ptr<te::da::DataSet> dataSet) const
 {
-  auto dataSet = std::dynamic_pointer_cast<te::mem::DataSet>(completeDataSet);
+  FilterColumns columns;
   size_t propertiesNumber = dataSet->getNumProperties();
-
-  size_t dateColumn = std::numeric_limits<size_t>::max();
-  size_t geomColumn = std::numeric_limits<size_t>::max();
-  size_t rasterColumn = std::numeric_limits<size_t>::max();
   for(size_t i = 0; i < propertiesNumber; ++i)
   {
-    if(!isValidColumn(dateColumn) && dataSet->getPropertyDataType(i) == te::dt::DATETIME_TYPE)
-    {
-      dateColumn = i;
-      continue;
-    }
-
-    if(!isValidColumn(geomColumn) && dataSet->getPropertyDataType(i) == te::dt::GEOMETRY_TYPE)
-    {
-      geomColumn = i;
-      continue;
-    }
-
-    if(!isValidColumn(rasterColumn) && dataSet->getPropertyDataType(i) == te::dt::RASTER_TYPE)
-    {
-      geomColumn = i;
-      continue;
-    }
+    int type = dataSet->getPropertyDataType(i);
+    if(!isValidColumn(columns.dateColumn) && type == te::dt::DATETIME_TYPE)
+      columns.dateColumn = i;
+    else if(!isValidColumn(columns.geomColumn) && type == te::dt::GEOMETRY_TYPE)
+      columns.geomColumn = i;
+    else if(!isValidColumn(columns.rasterColumn) && type == te::dt::RASTER_TYPE)
+      columns.rasterColumn = i;
   }
 
-  size_t size = dataSet->size();
-  size_t i = 0;
+  return columns;
+}
 
-  while(i < size)
-  {
-    dataSet->move(i);
-    if(!isValidTimestamp(dataSet, filter, dateColumn)
-        || !isValidGeometry(dataSet, filter, geomColumn)
-        || !isValidRaster(dataSet, filter, rasterColumn))
-    {
-      dataSet->remove();
-      --size;
-      continue;
-    }
+bool terrama2::core::DataAccessorFile::hasRowFilter(const Filter& filter) const
+{
+  return filter.discardBefore.get() || filter.discardAfter.get() || filter.region.get();
+}
 
-    ++i;
-  }
+bool terrama2::core::DataAccessorFile::isValidRow(std::shared_ptr<te::da::DataSet> dataSet, const Filter& filter, const FilterColumns& columns) const
+{
+  std::unique_ptr<te::rst::Raster> raster;
+  return isValidTimestamp(dataSet, filter, columns.dateColumn)
+      && isValidGeometry(dataSet, filter, columns.geomColumn)
+      && isValidRaster(dataSet, filter, columns.rasterColumn, raster);
 }
 
 void terrama2::core::DataAccessorFile::filterDataSetByLastValue(std::shared_ptr<te::da::DataSet> completeDataSet,
     const Filter& filter,
     std::shared_ptr<te::dt::TimeInstantTZ> lastTimestamp) const
 {
-  if(!filter.lastValue)
+  if(!filter.lastValue || !lastTimestamp.get())
     return;
 
   auto dataSet = std::dynamic_pointer_cast<te::mem::DataSet>(completeDataSet);
-  auto propertiesNumber = dataSet->getNumProperties();
-
-  size_t dateColumn = std::numeric_limits<size_t>::max();
-  for(size_t i = 0; i < propertiesNumber; ++i)
-  {
-    if(!isValidColumn(dateColumn) && dataSet->getPropertyDataType(i) == te::dt::DATETIME_TYPE)
-    {
-      dateColumn = i;
-      continue;
-    }
-  }
-
+  size_t dateColumn = getFilterColumns(dataSet).dateColumn;
   if(!isValidColumn(dateColumn))
     return;
 
-  size_t size = dataSet->size();
-  size_t i = 0;
-
-  while(i < size)
+  // the rows kept are copied and the dataset is refilled,
+  // removing the rows one by one is quadratic
+  size_t propertiesNumber = dataSet->getNumProperties();
+  std::vector<std::unique_ptr<te::mem::DataSetItem> > items;
+  dataSet->moveBeforeFirst();
+  while(dataSet->moveNext())
   {
-    dataSet->move(i);
-
-    if(dataSet->isNull(dateColumn))
+    if(!dataSet->isNull(dateColumn))
+    {
+      std::unique_ptr<te::dt::DateTime> dateTime(dataSet->getDateTime(dateColumn));
+      auto timesIntant = dynamic_cast<te::dt::TimeInstantTZ*>(dateTime.get());
+      if(*timesIntant != *lastTimestamp)
+        continue;
+    }
+    else
     {
       QString errMsg = QObject::tr("Null date/time attribute.");
       TERRAMA2_LOG_WARNING() << errMsg;
-      ++i;
-      continue;
     }
 
-    std::shared_ptr< te::dt::DateTime > dateTime(dataSet->getDateTime(dateColumn));
-    auto timesIntant = std::dynamic_pointer_cast<te::dt::TimeInstantTZ>(dateTime);
-    if(*timesIntant != *lastTimestamp)
+    std::unique_ptr<te::mem::DataSetItem> item(new te::mem::DataSetItem(dataSet.get()));
+    for(size_t i = 0; i < propertiesNumber; ++i)
     {
-      dataSet->remove();
-      --size;
-      continue;
+      if(!dataSet->isNull(i))
+        item->setValue(i, dataSet->getValue(i).release());
     }
-
-    ++i;
+    items.push_back(std::move(item));
   }
+
+  dataSet->clear();
+  for(auto& item : items)
+    dataSet->add(item.release());
 }
 
-bool terrama2::core::DataAccessorFile::isValidTimestamp(std::shared_ptr<te::mem::DataSet> dataSet, const Filter& filter, size_t dateColumn) const
+bool terrama2::core::DataAccessorFile::isValidTimestamp(std::shared_ptr<te::da::DataSet> dataSet, const Filter& filter, size_t dateColumn) const
 {
   if(!isValidColumn(dateColumn) || (!filter.discardBefore.get() && !filter.discardAfter.get()))
     return true;
@@ -202,7 +187,7 @@ bool terrama2::core::DataAccessorFile::isValidTimestamp(std::shared_ptr<te::mem:
   return true;
 }
 
-bool terrama2::core::DataAccessorFile::isValidGeometry(std::shared_ptr<te::mem::DataSet> dataSet, const Filter& filter, size_t geomColumn) const
+bool terrama2::core::DataAccessorFile::isValidGeometry(std::shared_ptr<te::da::DataSet> dataSet, const Filter& filter, size_t geomColumn) const
 {
   if(!isValidColumn(geomColumn) || !filter.region.get())
     return true;
@@ -222,8 +207,11 @@ bool terrama2::core::DataAccessorFile::isValidGeometry(std::shared_ptr<te::mem::
   return true;
 }
 
-bool terrama2::core::DataAccessorFile::isValidRaster(std::shared_ptr<te::mem::DataSet> dataSet, const Filter&  filter, size_t rasterColumn) const
+bool terrama2::core::DataAccessorFile::isValidRaster(std::shared_ptr<te::da::DataSet> dataSet, const Filter&  filter, size_t rasterColumn,
+                                                     std::unique_ptr<te::rst::Raster>& raster) const
 {
+  raster.reset();
+
   if(!isValidColumn(rasterColumn) || !filter.region.get())
     return true;
 
@@ -234,15 +222,54 @@ bool terrama2::core::DataAccessorFile::isValidRaster(std::shared_ptr<te::mem::Da
     return true;
   }
 
-  std::shared_ptr< te::rst::Raster > raster(dataSet->getRaster(rasterColumn));
+  raster.reset(dataSet->getRaster(rasterColumn).release());
 
-  std::unique_ptr<const te::gm::Envelope> envelope(filter.region->getMBR());
-  if(!raster->getExtent(filter.region->getSRID())->intersects(*envelope))
+  // the MBR is owned by the region
+  te::gm::Envelope envelope(*filter.region->getMBR());
+  if(!raster->getExtent(filter.region->getSRID())->intersects(envelope))
     return false;
 
   return true;
 }
 
+std::string terrama2::core::DataAccessorFile::dataVersion() const
+{
+  // remote files can't be listed without accessing the server
+  if(dataProvider_->dataProviderType != "FILE")
+    return "";
+
+  QCryptographicHash hash(QCryptographicHash::Md5);
+  for(const auto& dataSet : dataSeries_->datasetList)
+  {
+    if(!dataSet->active)
+      continue;
+
+    QUrl url;
+    try
+    {
+      url = QUrl(QString::fromStdString(dataProvider_->uri+"/"+getFolder(dataSet)));
+    }
+    catch(UndefinedTagException&)
+    {
+      url = QUrl(QString::fromStdString(dataProvider_->uri));
+    }
+
+    QDir dir(url.path());
+    if(!dir.exists())
+      return "";
+
+    hash.addData(QByteArray::number(dataSet->id));
+    for(const auto& fileInfo : dir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot | QDir::Readable | QDir::CaseSensitive, QDir::Name))
+    {
+      hash.addData(fileInfo.fileName().toUtf8());
+      hash.addData(QByteArray::number(fileInfo.size()));
+      hash.addData(QByteArray::number(fileInfo.lastModified().toMSecsSinceEpoch()));
+    }
+  }
+
+  return hash.result().toHex().toStdString();
+}
+
 std::string terrama2::core::DataAccessorFile::getFolder(DataSetPtr dataSet) const
 {
   return getProperty(dataSet, dataSeries_, "folder", false);
@@ -250,10 +277,33 @@ std::string terrama2::core::DataAccessorFile::getFolder(DataSetPtr dataSet) cons
 
 void terrama2::core::DataAccessorFile::addToCompleteDataSet(std::shared_ptr<te::da::DataSet> completeDataSet,
     std::shared_ptr<te::da::DataSet> dataSet,
-    std::shared_ptr< te::dt::TimeInstantTZ > fileTimestamp) const
+    std::shared_ptr< te::dt::TimeInstantTZ > fileTimestamp,
+    const Filter& filter) const
 {
   auto complete = std::dynamic_pointer_cast<te::mem::DataSet>(completeDataSet);
-  complete->copy(*dataSet);
+  if(!hasRowFilter(filter))
+  {
+    complete->copy(*dataSet);
+    return;
+  }
+
+  FilterColumns columns = getFilterColumns(dataSet);
+  size_t propertiesNumber = dataSet->getNumProperties();
+
+  dataSet->moveBeforeFirst();
+  while(dataSet->moveNext())
+  {
+    if(!isValidRow(dataSet, filter, columns))
+      continue;
+
+    std::unique_ptr<te::mem::DataSetItem> item(new te::mem::DataSetItem(complete.get()));
+    for(size_t i = 0; i < propertiesNumber; ++i)
+    {
+      if(!dataSet->isNull(i))
+        item->setValue(i, dataSet->getValue(i).release());
+    }
+    complete->add(item.release());
+  }
 }
 
 std::shared_ptr<te::da::DataSet> terrama2::core::DataAccessorFile::getTerraLibDataSet(std::shared_ptr<te::da::DataSourceTransactor> transactor,
@@ -264,6 +314,96 @@ std::shared_ptr<te::da::DataSet> terrama2::core::DataAccessorFile::getTerraLibDa
   return std::shared_ptr<te::da::DataSet>(te::da::CreateAdapter(datasetOrig.release(), converter.get(), true));
 }
 
+terrama2::core::DataAccessorFile::FileData terrama2::core::DataAccessorFile::readFileData(DataSetPtr dataSet,
+                                                                                         const QFileInfo& fileInfo,
+                                                                                         FileCatalog::ReadPosition& position) const
+{
+  FileData fileData;
+  fileData.dataSet = readFile(dataSet, fileInfo.absoluteFilePath().toStdString(), fileData.dataSetType, position);
+  if(fileData.dataSet)
+    return fileData;
+
+  std::string name = fileInfo.fileName().toStdString();
+  std::string baseName = fileInfo.baseName().toStdString();
+  std::string completeBaseName = fileInfo.completeBaseName().toStdString();
+
+  // creates a DataSource to the data and filters the dataset,
+  // also joins if the DCP comes from separated files
+  std::shared_ptr<te::da::DataSource> datasource(te::da::DataSourceFactory::make(dataSourceType()).release(),
+                                                 [](te::da::DataSource* datasource)
+                                                 {
+                                                   try
+                                                   {
+                                                     datasource->close();
+                                                   }
+                                                   catch(...)
+                                                   {
+                                                     TERRAMA2_LOG_ERROR() << QObject::tr("Could not close the data source.");
+                                                   }
+                                                   delete datasource;
+                                                 });
+  std::map<std::string, std::string> connInfo;
+
+  connInfo["URI"] = typePrefix() + fileInfo.absolutePath().toStdString() + "/" + name;
+  datasource->setConnectionInfo(connInfo);
+  datasource->open();
+
+  if(!datasource->isOpened())
+  {
+    // Can't throw here, inside loop
+    // just log and continue
+    QString errMsg = QObject::tr("DataProvider could not be opened.");
+    TERRAMA2_LOG_ERROR() << errMsg;
+    return fileData;
+  }
+
+  // get a transactor to interact to the data source
+  std::shared_ptr<te::da::DataSourceTransactor> transactor(datasource->getTransactor());
+
+  // Some drivers use the base name and other use filename with extension
+  std::string dataSetName;
+  std::vector<std::string> dataSetNames = transactor->getDataSetNames();
+
+  auto itCompleteBaseName= std::find(dataSetNames.cbegin(), dataSetNames.cend(), completeBaseName);
+  auto itBaseName = std::find(dataSetNames.cbegin(), dataSetNames.cend(), baseName);
+  auto itFileName = std::find(dataSetNames.cbegin(), dataSetNames.cend(), name);
+  if(itBaseName != dataSetNames.cend())
+    dataSetName = baseName;
+  else if(itCompleteBaseName != dataSetNames.cend())
+    dataSetName = completeBaseName;
+  else if(itFileName != dataSetNames.cend())
+    dataSetName = name;
+  else
+    dataSetName = name;
+
+  // TODO: Some raster files (.env) don't appear in the getDataSetNames()
+  // but we can open directly with the file name.
+  // should we check or just continue with the file name?
+
+  //read and adapt all te:da::DataSet from terrama2::core::DataSet
+  std::shared_ptr<te::da::DataSetType> fileDataSetType(transactor->getDataSetType(dataSetName));
+  std::shared_ptr<te::da::DataSetTypeConverter> converter = getConverter(dataSet, fileDataSetType);
+  fileData.dataSetType.reset(static_cast<te::da::DataSetType*>(converter->getResult()->clone()));
+
+  std::shared_ptr<te::da::DataSet> teDataSet = getTerraLibDataSet(transactor, dataSetName, converter);
+  if(isValidColumn(te::da::GetFirstPropertyPos(teDataSet.get(), te::dt::RASTER_TYPE)))
+  {
+    // rasters are read on demand,
+    // the data source is kept open until the raster is added to the complete dataset
+    fileData.dataSource = datasource;
+    fileData.transactor = transactor;
+    fileData.converter = converter;
+    fileData.dataSet = teDataSet;
+  }
+  else
+  {
+    // the file is parsed here, concurrently with the other files
+    fileData.dataSet = std::make_shared<te::mem::DataSet>(*teDataSet);
+  }
+
+  return fileData;
+}
+
 terrama2::core::DataSetSeries terrama2::core::DataAccessorFile::getSeries(const std::string& uri,
     const terrama2::core::Filter& filter,
     terrama2::core::DataSetPtr dataSet) const
@@ -292,7 +432,6 @@ terrama2::core::DataSetSeries terrama2::core::DataAccessorFile::getSeries(const
   series.dataSet = dataSet;
 
   std::shared_ptr<te::da::DataSet> completeDataset(nullptr);
-  std::shared_ptr<te::da::DataSetTypeConverter> converter(nullptr);
 
   boost::local_time::local_date_time noTime(boost::local_time::not_a_date_time);
   std::shared_ptr< te::dt::TimeInstantTZ > lastFileTimestamp = std::make_shared<te::dt::TimeInstantTZ>(noTime);
@@ -310,101 +449,121 @@ terrama2::core::DataSetSeries terrama2::core::DataAccessorFile::getSeries(const
   }
 
 
+  // the mask is compiled and matched only once for each file
+  auto matcher = MaskMatcher::get(getMask(dataSet), timezone);
+
   //fill file list
   QFileInfoList newFileInfoList;
-  for(const auto& fileInfo : fileInfoList)
+  // index of the listed file of each file in newFileInfoList
+  std::vector<int> originIndexes;
+  // the unpacked files are kept in the unpack cache until they are read
+  std::vector<Unpack::CacheFolderPtr> unpackedFolders;
+  std::string folderPath = dir.absolutePath().toStdString();
+  for(int i = 0; i < fileInfoList.size(); ++i)
   {
+    const auto& fileInfo = fileInfoList.at(i);
     std::string name = fileInfo.fileName().toStdString();
-    std::string folderPath = dir.absolutePath().toStdString();
+
+    // files already processed that didn't change are not accessed again
+    if(fileCatalog_ && fileCatalog_->isProcessed(std::to_string(dataSet->id) + "/" + name, fileInfo))
+      continue;
+
     if(terrama2::core::Unpack::verifyCompressFile(folderPath+ "/" + name))
     {
-      //unpack files
-      std::string tempFolderPath = terrama2::core::Unpack::unpackList(folderPath+ "/" + name);
-      QDir tempDir(QString::fromStdString(tempFolderPath));
+      //unpack files, only the files valid for the filter are extracted from zip files
+      auto unpackedFolder = terrama2::core::Unpack::unpackList(folderPath+ "/" + name, [&matcher, &filter](const std::string& memberName)
+      {
+        std::shared_ptr< te::dt::TimeInstantTZ > memberTimestamp;
+        return matcher->isValid(memberName, filter, memberTimestamp);
+      });
+      unpackedFolders.push_back(unpackedFolder);
+      QDir tempDir(QString::fromStdString(unpackedFolder->path()));
       QFileInfoList fileList = tempDir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot | QDir::Readable | QDir::CaseSensitive);
 
       newFileInfoList.append(fileList);
+      originIndexes.insert(originIndexes.end(), fileList.size(), i);
     }
     else
     {
       newFileInfoList.append(fileInfo);
+      originIndexes.push_back(i);
     }
   }
 
-  bool first = true;
+  // files that match the mask and are valid for the filter
+  std::vector<std::string> names;
+  names.reserve(newFileInfoList.size());
   for(const auto& fileInfo : newFileInfoList)
-  {
-    std::string name = fileInfo.fileName().toStdString();
-    std::string baseName = fileInfo.baseName().toStdString();
-    std::string completeBaseName = fileInfo.completeBaseName().toStdString();
-
-    std::shared_ptr< te::dt::TimeInstantTZ > thisFileTimestamp = std::make_shared<te::dt::TimeInstantTZ>(noTime);
-    // Verify if the file name matches the mask
-    if(!isValidDataSetName(getMask(dataSet), filter, timezone, name, thisFileTimestamp))
-      continue;
-
-    // creates a DataSource to the data and filters the dataset,
-    // also joins if the DCP comes from separated files
-    std::shared_ptr<te::da::DataSource> datasource(te::da::DataSourceFactory::make(dataSourceType()));
-    std::map<std::string, std::string> connInfo;
+    names.push_back(fileInfo.fileName().toStdString());
 
-    connInfo["URI"] = typePrefix() + fileInfo.absolutePath().toStdString() + "/" + name;
-    datasource->setConnectionInfo(connInfo);
+  auto validFiles = MaskMatcher::select(matcher->index(names), filter, filter.lastValue && hasSingleTimestampPerFile());
 
-    //RAII for open/closing the datasource
-    OpenClose<std::shared_ptr<te::da::DataSource> > openClose(datasource);
+  std::vector<QFileInfo> matchedFiles;
+  std::vector<std::shared_ptr< te::dt::TimeInstantTZ > > matchedTimestamps;
+  std::vector<int> matchedOrigins;
+  for(const auto& validFile : validFiles)
+  {
+    matchedFiles.push_back(newFileInfoList.at(static_cast<int>(validFile.position)));
+    matchedTimestamps.push_back(validFile.timestamp);
+    matchedOrigins.push_back(originIndexes.at(validFile.position));
+  }
 
-    if(!datasource->isOpened())
+  // position of the data already read of files that grow,
+  // files extracted from compressed files are always read completely
+  std::vector<FileCatalog::ReadPosition> readPositions(matchedFiles.size());
+  if(fileCatalog_)
+  {
+    for(std::size_t i = 0; i < matchedFiles.size(); ++i)
     {
-      // Can't throw here, inside loop
-      // just log and continue
-      QString errMsg = QObject::tr("DataProvider could not be opened.");
-      TERRAMA2_LOG_ERROR() << errMsg;
-      continue;
+      const auto& originInfo = fileInfoList.at(matchedOrigins[i]);
+      if(originInfo.absoluteFilePath() == matchedFiles[i].absoluteFilePath())
+        readPositions[i] = fileCatalog_->readPosition(std::to_string(dataSet->id) + "/" + originInfo.fileName().toStdString(), originInfo);
     }
+  }
 
-    // get a transactor to interact to the data source
-    std::shared_ptr<te::da::DataSourceTransactor> transactor(datasource->getTransactor());
-
-    // Some drivers use the base name and other use filename with extension
-    std::string dataSetName;
-    std::vector<std::string> dataSetNames = transactor->getDataSetNames();
-
-    auto itCompleteBaseName= std::find(dataSetNames.cbegin(), dataSetNames.cend(), completeBaseName);
-    auto itBaseName = std::find(dataSetNames.cbegin(), dataSetNames.cend(), baseName);
-    auto itFileName = std::find(dataSetNames.cbegin(), dataSetNames.cend(), name);
-    if(itBaseName != dataSetNames.cend())
-      dataSetName = baseName;
-    else if(itCompleteBaseName != dataSetNames.cend())
-      dataSetName = completeBaseName;
-    else if(itFileName != dataSetNames.cend())
-      dataSetName = name;
-    else
-      dataSetName = name;
+  // open and read the files concurrently
+  std::vector<FileData> filesData(matchedFiles.size());
+  parallelFor(matchedFiles.size(), dataProvider_->ingestionThreads, [&](std::size_t i)
+  {
+    filesData[i] = readFileData(dataSet, matchedFiles[i], readPositions[i]);
+  });
 
-    // TODO: Some raster files (.env) don't appear in the getDataSetNames()
-    // but we can open directly with the file name.
-    // should we check or just continue with the file name?
+  // join the data in the file order
+  bool first = true;
+  for(std::size_t i = 0; i < filesData.size(); ++i)
+  {
+    auto& fileData = filesData[i];
+    if(!fileData.dataSet)
+      continue;
 
     if(first)
     {
-      //read and adapt all te:da::DataSet from terrama2::core::DataSet
-      converter = getConverter(dataSet, std::shared_ptr<te::da::DataSetType>(transactor->getDataSetType(dataSetName)));
-      series.teDataSetType.reset(static_cast<te::da::DataSetType*>(converter->getResult()->clone()));
+      series.teDataSetType.reset(static_cast<te::da::DataSetType*>(fileData.dataSetType->clone()));
       assert(series.teDataSetType.get());
       completeDataset = createCompleteDataSet(series.teDataSetType);
       first = false;
     }
 
-    assert(converter);
-    std::shared_ptr<te::da::DataSet> teDataSet = getTerraLibDataSet(transactor, dataSetName, converter);
+    auto thisFileTimestamp = matchedTimestamps[i];
+    addToCompleteDataSet(completeDataset, fileData.dataSet, thisFileTimestamp, filter);
 
-    addToCompleteDataSet(completeDataset, teDataSet, thisFileTimestamp);
+    // release the file as soon as possible
+    fileData = FileData();
+
+    if(fileCatalog_)
+    {
+      const auto& originInfo = fileInfoList.at(matchedOrigins[i]);
+      std::string timestamp = thisFileTimestamp && !thisFileTimestamp->getTimeInstantTZ().is_special() ? thisFileTimestamp->toString() : "";
+      // the position of a file extracted from a compressed file doesn't apply to the compressed file
+      if(originInfo.absoluteFilePath() != matchedFiles[i].absoluteFilePath())
+        readPositions[i] = FileCatalog::ReadPosition();
+
+      fileCatalog_->setProcessed(std::to_string(dataSet->id) + "/" + originInfo.fileName().toStdString(), originInfo, timestamp, readPositions[i]);
+    }
 
     //update lastest file timestamp
     if(!lastFileTimestamp.get() || lastFileTimestamp->getTimeInstantTZ().is_special() || *lastFileTimestamp < *thisFileTimestamp)
       lastFileTimestamp = thisFileTimestamp;
-
   }// for each file
 
   if(!completeDataset.get() || completeDataset->isEmpty())
@@ -414,34 +573,16 @@ terrama2::core::DataSetSeries terrama2::core::DataAccessorFile::getSeries(const
     throw terrama2::core::NoDataException() << ErrorDescription(errMsg);
   }
 
-  filterDataSet(completeDataset, filter);
-
   //Get last data timestamp and compare with file name timestamp
   std::shared_ptr< te::dt::TimeInstantTZ > dataTimeStamp = getDataLastTimestamp(dataSet, completeDataset);
 
   filterDataSetByLastValue(completeDataset, filter, dataTimeStamp);
 
-  //if both dates are valid
-  if((lastFileTimestamp.get() && !lastFileTimestamp->getTimeInstantTZ().is_special())
-      && (dataTimeStamp.get() && !dataTimeStamp->getTimeInstantTZ().is_special()))
-  {
-    (*lastDateTime_) = *dataTimeStamp > *lastFileTimestamp ? *dataTimeStamp : *lastFileTimestamp;
-  }
-  else if(lastFileTimestamp.get() && !lastFileTimestamp->getTimeInstantTZ().is_special())
-  {
-    //if only fileTimestamp is valid
-    (*lastDateTime_) = *lastFileTimestamp;
-  }
-  else if(dataTimeStamp.get() && !dataTimeStamp->getTimeInstantTZ().is_special())
-  {
-    //if only dataTimeStamp is valid
-    (*lastDateTime_) = *dataTimeStamp;
-  }
-  else
-  {
-    boost::local_time::local_date_time noTime(boost::local_time::not_a_date_time);
-    (*lastDateTime_) = te::dt::TimeInstantTZ(noTime);
-  }
+  //the last timestamp is the latest of the file name and data timestamps
+  if(lastFileTimestamp.get())
+    updateLastDateTime(*lastFileTimestamp);
+  if(dataTimeStamp.get())
+    updateLastDateTime(*dataTimeStamp);
 
 
   std::shared_ptr<SynchronizedDataSet> syncDataset(new SynchronizedDataSet(completeDataset));
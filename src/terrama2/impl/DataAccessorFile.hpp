@@ -35,6 +35,28 @@
 #include "../core/data-access/DataAccessor.hpp"
 #include "../core/data-model/DataSet.hpp"
 #include "../core/data-model/Filter.hpp"
+#include "../core/utility/FileCatalog.hpp"
+
+//STL
+#include <limits>
+#include <memory>
+
+// Forward declaration
+class QFileInfo;
+
+namespace te
+{
+  namespace da
+  {
+    class DataSource;
+    class DataSourceTransactor;
+  }
+
+  namespace rst
+  {
+    class Raster;
+  }
+}
 
 namespace terrama2
 {
@@ -59,20 +81,79 @@ namespace terrama2
         virtual std::string retrieveData(const DataRetrieverPtr dataRetriever, DataSetPtr dataset, const Filter& filter) const override;
         // Doc in base class
         virtual DataSetSeries getSeries(const std::string& uri, const Filter& filter, DataSetPtr dataSet) const override;
+
+        /*!
+          \brief Version of the files of the active datasets, from their names, sizes and modification times.
+
+          Only local files are listed, the version of remote files is unknown.
+        */
+        virtual std::string dataVersion() const override;
+
         //! Recover file mask
         virtual std::string getMask(DataSetPtr dataset) const;
 
       protected:
         virtual std::shared_ptr<te::da::DataSet> createCompleteDataSet(std::shared_ptr<te::da::DataSetType> dataSetType) const;
+        /*!
+          \brief Adds the rows of the dataset accepted by the filter to the complete dataset.
+
+          The filter is evaluated for each row before it's copied, rejected rows are never copied.
+          The last value filter is applied after all files are added, see filterDataSetByLastValue().
+        */
         virtual void addToCompleteDataSet(std::shared_ptr<te::da::DataSet> completeDataSet,
                                           std::shared_ptr<te::da::DataSet> dataSet,
-                                          std::shared_ptr< te::dt::TimeInstantTZ > fileTimestamp) const;
+                                          std::shared_ptr< te::dt::TimeInstantTZ > fileTimestamp,
+                                          const Filter& filter) const;
         virtual std::shared_ptr<te::da::DataSet> getTerraLibDataSet(std::shared_ptr<te::da::DataSourceTransactor> transactor, const std::string& dataSetName, std::shared_ptr<te::da::DataSetTypeConverter> converter) const;
 
         /*!
-          \brief Filter dataset based on Filter
+          \brief Reads the file without a TerraLib data source.
+
+          The resulting dataset must have the same properties as the one adapted by getConverter().
+
+          \note Called concurrently for the files of a DataSet.
+
+          Files that grow by appended data can be read incrementally,
+          the reading starts at \e position and the position is updated to the end of the data read.
+          If the file is read completely the position must be left unchanged.
+
+          \param dataSet DataSet of the file.
+          \param filePath Absolute path of the file.
+          \param dataSetType Properties of the resulting dataset.
+          \param position Position of the data already read, the default position if the file was not read or changed.
+          \return The dataset read or nullptr if the file should be read by the data source.
+        */
+        virtual std::shared_ptr<te::da::DataSet> readFile(DataSetPtr dataSet,
+                                                          const std::string& filePath,
+                                                          std::shared_ptr<te::da::DataSetType>& dataSetType,
+                                                          FileCatalog::ReadPosition& position) const { return nullptr; }
+
+        //! Columns of a dataset checked by the filter.
+        struct FilterColumns
+        {
+          size_t dateColumn = std::numeric_limits<size_t>::max();
+          size_t geomColumn = std::numeric_limits<size_t>::max();
+          size_t rasterColumn = std::numeric_limits<size_t>::max();
+        };
+
+        //! Returns the first date/time, geometry and raster columns of the dataset.
+        FilterColumns getFilterColumns(std::shared_ptr<te::da::DataSet> dataSet) const;
+
+        //! Returns true if the filter has a time range or region to check.
+        bool hasRowFilter(const Filter& filter) const;
+
+        /*!
+          \brief Checks if the current row of the dataset is accepted by the filter.
+
+          The row is checked with isValidTimestamp(), isValidGeometry() and isValidRaster().
+        */
+        bool isValidRow(std::shared_ptr<te::da::DataSet> dataSet, const Filter& filter, const FilterColumns& columns) const;
+
+        /*!
+          \brief Keeps only the rows with the last timestamp, if the filter requests the last value.
+
+          The dataset is compacted in a single pass.
         */
-        virtual void filterDataSet(std::shared_ptr<te::da::DataSet> completeDataSet, const Filter& filter) const;
         void filterDataSetByLastValue(std::shared_ptr<te::da::DataSet> completeDataSet,
                                       const Filter& filter,
                                       std::shared_ptr<te::dt::TimeInstantTZ> lastTimestamp) const;
@@ -90,7 +171,7 @@ namespace terrama2
            - DateTime attribute is null (will be logged)
 
         */
-        virtual bool isValidTimestamp(std::shared_ptr<te::mem::DataSet> dataSet, const Filter& filter, size_t dateColumn) const;
+        virtual bool isValidTimestamp(std::shared_ptr<te::da::DataSet> dataSet, const Filter& filter, size_t dateColumn) const;
         /*!
           \brief Filter dataset by geometry
 
@@ -103,7 +184,7 @@ namespace terrama2
            - Geometry attribute is null (will be logged)
 
         */
-        virtual bool isValidGeometry(std::shared_ptr<te::mem::DataSet> dataSet, const Filter&  filter, size_t geomColumn) const;
+        virtual bool isValidGeometry(std::shared_ptr<te::da::DataSet> dataSet, const Filter&  filter, size_t geomColumn) const;
 
         /*!
           \brief Filter dataset by raster envelope
@@ -116,12 +197,41 @@ namespace terrama2
            - Filter has no region set
            - Raster attribute is null (will be logged)
 
+          \param raster Receives the raster read to check the region, so it's not opened again, null if it wasn't read.
         */
-        virtual bool isValidRaster(std::shared_ptr<te::mem::DataSet> dataSet, const Filter&  filter, size_t rasterColumn) const;
+        virtual bool isValidRaster(std::shared_ptr<te::da::DataSet> dataSet, const Filter&  filter, size_t rasterColumn,
+                                   std::unique_ptr<te::rst::Raster>& raster) const;
 
         virtual std::string getFolder(DataSetPtr dataSet) const;
 
+        /*!
+          \brief Returns true if each file has data of a single date, the timestamp in the file name.
+
+          If true, only the latest files are read when the filter requests the last value.
+        */
+        virtual bool hasSingleTimestampPerFile() const { return false; }
+
         std::shared_ptr< te::dt::TimeInstantTZ > getDataLastTimestamp(DataSetPtr dataSet, std::shared_ptr<te::da::DataSet> teDataSet) const;
+
+      private:
+        //! Data read from a file.
+        struct FileData
+        {
+          std::shared_ptr<te::da::DataSource> dataSource; //!< Kept open while the dataset is read on demand.
+          std::shared_ptr<te::da::DataSourceTransactor> transactor;
+          std::shared_ptr<te::da::DataSetTypeConverter> converter;
+          std::shared_ptr<te::da::DataSetType> dataSetType; //!< Properties of the adapted dataset.
+          std::shared_ptr<te::da::DataSet> dataSet; //!< Adapted dataset, null if the file could not be read.
+        };
+
+        /*!
+          \brief Opens the file and reads its adapted dataset.
+
+          Vector data is read to memory, rasters are read on demand when added to the complete dataset.
+
+          \note Called concurrently for the files of a DataSet.
+        */
+        FileData readFileData(DataSetPtr dataSet, const QFileInfo& fileInfo, FileCatalog::ReadPosition& position) const;
     };
   }
 }
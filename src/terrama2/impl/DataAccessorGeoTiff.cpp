@@ -30,16 +30,26 @@
 #include "DataAccessorGeoTiff.hpp"
 #include "../core/utility/Logger.hpp"
 #include "../core/utility/Utils.hpp"
+#include "../core/utility/Unpack.hpp"
+#include "../core/utility/FilterUtils.hpp"
+#include "../core/utility/MaskMatcher.hpp"
+#include "../core/utility/DataRetrieverFactory.hpp"
+#include "../core/data-model/DataSetGrid.hpp"
+#include "../core/data-access/GridSeries.hpp"
+#include "../core/data-access/RasterHandle.hpp"
 
 //TerraLib
 #include <terralib/datatype/DateTimeProperty.h>
 #include <terralib/dataaccess/utils/Utils.h>
 #include <terralib/memory/DataSetItem.h>
+#include <terralib/geometry/Geometry.h>
 
 //QT
 #include <QString>
 #include <QObject>
 #include <QFileInfo>
+#include <QDir>
+#include <QUrl>
 
 terrama2::core::DataAccessorGeoTiff::DataAccessorGeoTiff(DataProviderPtr dataProvider, DataSeriesPtr dataSeries, const Filter& filter)
  : DataAccessor(dataProvider, dataSeries, filter),
@@ -65,7 +75,8 @@ std::shared_ptr<te::da::DataSet> terrama2::core::DataAccessorGeoTiff::createComp
 
 void terrama2::core::DataAccessorGeoTiff::addToCompleteDataSet(std::shared_ptr<te::da::DataSet> completeDataSet,
                                                                std::shared_ptr<te::da::DataSet> dataSet,
-                                                               std::shared_ptr< te::dt::TimeInstantTZ > fileTimestamp) const
+                                                               std::shared_ptr< te::dt::TimeInstantTZ > fileTimestamp,
+                                                               const Filter& filter) const
 {
   auto complete = std::dynamic_pointer_cast<te::mem::DataSet>(completeDataSet);
   complete->moveLast();
@@ -83,7 +94,14 @@ void terrama2::core::DataAccessorGeoTiff::addToCompleteDataSet(std::shared_ptr<t
   dataSet->moveBeforeFirst();
   while(dataSet->moveNext())
   {
-    std::unique_ptr<te::rst::Raster> raster(dataSet->isNull(rasterColumn) ? nullptr : dataSet->getRaster(rasterColumn).release());
+    // rasters out of the filter region are not read,
+    // the raster opened to check the region is reused
+    std::unique_ptr<te::rst::Raster> raster;
+    if(!isValidRaster(dataSet, filter, rasterColumn, raster))
+      continue;
+
+    if(!raster && !dataSet->isNull(rasterColumn))
+      raster.reset(dataSet->getRaster(rasterColumn).release());
 
     te::mem::DataSetItem* item = new te::mem::DataSetItem(complete.get());
 
@@ -94,3 +112,149 @@ void terrama2::core::DataAccessorGeoTiff::addToCompleteDataSet(std::shared_ptr<t
     complete->add(item);
   }
 }
+
+bool terrama2::core::DataAccessorGeoTiff::listLocalGrids(const Filter& filter, std::vector<GridInfo>& gridInfoList)
+{
+  auto& retrieverFactory = DataRetrieverFactory::getInstance();
+  DataRetrieverPtr dataRetriever = retrieverFactory.make(dataProvider_);
+  if(!dataProvider_->active || dataRetriever->isRetrivable())
+    return false;
+
+  for(const auto& dataSet : dataSeries_->datasetList)
+  {
+    if(!dataSet->active)
+      continue;
+
+    auto dataSetGrid = std::dynamic_pointer_cast<const DataSetGrid>(dataSet);
+
+    QUrl url;
+    try
+    {
+      url = QUrl(QString::fromStdString(dataProvider_->uri+"/"+getFolder(dataSet)));
+    }
+    catch(UndefinedTagException&)
+    {
+      url = QUrl(QString::fromStdString(dataProvider_->uri));
+    }
+
+    std::string timezone;
+    try
+    {
+      timezone = getTimeZone(dataSet);
+    }
+    catch(const terrama2::core::UndefinedTagException& /*e*/)
+    {
+      //if timezone is not defined
+      timezone = "UTC+00";
+    }
+
+    auto matcher = MaskMatcher::get(getMask(dataSet), timezone);
+
+    QDir dir(url.path());
+    QFileInfoList fileInfoList;
+    // unpack cache folder of each file, null for files not compressed
+    std::vector<Unpack::CacheFolderPtr> unpackedFolders;
+    for(const auto& fileInfo : dir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot | QDir::Readable | QDir::CaseSensitive))
+    {
+      if(!terrama2::core::Unpack::verifyCompressFile(fileInfo.absoluteFilePath().toStdString()))
+      {
+        fileInfoList.append(fileInfo);
+        unpackedFolders.push_back(nullptr);
+        continue;
+      }
+
+      // compressed files are unpacked to the unpack cache, only once,
+      // only the members valid for the filter are extracted from zip files
+      auto unpackedFolder = terrama2::core::Unpack::unpackList(fileInfo.absoluteFilePath().toStdString(), [&matcher, &filter](const std::string& memberName)
+      {
+        std::shared_ptr< te::dt::TimeInstantTZ > memberTimestamp;
+        return matcher->isValid(memberName, filter, memberTimestamp);
+      });
+      QDir tempDir(QString::fromStdString(unpackedFolder->path()));
+      QFileInfoList fileList = tempDir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot | QDir::Readable | QDir::CaseSensitive);
+      fileInfoList.append(fileList);
+      unpackedFolders.insert(unpackedFolders.end(), fileList.size(), unpackedFolder);
+    }
+
+    std::vector<std::string> names;
+    names.reserve(fileInfoList.size());
+    for(const auto& fileInfo : fileInfoList)
+      names.push_back(fileInfo.fileName().toStdString());
+
+    const bool decodedCache = useDecodedCache(dataSet);
+
+    // time range and last value are selected with binary search on the sorted files
+    auto validFiles = MaskMatcher::select(matcher->index(names), filter, filter.lastValue);
+    for(const auto& validFile : validFiles)
+    {
+      GridInfo gridInfo = probeGridFile(fileInfoList.at(static_cast<int>(validFile.position)).absoluteFilePath().toStdString());
+      if(filter.region.get())
+      {
+        // the MBR is owned by the region
+        te::gm::Envelope envelope(*filter.region->getMBR());
+        te::gm::Envelope extent(*gridInfo.extent);
+        extent.transform(gridInfo.srid, filter.region->getSRID());
+        if(!extent.intersects(envelope))
+          continue;
+      }
+
+      gridInfo.dataSet = dataSetGrid;
+      gridInfo.timestamp = validFile.timestamp;
+      gridInfo.decodedCache = decodedCache;
+      // the unpacked file is kept while the grid is in use
+      gridInfo.unpackedFolder = unpackedFolders.at(validFile.position);
+      gridInfoList.push_back(gridInfo);
+    }
+  }
+
+  return true;
+}
+
+std::vector<terrama2::core::GridInfo> terrama2::core::DataAccessorGeoTiff::getGridInfo(const Filter& filter)
+{
+  std::vector<GridInfo> gridInfoList;
+  if(!listLocalGrids(filter, gridInfoList))
+    return DataAccessorGrid::getGridInfo(filter);
+
+  if(gridInfoList.empty())
+  {
+    QString errMsg = QObject::tr("No data in data series: %1.").arg(dataSeries_->id);
+    TERRAMA2_LOG_WARNING() << errMsg;
+    throw terrama2::core::NoDataException() << ErrorDescription(errMsg);
+  }
+
+  return gridInfoList;
+}
+
+terrama2::core::GridSeriesPtr terrama2::core::DataAccessorGeoTiff::getGridSeries(const Filter& filter)
+{
+  std::vector<GridInfo> gridInfoList;
+  if(!listLocalGrids(filter, gridInfoList))
+    return DataAccessorGrid::getGridSeries(filter);
+
+  std::unique_ptr<te::gm::Envelope> region;
+  if(filter.region.get())
+    region.reset(new te::gm::Envelope(*filter.region->getMBR()));
+
+  GridSeriesPtr gridSeries = std::make_shared<GridSeries>();
+  for(const auto& gridInfo : gridInfoList)
+  {
+    auto handle = std::make_shared<RasterHandle>(gridInfo, gridInfo.timestamp);
+    if(region && !handle->setWindow(*region, filter.region->getSRID()))
+      continue;
+
+    gridSeries->addRasterHandle(gridInfo.dataSet, handle);
+
+    if(gridInfo.timestamp)
+      updateLastDateTime(*gridInfo.timestamp);
+  }
+
+  if(gridSeries->handleMap().empty())
+  {
+    QString errMsg = QObject::tr("No data in data series: %1.").arg(dataSeries_->id);
+    TERRAMA2_LOG_WARNING() << errMsg;
+    throw terrama2::core::NoDataException() << ErrorDescription(errMsg);
+  }
+
+  return gridSeries;
+}
@@ -70,10 +70,44 @@ namespace terrama2
 
       virtual void addToCompleteDataSet(std::shared_ptr<te::da::DataSet> completeDataSet,
                                         std::shared_ptr<te::da::DataSet> dataSet,
-                                        std::shared_ptr< te::dt::TimeInstantTZ > fileTimestamp) const override;
+                                        std::shared_ptr< te::dt::TimeInstantTZ > fileTimestamp,
+                                        const Filter& filter) const override;
+
+      /*!
+        \brief Returns the geometry of the grids filtered by Filter reading only the file headers.
+
+        Falls back to DataAccessorGrid::getGridInfo() if the data must be retrieved
+        from a remote server.
+      */
+      virtual std::vector<GridInfo> getGridInfo(const Filter& filter) override;
+
+      /*!
+        \brief Returns a GridSeries with handles to the files filtered by Filter.
+
+        Only the file headers are read, the pixels are read when the rasters are requested.
+        If the filter has a region only the pixels of the region are read.
+        Compressed files are unpacked to the unpack cache and, if the data series has
+        the "decoded_cache" tag, the decoded blocks are stored in the DecodedRasterCache.
+
+        Falls back to DataAccessorGrid::getGridSeries() if the data must be retrieved
+        from a remote server.
+      */
+      virtual GridSeriesPtr getGridSeries(const Filter& filter) override;
 
     protected:
       virtual std::string dataSourceType() const override;
+
+      //! Each GeoTiff file is a single raster of the date in the file name.
+      virtual bool hasSingleTimestampPerFile() const override { return true; }
+
+    private:
+      /*!
+        \brief Lists the local files of the active datasets valid for the filter, reading only the file headers.
+
+        \return False if the files can't be read directly, if the data must be retrieved
+                from a remote server.
+      */
+      bool listLocalGrids(const Filter& filter, std::vector<GridInfo>& gridInfoList);
     };
   }
 }
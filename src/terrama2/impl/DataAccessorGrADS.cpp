@@ -31,8 +31,10 @@
 #include "../core/utility/Logger.hpp"
 #include "../core/utility/Utils.hpp"
 #include "../core/utility/FilterUtils.hpp"
-#include "../core/utility/Raii.hpp"
 #include "../core/utility/Unpack.hpp"
+#include "../core/utility/MaskMatcher.hpp"
+#include "../core/utility/DecodedRasterCache.hpp"
+#include "../core/utility/RasterBlockCache.hpp"
 
 //TerraLib
 #include <terralib/datatype/DateTimeProperty.h>
@@ -43,10 +45,9 @@
 #include <terralib/raster/Grid.h>
 #include <terralib/raster/RasterFactory.h>
 #include <terralib/raster/Band.h>
-#include <terralib/dataaccess/datasource/DataSourceFactory.h>
-#include <terralib/dataaccess/datasource/DataSourceTransactor.h>
-#include <terralib/srs/SpatialReferenceSystemManager.h>
-#include <terralib/srs/SpatialReferenceSystem.h>
+#include <terralib/dataaccess/dataset/DataSetType.h>
+#include <terralib/geometry/Envelope.h>
+#include <terralib/memory/DataSet.h>
 
 //QT
 #include <QTextStream>
@@ -56,6 +57,51 @@
 #include <QFileInfo>
 #include <QUrl>
 #include <QDir>
+#include <QDateTime>
+#include <QtEndian>
+
+//Boost
+#include <boost/algorithm/string.hpp>
+
+//STL
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+namespace
+{
+  //! A descriptor read from a CTL file and the state of the file when it was read.
+  struct CachedDescriptor
+  {
+    qint64 size = 0;
+    QDateTime lastModified;
+    terrama2::core::GrADSDataDescriptor descriptor;
+  };
+
+  std::mutex descriptorCacheMutex;
+  std::map<std::string, CachedDescriptor> descriptorCache;
+
+  //! Creates a dataset with a single item holding the raster.
+  std::tuple<std::shared_ptr<te::da::DataSet>, std::shared_ptr<te::da::DataSetType> >
+  createRasterDataSet(std::unique_ptr<te::rst::Raster> raster)
+  {
+    std::vector<te::rst::BandProperty*> bands;
+    for(std::size_t i = 0; i < raster->getNumberOfBands(); ++i)
+      bands.push_back(new te::rst::BandProperty(*raster->getBand(i)->getProperty()));
+
+    std::shared_ptr<te::da::DataSetType> dataSetType = std::make_shared<te::da::DataSetType>("grads");
+    dataSetType->add(new te::rst::RasterProperty(new te::rst::Grid(*raster->getGrid()), bands, {}));
+
+    auto dataSet = std::make_shared<te::mem::DataSet>(dataSetType.get());
+    te::mem::DataSetItem* item = new te::mem::DataSetItem(dataSet.get());
+    item->setRaster(0, raster.release());
+    dataSet->add(item);
+
+    return std::make_tuple(dataSet, dataSetType);
+  }
+}
 
 
 terrama2::core::DataAccessorGrADS::DataAccessorGrADS(DataProviderPtr dataProvider, DataSeriesPtr dataSeries,
@@ -123,7 +169,8 @@ terrama2::core::DataAccessorGrADS::createCompleteDataSet(std::shared_ptr<te::da:
 
 void terrama2::core::DataAccessorGrADS::addToCompleteDataSet(std::shared_ptr<te::da::DataSet> completeDataSet,
                                                              std::shared_ptr<te::da::DataSet> dataSet,
-                                                             std::shared_ptr<te::dt::TimeInstantTZ> fileTimestamp) const
+                                                             std::shared_ptr<te::dt::TimeInstantTZ> fileTimestamp,
+                                                             const Filter& filter) const
 {
   auto complete = std::dynamic_pointer_cast<te::mem::DataSet>(completeDataSet);
   complete->moveLast();
@@ -141,8 +188,14 @@ void terrama2::core::DataAccessorGrADS::addToCompleteDataSet(std::shared_ptr<te:
   dataSet->moveBeforeFirst();
   while (dataSet->moveNext())
   {
-    std::unique_ptr<te::rst::Raster> raster(
-        dataSet->isNull(rasterColumn) ? nullptr : dataSet->getRaster(rasterColumn).release());
+    // rasters out of the filter region are not read,
+    // the raster opened to check the region is reused
+    std::unique_ptr<te::rst::Raster> raster;
+    if (!isValidRaster(dataSet, filter, rasterColumn, raster))
+      continue;
+
+    if (!raster && !dataSet->isNull(rasterColumn))
+      raster.reset(dataSet->getRaster(rasterColumn).release());
 
     te::mem::DataSetItem* item = new te::mem::DataSetItem(complete.get());
 
@@ -228,6 +281,8 @@ terrama2::core::DataSetSeries terrama2::core::DataAccessorGrADS::getSeries(const
 
   //fill file list
   QFileInfoList newFileInfoList;
+  // the unpacked files are kept in the unpack cache until they are read
+  std::vector<Unpack::CacheFolderPtr> unpackedFolders;
   for(const auto& fileInfo : fileInfoList)
   {
     std::string name = fileInfo.fileName().toStdString();
@@ -235,8 +290,9 @@ terrama2::core::DataSetSeries terrama2::core::DataAccessorGrADS::getSeries(const
     if(terrama2::core::Unpack::verifyCompressFile(folderPath+ "/" + name))
     {
       //unpack files
-      std::string tempFolderPath = terrama2::core::Unpack::unpackList(folderPath+ "/" + name);
-      QDir tempDir(QString::fromStdString(tempFolderPath));
+      auto unpackedFolder = terrama2::core::Unpack::unpackList(folderPath+ "/" + name);
+      unpackedFolders.push_back(unpackedFolder);
+      QDir tempDir(QString::fromStdString(unpackedFolder->path()));
       QFileInfoList fileList = tempDir.entryInfoList(QDir::Files | QDir::NoDotAndDotDot | QDir::Readable | QDir::CaseSensitive);
 
       newFileInfoList.append(fileList);
@@ -247,29 +303,27 @@ terrama2::core::DataSetSeries terrama2::core::DataAccessorGrADS::getSeries(const
     }
   }
 
-  bool first = true;
+  std::vector<std::string> names;
+  names.reserve(newFileInfoList.size());
   for (const auto& fileInfo : newFileInfoList)
-  {
-    std::string name = fileInfo.fileName().toStdString();
+    names.push_back(fileInfo.fileName().toStdString());
 
-    std::shared_ptr<te::dt::TimeInstantTZ> thisFileTimestamp = std::make_shared<te::dt::TimeInstantTZ>(noTime);
+  // the listing is indexed once for the CTL mask and once for each data file mask,
+  // the data files of a CTL are selected from the index by timestamp
+  auto ctlMatcher = MaskMatcher::get(getCtlFilename(dataSet), timezone);
+  auto ctlFiles = MaskMatcher::select(ctlMatcher->index(names), filter, false);
+  std::map<std::string, MaskMatcher::Index> dataFileIndexes;
 
-    QString ctlMask = getCtlFilename(dataSet).c_str();
+  const Srid srid = getSrid(dataSet);
+  const bool decodedCache = useDecodedCache(dataSet);
 
-    // Verify if it is a valid CTL file name
-    if (!isValidDataSetName(ctlMask.toStdString(), filter, timezone, name, thisFileTimestamp))
-      continue;
+  bool first = true;
+  for (const auto& ctlFile : ctlFiles)
+  {
+    const auto& fileInfo = newFileInfoList.at(static_cast<int>(ctlFile.position));
 
-    auto gradsDescriptor = readDataDescriptor(fileInfo.absoluteFilePath().toStdString());;
-    gradsDescriptor.srid_ = getSrid(dataSet);
-
-    //FIXME: temporary restriction of only one band
-    if(gradsDescriptor.tDef_->numValues_ > 1)
-    {
-      QString errMsg = QObject::tr("Invalid number of bands in dataset %1").arg(dataSet->id);
-      TERRAMA2_LOG_ERROR() << errMsg;
-      throw DataAccessException() << ErrorDescription(errMsg);
-    }
+    auto gradsDescriptor = readDataDescriptor(fileInfo.absoluteFilePath().toStdString());
+    gradsDescriptor.srid_ = srid;
 
     // Reads the dataset name from CTL
     std::string datasetMask = gradsDescriptor.datasetFilename_;
@@ -281,98 +335,46 @@ terrama2::core::DataSetSeries terrama2::core::DataAccessorGrADS::getSeries(const
 
     datasetMask = replaceMask(datasetMask.c_str()).toStdString();
 
+    auto it = dataFileIndexes.find(datasetMask);
+    if (it == dataFileIndexes.end())
+      it = dataFileIndexes.emplace(datasetMask, MaskMatcher::get(datasetMask, timezone)->index(names)).first;
 
-    for (const auto& dataFileInfo : newFileInfoList)
+    for (const auto& dataFile : MaskMatcher::select(it->second, filter, false))
     {
-      std::string name = dataFileInfo.fileName().toStdString();
-      std::string baseName = dataFileInfo.baseName().toStdString();
-      std::string extension = dataFileInfo.suffix().toStdString();
-
-      // Verify if the file name matches the datasetMask
-      if (!isValidDataSetName(datasetMask, filter, timezone, name, thisFileTimestamp))
-        continue;
-
-      boost::replace_last(name, extension, "vrt");
-
-      QString binFilename = dataFileInfo.absoluteFilePath();
-      QString vrtFilename = dataFileInfo.absoluteFilePath();
-      vrtFilename.replace(QString::fromStdString(extension), "vrt");
-
+      const auto& dataFileInfo = newFileInfoList.at(static_cast<int>(dataFile.position));
+      std::shared_ptr<te::dt::TimeInstantTZ> thisFileTimestamp = dataFile.timestamp ? dataFile.timestamp : std::make_shared<te::dt::TimeInstantTZ>(noTime);
 
-      writeVRTFile(gradsDescriptor, binFilename.toStdString(), vrtFilename.toStdString());
-
-      // creates a DataSource to the data and filters the dataset,
-      // also joins if the DCP comes from separated files
-      std::shared_ptr<te::da::DataSource> datasource(te::da::DataSourceFactory::make(dataSourceType()));
-      std::map<std::string, std::string> connInfo;
-
-      connInfo["URI"] = typePrefix() + dataFileInfo.absolutePath().toStdString() + "/" + name;
-      datasource->setConnectionInfo(connInfo);
-
-      //RAII for open/closing the datasource
-      OpenClose<std::shared_ptr<te::da::DataSource> > openClose(datasource);
-
-      if (!datasource->isOpened())
+      std::unique_ptr<te::rst::Raster> raster;
+      try
       {
-        // Can't throw here, inside loop
-        // just log and continue
-        QString errMsg = QObject::tr("DataProvider could not be opened.");
-        TERRAMA2_LOG_ERROR() << errMsg;
-        continue;
+        raster = readBinaryFile(gradsDescriptor, dataFileInfo.absoluteFilePath().toStdString(), decodedCache);
       }
-
-      // get a transactor to interact to the data source
-      std::shared_ptr<te::da::DataSourceTransactor> transactor(datasource->getTransactor());
-
-      // Some drivers use the base name and other use filename with extension
-      std::string dataSetName;
-      std::vector<std::string> dataSetNames = transactor->getDataSetNames();
-      auto itBaseName = std::find(dataSetNames.cbegin(), dataSetNames.cend(), baseName);
-      auto itFileName = std::find(dataSetNames.cbegin(), dataSetNames.cend(), name);
-      if (itBaseName != dataSetNames.cend())
-        dataSetName = baseName;
-      else if (itFileName != dataSetNames.cend())
-        dataSetName = name;
-      //No valid dataset name found
-      if (dataSetName.empty())
-        continue;
-
-      std::shared_ptr<te::da::DataSet> teDataSet(transactor->getDataSet(dataSetName));
-      if(!teDataSet)
-      {
-        QString errMsg = QObject::tr("Could not read dataset: %1").arg(dataSetName.c_str());
-        TERRAMA2_LOG_WARNING() << errMsg;
-        throw terrama2::core::DataAccessorException() << ErrorDescription(errMsg);
-      }
-      auto raster = teDataSet->getRaster(0);
-      if(raster.get() == nullptr)
+      catch (const DataAccessorException&)
       {
-        QString errMsg = QObject::tr("Invalid raster for dataset: %1").arg(dataSetName.c_str());
-        TERRAMA2_LOG_WARNING() << errMsg;
-        throw terrama2::core::DataAccessorException() << ErrorDescription(errMsg);
+        // Can't throw here, inside loop
+        // the error was logged, continue with the next file
+        continue;
       }
 
+      std::shared_ptr<te::da::DataSet> teDataSet;
+      std::shared_ptr<te::da::DataSetType> dataSetType;
+      std::tie(teDataSet, dataSetType) = createRasterDataSet(std::move(raster));
 
       if (first)
       {
         //read and adapt all te:da::DataSet from terrama2::core::DataSet
-        converter = getConverter(dataSet, std::shared_ptr<te::da::DataSetType>(transactor->getDataSetType(dataSetName)));
+        converter = getConverter(dataSet, dataSetType);
         series.teDataSetType.reset(static_cast<te::da::DataSetType*>(converter->getResult()->clone()));
         assert(series.teDataSetType.get());
         completeDataset = createCompleteDataSet(series.teDataSetType);
         first = false;
       }
 
-      addToCompleteDataSet(completeDataset, teDataSet, thisFileTimestamp);
-//      // Creates flipped raster
-//      QFile vrtFile(vrtFilename);
-//      vrtFile.remove();
-
+      addToCompleteDataSet(completeDataset, teDataSet, thisFileTimestamp, filter);
 
       //update last file timestamp
       if (lastFileTimestamp->getTimeInstantTZ().is_not_a_date_time() || *lastFileTimestamp < *thisFileTimestamp)
         lastFileTimestamp = thisFileTimestamp;
-
     }
   }
 
@@ -383,34 +385,16 @@ terrama2::core::DataSetSeries terrama2::core::DataAccessorGrADS::getSeries(const
     throw terrama2::core::NoDataException() << ErrorDescription(errMsg);
   }
 
-  filterDataSet(completeDataset, filter);
-
   //Get last data timestamp and compare with file name timestamp
   std::shared_ptr<te::dt::TimeInstantTZ> dataTimeStamp = getDataLastTimestamp(dataSet, completeDataset);
 
   filterDataSetByLastValue(completeDataset, filter, dataTimeStamp);
 
-  //if both dates are valid
-  if ((lastFileTimestamp.get() && !lastFileTimestamp->getTimeInstantTZ().is_not_a_date_time())
-      && (dataTimeStamp.get() && !dataTimeStamp->getTimeInstantTZ().is_not_a_date_time()))
-  {
-    (*lastDateTime_) = *dataTimeStamp > *lastFileTimestamp ? *dataTimeStamp : *lastFileTimestamp;
-  }
-  else if (lastFileTimestamp.get() && !lastFileTimestamp->getTimeInstantTZ().is_not_a_date_time())
-  {
-    //if only fileTimestamp is valid
-    (*lastDateTime_) = *lastFileTimestamp;
-  }
-  else if (dataTimeStamp.get() && !dataTimeStamp->getTimeInstantTZ().is_not_a_date_time())
-  {
-    //if only dataTimeStamp is valid
-    (*lastDateTime_) = *dataTimeStamp;
-  }
-  else
-  {
-    boost::local_time::local_date_time noTime(boost::local_time::not_a_date_time);
-    (*lastDateTime_) = te::dt::TimeInstantTZ(noTime);
-  }
+  //the last timestamp is the latest of the file name and data timestamps
+  if(lastFileTimestamp.get())
+    updateLastDateTime(*lastFileTimestamp);
+  if(dataTimeStamp.get())
+    updateLastDateTime(*dataTimeStamp);
 
 
   std::shared_ptr<SynchronizedDataSet> syncDataset(new SynchronizedDataSet(completeDataset));
@@ -457,6 +441,11 @@ void terrama2::core::GrADSDataDescriptor::setKeyValue(const std::string& key, co
     datasetFilename_ = value;
     found = true;
   }
+  else if (key == "FILEHEADER")
+  {
+    fileHeaderLength_ = std::atoi(value.c_str());
+    found = true;
+  }
   else if (key == "TITLE")
   {
     title_ = value;
@@ -511,6 +500,41 @@ void terrama2::core::GrADSDataDescriptor::setKeyValue(const std::string& key, co
   }
 }
 
+bool terrama2::core::GrADSDataDescriptor::hasOption(const std::string& option) const
+{
+  return std::any_of(vecOptions_.cbegin(), vecOptions_.cend(), [&option](const std::string& value)
+  {
+    return boost::iequals(value, option);
+  });
+}
+
+int terrama2::core::GrADSDataDescriptor::levels(const Var& var)
+{
+  return std::max(var.verticalLevels_, 1);
+}
+
+std::size_t terrama2::core::GrADSDataDescriptor::gridsPerTimeStep() const
+{
+  std::size_t grids = 0;
+  for (const auto& var : vecVars_)
+    grids += static_cast<std::size_t>(levels(*var));
+
+  return grids;
+}
+
+std::size_t terrama2::core::GrADSDataDescriptor::gridSize() const
+{
+  if (xDef_ == nullptr || yDef_ == nullptr)
+    return 0;
+
+  std::size_t size = static_cast<std::size_t>(xDef_->numValues_) * static_cast<std::size_t>(yDef_->numValues_) * sizeof(float);
+  // sequential files have the record length before and after each grid
+  if (hasOption("sequential"))
+    size += 2 * sizeof(qint32);
+
+  return size;
+}
+
 terrama2::core::GrADSDataDescriptor::TValueDef*
 terrama2::core::GrADSDataDescriptor::getTValueDef(const std::string& value)
 {
@@ -624,7 +648,7 @@ terrama2::core::GrADSDataDescriptor& terrama2::core::GrADSDataDescriptor::operat
   if (tDef_ != nullptr)
   {
     delete tDef_;
-    zDef_ = nullptr;
+    tDef_ = nullptr;
   }
 
   for (size_t i = 0; i < vecVars_.size(); ++i)
@@ -660,7 +684,10 @@ terrama2::core::GrADSDataDescriptor& terrama2::core::GrADSDataDescriptor::operat
   return *this;
 }
 
-terrama2::core::GrADSDataDescriptor::GrADSDataDescriptor(const GrADSDataDescriptor& rhs)
+terrama2::core::GrADSDataDescriptor::GrADSDataDescriptor(const GrADSDataDescriptor& rhs) : xDef_(nullptr),
+                                                                                        yDef_(nullptr),
+                                                                                        zDef_(nullptr),
+                                                                                        tDef_(nullptr)
 {
   datasetFilename_ = rhs.datasetFilename_;
   title_ = rhs.title_;
@@ -723,6 +750,16 @@ terrama2::core::GrADSDataDescriptor::GrADSDataDescriptor() : undef_(0.),
 terrama2::core::GrADSDataDescriptor
 terrama2::core::DataAccessorGrADS::readDataDescriptor(const std::string& filename) const
 {
+  QFileInfo fileInfo(QString::fromStdString(filename));
+  {
+    std::lock_guard<std::mutex> lock(descriptorCacheMutex);
+    auto it = descriptorCache.find(filename);
+    if (it != descriptorCache.end()
+        && it->second.size == fileInfo.size()
+        && it->second.lastModified == fileInfo.lastModified())
+      return it->second.descriptor;
+  }
+
   GrADSDataDescriptor grADSDataDescriptor;
 
   // Opens the CTL file
@@ -826,80 +863,177 @@ terrama2::core::DataAccessorGrADS::readDataDescriptor(const std::string& filenam
     }
   }
 
+  CachedDescriptor cached;
+  cached.size = fileInfo.size();
+  cached.lastModified = fileInfo.lastModified();
+  cached.descriptor = grADSDataDescriptor;
+
+  std::lock_guard<std::mutex> lock(descriptorCacheMutex);
+  descriptorCache[filename] = cached;
+
   return grADSDataDescriptor;
 }
 
-void terrama2::core::DataAccessorGrADS::writeVRTFile(terrama2::core::GrADSDataDescriptor descriptor,
-                                                     const std::string& binFilename,
-                                                     const std::string& vrtFilename) const
+std::unique_ptr<te::rst::Raster>
+terrama2::core::DataAccessorGrADS::readBinaryFile(const GrADSDataDescriptor& descriptor, const std::string& filename,
+                                                  bool decodedCache) const
 {
+  if (descriptor.xDef_ == nullptr || descriptor.yDef_ == nullptr
+      || descriptor.xDef_->dimensionType_ != GrADSDataDescriptor::LINEAR
+      || descriptor.yDef_->dimensionType_ != GrADSDataDescriptor::LINEAR
+      || descriptor.xDef_->values_.size() < 2 || descriptor.yDef_->values_.size() < 2
+      || descriptor.xDef_->numValues_ <= 0 || descriptor.yDef_->numValues_ <= 0)
+  {
+    QString errMsg = QObject::tr("Only linear XDEF and YDEF are supported in GrADS file: %1").arg(QString::fromStdString(filename));
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw DataAccessorException() << ErrorDescription(errMsg);
+  }
 
-  std::ofstream vrtfile;
-  vrtfile.open(vrtFilename);
+  if (descriptor.vecVars_.empty())
+  {
+    QString errMsg = QObject::tr("No variable defined for GrADS file: %1").arg(QString::fromStdString(filename));
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw DataAccessorException() << ErrorDescription(errMsg);
+  }
 
-  if (!vrtfile.is_open())
+  QFile file(QString::fromStdString(filename));
+  if (!file.open(QIODevice::ReadOnly))
   {
-    QString errMsg = QObject::tr("Could not open VRT file.");
+    QString errMsg = QObject::tr("Could not open GrADS file: %1").arg(QString::fromStdString(filename));
     TERRAMA2_LOG_ERROR() << errMsg;
     throw DataAccessorException() << ErrorDescription(errMsg);
   }
-  else
+
+  const unsigned int nCols = static_cast<unsigned int>(descriptor.xDef_->numValues_);
+  const unsigned int nRows = static_cast<unsigned int>(descriptor.yDef_->numValues_);
+  const std::size_t gridSize = descriptor.gridSize();
+  const std::size_t gridsPerTimeStep = descriptor.gridsPerTimeStep();
+  const qint64 dataSize = file.size() - descriptor.fileHeaderLength_;
+
+  // a template file may have less time steps than the TDEF, incomplete time steps are not read
+  std::size_t timeSteps = dataSize > 0 ? static_cast<std::size_t>(dataSize) / (gridSize * gridsPerTimeStep) : 0;
+  if (descriptor.tDef_ != nullptr && descriptor.tDef_->numValues_ > 0)
+    timeSteps = std::min(timeSteps, static_cast<std::size_t>(descriptor.tDef_->numValues_));
+
+  if (timeSteps == 0)
   {
-    vrtfile.precision(20);
+    QString errMsg = QObject::tr("Incomplete GrADS file: %1").arg(QString::fromStdString(filename));
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw DataAccessorException() << ErrorDescription(errMsg);
+  }
 
-    vrtfile
-        << "<VRTDataset rasterXSize=\"" << descriptor.xDef_->numValues_ << "\""
-        << " rasterYSize=\"" << descriptor.yDef_->numValues_ << "\""
-        << ">";
+  // the mapping is released when the file is closed
+  const uchar* data = file.map(0, file.size());
+  if (data == nullptr)
+  {
+    QString errMsg = QObject::tr("Could not map GrADS file: %1").arg(QString::fromStdString(filename));
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw DataAccessorException() << ErrorDescription(errMsg);
+  }
 
-    if (descriptor.srid_ > 0)
-    {
-      const std::string wktStr = te::srs::SpatialReferenceSystemManager::getInstance().getWkt(descriptor.srid_);
+  // X and Y definitions are the centers of the cells
+  const double resX = descriptor.xDef_->values_[1];
+  const double resY = descriptor.yDef_->values_[1];
+  const double minX = descriptor.xDef_->values_[0] - resX / 2.;
+  const double minY = descriptor.yDef_->values_[0] - resY / 2.;
+  te::gm::Envelope* envelope = new te::gm::Envelope(minX, minY, minX + nCols * resX, minY + nRows * resY);
+  te::rst::Grid* grid = new te::rst::Grid(nCols, nRows, resX, resY, envelope, descriptor.srid_);
 
-      if (!wktStr.empty())
+  std::vector<te::rst::BandProperty*> bands;
+  for (std::size_t timeStep = 0; timeStep < timeSteps; ++timeStep)
+  {
+    for (const auto& var : descriptor.vecVars_)
+    {
+      for (int level = 0; level < GrADSDataDescriptor::levels(*var); ++level)
       {
-        vrtfile << std::endl << "<SRS>" << wktStr << "</SRS>";
+        std::string description = var->varName_ + ":" + std::to_string(level) + ":" + std::to_string(timeStep);
+        te::rst::BandProperty* bandProperty = new te::rst::BandProperty(bands.size(), te::dt::FLOAT_TYPE, description);
+        bandProperty->m_blkh = 1;
+        bandProperty->m_blkw = nCols;
+        bandProperty->m_nblocksx = 1;
+        bandProperty->m_nblocksy = nRows;
+        bandProperty->m_noDataValue = descriptor.undef_;
+        bands.push_back(bandProperty);
       }
     }
+  }
 
-    if ((descriptor.xDef_->values_[1] != 0.0) && (descriptor.yDef_->values_[1] != 0.0))
+  std::unique_ptr<te::rst::Raster> raster(te::rst::RasterFactory::make("MEM", grid, bands, {}));
+  if (!raster)
+  {
+    QString errMsg = QObject::tr("Could not create raster for GrADS file: %1").arg(QString::fromStdString(filename));
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw DataAccessorException() << ErrorDescription(errMsg);
+  }
+
+  // GrADS files are written in the byte order of the machine that created them
+  bool bigEndian = Q_BYTE_ORDER == Q_BIG_ENDIAN;
+  if (descriptor.hasOption("big_endian"))
+    bigEndian = true;
+  else if (descriptor.hasOption("little_endian"))
+    bigEndian = false;
+  else if (descriptor.hasOption("byteswapped"))
+    bigEndian = !bigEndian;
+
+  // rows are stored from south to north unless the y axis is reversed
+  const bool northToSouth = descriptor.hasOption("yrev");
+  const std::size_t recordMarker = descriptor.hasOption("sequential") ? sizeof(qint32) : 0;
+
+  // each band is a block of the cache, readers of the same file share the decoded bands,
+  // the layout of the descriptor is part of the identity as the same file may be described by other CTL
+  const std::string layout = std::to_string(nCols) + "x" + std::to_string(nRows)
+                             + ":" + std::to_string(descriptor.fileHeaderLength_) + ":" + std::to_string(gridSize)
+                             + (bigEndian ? ":be" : ":le") + (northToSouth ? ":yrev" : "");
+  const std::string fileIdentity = RasterBlockCache::fileIdentity(filename) + ":" + layout;
+  const std::string sourceIdentity = decodedCache ? DecodedRasterCache::sourceIdentity(filename, layout) : std::string();
+  std::vector<float> row(nCols);
+  for (std::size_t bandIdx = 0; bandIdx < bands.size(); ++bandIdx)
+  {
+    RasterBlockKey key;
+    key.fileIdentity = fileIdentity;
+    key.band = bandIdx;
+
+    auto decode = [&]()
     {
-      vrtfile << std::endl << "<GeoTransform>" << descriptor.xDef_->values_[0] << ","
-              << descriptor.xDef_->values_[1] << ",0," << descriptor.yDef_->values_[0] << ",0,"
-              << descriptor.yDef_->values_[1]
-              << "</GeoTransform>";
-    }
+      RasterBlock values(te::dt::FLOAT_TYPE, static_cast<std::size_t>(nCols) * nRows);
+      const uchar* gridData = data + descriptor.fileHeaderLength_ + bandIdx * gridSize + recordMarker;
+      for (unsigned int fileRow = 0; fileRow < nRows; ++fileRow)
+      {
+        const uchar* rowData = gridData + static_cast<std::size_t>(fileRow) * nCols * sizeof(float);
+        unsigned int rasterRow = northToSouth ? fileRow : nRows - 1 - fileRow;
+        for (unsigned int col = 0; col < nCols; ++col)
+        {
+          quint32 word = bigEndian ? qFromBigEndian<quint32>(rowData + col * sizeof(float))
+                                   : qFromLittleEndian<quint32>(rowData + col * sizeof(float));
+          std::memcpy(values.data() + (static_cast<std::size_t>(rasterRow) * nCols + col) * sizeof(float), &word, sizeof(float));
+        }
+      }
 
-    unsigned int pixelOffset = 0;
-    unsigned int lineOffset = 0;
-    unsigned int imageOffset = 0;
+      return values;
+    };
 
-    for (unsigned int bandIdx = 0; bandIdx < descriptor.tDef_->numValues_; ++bandIdx)
+    RasterBlockPtr block = RasterBlockCache::getInstance().get(key, [&]()
     {
+      if (sourceIdentity.empty())
+        return decode();
 
-      // BSQ (Band sequential) interleave
-      pixelOffset = 4; // Float32
-      lineOffset = pixelOffset * descriptor.xDef_->numValues_;
-      imageOffset = bandIdx * lineOffset * descriptor.xDef_->numValues_;
-
-      vrtfile
-          << std::endl
-          << "<VRTRasterBand dataType=\"Float32\" band=\"" << (bandIdx + 1) << "\" subClass=\"VRTRawRasterBand\">"
-          << std::endl
-          << "<SourceFilename relativetoVRT=\"1\">" << binFilename << "</SourceFilename>" << std::endl
-          << "<ImageOffset>" << imageOffset << "</ImageOffset>" << std::endl
-          << "<PixelOffset>" << pixelOffset << "</PixelOffset>" << std::endl
-          << "<LineOffset>" << lineOffset << "</LineOffset>";
-
-      vrtfile << std::endl << "</VRTRasterBand>";
-    }
+      RasterBlockKey sourceKey = key;
+      sourceKey.fileIdentity = sourceIdentity;
+      return DecodedRasterCache::getInstance().get(sourceKey, te::dt::FLOAT_TYPE, decode);
+    });
 
-    vrtfile << std::endl << "</VRTDataset>" << std::endl;
+    // the block is stored as float, rows are copied as they are
+    te::rst::Band* band = raster->getBand(bandIdx);
+    for (unsigned int rasterRow = 0; rasterRow < nRows; ++rasterRow)
+    {
+      std::memcpy(row.data(), block->data() + static_cast<std::size_t>(rasterRow) * nCols * sizeof(float), nCols * sizeof(float));
+      band->write(0, static_cast<int>(rasterRow), row.data());
+    }
   }
 
+  return raster;
 }
 
-
 std::string terrama2::core::trim(const std::string& value)
 {
   std::string str = value;
@@ -36,6 +36,18 @@
 #include "../core/Shared.hpp"
 #include "../core/data-access/DataAccessorGrid.hpp"
 
+//STL
+#include <memory>
+
+// Forward declaration
+namespace te
+{
+  namespace rst
+  {
+    class Raster;
+  }
+}
+
 namespace terrama2
 {
   namespace core
@@ -122,6 +134,18 @@ namespace terrama2
 
         void setKeyValue(const std::string& key, const std::string& value);
 
+        //! Checks if the option is set in the OPTIONS entry, case insensitive.
+        bool hasOption(const std::string& option) const;
+
+        //! Number of levels of the variable, surface variables have one level.
+        static int levels(const Var& var);
+
+        //! Number of X-Y grids of a time step, the sum of the levels of all variables.
+        std::size_t gridsPerTimeStep() const;
+
+        //! Size in bytes of a X-Y grid in the binary file, including the record markers of sequential files.
+        std::size_t gridSize() const;
+
       protected:
 
         TValueDef* getTValueDef(const std::string& value);
@@ -189,7 +213,8 @@ namespace terrama2
         //! Concatenate the given dataset to the complete dataset.
         virtual void addToCompleteDataSet(std::shared_ptr<te::da::DataSet> completeDataSet,
                                           std::shared_ptr<te::da::DataSet> dataSet,
-                                          std::shared_ptr<te::dt::TimeInstantTZ> fileTimestamp) const override;
+                                          std::shared_ptr<te::dt::TimeInstantTZ> fileTimestamp,
+                                          const Filter& filter) const override;
 
         terrama2::core::DataSetSeries getSeries(const std::string& uri,
                                                 const terrama2::core::Filter& filter,
@@ -198,16 +223,36 @@ namespace terrama2
 
         QString replaceMask(QString qString) const;
 
+        /*!
+          \brief Reads the descriptor of the CTL file.
+
+          Descriptors are cached by path, the file is parsed again only if its size or modification time changed.
+        */
         GrADSDataDescriptor readDataDescriptor(const std::string& filename) const;
 
         std::string getCtlFilename(DataSetPtr dataSet) const;
 
+        /*!
+          \brief Reads a GrADS binary file into an in-memory raster.
+
+          The file is memory-mapped and each X-Y grid is a band of the raster,
+          ordered by time step, variable and level, as stored in the file.
+          The band description is "variable:level:time step".
+
+          Only the complete time steps of the file are read, up to the number of time steps of the TDEF.
+
+          \param descriptor Descriptor read from the CTL file, the SRID must be set.
+          \param filename Path of the binary file.
+          \param decodedCache If true, the decoded bands are stored in the DecodedRasterCache.
+
+          \exception DataAccessorException Raised if the file can't be read or the descriptor has no linear X and Y definition.
+        */
+        std::unique_ptr<te::rst::Raster> readBinaryFile(const GrADSDataDescriptor& descriptor, const std::string& filename,
+                                                        bool decodedCache = false) const;
+
       protected:
         //! Returns the data source type.
         virtual std::string dataSourceType() const override;
-
-        void writeVRTFile(GrADSDataDescriptor descriptor, const std::string& binFilename,
-                          const std::string& vrtFilename) const;
     };
 
 
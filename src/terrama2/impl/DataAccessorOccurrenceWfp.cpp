@@ -33,6 +33,7 @@
 #include "../core/utility/Raii.hpp"
 #include "../core/utility/FilterUtils.hpp"
 #include "../core/utility/Utils.hpp"
+#include "../core/utility/CsvParser.hpp"
 
 // terralib
 #include <terralib/dataaccess/datasource/DataSourceFactory.h>
@@ -71,6 +72,41 @@ std::string terrama2::core::DataAccessorOccurrenceWfp::typePrefix() const
   return "CSV:";
 }
 
+std::shared_ptr<te::da::DataSet> terrama2::core::DataAccessorOccurrenceWfp::readFile(DataSetPtr dataSet,
+                                                                                     const std::string& filePath,
+                                                                                     std::shared_ptr<te::da::DataSetType>& dataSetType,
+                                                                                     FileCatalog::ReadPosition& /*position*/) const
+{
+  std::string timestampProperty = getTimestampPropertyName(dataSet);
+  std::string latitudeProperty = getLatitudePropertyName(dataSet);
+  std::string longitudeProperty = getLongitudePropertyName(dataSet);
+
+  CsvParser::Format format;
+  format.timezone = getTimeZone(dataSet);
+  format.geometryName = getGeometryPropertyName(dataSet);
+  format.srid = getSrid(dataSet);
+  format.column = [timestampProperty, latitudeProperty, longitudeProperty](const std::string& header)
+  {
+    CsvParser::Column column;
+    column.name = header;
+    if(header == timestampProperty)
+      column.type = CsvParser::ColumnType::TIMESTAMP;
+    else if(header == latitudeProperty)
+      column.type = CsvParser::ColumnType::LATITUDE;
+    else if(header == longitudeProperty)
+      column.type = CsvParser::ColumnType::LONGITUDE;
+    else // the only other columns is the satellite name
+      column.type = CsvParser::ColumnType::STRING;
+
+    return column;
+  };
+
+  CsvParser parser(format);
+  auto result = parser.parse(filePath);
+  dataSetType = result.dataSetType;
+  return result.dataSet;
+}
+
 void terrama2::core::DataAccessorOccurrenceWfp::adapt(DataSetPtr dataSet, std::shared_ptr<te::da::DataSetTypeConverter> converter) const
 {
   // only one timestamp column
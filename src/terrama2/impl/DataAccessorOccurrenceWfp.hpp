@@ -65,8 +65,12 @@ namespace terrama2
         virtual void adapt(DataSetPtr dataSet, std::shared_ptr<te::da::DataSetTypeConverter> converter) const override;
         virtual void addColumns(std::shared_ptr<te::da::DataSetTypeConverter>, const std::shared_ptr<te::da::DataSetType>&) const override;
 
+        //! Reads the WFP file with the native CSV parser.
+        virtual std::shared_ptr<te::da::DataSet> readFile(DataSetPtr dataSet, const std::string& filePath, std::shared_ptr<te::da::DataSetType>& dataSetType,
+                                                          FileCatalog::ReadPosition& position) const override;
+
         // WFP file may have delayed data that should not be filtered
-        virtual bool isValidTimestamp(std::shared_ptr<te::mem::DataSet> /*dataSet*/, const Filter& /*filter*/, size_t /*dateColumn*/) const override { return true; }
+        virtual bool isValidTimestamp(std::shared_ptr<te::da::DataSet> /*dataSet*/, const Filter& /*filter*/, size_t /*dateColumn*/) const override { return true; }
 
       private:
         //! Name of column with latitude information
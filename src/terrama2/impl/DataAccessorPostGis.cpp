@@ -30,6 +30,8 @@
 #include "DataAccessorPostGis.hpp"
 #include "../core/utility/Raii.hpp"
 #include "../core/utility/TimeUtils.hpp"
+#include "../core/utility/Utils.hpp"
+#include "../core/Exception.hpp"
 #include "../core/data-access/SynchronizedDataSet.hpp"
 
 // TerraLib
@@ -60,6 +62,44 @@
 #include <QUrl>
 #include <QObject>
 
+// Boost
+#include <boost/algorithm/string/replace.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+// STL
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace
+{
+  //! Connection parameters of the PostgreSQL database of the url.
+  std::map<std::string, std::string> connectionInfo(const QUrl& url)
+  {
+    return {{"PG_HOST", url.host().toStdString()},
+      {"PG_PORT", std::to_string(url.port())},
+      {"PG_USER", url.userName().toStdString()},
+      {"PG_PASSWORD", url.password().toStdString()},
+      {"PG_DB_NAME", url.path().section("/", 1, 1).toStdString()},
+      {"PG_CONNECT_TIMEOUT", "4"},
+      {"PG_CLIENT_ENCODING", "UTF-8"}
+    };
+  }
+
+  //! SQL literal of the timestamp in UTC.
+  std::string sqlTimestamp(const te::dt::TimeInstantTZ& timestamp)
+  {
+    std::string text = boost::posix_time::to_iso_extended_string(timestamp.getTimeInstantTZ().utc_time());
+
+    auto pos = text.find('T');
+    if(pos != std::string::npos)
+      text[pos] = ' ';
+
+    return "'"+text+"+00'";
+  }
+}
+
 terrama2::core::DataSetSeries terrama2::core::DataAccessorPostGis::getSeries(const std::string& uri, const terrama2::core::Filter& filter,
     terrama2::core::DataSetPtr dataSet) const
 {
@@ -71,16 +111,7 @@ terrama2::core::DataSetSeries terrama2::core::DataAccessorPostGis::getSeries(con
   // also joins if the DCP comes from separated files
   std::shared_ptr<te::da::DataSource> datasource(te::da::DataSourceFactory::make(dataSourceType()));
 
-  std::map<std::string, std::string> connInfo {{"PG_HOST", url.host().toStdString()},
-    {"PG_PORT", std::to_string(url.port())},
-    {"PG_USER", url.userName().toStdString()},
-    {"PG_PASSWORD", url.password().toStdString()},
-    {"PG_DB_NAME", url.path().section("/", 1, 1).toStdString()},
-    {"PG_CONNECT_TIMEOUT", "4"},
-    {"PG_CLIENT_ENCODING", "UTF-8"}
-  };
-
-  datasource->setConnectionInfo(connInfo);
+  datasource->setConnectionInfo(connectionInfo(url));
 
   // RAII for open/closing the datasource
   OpenClose<std::shared_ptr<te::da::DataSource>> openClose(datasource);
@@ -113,6 +144,7 @@ terrama2::core::DataSetSeries terrama2::core::DataAccessorPostGis::getSeries(con
   }
 
   where_ = addLastValueFilter(dataSet, filter, where_);
+  query += where_;
   std::shared_ptr<te::da::DataSet> tempDataSet = transactor->query(query);
 
   if(tempDataSet->isEmpty())
@@ -131,6 +163,62 @@ terrama2::core::DataSetSeries terrama2::core::DataAccessorPostGis::getSeries(con
   return series;
 }
 
+std::string terrama2::core::DataAccessorPostGis::dataVersion() const
+{
+  std::shared_ptr<te::da::DataSource> datasource(te::da::DataSourceFactory::make(dataSourceType()));
+  datasource->setConnectionInfo(connectionInfo(QUrl(QString::fromStdString(dataProvider_->uri))));
+
+  // RAII for open/closing the datasource
+  OpenClose<std::shared_ptr<te::da::DataSource>> openClose(datasource);
+  if(!datasource->isOpened())
+    return "";
+
+  std::shared_ptr<te::da::DataSourceTransactor> transactor(datasource->getTransactor());
+
+  std::string version;
+  for(const auto& dataSet : dataSeries_->datasetList)
+  {
+    if(!dataSet->active)
+      continue;
+
+    std::string tableName = getDataSetTableName(dataSet);
+
+    // the statistics counters change with every insert, update or delete in the table,
+    // partitioned tables have the counters in their partitions
+    std::vector<std::string> queries;
+    queries.push_back("SELECT SUM(n_tup_ins), SUM(n_tup_upd), SUM(n_tup_del) FROM pg_stat_user_tables"
+                      " WHERE relid = '"+tableName+"'::regclass"
+                      " OR relid IN (SELECT inhrelid FROM pg_inherits WHERE inhparent = '"+tableName+"'::regclass)");
+
+    std::string timestampProperty;
+    try
+    {
+      timestampProperty = getProperty(dataSet, dataSeries_, "timestamp_property", false);
+    }
+    catch(const UndefinedTagException&)
+    {
+      // static data, only the statistics identify changes
+    }
+
+    // the latest timestamp is read from the index, the table is not scanned
+    if(!timestampProperty.empty())
+      queries.push_back("SELECT MAX("+timestampProperty+") FROM "+tableName);
+
+    for(const auto& sql : queries)
+    {
+      std::unique_ptr<te::da::DataSet> tempDataSet(transactor->query(sql));
+      if(!tempDataSet || !tempDataSet->moveNext())
+        return "";
+
+      version += std::to_string(dataSet->id) + ":";
+      for(std::size_t i = 0; i < tempDataSet->getNumProperties(); ++i)
+        version += (tempDataSet->isNull(i) ? std::string() : tempDataSet->getAsString(i)) + "|";
+    }
+  }
+
+  return version;
+}
+
 std::string terrama2::core::DataAccessorPostGis::getDataSetTableName(DataSetPtr dataSet) const
 {
   try
@@ -159,11 +247,12 @@ void terrama2::core::DataAccessorPostGis::addDateTimeFilter(terrama2::core::Data
   if(!(filter.discardBefore.get() || filter.discardAfter.get()))
     return;
 
+  // constant bounds let PostgreSQL prune the partitions of partitioned tables when planning
   if(filter.discardBefore.get())
-    whereConditions.push_back(getTimestampPropertyName(dataSet)+" > "+filter.discardBefore->toString());
+    whereConditions.push_back(getTimestampPropertyName(dataSet)+" > "+sqlTimestamp(*filter.discardBefore));
 
   if(filter.discardAfter.get())
-    whereConditions.push_back(getTimestampPropertyName(dataSet)+" < "+filter.discardAfter->toString());
+    whereConditions.push_back(getTimestampPropertyName(dataSet)+" < "+sqlTimestamp(*filter.discardAfter));
 }
 
 void terrama2::core::DataAccessorPostGis::addGeometryFilter(terrama2::core::DataSetPtr dataSet,
@@ -171,7 +260,32 @@ void terrama2::core::DataAccessorPostGis::addGeometryFilter(terrama2::core::Data
     std::vector<std::string>& whereConditions) const
 {
   if(filter.region.get())
-    whereConditions.push_back(getGeometryPropertyName(dataSet)+".ST_INTERSECTS("+filter.region->asText()+")");
+    whereConditions.push_back(intersectsCondition(getDataSetTableName(dataSet), getGeometryPropertyName(dataSet), *filter.region));
+}
+
+std::string terrama2::core::DataAccessorPostGis::intersectsCondition(const std::string& tableName,
+                                                                     const std::string& geometryProperty,
+                                                                     const te::gm::Geometry& region)
+{
+  // unquoted names are stored in lower case in the geometry columns catalog
+  auto literal = [](std::string value)
+  {
+    std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+    boost::replace_all(value, "'", "''");
+    return "'"+value+"'";
+  };
+
+  std::string schema = "current_schema()::varchar";
+  std::string table = tableName;
+  auto pos = tableName.find('.');
+  if(pos != std::string::npos)
+  {
+    schema = literal(tableName.substr(0, pos));
+    table = tableName.substr(pos+1);
+  }
+
+  return "ST_Intersects("+geometryProperty+", ST_Transform(ST_GeomFromText('"+region.asText()+"', "+std::to_string(region.getSRID())+"), "
+         +"Find_SRID("+schema+", "+literal(table)+", "+literal(geometryProperty)+")))";
 }
 
 std::string terrama2::core::DataAccessorPostGis::addLastValueFilter(terrama2::core::DataSetPtr dataSet,
@@ -180,12 +294,19 @@ std::string terrama2::core::DataAccessorPostGis::addLastValueFilter(terrama2::co
 {
   if(filter.lastValue)
   {
+    std::string timestampProperty = getTimestampPropertyName(dataSet);
+
     std::string maxSelect = "SELECT ";
-    maxSelect += "MAX("+getTimestampPropertyName(dataSet)+") ";
+    maxSelect += "MAX("+timestampProperty+") ";
     maxSelect += "FROM " + getDataSetTableName(dataSet)+" ";
     maxSelect += whereCondition;
 
-    return "getTimestampPropertyName(dataSet) = ("+maxSelect+") AND "+whereCondition;
+    // the outer conditions are kept so the partitions are also pruned when planning,
+    // the other partitions are pruned during the execution with the result of the sub-query
+    if(whereCondition.empty())
+      return "WHERE "+timestampProperty+" = ("+maxSelect+")";
+
+    return whereCondition+" AND "+timestampProperty+" = ("+maxSelect+")";
   }
 
   return whereCondition;
@@ -246,5 +367,5 @@ void terrama2::core::DataAccessorPostGis::updateLastTimestamp(DataSetPtr dataSet
     throw terrama2::core::DataAccessorException() << ErrorDescription(errMsg);
   }
 
-  *lastDateTime_ = *lastDateTimeTz;
+  updateLastDateTime(*lastDateTimeTz);
 }
@@ -37,6 +37,7 @@
 #include "../core/data-model/Filter.hpp"
 
 #include <terralib/dataaccess/query/Expression.h>
+#include <terralib/geometry/Geometry.h>
 
 namespace terrama2
 {
@@ -61,6 +62,24 @@ namespace terrama2
         // Doc in base class
         virtual DataSetSeries getSeries(const std::string& uri, const terrama2::core::Filter& filter, terrama2::core::DataSetPtr dataSet) const override;
 
+        /*!
+          \brief Version of the tables of the active datasets.
+
+          The version is built from the latest timestamp
+          and the counters of inserted, updated and deleted rows of the table statistics,
+          the rows of the table are not counted.
+        */
+        virtual std::string dataVersion() const override;
+
+        /*!
+          \brief Returns the condition of the rows whose geometry intersects the region.
+
+          The region is transformed to the SRID of the geometry column,
+          the transformation is evaluated once so the spatial index of the column is used.
+        */
+        static std::string intersectsCondition(const std::string& tableName, const std::string& geometryProperty,
+                                               const te::gm::Geometry& region);
+
       protected:
         // Doc in base class
         virtual std::string retrieveData(const DataRetrieverPtr, DataSetPtr, const Filter&) const override;
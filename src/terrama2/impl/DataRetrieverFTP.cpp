@@ -28,6 +28,7 @@
 */
 
 // STL
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <vector>
@@ -41,6 +42,7 @@
 #include "../core/data-model/Filter.hpp"
 #include "../core/utility/FilterUtils.hpp"
 #include "../core/utility/Utils.hpp"
+#include "../core/utility/ScratchSpace.hpp"
 
 // Libcurl
 #include <curl/curl.h>
@@ -51,21 +53,19 @@
 // QT
 #include <QObject>
 #include <QDir>
+#include <QFileInfo>
 #include <QDebug>
 
 terrama2::core::DataRetrieverFTP::DataRetrieverFTP(DataProviderPtr dataprovider, CurlPtr&& curlwrapper)
   : DataRetriever(dataprovider),
     curlwrapper_(std::move(curlwrapper))
 {
-  // FIXME: this folder won't work on Windows
-  temporaryFolder_ = "/tmp/terrama2-download/";
+  // each retriever downloads to its own folder,
+  // the folder is removed when the retriever is released
+  scratchFolder_ = ScratchSpace::getInstance().createFolder("download");
+  temporaryFolder_ = scratchFolder_->path();
   scheme_ = "file://";
 
-  // Create the directory where you will download the files.
-  QDir dir(temporaryFolder_.c_str());
-  if (!dir.exists())
-    dir.mkpath(temporaryFolder_.c_str());
-
   curlwrapper_.init();
 
   // Verifies that the FTP address is valid
@@ -159,6 +159,10 @@ std::string terrama2::core::DataRetrieverFTP::retrieveData(const std::string& ma
             std::string uriOrigin = dataProvider_->uri +"/"+file;
             std::string filePath = temporaryFolder_+"/"+file;
 
+            // the size is checked before the download when the server reports it
+            int64_t expectedSize = curlwrapper_.getFileSize(uriOrigin);
+            ScratchSpace::getInstance().checkQuota(std::max(expectedSize, static_cast<int64_t>(0)));
+
             CURLcode res = curlwrapper_.getDownloadFiles(uriOrigin, &terrama2::core::DataRetrieverFTP::write_response, filePath);
 
             if (res != CURLE_OK)
@@ -169,6 +173,10 @@ std::string terrama2::core::DataRetrieverFTP::retrieveData(const std::string& ma
               TERRAMA2_LOG_ERROR() << errMsg;
               throw DataRetrieverException() << ErrorDescription(errMsg);
             }
+
+            ScratchSpace::getInstance().addUsage(QFileInfo(QString::fromStdString(filePath)).size());
+            // files downloaded again by other executions share the disk space
+            ScratchSpace::getInstance().shareFile(filePath);
           }
         }
       }
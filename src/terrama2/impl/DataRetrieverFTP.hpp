@@ -38,6 +38,7 @@
 // TerraMA2
 #include "../core/utility/Raii.hpp"
 #include "../core/utility/CurlPtr.hpp"
+#include "../core/utility/ScratchSpace.hpp"
 #include "../core/data-access/DataRetriever.hpp"
 #include "../core/Shared.hpp"
 
@@ -55,8 +56,8 @@ namespace terrama2
        * \brief The DataRetrieverFTP class performs the download of
        * occurrences of files, DCP-TOA5, DCP-INPE, GRADES ETA15km.
        *
-       * \warning The DataRetrieverFTP class only performs the download of files, but does not
-       * perform the removal of the files after downloading.
+       * The files are downloaded to a scratch folder of the retriever,
+       * the folder is removed after the retriever is released.
     */
     class DataRetrieverFTP: public DataRetriever
     {
@@ -65,11 +66,11 @@ namespace terrama2
        * \brief DataRetrieverFTP Constructor:
        * Initializes the Curl and check the URL to download.
        * Initializes scheme information. Ex. "file://".
-       * Initializes temporaFolder Folder information where the files will be saved. Ex. "/tmp/".
-       * Create the directory where you will download the files. Ex. "/tmp/terrama2-download/".
+       * Creates the scratch folder where the files will be downloaded.
        * \param dataprovider dataprovider Dataprovider information.
        * \exception DataRetrieverException when FTP address is invalid.
        * \exception DataRetreiverFTPException when unknown Error, FTP address is invalid.
+       * \exception ScratchSpaceException when the scratch folder can't be created.
       */
       explicit DataRetrieverFTP(DataProviderPtr dataprovider, CurlPtr&& curlwrapper);
 
@@ -120,7 +121,8 @@ namespace terrama2
     private:
       std::vector<std::string> vectorNames_; //! vector filtered names.
       std::string scheme_; //! scheme information. Ex. "file://".
-      std::string temporaryFolder_; //! Folder information where the files will be saved. Ex. "/tmp/".
+      ScratchFolderPtr scratchFolder_; //!< Folder where the files are downloaded, kept while the retriever is alive.
+      std::string temporaryFolder_; //! Folder information where the files will be saved.
       CurlPtr curlwrapper_; //!< Attribute for Handler CurlPtr.
     };
 
@@ -0,0 +1,254 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/impl/DataStoragerCsv.cpp
+
+  \brief Storager of delimited text files.
+
+  \author Jano Simas
+*/
+
+#include "DataStoragerCsv.hpp"
+#include "../core/data-model/DataProvider.hpp"
+#include "../core/data-model/DataSet.hpp"
+#include "../core/Exception.hpp"
+
+//terralib
+#include <terralib/dataaccess/dataset/DataSet.h>
+#include <terralib/datatype/Enums.h>
+
+//Qt
+#include <QDir>
+#include <QSaveFile>
+#include <QUrl>
+
+//Boost
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+//STL
+#include <algorithm>
+#include <cmath>
+
+terrama2::core::DataStoragerPtr terrama2::core::DataStoragerCsv::make(DataProviderPtr dataProvider)
+{
+  return std::make_shared<DataStoragerCsv>(dataProvider);
+}
+
+void terrama2::core::DataStoragerCsv::store(DataSetSeries series, DataSetPtr outputDataSet) const
+{
+  if(!outputDataSet.get() || !series.syncDataSet.get())
+  {
+    QString errMsg = QObject::tr("Mandatory parameters not provided.");
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw DataStoragerException() << ErrorDescription(errMsg);
+  }
+
+  auto dataset = series.syncDataSet->dataset();
+  const std::size_t numProperties = dataset->getNumProperties();
+
+  QByteArray data;
+  for(std::size_t i = 0; i < numProperties; ++i)
+  {
+    if(i > 0)
+      data.append(',');
+    appendText(data, dataset->getPropertyName(i));
+  }
+  data.append('\n');
+
+  // the first timestamp names the file
+  std::shared_ptr<te::dt::DateTime> timestamp;
+
+  dataset->moveBeforeFirst();
+  while(dataset->moveNext())
+  {
+    for(std::size_t i = 0; i < numProperties; ++i)
+    {
+      if(i > 0)
+        data.append(',');
+
+      if(dataset->isNull(i))
+        continue;
+
+      switch(dataset->getPropertyDataType(i))
+      {
+        case te::dt::DATETIME_TYPE:
+        {
+          std::shared_ptr<te::dt::DateTime> dateTime(dataset->getDateTime(i).release());
+          auto timeInstantTZ = std::dynamic_pointer_cast<te::dt::TimeInstantTZ>(dateTime);
+          data.append(timeInstantTZ ? formatTimestamp(*timeInstantTZ).c_str() : dateTime->toString().c_str());
+
+          if(!timestamp)
+            timestamp = dateTime;
+          break;
+        }
+        case te::dt::DOUBLE_TYPE:
+          data.append(QByteArray::number(dataset->getDouble(i), 'g', 17));
+          break;
+        case te::dt::FLOAT_TYPE:
+          data.append(QByteArray::number(dataset->getFloat(i), 'g', 9));
+          break;
+        case te::dt::STRING_TYPE:
+          appendText(data, dataset->getString(i));
+          break;
+        default:
+          appendText(data, dataset->getAsString(i));
+      }
+    }
+    data.append('\n');
+  }
+
+  writeFile(outputPath(outputDataSet, timestamp), data);
+}
+
+std::string terrama2::core::DataStoragerCsv::storeTable(const Table& table,
+                                                        std::shared_ptr<te::dt::TimeInstantTZ> timestamp,
+                                                        const std::string& timestampName,
+                                                        DataSetPtr outputDataSet) const
+{
+  if(!outputDataSet.get() || !timestamp.get())
+  {
+    QString errMsg = QObject::tr("Mandatory parameters not provided.");
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw DataStoragerException() << ErrorDescription(errMsg);
+  }
+
+  QByteArray data = toCsv(table, timestampName, formatTimestamp(*timestamp));
+
+  std::string path = outputPath(outputDataSet, timestamp);
+  writeFile(path, data);
+
+  return path;
+}
+
+QByteArray terrama2::core::DataStoragerCsv::toCsv(const Table& table, const std::string& timestampName, const std::string& timestamp)
+{
+  const std::size_t numRows = table.keys.size();
+  bool validColumns = table.columns.size() == table.names.size()
+                      && std::all_of(table.columns.begin(), table.columns.end(),
+                                     [numRows](const std::vector<double>& column) { return column.size() == numRows; });
+  if(!validColumns)
+  {
+    QString errMsg = QObject::tr("The columns of the table don't have a value for each row.");
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw DataStoragerException() << ErrorDescription(errMsg);
+  }
+
+  QByteArray data;
+  // estimated size of the rows, avoids reallocations while appending
+  data.reserve(static_cast<int>(numRows * (32 + timestamp.size() + 24 * table.names.size())));
+
+  appendText(data, table.keyName);
+  data.append(',');
+  appendText(data, timestampName);
+  for(const auto& name : table.names)
+  {
+    data.append(',');
+    appendText(data, name);
+  }
+  data.append('\n');
+
+  for(std::size_t row = 0; row < numRows; ++row)
+  {
+    appendText(data, table.keys[row]);
+    data.append(',');
+    data.append(timestamp.c_str());
+
+    for(const auto& column : table.columns)
+    {
+      data.append(',');
+
+      double value = column[row];
+      if(!std::isnan(value))
+        data.append(QByteArray::number(value, 'g', 17));
+    }
+    data.append('\n');
+  }
+
+  return data;
+}
+
+std::string terrama2::core::DataStoragerCsv::formatTimestamp(const te::dt::TimeInstantTZ& timestamp)
+{
+  std::string text = boost::posix_time::to_iso_extended_string(timestamp.getTimeInstantTZ().utc_time());
+
+  auto pos = text.find('T');
+  if(pos != std::string::npos)
+    text[pos] = ' ';
+
+  return text;
+}
+
+std::string terrama2::core::DataStoragerCsv::outputPath(DataSetPtr dataSet, std::shared_ptr<te::dt::DateTime> timestamp) const
+{
+  QUrl uri(QString::fromStdString(dataProvider_->uri));
+  QString folder = uri.path();
+
+  auto it = dataSet->format.find("folder");
+  if(it != dataSet->format.end() && !it->second.empty())
+    folder += "/" + QString::fromStdString(it->second);
+
+  if(!QDir().mkpath(folder))
+  {
+    QString errMsg = QObject::tr("Could not create the folder: %1.").arg(folder);
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw DataStoragerException() << ErrorDescription(errMsg);
+  }
+
+  std::string mask = getMask(dataSet);
+  if(mask.empty())
+  {
+    QString errMsg = QObject::tr("Empty mask for output file.");
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw DataStoragerException() << ErrorDescription(errMsg);
+  }
+
+  return folder.toStdString() + "/" + replaceMask(mask, timestamp, dataSet);
+}
+
+void terrama2::core::DataStoragerCsv::writeFile(const std::string& path, const QByteArray& data)
+{
+  QSaveFile file(QString::fromStdString(path));
+  if(!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit())
+  {
+    QString errMsg = QObject::tr("Could not write file: %1.").arg(QString::fromStdString(path));
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw DataStoragerException() << ErrorDescription(errMsg);
+  }
+}
+
+void terrama2::core::DataStoragerCsv::appendText(QByteArray& data, const std::string& text)
+{
+  if(text.find_first_of(",\"\r\n") == std::string::npos)
+  {
+    data.append(text.c_str(), static_cast<int>(text.size()));
+    return;
+  }
+
+  data.append('"');
+  for(char c : text)
+  {
+    if(c == '"')
+      data.append('"');
+    data.append(c);
+  }
+  data.append('"');
+}
@@ -0,0 +1,122 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/impl/DataStoragerCsv.hpp
+
+  \brief Storager of delimited text files.
+
+  \author Jano Simas
+*/
+
+#ifndef __TERRAMA2_IMPL_DATA_STORAGER_CSV_HPP__
+#define __TERRAMA2_IMPL_DATA_STORAGER_CSV_HPP__
+
+//TerraMA2
+#include "DataStoragerFile.hpp"
+
+//QT
+#include <QByteArray>
+
+//Terralib
+#include <terralib/datatype/TimeInstantTZ.h>
+
+//STL
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace terrama2
+{
+  namespace core
+  {
+    /*!
+      \brief Writes data to comma separated files in the folder of the data provider.
+
+      Each call writes a new file named by the mask of the dataset,
+      the files are replaced atomically so readers never see a partial file.
+
+      Timestamps are written in UTC with the format "%Y-%m-%d %H:%M:%S",
+      null values are empty fields, the files can be read with CsvParser.
+    */
+    class DataStoragerCsv : public DataStoragerFile
+    {
+      public:
+        //! Table with a text key column and columns of double values.
+        struct Table
+        {
+          std::string keyName; //!< Name of the key column.
+          std::vector<std::string> keys; //!< Key of each row.
+          std::vector<std::string> names; //!< Name of each value column.
+          std::vector<std::vector<double> > columns; //!< Values of each column, one value per row, NaN for null values.
+        };
+
+        DataStoragerCsv(DataProviderPtr outputDataProvider)
+                : DataStoragerFile(outputDataProvider) {}
+        ~DataStoragerCsv() {}
+
+        static DataStoragerPtr make(DataProviderPtr dataProvider);
+        static DataStoragerType dataStoragerType() { return "CSV"; }
+
+        /*!
+          \brief Writes the dataset of the series to a file.
+
+          The file is named by the first timestamp of the dataset.
+        */
+        virtual void store(DataSetSeries series, DataSetPtr outputDataSet) const override;
+
+        /*!
+          \brief Writes the table to a file named by the timestamp.
+
+          The values are written directly from the columns, without creating a dataset,
+          the timestamp is written in the column \e timestampName of all rows.
+
+          \return Path of the file.
+          \exception DataStoragerException Raised if the file can't be written.
+        */
+        std::string storeTable(const Table& table,
+                               std::shared_ptr<te::dt::TimeInstantTZ> timestamp,
+                               const std::string& timestampName,
+                               DataSetPtr outputDataSet) const;
+
+        //! Returns the text of the table, the timestamp is written in all rows.
+        static QByteArray toCsv(const Table& table, const std::string& timestampName, const std::string& timestamp);
+
+        //! Returns the timestamp in UTC in the format written to the files.
+        static std::string formatTimestamp(const te::dt::TimeInstantTZ& timestamp);
+
+      protected:
+        // Doc in base class
+        virtual std::string fileExtension() const override { return ".csv"; }
+
+        //! Returns the path of the file of the dataset for the timestamp, the folder is created if needed.
+        std::string outputPath(DataSetPtr dataSet, std::shared_ptr<te::dt::DateTime> timestamp) const;
+
+        //! Writes the data to the file, the previous file is only replaced if all data was written.
+        static void writeFile(const std::string& path, const QByteArray& data);
+
+        //! Appends the text as a field, quoted if it has delimiters or quotes.
+        static void appendText(QByteArray& data, const std::string& text);
+    };
+  }
+}
+
+#endif // __TERRAMA2_IMPL_DATA_STORAGER_CSV_HPP__
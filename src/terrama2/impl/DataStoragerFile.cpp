@@ -0,0 +1,197 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/impl/DataStoragerFile.cpp
+
+  \brief Base class of the storagers that write files named by a mask.
+
+  \author Jano Simas
+*/
+
+#include "DataStoragerFile.hpp"
+#include "../core/utility/Verify.hpp"
+#include "../core/Exception.hpp"
+
+//terralib
+#include <terralib/datatype/TimeInstant.h>
+
+//Boost
+#include <boost/date_time/local_time/local_time.hpp>
+
+//STL
+#include <iomanip>
+#include <sstream>
+
+std::string terrama2::core::DataStoragerFile::getMask(DataSetPtr dataSet) const
+{
+  try
+  {
+    return dataSet->format.at("mask");
+  }
+  catch(...)
+  {
+    QString errMsg = QObject::tr("Undefined mask in dataset: %1.").arg(dataSet->id);
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw UndefinedTagException() << ErrorDescription(errMsg);
+  }
+}
+
+std::string terrama2::core::DataStoragerFile::getTimezone(DataSetPtr dataSet, bool logError) const
+{
+  try
+  {
+    return dataSet->format.at("timezone");
+  }
+  catch(...)
+  {
+    QString errMsg = QObject::tr("Undefined timezone in dataset: %1.").arg(dataSet->id);
+    if(logError)
+      TERRAMA2_LOG_ERROR() << errMsg;
+    throw UndefinedTagException() << ErrorDescription(errMsg);
+  }
+}
+
+std::string terrama2::core::DataStoragerFile::zeroPadNumber(long num, int size) const
+{
+  std::ostringstream ss;
+  ss << std::setw(size) << std::setfill('0') << num;
+  return ss.str();
+}
+
+std::string terrama2::core::DataStoragerFile::replaceMask(const std::string& mask,
+                                                          std::shared_ptr<te::dt::DateTime> timestamp,
+                                                          terrama2::core::DataSetPtr dataSet) const
+{
+  if(!timestamp.get())
+    return mask;
+
+  long year = 0;
+  long month = 0;
+  long day = 0;
+  long hour = 0;
+  long minutes = 0;
+  long seconds = 0;
+
+  if(timestamp->getDateTimeType() == te::dt::TIME_INSTANT)
+  {
+    auto dateTime = std::dynamic_pointer_cast<te::dt::TimeInstant>(timestamp);
+    //invalid date type
+    try
+    {
+      verify::date(dateTime);
+    }
+    catch (const VerifyException&)
+    {
+      return mask;
+    }
+
+    auto date = dateTime->getDate();
+    year = date.getYear();
+    month = date.getMonth().as_number();
+    day = date.getDay().as_number();
+
+    auto time = dateTime->getTime();
+    hour = time.getHours();
+    minutes = time.getMinutes();
+    seconds = time.getSeconds();
+  }
+  else if(timestamp->getDateTimeType() == te::dt::TIME_INSTANT_TZ)
+  {
+    auto dateTime = std::dynamic_pointer_cast<te::dt::TimeInstantTZ>(timestamp);
+    try
+    {
+      verify::date(dateTime);
+    }
+    catch (const VerifyException&)
+    {
+      return mask;
+    }
+
+    std::string timezone;
+    try
+    {
+      //get dataset timezone
+      timezone = getTimezone(dataSet, false);
+    }
+    catch(const terrama2::core::UndefinedTagException&)
+    {
+      //if no timezone is set use UTC
+      timezone = "UTC+00";
+    }
+
+    auto boostLocalTime = dateTime->getTimeInstantTZ();
+    boost::local_time::time_zone_ptr zone(new boost::local_time::posix_time_zone(timezone));
+    auto localTime = boostLocalTime.local_time_in(zone);
+    auto date = localTime.date();
+    year = date.year();
+    month = date.month().as_number();
+    day = date.day();
+
+    auto time = localTime.time_of_day();
+    hour = time.hours();
+    minutes = time.minutes();
+    seconds = time.seconds();
+  }
+  else
+  {
+    //This method expects a valid Date/Time, other formats are not valid.
+    QString errMsg = QObject::tr("Unknown date format.");
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw terrama2::core::DataAccessorException() << ErrorDescription(errMsg);
+  }
+
+  //replace wildcards in mask
+  std::string fileName = mask;
+  size_t pos = fileName.find("yyyy");
+  if(pos != std::string::npos)
+    fileName.replace(pos, 4, zeroPadNumber(year, 4));
+
+  pos = fileName.find("yy");
+  if(pos != std::string::npos)
+    fileName.replace(pos, 2, zeroPadNumber(year, 2));
+
+  pos = fileName.find("MM");
+  if(pos != std::string::npos)
+    fileName.replace(pos, 2, zeroPadNumber(month, 2));
+
+  pos = fileName.find("dd");
+  if(pos != std::string::npos)
+    fileName.replace(pos, 2, zeroPadNumber(day, 2));
+
+  pos = fileName.find("hh");
+  if(pos != std::string::npos)
+    fileName.replace(pos, 2, zeroPadNumber(hour, 2));
+
+  pos = fileName.find("mm");
+  if(pos != std::string::npos)
+    fileName.replace(pos, 2, zeroPadNumber(minutes, 2));
+
+  pos = fileName.find("ss");
+  if(pos != std::string::npos)
+    fileName.replace(pos, 2, zeroPadNumber(seconds, 2));
+
+  //if no extension in the mask, add extension
+  pos = fileName.find(fileExtension());
+  if(pos == std::string::npos)
+    fileName += fileExtension();
+  return fileName;
+}
@@ -0,0 +1,84 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/impl/DataStoragerFile.hpp
+
+  \brief Base class of the storagers that write files named by a mask.
+
+  \author Jano Simas
+*/
+
+#ifndef __TERRAMA2_IMPL_DATA_STORAGER_FILE_HPP__
+#define __TERRAMA2_IMPL_DATA_STORAGER_FILE_HPP__
+
+//TerraMA2
+#include "../core/data-access/DataStorager.hpp"
+#include "../core/utility/Logger.hpp"
+
+//QT
+#include <QString>
+#include <QObject>
+
+//Terralib
+#include <terralib/datatype/DateTime.h>
+
+//STL
+#include <memory>
+#include <string>
+
+namespace terrama2
+{
+  namespace core
+  {
+    /*!
+      \brief Base class of the storagers that write files in the folder of the data provider.
+
+      The name of the file is the mask of the dataset with the date wildcards replaced by the timestamp of the data.
+    */
+    class DataStoragerFile : public DataStorager
+    {
+      public:
+        DataStoragerFile(DataProviderPtr outputDataProvider)
+                : DataStorager(outputDataProvider) {}
+        virtual ~DataStoragerFile() = default;
+
+      protected:
+        std::string getMask(DataSetPtr dataSet) const;
+        std::string getTimezone(DataSetPtr dataSet, bool logError = true) const;
+        std::string zeroPadNumber(long num, int size) const;
+
+        /*!
+          \brief Replaces the date wildcards of the mask by the timestamp in the timezone of the dataset.
+
+          The file extension is added if the mask doesn't have it.
+        */
+        std::string replaceMask(const std::string& mask,
+                                std::shared_ptr<te::dt::DateTime> timestamp,
+                                terrama2::core::DataSetPtr dataSet) const;
+
+        //! Extension of the files, with the dot.
+        virtual std::string fileExtension() const = 0;
+    };
+  }
+}
+
+#endif // __TERRAMA2_IMPL_DATA_STORAGER_FILE_HPP__
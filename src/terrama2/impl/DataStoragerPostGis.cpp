@@ -31,6 +31,7 @@
 
 #include "../core/data-model/DataProvider.hpp"
 #include "../core/utility/Raii.hpp"
+#include "../core/Exception.hpp"
 
 //terralib
 #include <terralib/dataaccess/datasource/DataSourceTransactor.h>
@@ -39,12 +40,71 @@
 #include <terralib/dataaccess/datasource/DataSource.h>
 #include <terralib/geometry/GeometryProperty.h>
 #include <terralib/dataaccess/utils/Utils.h>
+#include <terralib/dataaccess/dataset/DataSetType.h>
+#include <terralib/dataaccess/dataset/Index.h>
+#include <terralib/dataaccess/dataset/PrimaryKey.h>
+#include <terralib/dataaccess/dataset/UniqueKey.h>
+#include <terralib/datatype/DateTimeProperty.h>
+#include <terralib/datatype/SimpleProperty.h>
+#include <terralib/datatype/StringProperty.h>
+#include <terralib/datatype/TimeInstant.h>
+#include <terralib/datatype/TimeInstantTZ.h>
 
 //Qt
 #include <QUrl>
 
+//Boost
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/join.hpp>
+#include <boost/algorithm/string/replace.hpp>
+#include <boost/algorithm/string/split.hpp>
+
 //STL
 #include <algorithm>
+#include <vector>
+
+namespace
+{
+  //! Names of the properties.
+  std::vector<std::string> propertyNames(const std::vector<te::dt::Property*>& properties)
+  {
+    std::vector<std::string> names;
+    for(const auto& property : properties)
+      names.push_back(property->getName());
+
+    return names;
+  }
+
+  bool contains(const std::vector<std::string>& names, const std::string& name)
+  {
+    return std::find(names.begin(), names.end(), name) != names.end();
+  }
+
+  //! Quotes the name, folded to lower case as PostgreSQL does with unquoted names.
+  std::string quoteIdentifier(std::string name)
+  {
+    std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+    boost::replace_all(name, "\"", "\"\"");
+    return "\""+name+"\"";
+  }
+
+  //! Quoted names of the properties, separated by commas.
+  std::string quotedList(const std::vector<std::string>& names)
+  {
+    std::vector<std::string> quoted;
+    for(const auto& name : names)
+      quoted.push_back(quoteIdentifier(name));
+
+    return boost::algorithm::join(quoted, ", ");
+  }
+
+  //! Name of the table without the schema, indexes are always created in the schema of the table.
+  std::string unqualifiedName(const std::string& tableName)
+  {
+    auto pos = tableName.rfind('.');
+    return pos == std::string::npos ? tableName : tableName.substr(pos+1);
+  }
+}
 
 void terrama2::core::DataStoragerPostGis::store(DataSetSeries series, DataSetPtr outputDataSet) const
 {
@@ -82,36 +142,51 @@ void terrama2::core::DataStoragerPostGis::store(DataSetSeries series, DataSetPtr
 
   std::shared_ptr<te::da::DataSetType> datasetType = series.teDataSetType;
 
+  PartitionInterval partitionInterval = getPartitionInterval(outputDataSet);
+  std::string partitionProperty;
+  if(partitionInterval != PartitionInterval::NONE)
+    partitionProperty = getPartitionProperty(outputDataSet, *datasetType);
+
+  bool partitioned = partitionInterval != PartitionInterval::NONE && isPartitioned(transactorDestination, destinationDataSetName);
 
   std::map<std::string, std::string> options;
   std::shared_ptr<te::da::DataSetType> newDataSetType;
-  if (!transactorDestination->dataSetExists(destinationDataSetName))
+  if (!partitioned && !transactorDestination->dataSetExists(destinationDataSetName))
   {
-    // create and save datasettype in the datasource destination
-    newDataSetType = std::shared_ptr<te::da::DataSetType>(static_cast<te::da::DataSetType*>(datasetType->clone()));
-    if(!newDataSetType->getPrimaryKey())
+    if(partitionInterval != PartitionInterval::NONE)
     {
-      std::string pkName = "\""+newDataSetType->getName()+"_pk\"";
-      auto pk = new te::da::PrimaryKey(pkName, newDataSetType.get());
+      createPartitionedTable(transactorDestination, *datasetType, destinationDataSetName, partitionProperty);
+      partitioned = true;
 
-      te::dt::SimpleProperty* serialPk = new te::dt::SimpleProperty("pid", te::dt::INT32_TYPE, true);
-      serialPk->setAutoNumber(true);
-      newDataSetType->add(serialPk);
-      pk->add(serialPk);
+      newDataSetType = transactorDestination->getDataSetType(destinationDataSetName);
     }
-
-    newDataSetType->setName(destinationDataSetName);
-    transactorDestination->createDataSet(newDataSetType.get(),options);
-
-    //Get original geometry to get srid
-    te::gm::GeometryProperty* geom = GetFirstGeomProperty(datasetType.get());
-    //configure if there is a geometry property
-    if(geom)
+    else
     {
-      GetFirstGeomProperty(newDataSetType.get())->setSRID(geom->getSRID());
-      GetFirstGeomProperty(newDataSetType.get())->setGeometryType(te::gm::GeometryType);
+      // create and save datasettype in the datasource destination
+      newDataSetType = std::shared_ptr<te::da::DataSetType>(static_cast<te::da::DataSetType*>(datasetType->clone()));
+      if(!newDataSetType->getPrimaryKey())
+      {
+        std::string pkName = "\""+newDataSetType->getName()+"_pk\"";
+        auto pk = new te::da::PrimaryKey(pkName, newDataSetType.get());
+
+        te::dt::SimpleProperty* serialPk = new te::dt::SimpleProperty("pid", te::dt::INT32_TYPE, true);
+        serialPk->setAutoNumber(true);
+        newDataSetType->add(serialPk);
+        pk->add(serialPk);
+      }
+
+      newDataSetType->setName(destinationDataSetName);
+      transactorDestination->createDataSet(newDataSetType.get(),options);
+
+      //Get original geometry to get srid
+      te::gm::GeometryProperty* geom = GetFirstGeomProperty(datasetType.get());
+      //configure if there is a geometry property
+      if(geom)
+      {
+        GetFirstGeomProperty(newDataSetType.get())->setSRID(geom->getSRID());
+        GetFirstGeomProperty(newDataSetType.get())->setGeometryType(te::gm::GeometryType);
+      }
     }
-
   }
   else
   {
@@ -126,6 +201,31 @@ void terrama2::core::DataStoragerPostGis::store(DataSetSeries series, DataSetPtr
       transactorDestination->addProperty(newDataSetType->getName(), property);
   }
 
+  if(partitioned)
+  {
+    // rows without a partition for their timestamp can't be inserted
+    auto dataset = series.syncDataSet->dataset();
+    std::size_t partitionPos = te::da::GetPropertyPos(dataset.get(), partitionProperty);
+    auto dateTimeProperty = dynamic_cast<te::dt::DateTimeProperty*>(datasetType->getProperty(partitionProperty));
+    bool withTimeZone = dateTimeProperty && dateTimeProperty->getSubType() == te::dt::TIME_INSTANT_TZ;
+
+    std::set<boost::gregorian::date> dates;
+    dataset->moveBeforeFirst();
+    while(dataset->moveNext())
+    {
+      if(dataset->isNull(partitionPos))
+        continue;
+
+      std::shared_ptr<te::dt::DateTime> dateTime(dataset->getDateTime(partitionPos).release());
+      if(auto timeInstantTz = std::dynamic_pointer_cast<te::dt::TimeInstantTZ>(dateTime))
+        dates.insert(timeInstantTz->getTimeInstantTZ().utc_time().date());
+      else if(auto timeInstant = std::dynamic_pointer_cast<te::dt::TimeInstant>(dateTime))
+        dates.insert(timeInstant->getTimeInstant().date());
+    }
+
+    createPartitions(transactorDestination, outputDataSet, destinationDataSetName, partitionInterval, withTimeZone, dates);
+  }
+
   series.syncDataSet->dataset()->moveBeforeFirst();
   transactorDestination->add(newDataSetType->getName(), series.syncDataSet->dataset().get(), options);
 
@@ -173,3 +273,286 @@ bool terrama2::core::DataStoragerPostGis::isPropertyEqual(te::dt::Property* newP
 
   return true;
 }
+
+terrama2::core::DataStoragerPostGis::PartitionInterval terrama2::core::DataStoragerPostGis::getPartitionInterval(DataSetPtr dataSet) const
+{
+  auto it = dataSet->format.find("partition_interval");
+  if(it == dataSet->format.end() || it->second.empty())
+    return PartitionInterval::NONE;
+
+  const std::string& interval = it->second;
+  if(interval == "day")
+    return PartitionInterval::DAY;
+  if(interval == "week")
+    return PartitionInterval::WEEK;
+  if(interval == "month")
+    return PartitionInterval::MONTH;
+  if(interval == "year")
+    return PartitionInterval::YEAR;
+
+  QString errMsg = QObject::tr("Unknown partition interval in dataset %1: %2.").arg(dataSet->id).arg(QString::fromStdString(interval));
+  TERRAMA2_LOG_ERROR() << errMsg;
+  throw DataStoragerException() << ErrorDescription(errMsg);
+}
+
+std::string terrama2::core::DataStoragerPostGis::getPartitionProperty(DataSetPtr dataSet, const te::da::DataSetType& dataSetType) const
+{
+  auto it = dataSet->format.find("timestamp_property");
+  if(it != dataSet->format.end() && dataSetType.getProperty(it->second))
+    return it->second;
+
+  for(const auto& property : dataSetType.getProperties())
+  {
+    auto dateTimeProperty = dynamic_cast<const te::dt::DateTimeProperty*>(property);
+    if(dateTimeProperty
+       && (dateTimeProperty->getSubType() == te::dt::TIME_INSTANT || dateTimeProperty->getSubType() == te::dt::TIME_INSTANT_TZ))
+      return property->getName();
+  }
+
+  QString errMsg = QObject::tr("Partitioned tables need a timestamp property, dataset: %1.").arg(dataSet->id);
+  TERRAMA2_LOG_ERROR() << errMsg;
+  throw DataStoragerException() << ErrorDescription(errMsg);
+}
+
+bool terrama2::core::DataStoragerPostGis::isPartitioned(std::shared_ptr<te::da::DataSourceTransactor> transactor, const std::string& tableName) const
+{
+  std::unique_ptr<te::da::DataSet> result(transactor->query("SELECT 1 FROM pg_partitioned_table WHERE partrelid = to_regclass('"+tableName+"')"));
+  return result && result->moveNext();
+}
+
+void terrama2::core::DataStoragerPostGis::createPartitionedTable(std::shared_ptr<te::da::DataSourceTransactor> transactor,
+                                                                 const te::da::DataSetType& dataSetType,
+                                                                 const std::string& tableName,
+                                                                 const std::string& partitionProperty) const
+{
+  std::vector<std::string> definitions;
+  std::vector<std::string> primaryKey;
+  if(dataSetType.getPrimaryKey())
+  {
+    primaryKey = propertyNames(dataSetType.getPrimaryKey()->getProperties());
+  }
+  else
+  {
+    definitions.push_back("pid SERIAL");
+    primaryKey.push_back("pid");
+  }
+
+  for(const auto& property : dataSetType.getProperties())
+  {
+    std::string definition = quoteIdentifier(property->getName())+" "+sqlType(property);
+
+    auto simpleProperty = dynamic_cast<const te::dt::SimpleProperty*>(property);
+    if(property->getName() == partitionProperty || (simpleProperty && simpleProperty->isRequired()))
+      definition += " NOT NULL";
+
+    definitions.push_back(definition);
+  }
+
+  // keys of partitioned tables must contain the partition key
+  if(!contains(primaryKey, partitionProperty))
+    primaryKey.push_back(partitionProperty);
+  definitions.push_back("PRIMARY KEY ("+quotedList(primaryKey)+")");
+
+  for(std::size_t i = 0; i < dataSetType.getNumberOfUniqueKeys(); ++i)
+  {
+    auto uniqueKey = dataSetType.getUniqueKey(i);
+    auto names = propertyNames(uniqueKey->getProperties());
+    if(!contains(names, partitionProperty))
+    {
+      TERRAMA2_LOG_WARNING() << QObject::tr("Unique key %1 doesn't contain the partition key %2, it's not created.")
+                                .arg(QString::fromStdString(uniqueKey->getName()), QString::fromStdString(partitionProperty));
+      continue;
+    }
+
+    definitions.push_back("CONSTRAINT "+quoteIdentifier(uniqueKey->getName())+" UNIQUE ("+quotedList(names)+")");
+  }
+
+  const std::string quotedTableName = quoteTableName(tableName);
+  transactor->execute("CREATE TABLE "+quotedTableName+" ("+boost::algorithm::join(definitions, ", ")+") PARTITION BY RANGE ("+quoteIdentifier(partitionProperty)+")");
+
+  // indexes of a partitioned table are created in all its partitions, also in the partitions created later
+  bool hasPartitionIndex = false;
+  for(std::size_t i = 0; i < dataSetType.getNumberOfIndexes(); ++i)
+  {
+    auto index = dataSetType.getIndex(i);
+    auto names = propertyNames(index->getProperties());
+    if(names.empty())
+      continue;
+
+    hasPartitionIndex = hasPartitionIndex || names.front() == partitionProperty;
+
+    std::string method;
+    switch(index->getIndexType())
+    {
+      case te::da::R_TREE_TYPE:
+      case te::da::QUAD_TREE_TYPE:
+        method = " USING GIST";
+        break;
+      case te::da::HASH_TYPE:
+        method = " USING HASH";
+        break;
+      default:
+        break;
+    }
+
+    transactor->execute("CREATE INDEX "+quoteIdentifier(unqualifiedName(index->getName()))+" ON "+quotedTableName+method+" ("+quotedList(names)+")");
+  }
+
+  // used by the last value and date range reads inside each partition
+  const std::string indexPrefix = unqualifiedName(tableName)+"_";
+  if(!hasPartitionIndex)
+    transactor->execute("CREATE INDEX "+quoteIdentifier(indexPrefix+partitionProperty+"_idx")+" ON "+quotedTableName+" ("+quoteIdentifier(partitionProperty)+")");
+
+  auto geometryProperty = te::da::GetFirstGeomProperty(&dataSetType);
+  if(geometryProperty)
+    transactor->execute("CREATE INDEX "+quoteIdentifier(indexPrefix+geometryProperty->getName()+"_idx")+" ON "+quotedTableName
+                        +" USING GIST ("+quoteIdentifier(geometryProperty->getName())+")");
+}
+
+void terrama2::core::DataStoragerPostGis::createPartitions(std::shared_ptr<te::da::DataSourceTransactor> transactor,
+                                                           DataSetPtr dataSet,
+                                                           const std::string& tableName,
+                                                           PartitionInterval interval,
+                                                           bool withTimeZone,
+                                                           const std::set<boost::gregorian::date>& dates) const
+{
+  int partitionsAhead = 2;
+  auto it = dataSet->format.find("partitions_ahead");
+  if(it != dataSet->format.end())
+  {
+    bool ok = false;
+    int value = QString::fromStdString(it->second).toInt(&ok);
+    if(ok && value >= 0)
+      partitionsAhead = value;
+    else
+      TERRAMA2_LOG_WARNING() << QObject::tr("Invalid number of partitions ahead in dataset %1: %2.").arg(dataSet->id).arg(QString::fromStdString(it->second));
+  }
+
+  std::set<boost::gregorian::date> starts;
+  for(const auto& day : dates)
+    starts.insert(partitionStart(day, interval));
+
+  auto start = partitionStart(boost::gregorian::day_clock::universal_day(), interval);
+  for(int i = 0; i <= partitionsAhead; ++i)
+  {
+    starts.insert(start);
+    start = nextPartitionStart(start, interval);
+  }
+
+  for(const auto& partition : starts)
+    transactor->execute(createPartitionSql(tableName, partition, interval, withTimeZone));
+}
+
+boost::gregorian::date terrama2::core::DataStoragerPostGis::partitionStart(const boost::gregorian::date& day, PartitionInterval interval)
+{
+  switch(interval)
+  {
+    case PartitionInterval::WEEK:
+    {
+      // day_of_week is 0 on sunday
+      int daysSinceMonday = (day.day_of_week().as_number() + 6) % 7;
+      return day - boost::gregorian::days(daysSinceMonday);
+    }
+    case PartitionInterval::MONTH:
+      return boost::gregorian::date(day.year(), day.month(), 1);
+    case PartitionInterval::YEAR:
+      return boost::gregorian::date(day.year(), 1, 1);
+    default:
+      return day;
+  }
+}
+
+boost::gregorian::date terrama2::core::DataStoragerPostGis::nextPartitionStart(const boost::gregorian::date& start, PartitionInterval interval)
+{
+  switch(interval)
+  {
+    case PartitionInterval::WEEK:
+      return start + boost::gregorian::weeks(1);
+    case PartitionInterval::MONTH:
+      return start + boost::gregorian::months(1);
+    case PartitionInterval::YEAR:
+      return start + boost::gregorian::years(1);
+    default:
+      return start + boost::gregorian::days(1);
+  }
+}
+
+std::string terrama2::core::DataStoragerPostGis::createPartitionSql(const std::string& tableName, const boost::gregorian::date& start,
+                                                                    PartitionInterval interval, bool withTimeZone)
+{
+  const std::string timeOfDay = withTimeZone ? " 00:00:00+00" : " 00:00:00";
+  auto end = nextPartitionStart(start, interval);
+
+  return "CREATE TABLE IF NOT EXISTS "+quoteTableName(tableName+"_"+boost::gregorian::to_iso_string(start))
+         +" PARTITION OF "+quoteTableName(tableName)
+         +" FOR VALUES FROM ('"+boost::gregorian::to_iso_extended_string(start)+timeOfDay+"')"
+         +" TO ('"+boost::gregorian::to_iso_extended_string(end)+timeOfDay+"')";
+}
+
+std::string terrama2::core::DataStoragerPostGis::quoteTableName(const std::string& tableName)
+{
+  std::vector<std::string> parts;
+  boost::algorithm::split(parts, tableName, boost::algorithm::is_any_of("."));
+
+  std::vector<std::string> quoted;
+  for(const auto& part : parts)
+    quoted.push_back(quoteIdentifier(part));
+
+  return boost::algorithm::join(quoted, ".");
+}
+
+std::string terrama2::core::DataStoragerPostGis::sqlType(const te::dt::Property* property)
+{
+  switch(property->getType())
+  {
+    case te::dt::BOOLEAN_TYPE:
+      return "BOOLEAN";
+    case te::dt::INT16_TYPE:
+      return "SMALLINT";
+    case te::dt::INT32_TYPE:
+      return "INTEGER";
+    case te::dt::INT64_TYPE:
+      return "BIGINT";
+    case te::dt::FLOAT_TYPE:
+      return "REAL";
+    case te::dt::DOUBLE_TYPE:
+      return "DOUBLE PRECISION";
+    case te::dt::NUMERIC_TYPE:
+      return "NUMERIC";
+    case te::dt::STRING_TYPE:
+    {
+      auto stringProperty = static_cast<const te::dt::StringProperty*>(property);
+      if(stringProperty->size() == 0)
+        return "TEXT";
+      if(stringProperty->getSubType() == te::dt::FIXED_STRING)
+        return "CHAR("+std::to_string(stringProperty->size())+")";
+      if(stringProperty->getSubType() == te::dt::VAR_STRING)
+        return "VARCHAR("+std::to_string(stringProperty->size())+")";
+      return "TEXT";
+    }
+    case te::dt::DATETIME_TYPE:
+    {
+      auto dateTimeProperty = static_cast<const te::dt::DateTimeProperty*>(property);
+      if(dateTimeProperty->getSubType() == te::dt::DATE)
+        return "DATE";
+      if(dateTimeProperty->getSubType() == te::dt::TIME_INSTANT)
+        return "TIMESTAMP";
+      if(dateTimeProperty->getSubType() == te::dt::TIME_INSTANT_TZ)
+        return "TIMESTAMP WITH TIME ZONE";
+      break;
+    }
+    case te::dt::GEOMETRY_TYPE:
+    {
+      auto geometryProperty = static_cast<const te::gm::GeometryProperty*>(property);
+      if(geometryProperty->getSRID() <= 0)
+        return "GEOMETRY";
+      return "GEOMETRY(Geometry, "+std::to_string(geometryProperty->getSRID())+")";
+    }
+    default:
+      break;
+  }
+
+  QString errMsg = QObject::tr("Property type not supported in partitioned tables: %1.").arg(QString::fromStdString(property->getName()));
+  TERRAMA2_LOG_ERROR() << errMsg;
+  throw DataStoragerException() << ErrorDescription(errMsg);
+}
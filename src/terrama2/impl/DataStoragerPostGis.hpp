@@ -38,13 +38,52 @@
 #include <QString>
 #include <QObject>
 
+//Boost
+#include <boost/date_time/gregorian/gregorian.hpp>
+
+//STL
+#include <memory>
+#include <set>
+#include <string>
+
+namespace te
+{
+  namespace da
+  {
+    class DataSetType;
+    class DataSourceTransactor;
+  }
+}
+
 namespace terrama2
 {
   namespace core
   {
+    /*!
+      \brief Stores the data in a PostGIS table, the table is created if needed.
+
+      If the dataset has the format "partition_interval" ("day", "week", "month" or "year"),
+      the table is created as a PostgreSQL table partitioned by range of the timestamp property.
+      The partitions of the stored data and the next "partitions_ahead" partitions (default 2)
+      are created on each store, the indexes of the table are created in all partitions.
+
+      The partition key is the "timestamp_property" of the dataset format or the first date and time property,
+      unique keys that don't contain the partition key are not created.
+      Tables that already exist are not converted.
+    */
     class DataStoragerPostGis : public DataStorager
     {
       public:
+        //! Range of time of each partition of a table.
+        enum class PartitionInterval
+        {
+          NONE, //!< The table isn't partitioned.
+          DAY,
+          WEEK, //!< Weeks start on monday.
+          MONTH,
+          YEAR
+        };
+
         DataStoragerPostGis(DataProviderPtr outputDataProvider)
                 : DataStorager(outputDataProvider) {}
         ~DataStoragerPostGis() {}
@@ -54,8 +93,76 @@ namespace terrama2
 
         virtual void store(DataSetSeries series, DataSetPtr outputDataSet) const override;
 
+        //! Returns the first day of the partition that contains the date.
+        static boost::gregorian::date partitionStart(const boost::gregorian::date& date, PartitionInterval interval);
+
+        //! Returns the first day of the partition after the partition that starts in \e start.
+        static boost::gregorian::date nextPartitionStart(const boost::gregorian::date& start, PartitionInterval interval);
+
+        /*!
+          \brief Returns the statement that creates the partition, if it doesn't exist.
+
+          \param tableName Name of the partitioned table.
+          \param start First day of the partition.
+          \param interval Range of time of the partition.
+          \param withTimeZone If true, the bounds of the partition are in UTC.
+        */
+        static std::string createPartitionSql(const std::string& tableName, const boost::gregorian::date& start,
+                                              PartitionInterval interval, bool withTimeZone);
+
+        /*!
+          \brief Returns the quoted name of the table, each part of a schema-qualified name is quoted.
+
+          Names are folded to lower case, as PostgreSQL does with unquoted names,
+          so the table is also found by queries with unquoted names.
+        */
+        static std::string quoteTableName(const std::string& tableName);
+
       protected:
         std::string getDataSetTableName(DataSetPtr dataSet) const;
+
+        /*!
+          \brief Returns the partition interval of the dataset format.
+
+          \exception DataStoragerException Raised if the interval is unknown.
+        */
+        PartitionInterval getPartitionInterval(DataSetPtr dataSet) const;
+
+        /*!
+          \brief Returns the name of the partition key property.
+
+          \exception DataStoragerException Raised if the dataset type has no date and time property.
+        */
+        std::string getPartitionProperty(DataSetPtr dataSet, const te::da::DataSetType& dataSetType) const;
+
+        //! Returns true if the table exists and is partitioned.
+        bool isPartitioned(std::shared_ptr<te::da::DataSourceTransactor> transactor, const std::string& tableName) const;
+
+        //! Creates the partitioned table with the properties, keys and indexes of the dataset type.
+        void createPartitionedTable(std::shared_ptr<te::da::DataSourceTransactor> transactor,
+                                    const te::da::DataSetType& dataSetType,
+                                    const std::string& tableName,
+                                    const std::string& partitionProperty) const;
+
+        /*!
+          \brief Creates the partitions of the timestamps of the data and the partitions ahead of the current date.
+
+          \param dates UTC dates of the stored data.
+        */
+        void createPartitions(std::shared_ptr<te::da::DataSourceTransactor> transactor,
+                              DataSetPtr dataSet,
+                              const std::string& tableName,
+                              PartitionInterval interval,
+                              bool withTimeZone,
+                              const std::set<boost::gregorian::date>& dates) const;
+
+        /*!
+          \brief Returns the SQL type of the property.
+
+          \exception DataStoragerException Raised if the type isn't supported.
+        */
+        static std::string sqlType(const te::dt::Property* property);
+
         /*!
            \brief Check if the two properties have same name and type.
            \exception DataStoragerException Raise if have the same name and different types
@@ -30,177 +30,28 @@
 #include "DataStoragerTiff.hpp"
 #include "../core/utility/TimeUtils.hpp"
 #include "../core/utility/Utils.hpp"
-#include "../core/utility/Verify.hpp"
 #include "../core/data-model/DataProvider.hpp"
 
 //terralib
-#include <terralib/rp/Functions.h>
-#include <terralib/datatype/TimeInstant.h>
 #include <terralib/dataaccess/utils/Utils.h>
+#include <terralib/raster/Band.h>
+#include <terralib/raster/BandProperty.h>
+#include <terralib/raster/Grid.h>
+#include <terralib/raster/RasterFactory.h>
 
 //Qt
 #include <QUrl>
 
+//STL
+#include <map>
+#include <memory>
+#include <vector>
+
 terrama2::core::DataStoragerPtr terrama2::core::DataStoragerTiff::make(DataProviderPtr dataProvider)
 {
   return std::make_shared<DataStoragerTiff>(dataProvider);
 }
 
-std::string terrama2::core::DataStoragerTiff::getMask(DataSetPtr dataSet) const
-{
-  try
-  {
-    return dataSet->format.at("mask");
-  }
-  catch(...)
-  {
-    QString errMsg = QObject::tr("Undefined mask in dataset: %1.").arg(dataSet->id);
-    TERRAMA2_LOG_ERROR() << errMsg;
-    throw UndefinedTagException() << ErrorDescription(errMsg);
-  }
-}
-
-std::string terrama2::core::DataStoragerTiff::getTimezone(DataSetPtr dataSet, bool logError) const
-{
-  try
-  {
-    return dataSet->format.at("timezone");
-  }
-  catch(...)
-  {
-    QString errMsg = QObject::tr("Undefined timezone in dataset: %1.").arg(dataSet->id);
-    if(logError)
-      TERRAMA2_LOG_ERROR() << errMsg;
-    throw UndefinedTagException() << ErrorDescription(errMsg);
-  }
-}
-
-std::string terrama2::core::DataStoragerTiff::zeroPadNumber(long num, int size) const
-{
-  std::ostringstream ss;
-  ss << std::setw(size) << std::setfill('0') << num;
-  return ss.str();
-}
-
-std::string terrama2::core::DataStoragerTiff::replaceMask(const std::string& mask,
-                                                          std::shared_ptr<te::dt::DateTime> timestamp,
-                                                          terrama2::core::DataSetPtr dataSet) const
-{
-  if(!timestamp.get())
-    return mask;
-
-  long year = 0;
-  long month = 0;
-  long day = 0;
-  long hour = 0;
-  long minutes = 0;
-  long seconds = 0;
-
-  if(timestamp->getDateTimeType() == te::dt::TIME_INSTANT)
-  {
-    auto dateTime = std::dynamic_pointer_cast<te::dt::TimeInstant>(timestamp);
-    //invalid date type
-    try
-    {
-      verify::date(dateTime);
-    }
-    catch (const VerifyException&)
-    {
-      return mask;
-    }
-
-    auto date = dateTime->getDate();
-    year = date.getYear();
-    month = date.getMonth().as_number();
-    day = date.getDay().as_number();
-
-    auto time = dateTime->getTime();
-    hour = time.getHours();
-    minutes = time.getMinutes();
-    seconds = time.getSeconds();
-  }
-  else if(timestamp->getDateTimeType() == te::dt::TIME_INSTANT_TZ)
-  {
-    auto dateTime = std::dynamic_pointer_cast<te::dt::TimeInstantTZ>(timestamp);
-    try
-    {
-      verify::date(dateTime);
-    }
-    catch (const VerifyException&)
-    {
-      return mask;
-    }
-
-    std::string timezone;
-    try
-    {
-      //get dataset timezone
-      timezone = getTimezone(dataSet, false);
-    }
-    catch(const terrama2::core::UndefinedTagException&)
-    {
-      //if no timezone is set use UTC
-      timezone = "UTC+00";
-    }
-
-    auto boostLocalTime = dateTime->getTimeInstantTZ();
-    boost::local_time::time_zone_ptr zone(new boost::local_time::posix_time_zone(timezone));
-    auto localTime = boostLocalTime.local_time_in(zone);
-    auto date = localTime.date();
-    year = date.year();
-    month = date.month().as_number();
-    day = date.day();
-
-    auto time = localTime.time_of_day();
-    hour = time.hours();
-    minutes = time.minutes();
-    seconds = time.seconds();
-  }
-  else
-  {
-    //This method expects a valid Date/Time, other formats are not valid.
-    QString errMsg = QObject::tr("Unknown date format.");
-    TERRAMA2_LOG_ERROR() << errMsg;
-    throw terrama2::core::DataAccessorException() << ErrorDescription(errMsg);
-  }
-
-  //replace wildcards in mask
-  std::string fileName = mask;
-  size_t pos = fileName.find("yyyy");
-  if(pos != std::string::npos)
-    fileName.replace(pos, 4, zeroPadNumber(year, 4));
-
-  pos = fileName.find("yy");
-  if(pos != std::string::npos)
-    fileName.replace(pos, 2, zeroPadNumber(year, 2));
-
-  pos = fileName.find("MM");
-  if(pos != std::string::npos)
-    fileName.replace(pos, 2, zeroPadNumber(month, 2));
-
-  pos = fileName.find("dd");
-  if(pos != std::string::npos)
-    fileName.replace(pos, 2, zeroPadNumber(day, 2));
-
-  pos = fileName.find("hh");
-  if(pos != std::string::npos)
-    fileName.replace(pos, 2, zeroPadNumber(hour, 2));
-
-  pos = fileName.find("mm");
-  if(pos != std::string::npos)
-    fileName.replace(pos, 2, zeroPadNumber(minutes, 2));
-
-  pos = fileName.find("ss");
-  if(pos != std::string::npos)
-    fileName.replace(pos, 2, zeroPadNumber(seconds, 2));
-
-  //if no extension in the mask, add extension
-  pos = fileName.find(".tif");
-  if(pos == std::string::npos)
-    fileName += ".tif";
-  return fileName;
-}
-
 void terrama2::core::DataStoragerTiff::store(DataSetSeries series, DataSetPtr outputDataSet) const
 {
   if(!outputDataSet.get() || !series.syncDataSet.get())
@@ -253,6 +104,70 @@ void terrama2::core::DataStoragerTiff::store(DataSetSeries series, DataSetPtr ou
     std::string filename = replaceMask(mask, timestamp, outputDataSet);
 
     std::string output = path + "/" + filename;
-    te::rp::Copy2DiskRaster(*raster, output);
+    writeRaster(*raster, output);
+  }
+}
+
+void terrama2::core::DataStoragerTiff::writeRaster(const te::rst::Raster& raster, const std::string& output) const
+{
+  const unsigned int nCols = raster.getNumberOfColumns();
+  const unsigned int nRows = raster.getNumberOfRows();
+
+  // the file keeps the pixel type, no data, scale and offset of each band
+  std::vector<te::rst::BandProperty*> bands;
+  for(std::size_t bandIdx = 0; bandIdx < raster.getNumberOfBands(); ++bandIdx)
+  {
+    te::rst::BandProperty* bandProperty = new te::rst::BandProperty(*raster.getBand(bandIdx)->getProperty());
+    bandProperty->m_blkh = 1;
+    bandProperty->m_blkw = nCols;
+    bandProperty->m_nblocksx = 1;
+    bandProperty->m_nblocksy = nRows;
+    bands.push_back(bandProperty);
+  }
+
+  std::map<std::string, std::string> rinfo;
+  rinfo["URI"] = output;
+  std::unique_ptr<te::rst::Raster> file(te::rst::RasterFactory::make("GDAL", new te::rst::Grid(*raster.getGrid()), bands, rinfo));
+  if(!file)
+  {
+    QString errMsg = QObject::tr("Could not create file: %1.").arg(QString::fromStdString(output));
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw DataStoragerException() << ErrorDescription(errMsg);
+  }
+
+  auto isRowBlocked = [nCols](const te::rst::BandProperty* bandProperty)
+  {
+    return bandProperty->m_blkh == 1 && bandProperty->m_blkw == static_cast<int>(nCols)
+        && bandProperty->m_nblocksx == 1;
+  };
+
+  std::vector<unsigned char> block;
+  std::vector<double> row(nCols);
+  for(std::size_t bandIdx = 0; bandIdx < raster.getNumberOfBands(); ++bandIdx)
+  {
+    const te::rst::Band* inputBand = raster.getBand(bandIdx);
+    te::rst::Band* fileBand = file->getBand(bandIdx);
+
+    // rows of the same pixel type are copied without conversion
+    if(isRowBlocked(inputBand->getProperty()) && isRowBlocked(fileBand->getProperty())
+       && inputBand->getProperty()->getType() == fileBand->getProperty()->getType())
+    {
+      block.resize(static_cast<std::size_t>(inputBand->getBlockSize()));
+      for(unsigned int rowIdx = 0; rowIdx < nRows; ++rowIdx)
+      {
+        inputBand->read(0, static_cast<int>(rowIdx), block.data());
+        fileBand->write(0, static_cast<int>(rowIdx), block.data());
+      }
+
+      continue;
+    }
+
+    for(unsigned int rowIdx = 0; rowIdx < nRows; ++rowIdx)
+    {
+      for(unsigned int col = 0; col < nCols; ++col)
+        inputBand->getValue(col, rowIdx, row[col]);
+      for(unsigned int col = 0; col < nCols; ++col)
+        fileBand->setValue(col, rowIdx, row[col]);
+    }
   }
 }
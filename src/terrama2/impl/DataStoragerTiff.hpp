@@ -31,8 +31,7 @@
 #define __TERRAMA2_CORE_DATA_ACCESS_DATA_STORAGER_TIF_HPP__
 
 //TerraMA2
-#include "../core/data-access/DataStorager.hpp"
-#include "../core/utility/Logger.hpp"
+#include "DataStoragerFile.hpp"
 
 //QT
 #include <QString>
@@ -40,16 +39,17 @@
 
 //Terralib
 #include <terralib/datatype/TimeInstantTZ.h>
+#include <terralib/raster/Raster.h>
 
 namespace terrama2
 {
   namespace core
   {
-    class DataStoragerTiff : public DataStorager
+    class DataStoragerTiff : public DataStoragerFile
     {
       public:
         DataStoragerTiff(DataProviderPtr outputDataProvider)
-                : DataStorager(outputDataProvider) {}
+                : DataStoragerFile(outputDataProvider) {}
         ~DataStoragerTiff() {}
 
         static DataStoragerPtr make(DataProviderPtr dataProvider);
@@ -58,12 +58,18 @@ namespace terrama2
         virtual void store(DataSetSeries series, DataSetPtr outputDataSet) const override;
 
       protected:
-        std::string getMask(DataSetPtr dataSet) const;
-        std::string getTimezone(DataSetPtr dataSet, bool logError = true) const;
-        std::string zeroPadNumber(long num, int size) const;
-        std::string replaceMask(const std::string& mask,
-                                std::shared_ptr<te::dt::DateTime> timestamp,
-                                terrama2::core::DataSetPtr dataSet) const;
+        // Doc in base class
+        virtual std::string fileExtension() const override { return ".tif"; }
+
+        /*!
+          \brief Writes the raster to a GeoTIFF file.
+
+          Each band keeps its pixel type, no data value, scale and offset,
+          rows of bands with the same pixel type and row layout are copied without conversion.
+
+          \exception DataStoragerException Raised if the file can't be created.
+        */
+        void writeRaster(const te::rst::Raster& raster, const std::string& output) const;
     };
   }
 }
@@ -39,6 +39,7 @@
 #include "DataAccessorStaticDataOGR.hpp"
 #include "DataAccessorAnalysisPostGis.hpp"
 
+#include "DataStoragerCsv.hpp"
 #include "DataStoragerPostGis.hpp"
 #include "DataStoragerTiff.hpp"
 
@@ -64,6 +65,7 @@ void terrama2::core::registerFactories()
   // Data storager
   terrama2::core::DataStoragerFactory::getInstance().add(terrama2::core::DataStoragerPostGis::dataStoragerType(), terrama2::core::DataStoragerPostGis::make);
   terrama2::core::DataStoragerFactory::getInstance().add(terrama2::core::DataStoragerTiff::dataStoragerType(), terrama2::core::DataStoragerTiff::make);
+  terrama2::core::DataStoragerFactory::getInstance().add(terrama2::core::DataStoragerCsv::dataStoragerType(), terrama2::core::DataStoragerCsv::make);
 
   terrama2::core::DataRetrieverFactory::getInstance().add(terrama2::core::DataRetrieverFTP::dataRetrieverType(), terrama2::core::DataRetrieverFTP::make);
 }
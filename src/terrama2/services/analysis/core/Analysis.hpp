@@ -149,6 +149,17 @@ namespace terrama2
           CUSTOM = 3 //!< Use a custom box.
         };
 
+        /*!
+          \brief Pixel type of the output grid.
+        */
+        enum class OutputDataType
+        {
+          FLOAT64 = 1, //!< 64 bits floating point.
+          FLOAT32 = 2, //!< 32 bits floating point.
+          INT16 = 3, //!< 16 bits signed integer.
+          UINT8 = 4 //!< 8 bits unsigned integer.
+        };
+
         /*!
           \brief Defines the date filter for reprocessing of historical data
         */
@@ -174,6 +185,13 @@ namespace terrama2
           InterestAreaType interestAreaType; //!< Type of interest area.
           DataSeriesId interestAreaDataSeriesId = 0; //!< Identifier of the DataSeries to copy the box resolution.
           std::shared_ptr<te::gm::Geometry> interestAreaBox; //!< Custom box.
+          bool sparseExecution = false; //!< If true, only the cells inside the interest area with data in at least one input are evaluated.
+          OutputDataType dataType = OutputDataType::FLOAT64; //!< Pixel type of all output bands, the dummy value is the no data value of this type.
+          double scale = 1; //!< Stored values are (value - offset) / scale, the same for all output bands.
+          double offset = 0; //!< Stored values are (value - offset) / scale, the same for all output bands.
+          std::vector<std::string> bandNames; //!< Names of the output bands, the script returns a value for each band, empty for a single band.
+          std::map<std::string, DataSeriesId> bandDataSeries; //!< Bands stored in their own data series, the other bands are stored in the output data series of the analysis.
+          bool incrementalExecution = false; //!< If true, only the tiles affected by grids that changed since the previous execution are evaluated.
         };
 
         /*!
@@ -0,0 +1,509 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/services/analysis/core/AnalysisCheckpoint.cpp
+
+  \brief Local store of the chunks completed by an analysis execution, used to resume interrupted executions.
+
+  \author Jano Simas
+*/
+
+#include "AnalysisCheckpoint.hpp"
+#include "JSonUtils.hpp"
+#include "../../../core/utility/Logger.hpp"
+#include "../../../core/utility/RasterBlockCache.hpp"
+#include "../../../core/utility/ServiceManager.hpp"
+#include "../../../core/utility/TimeUtils.hpp"
+
+// TerraLib
+#include <terralib/raster/Band.h>
+#include <terralib/raster/BandProperty.h>
+#include <terralib/raster/Raster.h>
+
+// Boost
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/exception/all.hpp>
+
+// Qt
+#include <QByteArray>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QObject>
+#include <QSaveFile>
+
+// STL
+#include <algorithm>
+#include <iterator>
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <utility>
+
+namespace
+{
+  const QString INFO_FILE = "checkpoint.info";
+  const QString CHUNK_PREFIX = "chunk_";
+
+  std::mutex settingsMutex;
+  int64_t checkpointMaxAge = 7*24*60*60;
+
+  //! Folder set by the service configuration, empty for the default folder.
+  QString& configuredCheckpointFolder()
+  {
+    static QString folder;
+    return folder;
+  }
+
+  //! Returns the folder of the checkpoints, by default analysis-checkpoint in the data folder of the service.
+  QString checkpointFolder()
+  {
+    if(!configuredCheckpointFolder().isEmpty())
+      return configuredCheckpointFolder();
+
+    return QDir(QString::fromStdString(terrama2::core::ServiceManager::getInstance().dataFolder())).absoluteFilePath("analysis-checkpoint");
+  }
+
+  //! Identifies the configuration of the analysis, results of another configuration can't be resumed.
+  QString configuration(terrama2::services::analysis::core::AnalysisPtr analysis)
+  {
+    QByteArray data = QJsonDocument(terrama2::services::analysis::core::toJson(analysis)).toJson(QJsonDocument::Compact);
+    return QString(QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex());
+  }
+
+  //! Returns the folder of the checkpoint of an execution, identified by its start date in UTC.
+  QString executionFolder(const QString& root, terrama2::services::analysis::core::AnalysisId analysisId,
+                          std::shared_ptr<te::dt::TimeInstantTZ> startTime)
+  {
+    const std::string date = boost::posix_time::to_iso_string(startTime->getTimeInstantTZ().utc_time());
+    return root + "/" + QString::number(analysisId) + "_" + QString::fromStdString(date);
+  }
+
+  //! Reads the configuration and start date of a checkpoint, an empty object if the checkpoint is invalid.
+  QJsonObject readInfo(const QString& folder)
+  {
+    QFile infoFile(folder + "/" + INFO_FILE);
+    if(!infoFile.open(QIODevice::ReadOnly))
+      return QJsonObject();
+
+    return QJsonDocument::fromJson(infoFile.readAll()).object();
+  }
+
+  std::tuple<uint32_t, uint32_t, uint32_t, uint32_t> tileKey(const terrama2::services::analysis::core::GridTile& tile)
+  {
+    return std::make_tuple(tile.firstRow, tile.lastRow, tile.firstColumn, tile.lastColumn);
+  }
+}
+
+terrama2::services::analysis::core::AnalysisCheckpoint::AnalysisCheckpoint(AnalysisPtr analysis, std::shared_ptr<te::dt::TimeInstantTZ> startTime)
+  : analysis_(analysis),
+    startTime_(startTime)
+{
+  std::lock_guard<std::mutex> lock(settingsMutex);
+  folder_ = executionFolder(checkpointFolder(), analysis->id, startTime);
+}
+
+void terrama2::services::analysis::core::AnalysisCheckpoint::setFolder(const std::string& folder)
+{
+  std::lock_guard<std::mutex> lock(settingsMutex);
+  configuredCheckpointFolder() = QString::fromStdString(folder);
+}
+
+void terrama2::services::analysis::core::AnalysisCheckpoint::removeAnalysis(AnalysisId analysisId)
+{
+  std::lock_guard<std::mutex> lock(settingsMutex);
+  QDir root(checkpointFolder());
+  for(const auto& fileInfo : root.entryInfoList({QString::number(analysisId) + "_*"}, QDir::Dirs | QDir::NoDotAndDotDot))
+    QDir(fileInfo.absoluteFilePath()).removeRecursively();
+}
+
+void terrama2::services::analysis::core::AnalysisCheckpoint::setMaxAge(int64_t maxAge)
+{
+  std::lock_guard<std::mutex> lock(settingsMutex);
+  checkpointMaxAge = maxAge;
+}
+
+std::vector<std::shared_ptr<te::dt::TimeInstantTZ> >
+terrama2::services::analysis::core::AnalysisCheckpoint::pendingExecutions(AnalysisPtr analysis)
+{
+  QString root;
+  {
+    std::lock_guard<std::mutex> lock(settingsMutex);
+    root = checkpointFolder();
+  }
+
+  const QString config = configuration(analysis);
+
+  std::vector<std::shared_ptr<te::dt::TimeInstantTZ> > executions;
+  for(const auto& fileInfo : QDir(root).entryInfoList({QString::number(analysis->id) + "_*"}, QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name))
+  {
+    const QString folder = fileInfo.absoluteFilePath();
+    QJsonObject info = readInfo(folder);
+    if(info["configuration"].toString() == config)
+    {
+      try
+      {
+        executions.push_back(terrama2::core::TimeUtils::stringToTimestamp(info["start_time"].toString().toStdString(),
+                                                                          terrama2::core::TimeUtils::webgui_timefacet));
+        continue;
+      }
+      catch(const std::exception&)
+      {
+      }
+      catch(const boost::exception&)
+      {
+      }
+    }
+
+    TERRAMA2_LOG_INFO() << QObject::tr("Discarding the checkpoint %1 of the analysis %2.").arg(fileInfo.fileName()).arg(analysis->id);
+    QDir(folder).removeRecursively();
+  }
+
+  return executions;
+}
+
+std::size_t terrama2::services::analysis::core::AnalysisCheckpoint::chunkSize(std::size_t numberOfItems, std::size_t numberOfThreads)
+{
+  const std::size_t maxChunks = 50;
+  const std::size_t itemsPerThread = 16;
+  return std::max({numberOfThreads * itemsPerThread, (numberOfItems + maxChunks - 1) / maxChunks, static_cast<std::size_t>(1)});
+}
+
+QStringList terrama2::services::analysis::core::AnalysisCheckpoint::open()
+{
+  QString root;
+  int64_t maxAge = 0;
+  {
+    std::lock_guard<std::mutex> lock(settingsMutex);
+    root = checkpointFolder();
+    maxAge = checkpointMaxAge;
+  }
+
+  // checkpoints of executions that never finished
+  QDateTime oldest = QDateTime::currentDateTimeUtc().addSecs(-maxAge);
+  for(const auto& fileInfo : QDir(root).entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot))
+  {
+    if(fileInfo.absoluteFilePath() != QFileInfo(folder_).absoluteFilePath() && fileInfo.lastModified().toUTC() < oldest)
+      QDir(fileInfo.absoluteFilePath()).removeRecursively();
+  }
+
+  const QString config = configuration(analysis_);
+
+  if(readInfo(folder_)["configuration"].toString() == config)
+  {
+    QStringList chunks = QDir(folder_).entryList({CHUNK_PREFIX + "*"}, QDir::Files, QDir::Name);
+    for(const auto& chunk : chunks)
+      nextChunk_ = std::max(nextChunk_, static_cast<std::size_t>(chunk.mid(CHUNK_PREFIX.size()).toULongLong()) + 1);
+
+    return chunks;
+  }
+
+  QDir(folder_).removeRecursively();
+
+  QJsonObject info;
+  info["configuration"] = config;
+  info["start_time"] = QString::fromStdString(terrama2::core::TimeUtils::boostLocalTimeToString(startTime_->getTimeInstantTZ(),
+                                                                                                terrama2::core::TimeUtils::webgui_timefacet));
+  const QByteArray data = QJsonDocument(info).toJson(QJsonDocument::Compact);
+
+  QSaveFile newInfoFile(folder_ + "/" + INFO_FILE);
+  if(!QDir().mkpath(folder_)
+     || !newInfoFile.open(QIODevice::WriteOnly)
+     || newInfoFile.write(data) != data.size()
+     || !newInfoFile.commit())
+  {
+    TERRAMA2_LOG_WARNING() << QObject::tr("Could not create the checkpoint of the analysis %1.").arg(analysis_->id);
+  }
+
+  return {};
+}
+
+bool terrama2::services::analysis::core::AnalysisCheckpoint::writeChunk(const QByteArray& data)
+{
+  QSaveFile file(folder_ + "/" + CHUNK_PREFIX + QString::number(static_cast<qulonglong>(nextChunk_)));
+  if(!file.open(QIODevice::WriteOnly)
+     || file.write(data) != data.size()
+     || !file.commit())
+  {
+    // the checkpoint is an optimization, the execution continues
+    TERRAMA2_LOG_WARNING() << QObject::tr("Could not save a checkpoint of the analysis %1.").arg(analysis_->id);
+    return false;
+  }
+
+  ++nextChunk_;
+  return true;
+}
+
+std::vector<uint32_t>
+terrama2::services::analysis::core::AnalysisCheckpoint::restoreObjects(const std::vector<std::string>& geomIds, MonitoredObjectContextPtr context)
+{
+  // the rows of the dataset may be in another order or changed since the checkpoint
+  const std::set<std::string> currentIds(geomIds.begin(), geomIds.end());
+
+  std::set<std::string> completed;
+  for(const auto& chunk : open())
+  {
+    QFile file(folder_ + "/" + chunk);
+    if(!file.open(QIODevice::ReadOnly))
+      continue;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    QStringList chunkIds;
+    stream >> chunkIds;
+
+    quint32 numberOfObjects = 0;
+    stream >> numberOfObjects;
+    std::vector<std::pair<QString, QMap<QString, double> > > results(numberOfObjects);
+    for(auto& result : results)
+      stream >> result.first >> result.second;
+
+    if(stream.status() != QDataStream::Ok)
+    {
+      TERRAMA2_LOG_WARNING() << QObject::tr("Invalid checkpoint of the analysis %1: %2.").arg(analysis_->id).arg(chunk);
+      continue;
+    }
+
+    for(const auto& chunkId : chunkIds)
+      completed.insert(chunkId.toStdString());
+
+    // results of objects removed from the dataset are discarded
+    for(const auto& result : results)
+    {
+      const std::string geomId = result.first.toStdString();
+      if(currentIds.count(geomId) == 0)
+        continue;
+
+      for(auto it = result.second.begin(); it != result.second.end(); ++it)
+      {
+        context->addAttribute(it.key().toStdString());
+        context->setAnalysisResult(geomId, it.key().toStdString(), it.value());
+      }
+    }
+  }
+
+  std::vector<uint32_t> remaining;
+  for(uint32_t index = 0; index < geomIds.size(); ++index)
+  {
+    if(completed.count(geomIds[index]) == 0)
+      remaining.push_back(index);
+  }
+
+  if(remaining.size() != geomIds.size())
+    TERRAMA2_LOG_INFO() << QObject::tr("Analysis %1: resuming from checkpoint, %2 of %3 objects already evaluated.")
+                           .arg(analysis_->id).arg(geomIds.size() - remaining.size()).arg(geomIds.size());
+
+  return remaining;
+}
+
+void terrama2::services::analysis::core::AnalysisCheckpoint::saveObjects(const std::vector<std::string>& geomIds, MonitoredObjectContextPtr context)
+{
+  QByteArray data;
+  QDataStream stream(&data, QIODevice::WriteOnly);
+  stream.setVersion(QDataStream::Qt_5_0);
+
+  QStringList chunkIds;
+  for(const auto& geomId : geomIds)
+    chunkIds.append(QString::fromStdString(geomId));
+  stream << chunkIds;
+
+  // only the results of the objects of this chunk are saved
+  const std::set<std::string> chunkSet(geomIds.begin(), geomIds.end());
+  std::vector<std::pair<std::string, QMap<QString, double> > > results;
+  context->visitAnalysisResult([&chunkSet, &results](const std::string& geomId, const std::map<std::string, double>& result)
+  {
+    if(chunkSet.count(geomId) == 0)
+      return;
+
+    QMap<QString, double> attributes;
+    for(const auto& attribute : result)
+      attributes.insert(QString::fromStdString(attribute.first), attribute.second);
+
+    results.emplace_back(geomId, attributes);
+  });
+
+  stream << static_cast<quint32>(results.size());
+  for(const auto& result : results)
+    stream << QString::fromStdString(result.first) << result.second;
+
+  writeChunk(data);
+}
+
+std::vector<terrama2::services::analysis::core::GridTile>
+terrama2::services::analysis::core::AnalysisCheckpoint::restoreTiles(const std::vector<GridTile>& tiles, GridContextPtr context)
+{
+  auto outputRaster = context->getOutputRaster();
+  const std::size_t nBands = outputRaster->getNumberOfBands();
+
+  std::vector<int> bandTypes;
+  for(std::size_t bandIdx = 0; bandIdx < nBands; ++bandIdx)
+    bandTypes.push_back(terrama2::core::RasterBlock::storageType(outputRaster->getBand(bandIdx)->getProperty()->getType()));
+
+  std::set<std::tuple<uint32_t, uint32_t, uint32_t, uint32_t> > completed;
+  for(const auto& chunk : open())
+  {
+    QFile file(folder_ + "/" + chunk);
+    if(!file.open(QIODevice::ReadOnly))
+      continue;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    // values are stored in the data type of each band
+    quint32 numberOfBands = 0;
+    stream >> numberOfBands;
+    std::vector<int> chunkTypes(numberOfBands);
+    for(auto& type : chunkTypes)
+    {
+      qint32 value = 0;
+      stream >> value;
+      type = value;
+    }
+
+    quint32 numberOfTiles = 0;
+    stream >> numberOfTiles;
+
+    std::vector<std::pair<GridTile, std::vector<terrama2::core::RasterBlock> > > chunkTiles(numberOfTiles);
+    bool valid = chunkTypes == bandTypes;
+    for(auto& item : chunkTiles)
+    {
+      GridTile& tile = item.first;
+      stream >> tile.firstRow >> tile.lastRow >> tile.firstColumn >> tile.lastColumn;
+      if(stream.status() != QDataStream::Ok
+         || tile.firstRow > tile.lastRow || tile.lastRow > outputRaster->getNumberOfRows()
+         || tile.firstColumn > tile.lastColumn || tile.lastColumn > outputRaster->getNumberOfColumns())
+      {
+        valid = false;
+        break;
+      }
+
+      const std::size_t cells = static_cast<std::size_t>(tile.lastRow - tile.firstRow) * (tile.lastColumn - tile.firstColumn);
+      for(int type : bandTypes)
+      {
+        terrama2::core::RasterBlock values(type, cells);
+        const int size = static_cast<int>(values.byteSize());
+        if(stream.readRawData(reinterpret_cast<char*>(values.data()), size) != size)
+        {
+          valid = false;
+          break;
+        }
+
+        item.second.push_back(std::move(values));
+      }
+
+      if(!valid)
+        break;
+    }
+
+    if(!valid || stream.status() != QDataStream::Ok)
+    {
+      TERRAMA2_LOG_WARNING() << QObject::tr("Invalid checkpoint of the analysis %1: %2.").arg(analysis_->id).arg(chunk);
+      continue;
+    }
+
+    for(const auto& item : chunkTiles)
+    {
+      const GridTile& tile = item.first;
+      for(std::size_t bandIdx = 0; bandIdx < nBands; ++bandIdx)
+      {
+        const terrama2::core::RasterBlock& values = item.second[bandIdx];
+        std::size_t pos = 0;
+        for(uint32_t row = tile.firstRow; row < tile.lastRow; ++row)
+        {
+          for(uint32_t col = tile.firstColumn; col < tile.lastColumn; ++col)
+            outputRaster->setValue(col, row, values.value(pos++), bandIdx);
+        }
+      }
+
+      completed.insert(tileKey(tile));
+    }
+  }
+
+  std::vector<GridTile> remaining;
+  std::copy_if(tiles.begin(), tiles.end(), std::back_inserter(remaining),
+               [&completed](const GridTile& tile){ return completed.count(tileKey(tile)) == 0; });
+
+  if(remaining.size() != tiles.size())
+    TERRAMA2_LOG_INFO() << QObject::tr("Analysis %1: resuming from checkpoint, %2 of %3 tiles already evaluated.")
+                           .arg(analysis_->id).arg(tiles.size() - remaining.size()).arg(tiles.size());
+
+  return remaining;
+}
+
+void terrama2::services::analysis::core::AnalysisCheckpoint::saveTiles(const std::vector<GridTile>& tiles, GridContextPtr context)
+{
+  auto outputRaster = context->getOutputRaster();
+  const std::size_t nBands = outputRaster->getNumberOfBands();
+
+  QByteArray data;
+  QDataStream stream(&data, QIODevice::WriteOnly);
+  stream.setVersion(QDataStream::Qt_5_0);
+
+  // values are stored in the data type of each band
+  std::vector<int> bandTypes;
+  for(std::size_t bandIdx = 0; bandIdx < nBands; ++bandIdx)
+    bandTypes.push_back(terrama2::core::RasterBlock::storageType(outputRaster->getBand(bandIdx)->getProperty()->getType()));
+
+  stream << static_cast<quint32>(nBands);
+  for(int type : bandTypes)
+    stream << static_cast<qint32>(type);
+
+  stream << static_cast<quint32>(tiles.size());
+
+  for(const auto& tile : tiles)
+  {
+    stream << tile.firstRow << tile.lastRow << tile.firstColumn << tile.lastColumn;
+
+    const std::size_t cells = static_cast<std::size_t>(tile.lastRow - tile.firstRow) * (tile.lastColumn - tile.firstColumn);
+    for(std::size_t bandIdx = 0; bandIdx < nBands; ++bandIdx)
+    {
+      const te::rst::Band* band = outputRaster->getBand(bandIdx);
+      terrama2::core::RasterBlock values(bandTypes[bandIdx], cells);
+      std::size_t pos = 0;
+      double value = 0;
+      for(uint32_t row = tile.firstRow; row < tile.lastRow; ++row)
+      {
+        for(uint32_t col = tile.firstColumn; col < tile.lastColumn; ++col)
+        {
+          band->getValue(col, row, value);
+          values.setValue(pos++, value);
+        }
+      }
+
+      stream.writeRawData(reinterpret_cast<const char*>(values.data()), static_cast<int>(values.byteSize()));
+    }
+  }
+
+  writeChunk(data);
+}
+
+void terrama2::services::analysis::core::AnalysisCheckpoint::remove()
+{
+  QDir(folder_).removeRecursively();
+}
@@ -0,0 +1,152 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/services/analysis/core/AnalysisCheckpoint.hpp
+
+  \brief Local store of the chunks completed by an analysis execution, used to resume interrupted executions.
+
+  \author Jano Simas
+*/
+
+#ifndef __TERRAMA2_ANALYSIS_CORE_ANALYSIS_CHECKPOINT_HPP__
+#define __TERRAMA2_ANALYSIS_CORE_ANALYSIS_CHECKPOINT_HPP__
+
+#include "Analysis.hpp"
+#include "GridContext.hpp"
+#include "MonitoredObjectContext.hpp"
+#include "Shared.hpp"
+#include "Typedef.hpp"
+
+// TerraLib
+#include <terralib/datatype/TimeInstantTZ.h>
+
+// Qt
+#include <QString>
+#include <QStringList>
+
+// STL
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace terrama2
+{
+  namespace services
+  {
+    namespace analysis
+    {
+      namespace core
+      {
+        /*!
+          \brief Checkpoint of an analysis execution.
+
+          The execution is split in chunks, ranges of monitored objects or grid tiles,
+          the results of each completed chunk are saved in a local folder
+          identified by the analysis and the start date of the execution, the date that defines its data window.
+          An execution with the same analysis and start date, after an interruption or a reprocessing,
+          restores the saved results and only evaluates the remaining chunks.
+          Executions interrupted by a stop of the service are listed by pendingExecutions()
+          so they can be queued again with their original start date.
+
+          The checkpoint is discarded if the analysis configuration changed
+          and must be removed after the results are stored.
+        */
+        class AnalysisCheckpoint
+        {
+          public:
+            AnalysisCheckpoint(AnalysisPtr analysis, std::shared_ptr<te::dt::TimeInstantTZ> startTime);
+
+            //! Sets the folder of the checkpoints, by default analysis-checkpoint in the data folder of the service.
+            static void setFolder(const std::string& folder);
+
+            //! Removes the checkpoints of the analysis, called when the analysis is removed.
+            static void removeAnalysis(AnalysisId analysisId);
+
+            //! Sets the maximum age, in seconds, of the checkpoints of executions that never finished.
+            static void setMaxAge(int64_t maxAge);
+
+            /*!
+              \brief Returns the start dates of the executions of the analysis with a checkpoint.
+
+              Checkpoints of another configuration of the analysis are removed.
+            */
+            static std::vector<std::shared_ptr<te::dt::TimeInstantTZ> > pendingExecutions(AnalysisPtr analysis);
+
+            /*!
+              \brief Returns the number of items of each chunk.
+
+              Each chunk has enough items to keep all threads busy,
+              an execution is split in at most 50 chunks.
+            */
+            static std::size_t chunkSize(std::size_t numberOfItems, std::size_t numberOfThreads);
+
+            /*!
+              \brief Restores the results of the objects completed by a previous execution.
+
+              The objects are identified by the value of their identifier attribute,
+              the order of the rows of the dataset may change between executions.
+
+              \param geomIds Identifiers of the objects, in the order of the rows of the dataset.
+              \return The indexes of the rows that must be evaluated.
+            */
+            std::vector<uint32_t> restoreObjects(const std::vector<std::string>& geomIds, MonitoredObjectContextPtr context);
+
+            //! Saves the results of the objects as a completed chunk.
+            void saveObjects(const std::vector<std::string>& geomIds, MonitoredObjectContextPtr context);
+
+            /*!
+              \brief Restores the values of the tiles completed by a previous execution in the output raster.
+
+              \return The tiles that must be evaluated.
+            */
+            std::vector<GridTile> restoreTiles(const std::vector<GridTile>& tiles, GridContextPtr context);
+
+            //! Saves the values of the tiles, in the data type of the output bands, as a completed chunk.
+            void saveTiles(const std::vector<GridTile>& tiles, GridContextPtr context);
+
+            //! Removes the checkpoint, should be called after the results are stored.
+            void remove();
+
+          private:
+            /*!
+              \brief Opens the folder of the checkpoint.
+
+              A checkpoint of another configuration is removed and checkpoints older than the maximum age are pruned.
+
+              \return The names of the chunk files of a previous execution.
+            */
+            QStringList open();
+
+            //! Writes a chunk file, the file is only visible after it is complete.
+            bool writeChunk(const QByteArray& data);
+
+            AnalysisPtr analysis_;
+            std::shared_ptr<te::dt::TimeInstantTZ> startTime_;
+            QString folder_; //!< Folder of the checkpoint of the execution.
+            std::size_t nextChunk_ = 0; //!< Number of the next chunk file.
+        };
+      } // end namespace core
+    }   // end namespace analysis
+  }     // end namespace services
+}       // end namespace terrama2
+
+#endif //__TERRAMA2_ANALYSIS_CORE_ANALYSIS_CHECKPOINT_HPP__
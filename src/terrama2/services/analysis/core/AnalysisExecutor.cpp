@@ -30,6 +30,7 @@
 // TerraMA2
 
 #include "AnalysisExecutor.hpp"
+#include "AnalysisCheckpoint.hpp"
 #include "PythonInterpreter.hpp"
 #include "DataManager.hpp"
 #include "ThreadPool.hpp"
@@ -41,14 +42,24 @@
 #include "../../../core/utility/DataStoragerFactory.hpp"
 #include "../../../core/data-access/DataStorager.hpp"
 #include "../../../core/data-model/DataProvider.hpp"
+#include "../../../impl/DataStoragerCsv.hpp"
 #include "../../../impl/DataStoragerPostGis.hpp"
 #include "../../../impl/DataStoragerTiff.hpp"
 #include "GridContext.hpp"
+#include "GridProvenance.hpp"
+#include "InputVersion.hpp"
 #include "MonitoredObjectContext.hpp"
 
 // STL
+#include <algorithm>
+#include <iterator>
+#include <limits>
 #include <thread>
 #include <future>
+#include <map>
+#include <numeric>
+#include <memory>
+#include <vector>
 
 // Python
 #include <Python.h>
@@ -64,9 +75,11 @@
 #include <terralib/dataaccess/dataset/UniqueKey.h>
 #include <terralib/dataaccess/datasource/DataSource.h>
 #include <terralib/dataaccess/datasource/DataSourceFactory.h>
+#include <terralib/raster/Band.h>
 #include <terralib/raster/BandProperty.h>
 #include <terralib/raster/Raster.h>
 #include <terralib/raster/Grid.h>
+#include <terralib/raster/RasterFactory.h>
 #include <terralib/raster/RasterProperty.h>
 #include <terralib/dataaccess/utils/Utils.h>
 
@@ -82,6 +95,10 @@ void terrama2::services::analysis::core::runAnalysis(DataManagerPtr dataManager,
     return;
   }
 
+  std::unique_ptr<InputVersion> inputVersion;
+  // data timestamp of the previous execution, set if the execution is skipped
+  std::shared_ptr<te::dt::TimeInstantTZ> unchangedDataTimestamp;
+
   try
   {
     TERRAMA2_LOG_INFO() << QObject::tr("Starting analysis %1 execution: %2").arg(analysis->id).arg(startTime->toString().c_str());
@@ -89,22 +106,37 @@ void terrama2::services::analysis::core::runAnalysis(DataManagerPtr dataManager,
     if(logger.get())
       logId = logger->start(analysis->id);
 
-    switch(analysis->type)
+    if(InputVersion::isEligible(dataManager, analysis))
     {
-      case AnalysisType::MONITORED_OBJECT_TYPE:
-      {
-        runMonitoredObjectAnalysis(dataManager, analysis, startTime, threadPool, mainThreadState);
-        break;
-      }
-      case AnalysisType::PCD_TYPE:
-      {
-        runDCPAnalysis(dataManager, analysis, startTime, threadPool, mainThreadState);
-        break;
-      }
-      case AnalysisType::GRID_TYPE:
+      inputVersion.reset(new InputVersion(analysis, InputVersion::readVersions(dataManager, analysis, logger)));
+      if(logger.get() && inputVersion->isUnchanged())
+        unchangedDataTimestamp = logger->getDataLastTimestamp(analysis->id);
+    }
+
+    if(unchangedDataTimestamp)
+    {
+      TERRAMA2_LOG_INFO() << QObject::tr("Analysis %1 skipped, the inputs didn't change since the last execution.").arg(analysis->id);
+      logger->info("skipped-unchanged", logId);
+    }
+    else
+    {
+      switch(analysis->type)
       {
-        runGridAnalysis(dataManager, analysis, startTime, threadPool, mainThreadState);
-        break;
+        case AnalysisType::MONITORED_OBJECT_TYPE:
+        {
+          runMonitoredObjectAnalysis(dataManager, analysis, startTime, threadPool, mainThreadState);
+          break;
+        }
+        case AnalysisType::PCD_TYPE:
+        {
+          runDCPAnalysis(dataManager, analysis, startTime, threadPool, mainThreadState);
+          break;
+        }
+        case AnalysisType::GRID_TYPE:
+        {
+          runGridAnalysis(dataManager, analysis, startTime, threadPool, mainThreadState);
+          break;
+        }
       }
     }
   }
@@ -146,13 +178,20 @@ void terrama2::services::analysis::core::runAnalysis(DataManagerPtr dataManager,
       if(logger.get())
         logger->error(errorStr, logId);
 
+      // the stored results may be incomplete
+      if(inputVersion)
+        inputVersion->remove();
+
       QString errMsg = QObject::tr("Analysis %1 (%2) finished with the following error(s):\n%3").arg(analysis->id).arg(startTime->toString().c_str()).arg(QString::fromStdString(errorStr));
       TERRAMA2_LOG_INFO() << errMsg;
     }
     else
     {
       if(logger.get())
-        logger->done(startTime, logId);
+        logger->done(unchangedDataTimestamp ? unchangedDataTimestamp : startTime, logId);
+
+      if(inputVersion && !unchangedDataTimestamp)
+        inputVersion->save();
 
       QString errMsg = QObject::tr("Analysis %1 finished successfully: %2").arg(analysis->id).arg(startTime->toString().c_str());
       TERRAMA2_LOG_INFO() << errMsg;
@@ -188,6 +227,7 @@ void terrama2::services::analysis::core::runMonitoredObjectAnalysis(DataManagerP
     context->loadMonitoredObject();
 
     size_t size = 0;
+    std::shared_ptr<ContextDataSeries> moDsContext;
     for(auto analysisDataSeries : analysis->analysisDataSeriesList)
     {
       if(analysisDataSeries.type == AnalysisDataSeriesType::DATASERIES_MONITORED_OBJECT_TYPE)
@@ -204,6 +244,7 @@ void terrama2::services::analysis::core::runMonitoredObjectAnalysis(DataManagerP
           throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
         }
         size = contextDataset->series.syncDataSet->size();
+        moDsContext = contextDataset;
 
         break;
       }
@@ -229,49 +270,79 @@ void terrama2::services::analysis::core::runMonitoredObjectAnalysis(DataManagerP
       throw PythonInterpreterException() << ErrorDescription(errMsg);
     }
 
-    size_t threadNumber = std::min(threadPool->numberOfThreads(), size);
+    // the objects are evaluated in chunks, the results of completed chunks are kept in a checkpoint
+    AnalysisCheckpoint checkpoint(analysis, startTime);
+    const size_t chunkSize = AnalysisCheckpoint::chunkSize(size, threadPool->numberOfThreads());
+    // the objects are identified in the checkpoint by the identifier attribute, not by the order of the rows
+    const bool useCheckpoint = chunkSize < size && moDsContext->series.teDataSetType
+                               && moDsContext->series.teDataSetType->getProperty(moDsContext->identifier) != nullptr;
+
+    std::vector<std::string> geomIds;
+    std::vector<uint32_t> remaining(size);
+    std::iota(remaining.begin(), remaining.end(), 0);
+    if(useCheckpoint)
+    {
+      geomIds.reserve(size);
+      for(uint32_t index = 0; index < size; ++index)
+        geomIds.push_back(moDsContext->series.syncDataSet->getString(index, moDsContext->identifier));
 
+      remaining = checkpoint.restoreObjects(geomIds, context);
+    }
 
-    // Calculates the number of geometries that each thread will contain.
-    size_t packageSize = 1;
-    if(size >= threadNumber)
+    for(size_t chunkBegin = 0; chunkBegin < remaining.size(); chunkBegin += chunkSize)
     {
-      packageSize = size / threadNumber;
-    }
+      std::vector<uint32_t> chunk(remaining.begin() + chunkBegin, remaining.begin() + std::min(chunkBegin + chunkSize, remaining.size()));
 
-    // if it's different than 0, the last package will be bigger.
-    uint32_t mod = size % threadNumber;
+      size_t threadNumber = std::min(threadPool->numberOfThreads(), chunk.size());
 
-    uint32_t begin = 0;
+      // Calculates the number of geometries that each thread will contain.
+      size_t packageSize = 1;
+      if(chunk.size() >= threadNumber)
+      {
+        packageSize = chunk.size() / threadNumber;
+      }
 
+      // if it's different than 0, the last package will be bigger.
+      uint32_t mod = chunk.size() % threadNumber;
 
-    //Starts collection threads
-    for (size_t i = 0; i < threadNumber; ++i)
-    {
+      uint32_t begin = 0;
 
-      std::vector<uint32_t> indexes;
-       // The last package takes the rest of the division.
-      if(i == threadNumber - 1)
-        packageSize += mod;
 
-      for(size_t j = begin; j < begin + packageSize; ++j)
+      //Starts collection threads
+      for (size_t i = 0; i < threadNumber; ++i)
       {
-        indexes.push_back(j);
-      }
+         // The last package takes the rest of the division.
+        if(i == threadNumber - 1)
+          packageSize += mod;
 
+        std::vector<uint32_t> indexes(chunk.begin() + begin, chunk.begin() + begin + packageSize);
 
-      // create a thread state object for this thread
-      PyThreadState * myThreadState = PyThreadState_New(mainInterpreterState);
-      states.push_back(myThreadState);
-      futures.push_back(threadPool->enqueue(&terrama2::services::analysis::core::python::runMonitoredObjectScript, myThreadState, context, indexes));
+        // create a thread state object for this thread
+        PyThreadState * myThreadState = PyThreadState_New(mainInterpreterState);
+        states.push_back(myThreadState);
+        futures.push_back(threadPool->enqueue(&terrama2::services::analysis::core::python::runMonitoredObjectScript, myThreadState, context, indexes));
 
-      begin += packageSize;
-    }
+        begin += packageSize;
+      }
 
-    std::for_each(futures.begin(), futures.end(), [](std::future<void>& f){ f.get(); });
+      std::for_each(futures.begin(), futures.end(), [](std::future<void>& f){ f.get(); });
+      futures.clear();
 
+      if(useCheckpoint && context->getErrors().empty())
+      {
+        std::vector<std::string> chunkIds;
+        chunkIds.reserve(chunk.size());
+        for(uint32_t index : chunk)
+          chunkIds.push_back(geomIds[index]);
+
+        checkpoint.saveObjects(chunkIds, context);
+      }
+    }
 
     storeMonitoredObjectAnalysisResult(dataManager, context);
+
+    if(useCheckpoint && context->getErrors().empty())
+      checkpoint.remove();
   }
   catch(const terrama2::Exception& e)
   {
@@ -368,6 +439,47 @@ void terrama2::services::analysis::core::storeMonitoredObjectAnalysisResult(Data
     throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
   }
 
+  auto attributes = context->getAttributes();
+
+  assert(dataSeries->datasetList.size() == 1);
+
+  if(dataSeries->semantics.dataFormat == terrama2::core::DataStoragerCsv::dataStoragerType())
+  {
+    // the file is written directly from the result columns, without the intermediate dataset
+    terrama2::core::DataStoragerCsv::Table table;
+    table.keyName = "geom_id";
+    table.names.assign(attributes.begin(), attributes.end());
+    table.keys.reserve(resultMap.size());
+    table.columns.assign(table.names.size(), std::vector<double>(resultMap.size(), std::numeric_limits<double>::quiet_NaN()));
+
+    for(const auto& result : resultMap)
+    {
+      const std::size_t row = table.keys.size();
+      table.keys.push_back(result.first);
+
+      // names are sorted, as the attributes set
+      for(const auto& value : result.second)
+      {
+        auto it = std::lower_bound(table.names.begin(), table.names.end(), value.first);
+        if(it != table.names.end() && *it == value.first)
+          table.columns[std::distance(table.names.begin(), it)][row] = value.second;
+      }
+    }
+
+    try
+    {
+      terrama2::core::DataStoragerCsv storager(dataProvider);
+      storager.storeTable(table, context->getStartTime(), "execution_date", dataSeries->datasetList[0]);
+    }
+    catch(const terrama2::Exception& /*e*/)
+    {
+      QString errMsg = QObject::tr("Could not store the result of the analysis.");
+      throw Exception() << ErrorDescription(errMsg);
+    }
+
+    return;
+  }
+
   std::string datasetName;
 
   if(dataSeries->semantics.dataFormat == "POSTGIS")
@@ -377,8 +489,8 @@ void terrama2::services::analysis::core::storeMonitoredObjectAnalysisResult(Data
   }
   else
   {
-    //TODO Paulo: Implement storager file
-    throw terrama2::Exception() << ErrorDescription("NOT IMPLEMENTED YET");
+    QString errMsg = QObject::tr("Output format not supported for monitored object analysis: %1.").arg(QString::fromStdString(dataSeries->semantics.dataFormat));
+    throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
   }
 
   auto storager = terrama2::core::DataStoragerFactory::getInstance().make(dataSeries->semantics.dataFormat, dataProvider);
@@ -388,10 +500,6 @@ void terrama2::services::analysis::core::storeMonitoredObjectAnalysisResult(Data
     throw terrama2::core::DataStoragerException() << ErrorDescription(errMsg);
   }
 
-  auto attributes = context->getAttributes();
-
-  assert(dataSeries->datasetList.size() == 1);
-
 
   std::shared_ptr<te::da::DataSetType> dt = std::make_shared<te::da::DataSetType>(datasetName);
 
@@ -507,49 +615,90 @@ void terrama2::services::analysis::core::runGridAnalysis(DataManagerPtr dataMana
       throw PythonInterpreterException() << ErrorDescription(errMsg);
     }
 
-    size_t threadNumber = std::min(threadPool->numberOfThreads(), size);
-
+    std::vector<GridTile> tiles;
+    if(analysis->outputGridPtr->sparseExecution)
+    {
+      context->createValidityMask();
+      tiles = context->getActiveTiles();
 
-    // Calculates the number of geometries that each thread will contain.
-    size_t packageSize = 1;
-    if(size >= threadNumber)
+      // Inactive cells are not evaluated, fills them with the dummy value
+      context->fillInactiveCells(analysis->outputGridPtr->interpolationDummy);
+    }
+    else
     {
-      packageSize = size / threadNumber;
+      tiles = context->getActiveTiles();
     }
 
-    // if it's different than 0, the last package will be bigger.
-    uint32_t mod = size % threadNumber;
-
-    uint32_t begin = 0;
+    // only the tiles affected by grids that changed since the previous execution are evaluated
+    std::unique_ptr<GridProvenance> provenance;
+    std::vector<GridTile> reusedTiles;
+    if(analysis->outputGridPtr->incrementalExecution && GridProvenance::isSupported(analysis))
+    {
+      provenance.reset(new GridProvenance(context));
+      tiles = provenance->restore(tiles, reusedTiles);
+    }
 
-    //Starts collection threads
-    for (size_t i = 0; i < threadNumber; ++i)
+    auto runTiles = [&](const std::vector<GridTile>& tilesToRun)
     {
+      size_t threadNumber = std::min(threadPool->numberOfThreads(), std::max(tilesToRun.size(), static_cast<size_t>(1)));
 
-      std::vector<uint32_t> indexes;
-      // The last package takes the rest of the division.
-      if(i == threadNumber - 1)
-        packageSize += mod;
+      // Distributes the tiles among the threads, interleaved to balance regions with more work
+      std::vector<std::vector<GridTile> > packages(threadNumber);
+      for(size_t i = 0; i < tilesToRun.size(); ++i)
+        packages[i % threadNumber].push_back(tilesToRun[i]);
 
-      for(size_t j = begin; j < begin + packageSize; ++j)
+      //Starts collection threads
+      for(auto& package : packages)
       {
-        indexes.push_back(j);
+        if(package.empty())
+          continue;
+
+        // create a thread state object for this thread
+        PyThreadState * myThreadState = PyThreadState_New(mainInterpreterState);
+        states.push_back(myThreadState);
+        futures.push_back(threadPool->enqueue(&terrama2::services::analysis::core::python::runScriptGridAnalysis, myThreadState, context, package));
       }
 
+      std::for_each(futures.begin(), futures.end(), [](std::future<void>& f){ f.get(); });
+      futures.clear();
+    };
 
-      // create a thread state object for this thread
-      PyThreadState * myThreadState = PyThreadState_New(mainInterpreterState);
-      states.push_back(myThreadState);
-      futures.push_back(threadPool->enqueue(&terrama2::services::analysis::core::python::runScriptGridAnalysis, myThreadState, context, indexes));
+    // the tiles are evaluated in chunks, the values of completed chunks are kept in a checkpoint
+    AnalysisCheckpoint checkpoint(analysis, startTime);
+    const size_t chunkSize = AnalysisCheckpoint::chunkSize(tiles.size(), threadPool->numberOfThreads());
+    const bool useCheckpoint = chunkSize < tiles.size();
+    if(useCheckpoint)
+      tiles = checkpoint.restoreTiles(tiles, context);
 
-      begin += packageSize;
-    }
+    auto runChunks = [&](const std::vector<GridTile>& tilesToRun)
+    {
+      for(size_t chunkBegin = 0; chunkBegin < tilesToRun.size(); chunkBegin += chunkSize)
+      {
+        std::vector<GridTile> chunk(tilesToRun.begin() + chunkBegin, tilesToRun.begin() + std::min(chunkBegin + chunkSize, tilesToRun.size()));
+        runTiles(chunk);
 
-    std::for_each(futures.begin(), futures.end(), [](std::future<void>& f){ f.get(); });
+        if(useCheckpoint && context->getErrors().empty())
+          checkpoint.saveTiles(chunk, context);
+      }
+    };
+
+    runChunks(tiles);
+
+    // the script read other grids than the listed ones, the reused tiles may be outdated
+    if(provenance && !reusedTiles.empty() && context->getErrors().empty() && !provenance->isValid())
+      runChunks(reusedTiles);
+
+    if(provenance && context->getErrors().empty())
+      provenance->save();
 
     auto errors = context->getErrors();
     if(errors.empty())
+    {
       storeGridAnalysisResult(context);
+
+      if(useCheckpoint)
+        checkpoint.remove();
+    }
   }
   catch(const terrama2::Exception& e)
   {
@@ -598,6 +747,123 @@ void terrama2::services::analysis::core::runGridAnalysis(DataManagerPtr dataMana
   PyEval_ReleaseLock();
 }
 
+namespace
+{
+  //! Stores the raster in the dataset of the data series.
+  void storeGridResult(terrama2::services::analysis::core::DataManagerPtr dataManager, DataSeriesId dataSeriesId, std::unique_ptr<te::rst::Raster> raster)
+  {
+    auto dataSeries = dataManager->findDataSeries(dataSeriesId);
+    if(!dataSeries)
+    {
+      QString errMsg = QObject::tr("Could not find the output data series.");
+      throw terrama2::InvalidArgumentException() << terrama2::ErrorDescription(errMsg);
+    }
+
+    auto dataProvider = dataManager->findDataProvider(dataSeries->dataProviderId);
+    if(!dataProvider)
+    {
+      QString errMsg = QObject::tr("Could not find the output data provider.");
+      throw terrama2::InvalidArgumentException() << terrama2::ErrorDescription(errMsg);
+    }
+
+    std::map<std::string, std::string> rinfo;
+
+    // the stored bands keep the pixel type, no data, scale and offset of the output raster
+    std::vector<te::rst::BandProperty*> bprops;
+    for(std::size_t bandIdx = 0; bandIdx < raster->getNumberOfBands(); ++bandIdx)
+      bprops.push_back(new te::rst::BandProperty(*raster->getBand(bandIdx)->getProperty()));
+
+    te::rst::RasterProperty* rstp = new te::rst::RasterProperty(new te::rst::Grid(*raster->getGrid()), bprops, rinfo);
+    te::da::DataSetType* dt = new te::da::DataSetType("raster dataset");
+
+    dt->add(rstp);
+
+    assert(dataSeries->datasetList.size() == 1);
+    auto dataset = dataSeries->datasetList[0];
+
+    std::shared_ptr<te::mem::DataSet> ds = std::make_shared<te::mem::DataSet>(dt);
+
+    te::mem::DataSetItem* dsItem = new te::mem::DataSetItem(ds.get());
+    std::size_t rpos = te::da::GetFirstPropertyPos(ds.get(), te::dt::RASTER_TYPE);
+
+    dsItem->setRaster(rpos, raster.release());
+    ds->add(dsItem);
+
+    std::shared_ptr<terrama2::core::SynchronizedDataSet> syncDataSet = std::make_shared<terrama2::core::SynchronizedDataSet>(ds);
+
+    terrama2::core::DataSetSeries series;
+    series.teDataSetType.reset(dt);
+    series.syncDataSet.swap(syncDataSet);
+
+    try
+    {
+      terrama2::core::DataStoragerTiff storager(dataProvider);
+      storager.store(series, dataset);
+    }
+    catch(const terrama2::Exception& /*e*/)
+    {
+      QString errMsg = QObject::tr("Could not store the result of the analysis.");
+      throw terrama2::services::analysis::core::Exception() << terrama2::ErrorDescription(errMsg);
+    }
+  }
+}
+
+std::map<DataSeriesId, std::vector<std::size_t> >
+terrama2::services::analysis::core::outputBandsByDataSeries(const Analysis& analysis, std::size_t numberOfBands)
+{
+  std::map<DataSeriesId, std::vector<std::size_t> > bandsByDataSeries;
+  for(std::size_t bandIdx = 0; bandIdx < numberOfBands; ++bandIdx)
+  {
+    DataSeriesId dataSeriesId = analysis.outputDataSeriesId;
+    if(analysis.outputGridPtr && bandIdx < analysis.outputGridPtr->bandNames.size())
+    {
+      const auto& outputGrid = *analysis.outputGridPtr;
+      auto it = outputGrid.bandDataSeries.find(outputGrid.bandNames[bandIdx]);
+      if(it != outputGrid.bandDataSeries.end())
+        dataSeriesId = it->second;
+    }
+
+    bandsByDataSeries[dataSeriesId].push_back(bandIdx);
+  }
+
+  return bandsByDataSeries;
+}
+
+std::unique_ptr<te::rst::Raster> terrama2::services::analysis::core::selectBands(const te::rst::Raster& raster, const std::vector<std::size_t>& selectedBands)
+{
+  std::vector<te::rst::BandProperty*> bands;
+  for(std::size_t bandIdx : selectedBands)
+  {
+    te::rst::BandProperty* bandProperty = new te::rst::BandProperty(*raster.getBand(bandIdx)->getProperty());
+    bandProperty->m_idx = static_cast<unsigned int>(bands.size());
+    bands.push_back(bandProperty);
+  }
+
+  std::unique_ptr<te::rst::Raster> result(te::rst::RasterFactory::make("MEM", new te::rst::Grid(*raster.getGrid()), bands, {}));
+  if(!result)
+  {
+    QString errMsg = QObject::tr("Could not create raster of the output bands.");
+    throw Exception() << ErrorDescription(errMsg);
+  }
+
+  double value = 0;
+  for(std::size_t i = 0; i < selectedBands.size(); ++i)
+  {
+    const te::rst::Band* band = raster.getBand(selectedBands[i]);
+    te::rst::Band* resultBand = result->getBand(i);
+    for(unsigned int row = 0; row < raster.getNumberOfRows(); ++row)
+    {
+      for(unsigned int col = 0; col < raster.getNumberOfColumns(); ++col)
+      {
+        band->getValue(col, row, value);
+        resultBand->setValue(col, row, value);
+      }
+    }
+  }
+
+  return result;
+}
+
 void terrama2::services::analysis::core::storeGridAnalysisResult(terrama2::services::analysis::core::GridContextPtr context)
 {
   auto analysis = context->getAnalysis();
@@ -616,23 +882,6 @@ void terrama2::services::analysis::core::storeGridAnalysisResult(terrama2::servi
   //FIXME: check dataManager
   assert(dataManager.get());
 
-  auto dataSeries = dataManager->findDataSeries(analysis->outputDataSeriesId);
-  if(!dataSeries)
-  {
-    QString errMsg = QObject::tr("Could not find the output data series.");
-    throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
-  }
-
-  auto dataProvider = dataManager->findDataProvider(dataSeries->dataProviderId);
-  if(!dataProvider)
-  {
-    QString errMsg = QObject::tr("Could not find the output data provider.");
-    throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
-  }
-
-
-  std::map<std::string, std::string> rinfo;
-
   auto raster = context->getOutputRaster();
   if(!raster)
   {
@@ -647,40 +896,17 @@ void terrama2::services::analysis::core::storeGridAnalysisResult(terrama2::servi
     throw EmptyResultException() << ErrorDescription(errMsg);
   }
 
-  std::vector<te::rst::BandProperty*> bprops;
-  bprops.push_back(new te::rst::BandProperty(0, te::dt::DOUBLE_TYPE));
-
-  te::rst::RasterProperty* rstp = new te::rst::RasterProperty(new te::rst::Grid(*grid), bprops, rinfo);
-  te::da::DataSetType* dt = new te::da::DataSetType("raster dataset");
-
-  dt->add(rstp);
-
-  assert(dataSeries->datasetList.size() == 1);
-  auto dataset = dataSeries->datasetList[0];
-
-  std::shared_ptr<te::mem::DataSet> ds = std::make_shared<te::mem::DataSet>(dt);
-
-  te::mem::DataSetItem* dsItem = new te::mem::DataSetItem(ds.get());
-  std::size_t rpos = te::da::GetFirstPropertyPos(ds.get(), te::dt::RASTER_TYPE);
-
-  //REVIEW: should clone be used? why not the self raster?
-  dsItem->setRaster(rpos, dynamic_cast<te::rst::Raster*>(raster->clone()));
-  ds->add(dsItem);
-
-  std::shared_ptr<terrama2::core::SynchronizedDataSet> syncDataSet = std::make_shared<terrama2::core::SynchronizedDataSet>(ds);
-
-  terrama2::core::DataSetSeries series;
-  series.teDataSetType.reset(dt);
-  series.syncDataSet.swap(syncDataSet);
-
-  try
-  {
-    terrama2::core::DataStoragerTiff storager(dataProvider);
-    storager.store(series, dataset);
-  }
-  catch(const terrama2::Exception& /*e*/)
+  // bands with their own data series are stored separately,
+  // the other bands are stored together as one product in the output data series
+  for(const auto& item : outputBandsByDataSeries(*analysis, raster->getNumberOfBands()))
   {
-    QString errMsg = QObject::tr("Could not store the result of the analysis.");
-    throw Exception() << ErrorDescription(errMsg);
+    //REVIEW: should clone be used? why not the self raster?
+    std::unique_ptr<te::rst::Raster> product;
+    if(item.second.size() == raster->getNumberOfBands())
+      product.reset(dynamic_cast<te::rst::Raster*>(raster->clone()));
+    else
+      product = selectBands(*raster, item.second);
+
+    storeGridResult(dataManager, item.first, std::move(product));
   }
 }
@@ -37,6 +37,8 @@
 #include "GridContext.hpp"
 
 // STL
+#include <map>
+#include <memory>
 #include <vector>
 
 namespace terrama2
@@ -90,10 +92,23 @@ namespace terrama2
 
         /*!
           \brief Reads the analysis result from context and stores it to the configured output dataset.
-          \param dataManager A smart pointer to the data manager.
+
+          Output bands with their own data series are stored in it,
+          the other bands are stored together as a multi-band product in the output dataset.
         */
         void storeGridAnalysisResult(terrama2::services::analysis::core::GridContextPtr context);
 
+        /*!
+          \brief Groups the bands of the output grid by the data series where they are stored.
+
+          Bands listed in AnalysisOutputGrid::bandDataSeries are stored in their own data series,
+          the other bands in the output data series of the analysis.
+        */
+        std::map<DataSeriesId, std::vector<std::size_t> > outputBandsByDataSeries(const Analysis& analysis, std::size_t numberOfBands);
+
+        //! Creates a raster with a copy of the selected bands, in the order of the selection.
+        std::unique_ptr<te::rst::Raster> selectBands(const te::rst::Raster& raster, const std::vector<std::size_t>& selectedBands);
+
 
       } // end namespace core
     }   // end namespace analysis
@@ -34,6 +34,34 @@
 #include "../../../core/data-access/DataAccessorGrid.hpp"
 #include "../../../core/utility/DataAccessorFactory.hpp"
 #include "../../../core/utility/TimeUtils.hpp"
+#include "../../../core/Exception.hpp"
+
+// TerraLib
+#include <terralib/datatype/TimeInstantTZ.h>
+
+// Boost
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+namespace
+{
+  //! Version of the data of a list of grids, the number of grids and the latest timestamp.
+  std::string gridDataVersion(const std::vector<terrama2::core::GridInfo>& grids)
+  {
+    boost::posix_time::ptime lastTimestamp;
+    for(const auto& gridInfo : grids)
+    {
+      if(!gridInfo.timestamp)
+        continue;
+
+      auto timestamp = gridInfo.timestamp->getTimeInstantTZ().utc_time();
+      if(lastTimestamp.is_not_a_date_time() || timestamp > lastTimestamp)
+        lastTimestamp = timestamp;
+    }
+
+    return std::to_string(grids.size()) + "@"
+           + (lastTimestamp.is_not_a_date_time() ? std::string() : boost::posix_time::to_iso_string(lastTimestamp));
+  }
+}
 
 terrama2::services::analysis::core::BaseContext::BaseContext(terrama2::services::analysis::core::DataManagerPtr dataManager, terrama2::services::analysis::core::AnalysisPtr analysis, std::shared_ptr<te::dt::TimeInstantTZ> startTime)
   : dataManager_(dataManager),
@@ -149,24 +177,9 @@ terrama2::services::analysis::core::BaseContext::getGridMap(terrama2::services::
   auto it = analysisGridMap_.find(key);
   if(it == analysisGridMap_.end())
   {
-    auto dataSeriesPtr = dataManager->findDataSeries(dataSeriesId);
-    if(!dataSeriesPtr)
-    {
-      QString errMsg = QObject::tr("Could not recover data series: %1.").arg(dataSeriesId);
-      throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
-    }
-
-    auto dataProviderPtr = dataManager->findDataProvider(dataSeriesPtr->dataProviderId);
-
-    terrama2::core::DataAccessorPtr accessor = terrama2::core::DataAccessorFactory::getInstance().make(dataProviderPtr, dataSeriesPtr);
-    std::shared_ptr<terrama2::core::DataAccessorGrid> accessorGrid = std::dynamic_pointer_cast<terrama2::core::DataAccessorGrid>(accessor);
-    if(!accessorGrid)
-    {
-      QString errMsg = QObject::tr("Could not create a DataAccessor to the data series: %1.").arg(dataSeriesId);
-      throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
-    }
+    auto accessorGrid = createGridAccessor(dataManager, dataSeriesId);
 
-    terrama2::core::Filter filter = createFilter(dateDiscardBefore, dateDiscardAfter);
+    terrama2::core::Filter filter = createGridFilter(dateDiscardBefore, dateDiscardAfter);
     auto gridSeries = accessorGrid->getGridSeries(filter);
 
     if(!gridSeries)
@@ -175,14 +188,161 @@ terrama2::services::analysis::core::BaseContext::getGridMap(terrama2::services::
       throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
     }
 
+    GridRequest request;
+    request.key = key;
+    for(const auto& item : gridSeries->handleMap())
+    {
+      terrama2::core::GridInfo gridInfo = item.second->gridInfo();
+      gridInfo.dataSet = item.first;
+      gridInfo.timestamp = item.second->timestamp();
+      request.grids.push_back(gridInfo);
+    }
+    gridRequests_.push_back(request);
+
     auto gridMap =  gridSeries->gridMap();
     analysisGridMap_.emplace(key, gridMap);
+
+    dataVersionMap_.emplace(key, gridDataVersion(request.grids));
     return gridMap;
   }
 
   return it->second;
 }
 
+std::string terrama2::services::analysis::core::BaseContext::getDataVersion(const terrama2::core::DataSeriesPtr& dataSeries,
+    const std::string& dateDiscardBefore, const std::string& dateDiscardAfter)
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+
+  ObjectKey key;
+  key.objectId_ = dataSeries->id;
+  key.dateFilterBegin_ = dateDiscardBefore;
+  key.dateFilterEnd_ = dateDiscardAfter;
+
+  auto it = dataVersionMap_.find(key);
+  if(it != dataVersionMap_.end())
+    return it->second;
+
+  auto dataManager = dataManager_.lock();
+  if(!dataManager)
+  {
+    QString errMsg(QObject::tr("Invalid data manager."));
+    throw terrama2::core::InvalidDataManagerException() << terrama2::ErrorDescription(errMsg);
+  }
+
+  // the version only depends on the metadata of the grids, the pixels are not read
+  auto dataVersion = gridDataVersion(listGrids(dataManager, key));
+  dataVersionMap_.emplace(key, dataVersion);
+  return dataVersion;
+}
+
+std::string terrama2::services::analysis::core::BaseContext::getDateWindow(const std::string& dateDiscardBefore,
+    const std::string& dateDiscardAfter)
+{
+  auto filter = createFilter(dateDiscardBefore, dateDiscardAfter);
+
+  auto toUtcString = [](const std::unique_ptr<te::dt::TimeInstantTZ>& timestamp) -> std::string
+  {
+    if(!timestamp)
+      return "";
+
+    return boost::posix_time::to_iso_string(timestamp->getTimeInstantTZ().utc_time());
+  };
+
+  std::string window = toUtcString(filter.discardBefore) + "/" + toUtcString(filter.discardAfter);
+  if(filter.lastValue)
+    window += "/last";
+
+  return window;
+}
+
+std::vector<terrama2::core::GridInfo>
+terrama2::services::analysis::core::BaseContext::getGridInfo(terrama2::services::analysis::core::DataManagerPtr dataManager,
+    DataSeriesId dataSeriesId)
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+
+  auto it = gridInfoMap_.find(dataSeriesId);
+  if(it != gridInfoMap_.end())
+    return it->second;
+
+  std::vector<terrama2::core::GridInfo> gridInfoList;
+
+  ObjectKey key;
+  key.objectId_ = dataSeriesId;
+  auto itGrid = analysisGridMap_.find(key);
+  if(itGrid != analysisGridMap_.end())
+  {
+    // rasters already loaded, no need to probe the files
+    for(const auto& item : itGrid->second)
+    {
+      if(!item.second)
+        continue;
+
+      terrama2::core::GridInfo gridInfo;
+      gridInfo.dataSet = item.first;
+      terrama2::core::DataAccessorGrid::fillGridInfo(gridInfo, item.second.get());
+      gridInfoList.push_back(gridInfo);
+    }
+  }
+  else
+  {
+    auto accessorGrid = createGridAccessor(dataManager, dataSeriesId);
+
+    gridInfoList = accessorGrid->getGridInfo(createGridFilter());
+  }
+
+  gridInfoMap_.emplace(dataSeriesId, gridInfoList);
+  return gridInfoList;
+}
+
+std::vector<terrama2::services::analysis::core::GridRequest> terrama2::services::analysis::core::BaseContext::getGridRequests() const
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  return gridRequests_;
+}
+
+std::vector<terrama2::core::GridInfo>
+terrama2::services::analysis::core::BaseContext::listGrids(terrama2::services::analysis::core::DataManagerPtr dataManager,
+    const ObjectKey& key)
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+
+  auto accessorGrid = createGridAccessor(dataManager, key.objectId_);
+  try
+  {
+    return accessorGrid->getGridInfo(createGridFilter(key.dateFilterBegin_, key.dateFilterEnd_));
+  }
+  catch(const terrama2::core::NoDataException&)
+  {
+    return {};
+  }
+}
+
+std::shared_ptr<terrama2::core::DataAccessorGrid>
+terrama2::services::analysis::core::BaseContext::createGridAccessor(terrama2::services::analysis::core::DataManagerPtr dataManager,
+    DataSeriesId dataSeriesId)
+{
+  auto dataSeriesPtr = dataManager->findDataSeries(dataSeriesId);
+  if(!dataSeriesPtr)
+  {
+    QString errMsg = QObject::tr("Could not recover data series: %1.").arg(dataSeriesId);
+    throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
+  }
+
+  auto dataProviderPtr = dataManager->findDataProvider(dataSeriesPtr->dataProviderId);
+
+  terrama2::core::DataAccessorPtr accessor = terrama2::core::DataAccessorFactory::getInstance().make(dataProviderPtr, dataSeriesPtr);
+  std::shared_ptr<terrama2::core::DataAccessorGrid> accessorGrid = std::dynamic_pointer_cast<terrama2::core::DataAccessorGrid>(accessor);
+  if(!accessorGrid)
+  {
+    QString errMsg = QObject::tr("Could not create a DataAccessor to the data series: %1.").arg(dataSeriesId);
+    throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
+  }
+
+  return accessorGrid;
+}
+
 terrama2::core::Filter terrama2::services::analysis::core::BaseContext::createFilter(const std::string& dateDiscardBefore, const std::string& dateDiscardAfter)
 {
   std::lock_guard<std::recursive_mutex> lock(mutex_);
@@ -227,6 +387,15 @@ terrama2::core::Filter terrama2::services::analysis::core::BaseContext::createFi
   return filter;
 }
 
+terrama2::core::Filter terrama2::services::analysis::core::BaseContext::createGridFilter(const std::string& dateDiscardBefore, const std::string& dateDiscardAfter)
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+  terrama2::core::Filter filter = createFilter(dateDiscardBefore, dateDiscardAfter);
+  filter.region = interestArea_;
+
+  return filter;
+}
+
 std::unordered_map<terrama2::core::DataSetPtr,terrama2::core::DataSetSeries >
 terrama2::services::analysis::core::BaseContext::getSeriesMap(DataSeriesId dataSeriesId,
     const std::string& dateDiscardBefore,
@@ -255,16 +424,25 @@ terrama2::services::analysis::core::BaseContext::getSeriesMap(DataSeriesId dataS
     terrama2::core::DataAccessorPtr accessor = terrama2::core::DataAccessorFactory::getInstance().make(dataProviderPtr, dataSeriesPtr);
     std::shared_ptr<terrama2::core::DataAccessorGrid> accessorGrid = std::dynamic_pointer_cast<terrama2::core::DataAccessorGrid>(accessor);
 
-    terrama2::core::Filter filter = createFilter(dateDiscardBefore, dateDiscardAfter);
-    auto gridSeries = accessorGrid->getGridSeries(filter);
+    std::unordered_map<terrama2::core::DataSetPtr, terrama2::core::DataSetSeries > series;
+    if(accessorGrid)
+    {
+      auto gridSeries = accessorGrid->getGridSeries(createGridFilter(dateDiscardBefore, dateDiscardAfter));
 
-    if(!gridSeries)
+      if(!gridSeries)
+      {
+        QString errMsg = QObject::tr("Invalid grid series for data series: %1.").arg(dataSeriesId);
+        throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
+      }
+
+      series = gridSeries->getSeries();
+    }
+    else
     {
-      QString errMsg = QObject::tr("Invalid grid series for data series: %1.").arg(dataSeriesId);
-      throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
+      // the interest area is not applied to other data, e.g. occurrences out of the grid still count in a kernel density
+      series = accessor->getSeries(createFilter(dateDiscardBefore, dateDiscardAfter));
     }
 
-    auto series =  gridSeries->getSeries();
     analysisSeriesMap_.emplace(key, series);
     return series;
   }
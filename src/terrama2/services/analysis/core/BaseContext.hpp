@@ -36,6 +36,7 @@
 
 #include "../../../core/data-model/Filter.hpp"
 #include "../../../core/data-access/DataSetSeries.hpp"
+#include "../../../core/data-access/DataAccessorGrid.hpp"
 #include "../../../core/Shared.hpp"
 #include "DataManager.hpp"
 #include "Analysis.hpp"
@@ -74,6 +75,15 @@ namespace terrama2
           std::string dateFilterEnd_; //!< End date restriction.
         };
 
+        /*!
+          \brief Grids read by the context for a request to a grid data series.
+        */
+        struct GridRequest
+        {
+          ObjectKey key; //!< Data series and date filter of the request.
+          std::vector<terrama2::core::GridInfo> grids; //!< Grids returned by the data accessor.
+        };
+
         struct ObjectKeyHash
         {
           std::size_t operator()(ObjectKey const& key) const
@@ -166,11 +176,43 @@ namespace terrama2
 
             std::shared_ptr<te::rst::Interpolator> getInterpolator(std::shared_ptr<te::rst::Raster> raster);
 
+            /*!
+              \brief Returns the series of the data series, loaded once for each filter.
 
+              Grid data series are read as grid series, the others are read directly from their accessor.
+            */
             std::unordered_map<terrama2::core::DataSetPtr, terrama2::core::DataSetSeries > getSeriesMap(DataSeriesId dataSeriesId,
                 const std::string& dateDiscardBefore = "",
                 const std::string& dateDiscardAfter = "");
 
+            /*!
+              \brief Returns a version of the grid data of the data series used by this context.
+
+              The version changes when new data is collected,
+              results computed with the same version of the data can be shared between analyses.
+              If the grids were not loaded yet, only their metadata is read.
+            */
+            std::string getDataVersion(const terrama2::core::DataSeriesPtr& dataSeries,
+                const std::string& dateDiscardBefore = "", const std::string& dateDiscardAfter = "");
+
+            /*!
+              \brief Returns the absolute date window read with the given date filter.
+
+              The relative date filter is resolved with the start time of the context,
+              the window is represented by its UTC limits.
+            */
+            std::string getDateWindow(const std::string& dateDiscardBefore = "", const std::string& dateDiscardAfter = "");
+
+            //! Returns the requests to grid data series made by the context, in the order they were made.
+            std::vector<GridRequest> getGridRequests() const;
+
+            /*!
+              \brief Lists the grids a request to the data series would read, without reading the pixels.
+
+              \return The grids of the request, empty if there is no data.
+            */
+            std::vector<terrama2::core::GridInfo> listGrids(DataManagerPtr dataManager, const ObjectKey& key);
+
           protected:
             /*!
               \brief Return the a multimap of DataSetGridPtr to Raster
@@ -181,8 +223,32 @@ namespace terrama2
             std::unordered_multimap<terrama2::core::DataSetGridPtr, std::shared_ptr<te::rst::Raster> >
             getGridMap(DataManagerPtr dataManager, DataSeriesId dataSeriesId, const std::string& dateDiscardBefore = "", const std::string& dateDiscardAfter = "");
 
+            /*!
+              \brief Return the geometry of the last grids of the data series, without reading the pixels.
+
+              If the grids of the data series were already loaded their information is used.
+            */
+            std::vector<terrama2::core::GridInfo> getGridInfo(DataManagerPtr dataManager, DataSeriesId dataSeriesId);
+
+            //! Creates the grid data accessor of the data series.
+            std::shared_ptr<terrama2::core::DataAccessorGrid> createGridAccessor(DataManagerPtr dataManager, DataSeriesId dataSeriesId);
+
+            /*!
+              \brief Creates the filter to access the data series.
+
+              The filter has no region, data outside the interest area may still influence it,
+              e.g. occurrences near the border in a kernel density.
+            */
             terrama2::core::Filter createFilter(const std::string& dateDiscardBefore = "", const std::string& dateDiscardAfter = "");
 
+            /*!
+              \brief Creates the filter to read grids.
+
+              The region of the filter is the interest area of the context,
+              only the pixels of the grids in this area are read.
+            */
+            terrama2::core::Filter createGridFilter(const std::string& dateDiscardBefore = "", const std::string& dateDiscardAfter = "");
+
             /*!
               \brief Adds the given raster to the context map.
 
@@ -200,6 +266,7 @@ namespace terrama2
             std::weak_ptr<terrama2::services::analysis::core::DataManager> dataManager_;
             AnalysisPtr analysis_;
             std::shared_ptr<te::dt::TimeInstantTZ> startTime_;
+            std::shared_ptr<te::gm::Geometry> interestArea_; //!< Only the pixels of the grids in this area are read, if null the complete grids are read.
             std::set<std::string> errorsSet_;
 
 
@@ -207,8 +274,11 @@ namespace terrama2
             std::unordered_map<Srid, std::shared_ptr<te::srs::Converter> > converterMap_;
             std::unordered_map<ObjectKey, std::unordered_multimap<terrama2::core::DataSetGridPtr, std::shared_ptr<te::rst::Raster> >, ObjectKeyHash, EqualKeyComparator> analysisGridMap_;
             std::unordered_map<ObjectKey, std::unordered_map<terrama2::core::DataSetPtr,terrama2::core::DataSetSeries >, ObjectKeyHash, EqualKeyComparator> analysisSeriesMap_;
+            std::unordered_map<DataSeriesId, std::vector<terrama2::core::GridInfo> > gridInfoMap_;
+            std::unordered_map<ObjectKey, std::string, ObjectKeyHash, EqualKeyComparator> dataVersionMap_;
             std::unordered_map<ObjectKey, std::vector<std::shared_ptr<te::rst::Raster> >, ObjectKeyHash, EqualKeyComparator > rasterMap_;
             std::unordered_map<std::shared_ptr<te::rst::Raster>, std::shared_ptr<te::rst::Interpolator> > interpolatorMap_;
+            std::vector<GridRequest> gridRequests_; //!< Grids read by each call to getGridMap.
         };
 
       }
@@ -37,6 +37,119 @@
 #include <terralib/dataaccess/utils/Utils.h>
 #include <terralib/memory/DataSetItem.h>
 #include <terralib/geometry/GeometryProperty.h>
+#include <terralib/geometry/Utils.h>
+
+// STL
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+namespace
+{
+  /*!
+    \brief Disjoint-set forest with path compression and union by rank.
+
+    Used to group the occurrences whose buffers intersect in near linear time.
+  */
+  class DisjointSet
+  {
+    public:
+      explicit DisjointSet(std::size_t size) : parent_(size), rank_(size, 0)
+      {
+        std::iota(parent_.begin(), parent_.end(), 0);
+      }
+
+      std::size_t find(std::size_t i)
+      {
+        while(parent_[i] != i)
+        {
+          parent_[i] = parent_[parent_[i]];
+          i = parent_[i];
+        }
+        return i;
+      }
+
+      void unite(std::size_t a, std::size_t b)
+      {
+        a = find(a);
+        b = find(b);
+        if(a == b)
+          return;
+
+        if(rank_[a] < rank_[b])
+          std::swap(a, b);
+
+        parent_[b] = a;
+        if(rank_[a] == rank_[b])
+          ++rank_[a];
+      }
+
+    private:
+      std::vector<std::size_t> parent_;
+      std::vector<uint8_t> rank_;
+  };
+
+  /*!
+    \brief Streaming accumulator for the aggregation statistics.
+
+    Mean and variance are computed with Welford's algorithm, values are only kept
+    when the median is requested.
+  */
+  struct StatisticAccumulator
+  {
+    void add(double value)
+    {
+      ++count;
+      sum += value;
+      min = std::min(min, value);
+      max = std::max(max, value);
+
+      double delta = value - mean;
+      mean += delta / count;
+      m2 += delta * (value - mean);
+
+      if(keepValues)
+        values.push_back(value);
+    }
+
+    void fill(terrama2::services::analysis::core::OperatorCache& cache)
+    {
+      cache.count = count;
+      if(count == 0)
+        return;
+
+      cache.sum = sum;
+      cache.min = min;
+      cache.max = max;
+      cache.mean = mean;
+      cache.variance = m2 / count;
+      cache.standardDeviation = std::sqrt(cache.variance);
+
+      if(keepValues && !values.empty())
+      {
+        auto half = values.size() / 2;
+        std::nth_element(values.begin(), values.begin() + half, values.end());
+        cache.median = values[half];
+        if(values.size() % 2 == 0)
+        {
+          double lower = *std::max_element(values.begin(), values.begin() + half);
+          cache.median = (cache.median + lower) / 2.;
+        }
+      }
+    }
+
+    bool keepValues = false;
+    uint32_t count = 0;
+    double sum = 0.;
+    double min = std::numeric_limits<double>::max();
+    double max = std::numeric_limits<double>::lowest();
+    double mean = 0.;
+    double m2 = 0.;
+    std::vector<double> values;
+  };
+}
 
 std::shared_ptr<te::gm::Geometry> terrama2::services::analysis::core::createBuffer(Buffer buffer,
                                                                                    std::shared_ptr<te::gm::Geometry> geometry)
@@ -134,8 +247,6 @@ std::shared_ptr<te::mem::DataSet> terrama2::services::analysis::core::createAggr
   if(indexes.empty())
     return dsOut;
 
-
-
   // Creates memory dataset for buffer
   te::da::DataSetType* dt = new te::da::DataSetType("buffer");
 
@@ -153,129 +264,190 @@ std::shared_ptr<te::mem::DataSet> terrama2::services::analysis::core::createAggr
 
   dsOut.reset(new te::mem::DataSet(dt));
 
+  int attributeType = -1;
+
+  if(aggregationStatisticOperation != StatisticOperation::COUNT)
+  {
+    if(attribute.empty())
+    {
+      QString errMsg(QObject::tr("Invalid attribute"));
+      throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
+    }
 
-  std::shared_ptr<te::gm::Envelope> box(syncDs->getExtent(contextDataSeries->geometryPos));
+    auto property = contextDataSeries->series.teDataSetType->getProperty(attribute);
 
+    if(!property)
+    {
+      QString errMsg(QObject::tr("Invalid attribute: %1").arg(QString::fromStdString(attribute)));
+      throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
+    }
+    attributeType = property->getType();
+  }
 
   if(buffer.unit.empty())
     buffer.unit = "m";
 
-  // Inserts each geometry in the rtree, if there is a conflict, it makes the union of the two geometries
-  te::sam::rtree::Index<OccurrenceAggregation*, 4> rtree;
+  double distance = terrama2::core::convertDistanceUnit(buffer.distance, buffer.unit, "METER");
 
-  for(size_t i = 0; i < indexes.size(); ++i)
-  {
-    auto geom = syncDs->getGeometry(indexes[i], contextDataSeries->geometryPos);
+  // Two buffers intersect when the distance between the occurrences is at most twice the buffer distance
+  double threshold = 2 * distance;
 
+  // Converts each occurrence to its UTM zone in order to measure distances in meters
+  std::vector<std::unique_ptr<te::gm::Geometry> > utmGeometries;
+  std::vector<int> utmSrids;
+  utmGeometries.reserve(indexes.size());
+  utmSrids.reserve(indexes.size());
 
-    double distance = terrama2::core::convertDistanceUnit(buffer.distance, buffer.unit, "METER");
+  // Spatial index of the unbuffered occurrences, in the dataset SRID
+  te::sam::rtree::Index<std::size_t, 8> rtree;
 
-    std::unique_ptr<te::gm::Geometry> tempGeom(dynamic_cast<te::gm::Geometry*>(geom.get()->clone()));
+  for(std::size_t i = 0; i < indexes.size(); ++i)
+  {
+    auto geom = syncDs->getGeometry(indexes[i], contextDataSeries->geometryPos);
+
+    std::unique_ptr<te::gm::Geometry> tempGeom(geom ? dynamic_cast<te::gm::Geometry*>(geom->clone()) : nullptr);
     if(!tempGeom)
     {
-      QString errMsg(QObject::tr("Invalid geometry in dataset: ").arg(contextDataSeries->series.dataSet->id));
+      QString errMsg(QObject::tr("Invalid geometry in dataset: %1").arg(contextDataSeries->series.dataSet->id));
       throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
     }
-    int utmSrid = terrama2::core::getUTMSrid(tempGeom.get());
 
-    // Converts to UTM in order to create buffer in meters
+    rtree.insert(*tempGeom->getMBR(), i);
+
+    int utmSrid = terrama2::core::getUTMSrid(tempGeom.get());
     if(tempGeom->getSRID() != utmSrid)
-    {
       tempGeom->transform(utmSrid);
-    }
-    std::unique_ptr<te::gm::Geometry> aggBuffer(tempGeom->buffer(distance, 16, te::gm::CapButtType));
-    aggBuffer->setSRID(utmSrid);
-
-    // Converts buffer to DataSet SRID in order to compare with the occurrences in the rtree
-    aggBuffer->transform(geomSampleSrid);
 
+    utmSrids.push_back(utmSrid);
+    utmGeometries.push_back(std::move(tempGeom));
+  }
 
-    std::vector<OccurrenceAggregation*> vec;
-    bool aggregated = false;
+  // Groups the occurrences that are closer than the threshold
+  DisjointSet clusters(indexes.size());
 
-    // Search for occurrences in the same area
-    rtree.search(*(aggBuffer->getMBR()), vec);
-    for(std::size_t t = 0; t < vec.size(); ++t)
+  if(threshold > 0)
+  {
+    std::vector<std::size_t> candidates;
+    for(std::size_t i = 0; i < indexes.size(); ++i)
     {
-      OccurrenceAggregation* occurrenceAggregation = vec[t];
+      te::gm::Envelope searchBox(*utmGeometries[i]->getMBR());
+      searchBox.m_llx -= threshold;
+      searchBox.m_lly -= threshold;
+      searchBox.m_urx += threshold;
+      searchBox.m_ury += threshold;
+      searchBox.transform(utmSrids[i], geomSampleSrid);
+
+      candidates.clear();
+      rtree.search(searchBox, candidates);
 
-      // If the an intersection is found, makes the union of the two geometries and mark the index.
-      if(aggBuffer->intersects(occurrenceAggregation->buffer.get()))
+      for(auto j : candidates)
       {
-        rtree.remove(*(occurrenceAggregation->buffer->getMBR()), occurrenceAggregation);
-        occurrenceAggregation->buffer.reset(aggBuffer->Union(occurrenceAggregation->buffer.get()));
-        occurrenceAggregation->indexes.push_back(i);
-        rtree.insert(*(occurrenceAggregation->buffer->getMBR()), occurrenceAggregation);
-        aggregated = true;
-      }
-    }
+        // each pair only needs to be tested once
+        if(j <= i || clusters.find(i) == clusters.find(j))
+          continue;
 
-    if(!aggregated)
-    {
-      OccurrenceAggregation* occurrenceAggregation = new OccurrenceAggregation();
-      occurrenceAggregation->buffer.reset(aggBuffer.release());
-      occurrenceAggregation->indexes.push_back(i);
-      rtree.insert(*(occurrenceAggregation->buffer->getMBR()), occurrenceAggregation);
+        double pairDistance;
+        if(utmSrids[j] == utmSrids[i])
+        {
+          pairDistance = utmGeometries[i]->distance(utmGeometries[j].get());
+        }
+        else
+        {
+          // occurrences in different UTM zones, measures in the zone of the first one
+          std::unique_ptr<te::gm::Geometry> other(dynamic_cast<te::gm::Geometry*>(utmGeometries[j]->clone()));
+          other->transform(utmSrids[i]);
+          pairDistance = utmGeometries[i]->distance(other.get());
+        }
+
+        if(pairDistance <= threshold)
+          clusters.unite(i, j);
+      }
     }
   }
 
-  // Fills the memory dataset with the geometries
-  std::vector<OccurrenceAggregation*> occurrenceAggVec;
-
-  rtree.search(*(box.get()), occurrenceAggVec);
+  // Collects the members of each aggregation, keeping the order of the first occurrence
+  std::vector<OccurrenceAggregation> occurrenceAggVec;
+  std::vector<std::vector<std::size_t> > members;
+  std::unordered_map<std::size_t, std::size_t> rootToAggregation;
 
-  int attributeType = -1;
-
-  if(aggregationStatisticOperation != StatisticOperation::COUNT)
+  for(std::size_t i = 0; i < indexes.size(); ++i)
   {
-    auto property = contextDataSeries->series.teDataSetType->getProperty(attribute);
-
-    if(!property)
+    auto root = clusters.find(i);
+    auto it = rootToAggregation.find(root);
+    if(it == rootToAggregation.end())
     {
-      QString errMsg(QObject::tr("Invalid attribute: %1").arg(QString::fromStdString(attribute)));
-      throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
+      it = rootToAggregation.emplace(root, occurrenceAggVec.size()).first;
+      occurrenceAggVec.emplace_back();
+      members.emplace_back();
     }
-    attributeType = property->getType();
-  }
 
+    occurrenceAggVec[it->second].indexes.push_back(indexes[i]);
+    members[it->second].push_back(i);
+  }
 
-  for(size_t i = 0; i < occurrenceAggVec.size(); i++)
+  for(std::size_t a = 0; a < occurrenceAggVec.size(); ++a)
   {
-    OccurrenceAggregation* occurrenceAggregation = occurrenceAggVec[i];
+    OccurrenceAggregation& occurrenceAggregation = occurrenceAggVec[a];
 
-    OperatorCache cache;
-    std::vector<double> values;
-    for(auto index : occurrenceAggregation->indexes)
-    {
-      cache.count++;
+    StatisticAccumulator accumulator;
+    accumulator.keepValues = aggregationStatisticOperation == StatisticOperation::MEDIAN;
 
-      if(aggregationStatisticOperation != StatisticOperation::COUNT)
+    // Buffers are created in the UTM zone of the first occurrence of the aggregation
+    int utmSrid = utmSrids[members[a].front()];
+    std::vector<std::unique_ptr<te::gm::Geometry> > buffers;
+    buffers.reserve(members[a].size());
+
+    for(auto i : members[a])
+    {
+      if(aggregationStatisticOperation == StatisticOperation::COUNT)
       {
-        if(attribute.empty())
-        {
-          QString errMsg(QObject::tr("Invalid attribute"));
-          throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
-        }
+        accumulator.add(0.);
+      }
+      else
+      {
+        double value = getValue(syncDs, attribute, indexes[i], attributeType);
+        if(!std::isnan(value))
+          accumulator.add(value);
+      }
 
-        double value = getValue(syncDs, attribute, index, attributeType);
-        values.push_back(value);
-        cache.sum += value;
-        if(value > cache.max)
-          cache.max = value;
-        if(value < cache.min)
-          cache.min = value;
+      te::gm::Geometry* geom = utmGeometries[i].get();
+      std::unique_ptr<te::gm::Geometry> transformed;
+      if(utmSrids[i] != utmSrid)
+      {
+        transformed.reset(dynamic_cast<te::gm::Geometry*>(geom->clone()));
+        transformed->transform(utmSrid);
+        geom = transformed.get();
       }
+
+      buffers.emplace_back(geom->buffer(distance, 16, te::gm::CapButtType));
+    }
+
+    if(buffers.size() == 1)
+    {
+      occurrenceAggregation.buffer = std::move(buffers.front());
+    }
+    else
+    {
+      // Single cascaded union of all buffers of the aggregation
+      std::vector<te::gm::Geometry*> geomVec;
+      geomVec.reserve(buffers.size());
+      for(const auto& aggBuffer : buffers)
+        geomVec.push_back(aggBuffer.get());
+
+      occurrenceAggregation.buffer.reset(te::gm::GetGeometryUnion(geomVec));
     }
 
-    calculateStatistics(values, cache);
+    occurrenceAggregation.buffer->setSRID(utmSrid);
+    occurrenceAggregation.buffer->transform(geomSampleSrid);
+
+    OperatorCache cache;
+    accumulator.fill(cache);
 
     auto item = new te::mem::DataSetItem(dsOut.get());
-    item->setGeometry(0, dynamic_cast<te::gm::Geometry*>(occurrenceAggregation->buffer->clone()));
+    item->setGeometry(0, occurrenceAggregation.buffer.release());
     item->setDouble(1, getOperationResult(cache, aggregationStatisticOperation));
     dsOut->add(item);
   }
 
-
   return dsOut;
-
 }
@@ -81,8 +81,8 @@ namespace terrama2
         */
         struct OccurrenceAggregation
         {
-          std::shared_ptr<te::gm::Geometry> buffer; //!< The geometry of created by the aggregation of the occurrences buffers.
-          std::vector<unsigned int> indexes; //!< The indexes that were aggregated.
+          std::unique_ptr<te::gm::Geometry> buffer; //!< The geometry created by the union of the occurrences buffers.
+          std::vector<uint32_t> indexes; //!< The dataset indexes of the occurrences that were aggregated.
         };
 
         struct Buffer
@@ -113,9 +113,9 @@ namespace terrama2
           { }
 
           BufferType bufferType; //!< The type of the buffer.
-          double distance; //!< The distance of the buffer, positive value for outside buffer and negative for inside buffer.
+          double distance = 0; //!< The distance of the buffer, positive value for outside buffer and negative for inside buffer.
           std::string unit; //!< The distance unit.
-          double distance2; //!< The distance of the second buffer, this attribute is only used for composed buffer such as OUTSIDE_PLUS_INSIDE and DISTANCE_ZONE.
+          double distance2 = 0; //!< The distance of the second buffer, this attribute is only used for composed buffer such as OUTSIDE_PLUS_INSIDE and DISTANCE_ZONE.
           std::string unit2; //!< The distance unit of the second buffer, this attribute is only used for composed buffer such as OUTSIDE_PLUS_INSIDE and DISTANCE_ZONE.
         };
 
@@ -128,7 +128,13 @@ namespace terrama2
         std::shared_ptr<te::gm::Geometry> createBuffer(Buffer buffer, std::shared_ptr<te::gm::Geometry> geometry);
 
         /*!
-          \brief Creates a buffer for each given geometry with the given distance.
+          \brief Creates a buffer for each given geometry with the given distance and aggregates the ones that intersect.
+
+          Two occurrences belong to the same aggregation when their buffers intersect, that is,
+          when the distance between them is at most twice the buffer distance.
+          The aggregations are found with a union-find over a spatial index of the occurrences,
+          the statistics are accumulated in a single pass and the geometry of each aggregation
+          is built with one cascaded union of the buffers of its occurrences.
 
           \param indexes Vector with the geometries indexes.
           \param contextDataSeries Smart pointer to the ContextDataSeries of the occurrences.
@@ -203,3 +203,28 @@ bool terrama2::services::analysis::core::DataManager::hasAnalysis(const Analysis
   const auto& it = analysis_.find(analysisId);
   return it != analysis_.cend();
 }
+
+terrama2::services::analysis::core::AnalysisPtr terrama2::services::analysis::core::DataManager::findProducerAnalysis(const DataSeriesId dataSeriesId) const
+{
+  std::lock_guard<std::recursive_mutex> lock(mtx_);
+
+  const auto& it = std::find_if(analysis_.cbegin(), analysis_.cend(),
+                                [dataSeriesId](std::pair<AnalysisId, AnalysisPtr> analysisPair)
+                                {
+                                  auto analysis = analysisPair.second;
+                                  if(analysis->outputDataSeriesId == dataSeriesId)
+                                    return true;
+
+                                  if(!analysis->outputGridPtr)
+                                    return false;
+
+                                  const auto& bands = analysis->outputGridPtr->bandDataSeries;
+                                  return std::any_of(bands.cbegin(), bands.cend(),
+                                                     [dataSeriesId](const std::pair<std::string, DataSeriesId>& band)
+                                                     { return band.second == dataSeriesId; });
+                                });
+  if(it == analysis_.cend())
+    return nullptr;
+
+  return it->second;
+}
@@ -167,6 +167,13 @@ namespace terrama2
             */
             bool hasAnalysis(const AnalysisId analysisId) const;
 
+            /*!
+            \brief Returns the analysis that stores its result in the dataseries, an empty smart pointer if there is none.
+
+            \note Thread-safe.
+            */
+            AnalysisPtr findProducerAnalysis(const DataSeriesId dataSeriesId) const;
+
 
           signals:
 
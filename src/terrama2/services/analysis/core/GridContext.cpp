@@ -31,11 +31,20 @@
 #include "grid/Operator.hpp"
 #include "DataManager.hpp"
 #include "Utils.hpp"
+#include "Exception.hpp"
 #include "PythonInterpreter.hpp"
 #include "../../../core/utility/TimeUtils.hpp"
 #include "../../../core/utility/Verify.hpp"
 #include "../../../core/data-model/DataSetGrid.hpp"
-
+#include "../../../core/data-access/DataAccessor.hpp"
+#include "../../../core/data-access/SynchronizedDataSet.hpp"
+
+#include <terralib/dataaccess/utils/Utils.h>
+#include <terralib/geometry/Point.h>
+#include <terralib/raster/Band.h>
+#include <terralib/raster/BlockUtils.h>
+#include <terralib/raster/BandProperty.h>
+#include <terralib/raster/Grid.h>
 #include <terralib/raster/Raster.h>
 #include <terralib/raster/RasterFactory.h>
 #include <terralib/srs/Converter.h>
@@ -50,6 +59,12 @@
 #include <boost/python/make_function.hpp>
 #include <boost/bind.hpp>
 
+// STL
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
 terrama2::services::analysis::core::GridContext::GridContext(terrama2::services::analysis::core::DataManagerPtr dataManager, terrama2::services::analysis::core::AnalysisPtr analysis, std::shared_ptr<te::dt::TimeInstantTZ> startTime)
   : BaseContext(dataManager, analysis, startTime)
 {
@@ -79,6 +94,14 @@ void terrama2::services::analysis::core::GridContext::createOutputRaster()
     std::tie(grid, bands) = terrama2::services::analysis::core::getOutputRasterInfo(rinfo);
     assert(grid);
     outputRaster_.reset(te::rst::RasterFactory::make("EXPANSIBLE", grid, bands, {}));
+
+    const auto& bandNames = analysis_->outputGridPtr->bandNames;
+    for(std::size_t bandIdx = 0; bandIdx < bandNames.size(); ++bandIdx)
+      outputRaster_->getBand(bandIdx)->getProperty()->m_description = bandNames[bandIdx];
+
+    // only the pixels of the input grids in the output extent are read
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    interestArea_.reset(te::gm::GetGeomFromEnvelope(outputRaster_->getExtent(), outputRaster_->getSRID()));
   }
   catch(const terrama2::Exception&)
   {
@@ -128,8 +151,6 @@ std::map<std::string, std::string> terrama2::services::analysis::core::GridConte
   if(outputRasterInfo_.empty())
   {
     outputRasterInfo_["MEM_SRC_RASTER_DRIVER_TYPE"] = "GDAL";
-    outputRasterInfo_["MEM_RASTER_DATATYPE"] = te::common::Convert2String(te::dt::DOUBLE_TYPE);
-    outputRasterInfo_["MEM_RASTER_NBANDS"] = "1";
 
     if(!analysis_->outputGridPtr)
     {
@@ -137,7 +158,21 @@ std::map<std::string, std::string> terrama2::services::analysis::core::GridConte
       throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
     }
 
-    outputRasterInfo_["MEM_RASTER_NODATA"] = std::to_string(analysis_->outputGridPtr->interpolationDummy);
+    // a band for each named output, all computed in the same script execution
+    outputRasterInfo_["MEM_RASTER_NBANDS"] = std::to_string(std::max(analysis_->outputGridPtr->bandNames.size(), static_cast<std::size_t>(1)));
+
+    // the dummy value is stored as is, it must be representable in the pixel type
+    if(!isValidOutputDummy(*analysis_->outputGridPtr))
+    {
+      QString errMsg = QObject::tr("The dummy value %1 can't be stored in the output pixel type.").arg(analysis_->outputGridPtr->interpolationDummy);
+      throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
+    }
+
+    // compact pixel types store the quantized values, see quantizeOutputValue()
+    outputRasterInfo_["MEM_RASTER_DATATYPE"] = te::common::Convert2String(getTerraLibDataType(analysis_->outputGridPtr->dataType));
+    outputRasterInfo_["MEM_RASTER_NODATA"] = QString::number(analysis_->outputGridPtr->interpolationDummy, 'g', 17).toStdString();
+    outputRasterInfo_["MEM_RASTER_SCALE"] = QString::number(analysis_->outputGridPtr->scale, 'g', 17).toStdString();
+    outputRasterInfo_["MEM_RASTER_OFFSET"] = QString::number(analysis_->outputGridPtr->offset, 'g', 17).toStdString();
     addInterestAreaToRasterInfo(outputRasterInfo_);
     addResolutionToRasterInfo(outputRasterInfo_);
 
@@ -177,22 +212,16 @@ void terrama2::services::analysis::core::GridContext::addResolutionToRasterInfo(
     {
       try
       {
-        auto gridMap = getGridMap(dataManager, analysis_->outputGridPtr->resolutionDataSeriesId);
-        if(gridMap.empty())
+        auto gridInfoList = getGridInfo(dataManager, analysis_->outputGridPtr->resolutionDataSeriesId);
+        if(gridInfoList.empty())
         {
           QString errMsg = QObject::tr("Could not recover grid for data series: %1.").arg(analysis_->outputGridPtr->resolutionDataSeriesId);
           throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
         }
 
-        auto raster = gridMap.begin()->second;
-        if(!raster)
-        {
-          QString errMsg = QObject::tr("Could not recover raster for dataset: %1.").arg(gridMap.begin()->first->id);
-          throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
-        }
-
-        resX = raster->getResolutionX();
-        resY = raster->getResolutionY();
+        const auto& gridInfo = gridInfoList.front();
+        resX = gridInfo.resolutionX;
+        resY = gridInfo.resolutionY;
       }
       catch(const terrama2::core::NoDataException e)
       {
@@ -208,40 +237,34 @@ void terrama2::services::analysis::core::GridContext::addResolutionToRasterInfo(
       {
         try
         {
-          auto gridMap = getGridMap(dataManager, analysisDataSeries.dataSeriesId);
+          auto gridInfoList = getGridInfo(dataManager, analysisDataSeries.dataSeriesId);
 
-          if(gridMap.empty())
+          if(gridInfoList.empty())
           {
-            QString errMsg = QObject::tr("Could not recover grid for data series: %1.").arg(analysis_->outputGridPtr->resolutionDataSeriesId);
+            QString errMsg = QObject::tr("Could not recover grid for data series: %1.").arg(analysisDataSeries.dataSeriesId);
             throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
           }
 
-          auto raster = gridMap.begin()->second;
-          if(!raster)
-          {
-            QString errMsg = QObject::tr("Could not recover raster for dataset: %1.").arg(gridMap.begin()->first->id);
-            throw terrama2::InvalidArgumentException() <<
-                ErrorDescription(errMsg);
-          }
+          const auto& gridInfo = gridInfoList.front();
 
           // Calculates the area of the pixel
-          double area = raster->getResolutionX() * raster->getResolutionY();
+          double area = gridInfo.resolutionX * gridInfo.resolutionY;
           if(area >= pixelArea)
           {
             // In case the area is the same, gives priority to the greater in X.
             if(area == pixelArea)
             {
-              if(raster->getResolutionX() > resX)
+              if(gridInfo.resolutionX > resX)
               {
-                resX = raster->getResolutionX();
-                resY = raster->getResolutionY();
+                resX = gridInfo.resolutionX;
+                resY = gridInfo.resolutionY;
                 pixelArea = area;
               }
             }
             else
             {
-              resX = raster->getResolutionX();
-              resY = raster->getResolutionY();
+              resX = gridInfo.resolutionX;
+              resY = gridInfo.resolutionY;
               pixelArea = area;
             }
           }
@@ -261,39 +284,34 @@ void terrama2::services::analysis::core::GridContext::addResolutionToRasterInfo(
       {
         try
         {
-          auto gridMap = getGridMap(dataManager, analysisDataSeries.dataSeriesId);
+          auto gridInfoList = getGridInfo(dataManager, analysisDataSeries.dataSeriesId);
 
-          if(gridMap.empty())
+          if(gridInfoList.empty())
           {
-            QString errMsg = QObject::tr("Could not recover grid for data series: %1.").arg(analysis_->outputGridPtr->resolutionDataSeriesId);
+            QString errMsg = QObject::tr("Could not recover grid for data series: %1.").arg(analysisDataSeries.dataSeriesId);
             throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
           }
 
-          auto raster = gridMap.begin()->second;
-          if(!raster)
-          {
-            QString errMsg = QObject::tr("Could not recover raster for dataset: %1.").arg(gridMap.begin()->first->id);
-            throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
-          }
+          const auto& gridInfo = gridInfoList.front();
 
           // Calculates the area of the pixel
-          double area = raster->getResolutionX() * raster->getResolutionY();
+          double area = gridInfo.resolutionX * gridInfo.resolutionY;
           if(area <= pixelArea)
           {
             // In case the area is the same, gives priority to the greater in X.
             if(area == pixelArea)
             {
-              if(raster->getResolutionX() > resX)
+              if(gridInfo.resolutionX > resX)
               {
-                resX = raster->getResolutionX();
-                resY = raster->getResolutionY();
+                resX = gridInfo.resolutionX;
+                resY = gridInfo.resolutionY;
                 pixelArea = area;
               }
             }
             else
             {
-              resX = raster->getResolutionX();
-              resY = raster->getResolutionY();
+              resX = gridInfo.resolutionX;
+              resY = gridInfo.resolutionY;
               pixelArea = area;
             }
           }
@@ -338,31 +356,24 @@ void terrama2::services::analysis::core::GridContext::addInterestAreaToRasterInf
       {
         try
         {
-          auto gridMap = getGridMap(dataManager, analysisDataSeries.dataSeriesId);
+          auto gridInfoList = getGridInfo(dataManager, analysisDataSeries.dataSeriesId);
 
-          if(gridMap.empty())
+          if(gridInfoList.empty())
           {
             QString errMsg = QObject::tr("Could not recover grid for data series: %1.").arg(analysisDataSeries.dataSeriesId);
             throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
           }
 
-          auto raster = gridMap.begin()->second;
-          if(!raster)
-          {
-            QString errMsg = QObject::tr("Could not recover raster for dataset: %1.").arg(gridMap.begin()->first->id);
-            throw terrama2::InvalidArgumentException()
-                << ErrorDescription(errMsg);
-          }
-
+          const auto& gridInfo = gridInfoList.front();
           if(srid == 0)
           {
-            box->Union(*raster->getExtent());
-            srid = raster->getSRID();
+            box->Union(*gridInfo.extent);
+            srid = gridInfo.srid;
             continue;
           }
 
-          std::shared_ptr<te::gm::Geometry> geomBox(te::gm::GetGeomFromEnvelope(raster->getExtent(), raster->getSRID()));
-          if(raster->getSRID() != srid)
+          std::shared_ptr<te::gm::Geometry> geomBox(te::gm::GetGeomFromEnvelope(gridInfo.extent.get(), gridInfo.srid));
+          if(gridInfo.srid != srid)
           {
             geomBox->transform(srid);
           }
@@ -380,22 +391,16 @@ void terrama2::services::analysis::core::GridContext::addInterestAreaToRasterInf
     {
       try
       {
-        auto gridMap = getGridMap(dataManager, analysis_->outputGridPtr->interestAreaDataSeriesId);
-        if(gridMap.empty())
+        auto gridInfoList = getGridInfo(dataManager, analysis_->outputGridPtr->interestAreaDataSeriesId);
+        if(gridInfoList.empty())
         {
           QString errMsg = QObject::tr("Could not recover grid for data series: %1.").arg(analysis_->outputGridPtr->interestAreaDataSeriesId);
           throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
         }
 
-        auto raster = gridMap.begin()->second;
-        if(!raster)
-        {
-          QString errMsg = QObject::tr("Could not recover raster for dataset: %1.").arg(gridMap.begin()->first->id);
-          throw terrama2::InvalidArgumentException() << ErrorDescription(errMsg);
-        }
-
-        box->Union(*raster->getExtent());
-        srid = raster->getSRID();
+        const auto& gridInfo = gridInfoList.front();
+        box->Union(*gridInfo.extent);
+        srid = gridInfo.srid;
       }
       catch(const terrama2::core::NoDataException&)
       {
@@ -419,3 +424,503 @@ void terrama2::services::analysis::core::GridContext::addInterestAreaToRasterInf
   outputRasterInfo["MEM_RASTER_MAX_X"] = std::to_string(box->getUpperRightX());
   outputRasterInfo["MEM_RASTER_MAX_Y"] = std::to_string(box->getUpperRightY());
 }
+
+std::vector<double> terrama2::services::analysis::core::rasterizeGridOccurrences(std::vector<GridOccurrence>& occurrences,
+                                                                                OccurrenceRasterization type,
+                                                                                double bandwidth,
+                                                                                int nRows,
+                                                                                int nCols,
+                                                                                double resX,
+                                                                                double resY)
+{
+  bool isKernel = type == OccurrenceRasterization::GAUSSIAN_KERNEL || type == OccurrenceRasterization::QUARTIC_KERNEL;
+  if(isKernel && bandwidth <= 0)
+  {
+    QString errMsg(QObject::tr("Invalid kernel bandwidth: %1.").arg(bandwidth));
+    throw terrama2::InvalidArgumentException() << terrama2::ErrorDescription(errMsg);
+  }
+
+  std::vector<double> values(static_cast<std::size_t>(std::max(nRows, 0)) * std::max(nCols, 0), 0.);
+  if(occurrences.empty() || values.empty())
+    return values;
+
+  // Radius of influence of each occurrence, in cells
+  double radius = 0.;
+  if(type == OccurrenceRasterization::GAUSSIAN_KERNEL)
+    radius = 3 * bandwidth;
+  else if(type == OccurrenceRasterization::QUARTIC_KERNEL)
+    radius = bandwidth;
+
+  const int radiusCols = static_cast<int>(std::ceil(radius / resX));
+  const int radiusRows = static_cast<int>(std::ceil(radius / resY));
+
+  // Sorting by row allows each worker to find the occurrences that affect its rows with a binary search
+  std::sort(occurrences.begin(), occurrences.end(), [](const GridOccurrence& a, const GridOccurrence& b)
+  {
+    return a.row < b.row;
+  });
+
+  const double h2 = bandwidth * bandwidth;
+  const double pi = std::acos(-1.);
+
+  auto rasterizeRows = [&](int firstRow, int lastRow)
+  {
+    auto begin = std::lower_bound(occurrences.begin(), occurrences.end(), firstRow - radiusRows - 0.5,
+                                  [](const GridOccurrence& occurrence, double row) { return occurrence.row < row; });
+
+    for(auto it = begin; it != occurrences.end() && it->row < lastRow + radiusRows + 0.5; ++it)
+    {
+      int centerRow = static_cast<int>(std::lround(it->row));
+      int centerCol = static_cast<int>(std::lround(it->column));
+
+      if(!isKernel)
+      {
+        if(centerRow < firstRow || centerRow >= lastRow || centerCol < 0 || centerCol >= nCols)
+          continue;
+
+        values[static_cast<std::size_t>(centerRow) * nCols + centerCol] += it->weight;
+        continue;
+      }
+
+      int rowBegin = std::max(firstRow, centerRow - radiusRows);
+      int rowEnd = std::min(lastRow - 1, centerRow + radiusRows);
+      int colBegin = std::max(0, centerCol - radiusCols);
+      int colEnd = std::min(nCols - 1, centerCol + radiusCols);
+
+      for(int row = rowBegin; row <= rowEnd; ++row)
+      {
+        double dy = (row - it->row) * resY;
+        for(int col = colBegin; col <= colEnd; ++col)
+        {
+          double dx = (col - it->column) * resX;
+          double d2 = dx * dx + dy * dy;
+
+          double density = 0.;
+          if(type == OccurrenceRasterization::GAUSSIAN_KERNEL)
+          {
+            if(d2 > radius * radius)
+              continue;
+            density = std::exp(-d2 / (2 * h2)) / (2 * pi * h2);
+          }
+          else
+          {
+            if(d2 >= h2)
+              continue;
+            double u = 1. - d2 / h2;
+            density = 3. * u * u / (pi * h2);
+          }
+
+          values[static_cast<std::size_t>(row) * nCols + col] += it->weight * density;
+        }
+      }
+    }
+  };
+
+  // Each task writes to a disjoint band of rows, the tasks run in the shared worker threads
+  std::size_t numberOfThreads = std::max(1u, std::thread::hardware_concurrency());
+  int numberOfBands = static_cast<int>(std::min<std::size_t>(numberOfThreads, static_cast<std::size_t>(nRows)));
+  int rowsPerBand = (nRows + numberOfBands - 1) / numberOfBands;
+
+  terrama2::core::parallelFor(static_cast<std::size_t>(numberOfBands), numberOfThreads, [&](std::size_t band)
+  {
+    int firstRow = static_cast<int>(band) * rowsPerBand;
+    int lastRow = std::min(nRows, firstRow + rowsPerBand);
+    if(firstRow < lastRow)
+      rasterizeRows(firstRow, lastRow);
+  });
+
+  return values;
+}
+
+std::shared_ptr<const std::vector<double> >
+terrama2::services::analysis::core::GridContext::getOccurrenceGrid(terrama2::core::DataSeriesPtr dataSeries,
+                                                                   OccurrenceRasterization type,
+                                                                   const std::string& dateFilter,
+                                                                   const std::string& attribute,
+                                                                   double bandwidth)
+{
+  // the bits of the bandwidth are an exact and locale independent representation
+  uint64_t bandwidthBits = 0;
+  std::memcpy(&bandwidthBits, &bandwidth, sizeof(bandwidthBits));
+
+  std::string key = std::to_string(dataSeries->id) + "|" + std::to_string(static_cast<int>(type)) + "|"
+                    + dateFilter + "|" + attribute + "|" + std::to_string(bandwidthBits);
+
+  std::promise<std::shared_ptr<const std::vector<double> > > promise;
+  std::shared_future<std::shared_ptr<const std::vector<double> > > future;
+  bool owner = false;
+  {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    auto it = occurrenceGridMap_.find(key);
+    if(it == occurrenceGridMap_.end())
+    {
+      future = promise.get_future().share();
+      occurrenceGridMap_.emplace(key, future);
+      owner = true;
+    }
+    else
+      future = it->second;
+  }
+
+  if(owner)
+  {
+    // the rasterization is done outside the lock, other threads wait on the future
+    try
+    {
+      promise.set_value(rasterizeOccurrences(dataSeries, type, dateFilter, attribute, bandwidth));
+    }
+    catch(...)
+    {
+      promise.set_exception(std::current_exception());
+    }
+  }
+
+  return future.get();
+}
+
+std::shared_ptr<const std::vector<double> >
+terrama2::services::analysis::core::GridContext::rasterizeOccurrences(terrama2::core::DataSeriesPtr dataSeries,
+                                                                      OccurrenceRasterization type,
+                                                                      const std::string& dateFilter,
+                                                                      const std::string& attribute,
+                                                                      double bandwidth)
+{
+  auto outputRaster = getOutputRaster();
+  if(!outputRaster)
+  {
+    QString errMsg(QObject::tr("Invalid output raster."));
+    throw terrama2::InvalidArgumentException() << terrama2::ErrorDescription(errMsg);
+  }
+
+  if(type == OccurrenceRasterization::SUM && attribute.empty())
+  {
+    QString errMsg(QObject::tr("An attribute is required to sum occurrences."));
+    throw terrama2::InvalidArgumentException() << terrama2::ErrorDescription(errMsg);
+  }
+
+  auto grid = outputRaster->getGrid();
+  const int outputSrid = grid->getSRID();
+
+  std::vector<GridOccurrence> occurrences;
+
+  // the series is shared with the other operators of the analysis that read it with the same filter
+  std::unordered_map<terrama2::core::DataSetPtr, terrama2::core::DataSetSeries > seriesMap;
+  try
+  {
+    seriesMap = getSeriesMap(dataSeries->id, dateFilter);
+  }
+  catch(const terrama2::core::NoDataException&)
+  {
+  }
+
+  for(const auto& item : seriesMap)
+  {
+    auto syncDs = item.second.syncDataSet;
+    if(!syncDs || syncDs->size() == 0)
+      continue;
+
+    std::size_t geomPos = te::da::GetFirstPropertyPos(syncDs->dataset().get(), te::dt::GEOMETRY_TYPE);
+
+    int attributeType = 0;
+    if(!attribute.empty())
+    {
+      auto property = item.second.teDataSetType->getProperty(attribute);
+      if(!property)
+      {
+        QString errMsg(QObject::tr("Invalid attribute name: %1").arg(QString::fromStdString(attribute)));
+        throw InvalidParameterException() << terrama2::ErrorDescription(errMsg);
+      }
+      attributeType = property->getType();
+    }
+
+    te::srs::Converter converter;
+    bool sridChecked = false;
+    bool needsConversion = false;
+
+    auto size = syncDs->size();
+    occurrences.reserve(occurrences.size() + size);
+    for(std::size_t i = 0; i < size; ++i)
+    {
+      auto geom = syncDs->getGeometry(i, geomPos);
+      if(!geom)
+        continue;
+
+      // all geometries of the dataset have the SRID of its first geometry
+      if(!sridChecked)
+      {
+        sridChecked = true;
+        if(geom->getSRID() != outputSrid)
+        {
+          converter.setSourceSRID(geom->getSRID());
+          converter.setTargetSRID(outputSrid);
+          needsConversion = true;
+        }
+      }
+
+      auto center = geom->getMBR()->getCenter();
+      double x = center.getX();
+      double y = center.getY();
+      if(needsConversion)
+        converter.convert(x, y);
+
+      GridOccurrence occurrence;
+      grid->geoToGrid(x, y, occurrence.column, occurrence.row);
+
+      if(!attribute.empty())
+      {
+        if(syncDs->isNull(i, attribute))
+          continue;
+
+        occurrence.weight = getValue(syncDs, attribute, static_cast<uint32_t>(i), attributeType);
+        if(std::isnan(occurrence.weight))
+          continue;
+      }
+
+      occurrences.push_back(occurrence);
+    }
+  }
+
+  auto values = rasterizeGridOccurrences(occurrences, type, bandwidth,
+                                         static_cast<int>(outputRaster->getNumberOfRows()),
+                                         static_cast<int>(outputRaster->getNumberOfColumns()),
+                                         grid->getResolutionX(), grid->getResolutionY());
+
+  return std::make_shared<const std::vector<double> >(std::move(values));
+}
+
+void terrama2::services::analysis::core::GridContext::createValidityMask(uint32_t tileSize)
+{
+  auto outputRaster = getOutputRaster();
+  if(!outputRaster)
+  {
+    QString errMsg(QObject::tr("Invalid output raster."));
+    throw terrama2::InvalidArgumentException() << terrama2::ErrorDescription(errMsg);
+  }
+
+  if(tileSize == 0)
+    tileSize = 1;
+
+  auto grid = outputRaster->getGrid();
+  const uint32_t nRows = outputRaster->getNumberOfRows();
+  const uint32_t nCols = outputRaster->getNumberOfColumns();
+  const int outputSrid = grid->getSRID();
+
+  // Interest area in the output SRID, only custom areas can be smaller than the output box
+  std::shared_ptr<te::gm::Geometry> interestArea;
+  if(analysis_->outputGridPtr->interestAreaType == InterestAreaType::CUSTOM && analysis_->outputGridPtr->interestAreaBox)
+  {
+    interestArea.reset(dynamic_cast<te::gm::Geometry*>(analysis_->outputGridPtr->interestAreaBox->clone()));
+    if(interestArea->getSRID() != outputSrid)
+      interestArea->transform(outputSrid);
+  }
+
+  // Latest raster of each input, if the analysis only uses grids
+  std::vector<std::shared_ptr<te::rst::Raster> > inputRasters;
+  bool onlyGrids = true;
+  {
+    auto dataManager = dataManager_.lock();
+    if(!dataManager)
+    {
+      QString errMsg(QObject::tr("Invalid data manager."));
+      throw terrama2::core::InvalidDataManagerException() << terrama2::ErrorDescription(errMsg);
+    }
+
+    for(const auto& analysisDataSeries : analysis_->analysisDataSeriesList)
+    {
+      if(analysisDataSeries.type != AnalysisDataSeriesType::DATASERIES_GRID_TYPE)
+      {
+        onlyGrids = false;
+        break;
+      }
+
+      auto dataSeries = dataManager->findDataSeries(analysisDataSeries.dataSeriesId);
+      if(!dataSeries)
+        continue;
+
+      for(const auto& dataset : dataSeries->datasetList)
+      {
+        try
+        {
+          auto rasterList = getRasterList(dataSeries, dataset->id);
+          inputRasters.insert(inputRasters.end(), rasterList.begin(), rasterList.end());
+        }
+        catch(const terrama2::core::NoDataException&)
+        {
+          continue;
+        }
+      }
+    }
+  }
+
+  if(!onlyGrids)
+    inputRasters.clear();
+
+  validityMask_.assign(static_cast<std::size_t>(nRows) * nCols, 0);
+  activeTiles_.clear();
+
+  for(uint32_t firstRow = 0; firstRow < nRows; firstRow += tileSize)
+  {
+    for(uint32_t firstColumn = 0; firstColumn < nCols; firstColumn += tileSize)
+    {
+      GridTile tile;
+      tile.firstRow = firstRow;
+      tile.lastRow = std::min(nRows, firstRow + tileSize);
+      tile.firstColumn = firstColumn;
+      tile.lastColumn = std::min(nCols, firstColumn + tileSize);
+
+      // Tests the whole tile against the interest area before testing each cell
+      bool testEachCell = false;
+      if(interestArea)
+      {
+        auto lowerLeft = grid->gridToGeo(tile.firstColumn, tile.lastRow - 1);
+        auto upperRight = grid->gridToGeo(tile.lastColumn - 1, tile.firstRow);
+        te::gm::Envelope tileBox(lowerLeft.getX(), lowerLeft.getY(), upperRight.getX(), upperRight.getY());
+        std::unique_ptr<te::gm::Geometry> tileGeom(te::gm::GetGeomFromEnvelope(&tileBox, outputSrid));
+
+        if(!interestArea->intersects(tileGeom.get()))
+          continue;
+
+        testEachCell = !interestArea->covers(tileGeom.get());
+      }
+
+      bool activeTile = false;
+      for(uint32_t row = tile.firstRow; row < tile.lastRow; ++row)
+      {
+        for(uint32_t col = tile.firstColumn; col < tile.lastColumn; ++col)
+        {
+          auto coord = grid->gridToGeo(col, row);
+
+          if(testEachCell)
+          {
+            te::gm::Point point(coord.getX(), coord.getY(), outputSrid);
+            if(!interestArea->covers(&point))
+              continue;
+          }
+
+          if(onlyGrids && !hasInputData(coord, inputRasters))
+            continue;
+
+          validityMask_[static_cast<std::size_t>(row) * nCols + col] = 1;
+          activeTile = true;
+        }
+      }
+
+      if(activeTile)
+        activeTiles_.push_back(tile);
+    }
+  }
+}
+
+void terrama2::services::analysis::core::GridContext::fillInactiveCells(double value)
+{
+  auto outputRaster = getOutputRaster();
+  if(validityMask_.empty() || !outputRaster)
+    return;
+
+  const int nRows = static_cast<int>(outputRaster->getNumberOfRows());
+  const int nCols = static_cast<int>(outputRaster->getNumberOfColumns());
+
+  std::vector<unsigned char> block;
+  for(std::size_t bandIdx = 0; bandIdx < outputRaster->getNumberOfBands(); ++bandIdx)
+  {
+    te::rst::Band* band = outputRaster->getBand(bandIdx);
+    const te::rst::BandProperty* property = band->getProperty();
+
+    // converts the value to the pixel type of the band
+    te::rst::GetBufferValueFPtr getBufferValue = nullptr;
+    te::rst::GetBufferValueFPtr getBufferValueI = nullptr;
+    te::rst::SetBufferValueFPtr setBufferValue = nullptr;
+    te::rst::SetBufferValueFPtr setBufferValueI = nullptr;
+    te::rst::SetBlockFunctions(&getBufferValue, &getBufferValueI, &setBufferValue, &setBufferValueI, property->getType());
+
+    block.resize(static_cast<std::size_t>(band->getBlockSize()));
+    for(int blockY = 0; blockY < property->m_nblocksy; ++blockY)
+    {
+      for(int blockX = 0; blockX < property->m_nblocksx; ++blockX)
+      {
+        bool changed = false;
+        for(int blockRow = 0; blockRow < property->m_blkh; ++blockRow)
+        {
+          int row = blockY * property->m_blkh + blockRow;
+          if(row >= nRows)
+            break;
+
+          for(int blockCol = 0; blockCol < property->m_blkw; ++blockCol)
+          {
+            int col = blockX * property->m_blkw + blockCol;
+            if(col >= nCols)
+              break;
+
+            if(isActive(static_cast<uint32_t>(row), static_cast<uint32_t>(col)))
+              continue;
+
+            // blocks without inactive cells are not read
+            if(!changed)
+            {
+              band->read(blockX, blockY, block.data());
+              changed = true;
+            }
+
+            setBufferValue(blockRow * property->m_blkw + blockCol, block.data(), &value);
+          }
+        }
+
+        if(changed)
+          band->write(blockX, blockY, block.data());
+      }
+    }
+  }
+}
+
+bool terrama2::services::analysis::core::GridContext::hasInputData(const te::gm::Coord2D& coord,
+                                                                    const std::vector<std::shared_ptr<te::rst::Raster> >& inputRasters)
+{
+  for(const auto& raster : inputRasters)
+  {
+    auto dsGrid = raster->getGrid();
+    auto point = convertoTo(coord, dsGrid->getSRID());
+
+    double column, row;
+    dsGrid->geoToGrid(point.x, point.y, column, row);
+
+    auto col = static_cast<long>(std::lround(column));
+    auto lin = static_cast<long>(std::lround(row));
+    if(col < 0 || lin < 0
+       || col >= static_cast<long>(raster->getNumberOfColumns())
+       || lin >= static_cast<long>(raster->getNumberOfRows()))
+      continue;
+
+    double value;
+    auto band = raster->getBand(0);
+    band->getValue(static_cast<unsigned int>(col), static_cast<unsigned int>(lin), value);
+    if(value != band->getProperty()->m_noDataValue && !std::isnan(value))
+      return true;
+  }
+
+  return false;
+}
+
+std::vector<terrama2::services::analysis::core::GridTile> terrama2::services::analysis::core::GridContext::getActiveTiles() const
+{
+  if(!validityMask_.empty())
+    return activeTiles_;
+
+  std::vector<GridTile> tiles;
+  if(!outputRaster_)
+    return tiles;
+
+  const uint32_t nRows = outputRaster_->getNumberOfRows();
+  const uint32_t nCols = outputRaster_->getNumberOfColumns();
+  tiles.reserve(nRows);
+  for(uint32_t row = 0; row < nRows; ++row)
+  {
+    GridTile tile;
+    tile.firstRow = row;
+    tile.lastRow = row + 1;
+    tile.firstColumn = 0;
+    tile.lastColumn = nCols;
+    tiles.push_back(tile);
+  }
+
+  return tiles;
+}
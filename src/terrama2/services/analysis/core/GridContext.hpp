@@ -37,6 +37,10 @@
 
 #include <terralib/geometry/Coord2D.h>
 
+// STL
+#include <future>
+#include <vector>
+
 // Forward declaration
 namespace te
 {
@@ -54,6 +58,63 @@ namespace terrama2
     {
       namespace core
       {
+        /*!
+          \brief Defines how an occurrence series is rasterized in the output grid.
+        */
+        enum class OccurrenceRasterization
+        {
+          COUNT = 1, //!< Number of occurrences in each cell.
+          SUM = 2, //!< Sum of an attribute of the occurrences in each cell.
+          GAUSSIAN_KERNEL = 3, //!< Gaussian kernel density, truncated at three times the bandwidth.
+          QUARTIC_KERNEL = 4 //!< Quartic (biweight) kernel density.
+        };
+
+        /*!
+          \brief Position of an occurrence in the output grid and its weight.
+        */
+        struct GridOccurrence
+        {
+          double column = 0.; //!< Column of the occurrence, with fraction.
+          double row = 0.; //!< Row of the occurrence, with fraction.
+          double weight = 1.; //!< Weight of the occurrence.
+        };
+
+        /*!
+          \brief Rasterizes occurrences in a grid.
+
+          The rows of the grid are split in bands that are rasterized in parallel.
+
+          \param occurrences The occurrences in grid coordinates, they are sorted by row.
+          \param type The rasterization type.
+          \param bandwidth Kernel bandwidth, in the same units as the resolution.
+          \param nRows Number of rows of the grid.
+          \param nCols Number of columns of the grid.
+          \param resX Horizontal resolution of the grid.
+          \param resY Vertical resolution of the grid.
+          \return The rasterized values in row-major order.
+          \exception terrama2::InvalidArgumentException Raised if a kernel is requested with a bandwidth that is not positive.
+        */
+        std::vector<double> rasterizeGridOccurrences(std::vector<GridOccurrence>& occurrences,
+                                                     OccurrenceRasterization type,
+                                                     double bandwidth,
+                                                     int nRows,
+                                                     int nCols,
+                                                     double resX,
+                                                     double resY);
+
+        /*!
+          \brief A rectangular block of cells of the output grid.
+
+          The last row and last column are not included in the tile.
+        */
+        struct GridTile
+        {
+          uint32_t firstRow = 0; //!< First row of the tile.
+          uint32_t lastRow = 0; //!< Row after the last row of the tile.
+          uint32_t firstColumn = 0; //!< First column of the tile.
+          uint32_t lastColumn = 0; //!< Column after the last column of the tile.
+        };
+
         class GridContext : public BaseContext
         {
           public:
@@ -86,14 +147,84 @@ namespace terrama2
             */
             te::gm::Coord2D convertoTo(const te::gm::Coord2D& point, const int srid);
 
+            /*!
+              \brief Returns the rasterization of an occurrence series in the output grid.
+
+              The occurrences are read through getSeriesMap(), so the series is shared with the other
+              operators that read it with the same filter, and rasterized in a single parallel pass,
+              the result is stored in the context and shared by all pixels and threads,
+              concurrent requests for the same rasterization wait for the first one.
+
+              \param dataSeries The occurrence data series.
+              \param type The rasterization type.
+              \param dateFilter Time filter for the occurrences.
+              \param attribute Attribute to be summed or used as kernel weight, if empty each occurrence weights one.
+              \param bandwidth Kernel bandwidth in the units of the output grid SRID.
+              \return The rasterized values in row-major order, with the same size of the output raster.
+            */
+            std::shared_ptr<const std::vector<double> > getOccurrenceGrid(terrama2::core::DataSeriesPtr dataSeries,
+                                                                          OccurrenceRasterization type,
+                                                                          const std::string& dateFilter,
+                                                                          const std::string& attribute = "",
+                                                                          double bandwidth = 0.);
+
+            /*!
+              \brief Computes which cells of the output grid must be evaluated.
+
+              A cell is active when its center is inside the interest area geometry and at least one
+              input grid has data in it. The footprint of each input is taken from its latest raster.
+              Analyses that use non grid data series are only restricted by the interest area.
+
+              \param tileSize Size, in cells, of the side of the tiles used to dispatch the work.
+            */
+            void createValidityMask(uint32_t tileSize = 64);
+
+            /*!
+              \brief Returns the tiles of the output grid that have at least one active cell.
+
+              If the validity mask was not created, returns one tile for each row of the output grid.
+            */
+            std::vector<GridTile> getActiveTiles() const;
+
+            /*!
+              \brief Sets the value of the cells that are not active in all bands of the output raster.
+
+              The output raster is changed a block at a time, the blocks of the output raster are rows.
+              If the validity mask was not created nothing is changed.
+            */
+            void fillInactiveCells(double value);
+
+            /*!
+              \brief Returns true if the cell must be evaluated.
+
+              If the validity mask was not created all cells are active.
+            */
+            inline bool isActive(uint32_t row, uint32_t column) const
+            {
+              return validityMask_.empty() || validityMask_[static_cast<std::size_t>(row) * outputRaster_->getNumberOfColumns() + column];
+            }
+
           protected:
 
+            //! Returns true if any input grid has data in the given coordinate of the output grid.
+            bool hasInputData(const te::gm::Coord2D& coord, const std::vector<std::shared_ptr<te::rst::Raster> >& inputRasters);
+
+            //! Reads the occurrences and rasterizes them in the output grid.
+            std::shared_ptr<const std::vector<double> > rasterizeOccurrences(terrama2::core::DataSeriesPtr dataSeries,
+                                                                              OccurrenceRasterization type,
+                                                                              const std::string& dateFilter,
+                                                                              const std::string& attribute,
+                                                                              double bandwidth);
+
             std::map<std::string, std::string> getOutputRasterInfo();
             void addInterestAreaToRasterInfo(std::map<std::string, std::string>& outputRasterInfo);
             void addResolutionToRasterInfo(std::map<std::string, std::string>& outputRasterInfo);
 
             std::shared_ptr<te::rst::Raster> outputRaster_;
             std::map<std::string, std::string> outputRasterInfo_;
+            std::map<std::string, std::shared_future<std::shared_ptr<const std::vector<double> > > > occurrenceGridMap_;
+            std::vector<uint8_t> validityMask_; //!< One value for each cell of the output grid, in row-major order.
+            std::vector<GridTile> activeTiles_; //!< Tiles with at least one active cell.
         };
       }
     }
@@ -0,0 +1,480 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/services/analysis/core/GridProvenance.cpp
+
+  \brief Tile-level provenance of the output of grid analyses, used to reuse unchanged tiles.
+
+  \author Jano Simas
+*/
+
+#include "GridProvenance.hpp"
+#include "JSonUtils.hpp"
+#include "../../../core/data-access/RasterHandle.hpp"
+#include "../../../core/utility/DecodedRasterCache.hpp"
+#include "../../../core/utility/Logger.hpp"
+#include "../../../core/utility/ServiceManager.hpp"
+#include "../../../Exception.hpp"
+
+// TerraLib
+#include <terralib/raster/Band.h>
+#include <terralib/raster/Grid.h>
+#include <terralib/raster/Raster.h>
+
+// Qt
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QObject>
+#include <QSaveFile>
+
+// STL
+#include <algorithm>
+#include <mutex>
+
+namespace
+{
+  const QString RECORD_FILE = "record.json";
+  const QString VALUES_FILE = "values.bin";
+
+  std::mutex folderMutex;
+
+  //! Folder set by the service configuration, empty for the default folder.
+  QString& configuredProvenanceFolder()
+  {
+    static QString folder;
+    return folder;
+  }
+
+  //! Returns the folder of the records, by default analysis-provenance in the data folder of the service.
+  QString provenanceFolder()
+  {
+    if(!configuredProvenanceFolder().isEmpty())
+      return configuredProvenanceFolder();
+
+    return QDir(QString::fromStdString(terrama2::core::ServiceManager::getInstance().dataFolder())).absoluteFilePath("analysis-provenance");
+  }
+
+  bool sameKey(const terrama2::services::analysis::core::ObjectKey& lhs, const terrama2::services::analysis::core::ObjectKey& rhs)
+  {
+    return lhs.objectId_ == rhs.objectId_
+        && lhs.dateFilterBegin_ == rhs.dateFilterBegin_
+        && lhs.dateFilterEnd_ == rhs.dateFilterEnd_;
+  }
+
+  //! Writes the data to the file, the file is only replaced if all data was written.
+  bool writeFile(const QString& path, const char* data, qint64 size)
+  {
+    QSaveFile file(path);
+    if(!file.open(QIODevice::WriteOnly))
+      return false;
+
+    if(file.write(data, size) != size)
+    {
+      file.cancelWriting();
+      return false;
+    }
+
+    return file.commit();
+  }
+}
+
+terrama2::services::analysis::core::GridProvenance::GridProvenance(std::shared_ptr<GridContext> context)
+  : context_(context)
+{
+}
+
+bool terrama2::services::analysis::core::GridProvenance::isSupported(AnalysisPtr analysis)
+{
+  return std::all_of(analysis->analysisDataSeriesList.begin(), analysis->analysisDataSeriesList.end(),
+                     [](const AnalysisDataSeries& analysisDataSeries)
+                     {
+                       return analysisDataSeries.type == AnalysisDataSeriesType::DATASERIES_GRID_TYPE;
+                     });
+}
+
+void terrama2::services::analysis::core::GridProvenance::setFolder(const std::string& folder)
+{
+  std::lock_guard<std::mutex> lock(folderMutex);
+  configuredProvenanceFolder() = QString::fromStdString(folder);
+}
+
+void terrama2::services::analysis::core::GridProvenance::removeAnalysis(AnalysisId analysisId)
+{
+  std::lock_guard<std::mutex> lock(folderMutex);
+  QDir(provenanceFolder() + "/" + QString::number(analysisId)).removeRecursively();
+}
+
+QString terrama2::services::analysis::core::GridProvenance::recordFolder() const
+{
+  std::lock_guard<std::mutex> lock(folderMutex);
+  return provenanceFolder() + "/" + QString::number(context_->getAnalysis()->id);
+}
+
+std::vector<terrama2::services::analysis::core::GridTile>
+terrama2::services::analysis::core::GridProvenance::restore(const std::vector<GridTile>& tiles, std::vector<GridTile>& reusedTiles)
+{
+  replayed_.clear();
+  reusedTiles.clear();
+
+  auto analysis = context_->getAnalysis();
+  auto outputRaster = context_->getOutputRaster();
+  const QString folder = recordFolder();
+
+  QFile recordFile(folder + "/" + RECORD_FILE);
+  if(!recordFile.open(QIODevice::ReadOnly))
+    return tiles;
+
+  QJsonObject record = QJsonDocument::fromJson(recordFile.readAll()).object();
+  if(record["configuration"].toString().toStdString() != configurationHash())
+    return tiles;
+
+  const std::size_t nCols = outputRaster->getNumberOfColumns();
+  const std::size_t nRows = outputRaster->getNumberOfRows();
+  const std::size_t nBands = outputRaster->getNumberOfBands();
+  const qint64 size = static_cast<qint64>(nCols * nRows * nBands * sizeof(double));
+
+  QFile valuesFile(folder + "/" + VALUES_FILE);
+  if(!valuesFile.open(QIODevice::ReadOnly) || valuesFile.size() != size)
+    return tiles;
+
+  auto dataManager = context_->getDataManager().lock();
+  if(!dataManager)
+    return tiles;
+
+  // list the grids the requests of the previous execution read now
+  std::vector<Request> replayed;
+  std::vector<te::gm::Envelope> regions;
+  try
+  {
+    for(const auto& requestValue : record["requests"].toArray())
+    {
+      QJsonObject requestObj = requestValue.toObject();
+
+      Request previous;
+      previous.key.objectId_ = static_cast<uint32_t>(requestObj["data_series_id"].toInt());
+      previous.key.dateFilterBegin_ = requestObj["date_filter_begin"].toString().toStdString();
+      previous.key.dateFilterEnd_ = requestObj["date_filter_end"].toString().toStdString();
+      for(const auto& sourceValue : requestObj["sources"].toArray())
+      {
+        QJsonObject sourceObj = sourceValue.toObject();
+
+        Source source;
+        source.identity = sourceObj["identity"].toString().toStdString();
+        source.footprint = te::gm::Envelope(sourceObj["xmin"].toDouble(), sourceObj["ymin"].toDouble(),
+                                            sourceObj["xmax"].toDouble(), sourceObj["ymax"].toDouble());
+        previous.sources.push_back(source);
+      }
+
+      Request current;
+      current.key = previous.key;
+      for(const auto& gridInfo : context_->listGrids(dataManager, current.key))
+      {
+        Source source = toSource(gridInfo);
+        if(source.identity.empty())
+          return tiles;
+
+        current.sources.push_back(source);
+      }
+
+      auto changed = changedRegions(previous.sources, current.sources);
+      regions.insert(regions.end(), changed.begin(), changed.end());
+      replayed.push_back(current);
+    }
+  }
+  catch(const terrama2::Exception&)
+  {
+    TERRAMA2_LOG_WARNING() << QObject::tr("Could not list the grids of the previous execution of the analysis %1, all tiles will be evaluated.").arg(analysis->id);
+    return tiles;
+  }
+
+  // the mapping is released when the file is closed
+  const uchar* data = valuesFile.map(0, size);
+  if(data == nullptr)
+    return tiles;
+
+  const double* values = reinterpret_cast<const double*>(data);
+
+  std::vector<GridTile> dirtyTiles;
+  for(const auto& tile : tiles)
+  {
+    if(isAffected(tile, *outputRaster->getGrid(), regions))
+    {
+      dirtyTiles.push_back(tile);
+      continue;
+    }
+
+    reusedTiles.push_back(tile);
+    for(std::size_t bandIdx = 0; bandIdx < nBands; ++bandIdx)
+    {
+      for(uint32_t row = tile.firstRow; row < tile.lastRow; ++row)
+      {
+        for(uint32_t col = tile.firstColumn; col < tile.lastColumn; ++col)
+        {
+          if(context_->isActive(row, col))
+            outputRaster->setValue(col, row, values[(bandIdx * nRows + row) * nCols + col], bandIdx);
+        }
+      }
+    }
+  }
+
+  replayed_ = replayed;
+
+  TERRAMA2_LOG_INFO() << QObject::tr("Analysis %1: %2 of %3 tiles reused from the previous execution.")
+                         .arg(analysis->id).arg(tiles.size() - dirtyTiles.size()).arg(tiles.size());
+
+  return dirtyTiles;
+}
+
+bool terrama2::services::analysis::core::GridProvenance::isValid() const
+{
+  for(const auto& gridRequest : context_->getGridRequests())
+  {
+    auto it = std::find_if(replayed_.begin(), replayed_.end(),
+                           [&gridRequest](const Request& request){ return sameKey(request.key, gridRequest.key); });
+    if(it == replayed_.end())
+      return false;
+
+    std::vector<Source> sources;
+    for(const auto& gridInfo : gridRequest.grids)
+    {
+      Source source = toSource(gridInfo);
+      if(source.identity.empty())
+        return false;
+
+      sources.push_back(source);
+    }
+
+    if(!changedRegions(it->sources, sources).empty())
+      return false;
+  }
+
+  return true;
+}
+
+void terrama2::services::analysis::core::GridProvenance::save() const
+{
+  auto analysis = context_->getAnalysis();
+  auto outputRaster = context_->getOutputRaster();
+  const QString folder = recordFolder();
+
+  // requests made during the execution replace the listed ones
+  std::vector<Request> requests = replayed_;
+  for(const auto& gridRequest : context_->getGridRequests())
+  {
+    Request request;
+    request.key = gridRequest.key;
+    for(const auto& gridInfo : gridRequest.grids)
+    {
+      Source source = toSource(gridInfo);
+      if(source.identity.empty())
+      {
+        // changes of the grid can't be detected, the next execution evaluates all tiles
+        QDir(folder).removeRecursively();
+        return;
+      }
+
+      request.sources.push_back(source);
+    }
+
+    auto it = std::find_if(requests.begin(), requests.end(),
+                           [&request](const Request& other){ return sameKey(request.key, other.key); });
+    if(it != requests.end())
+      *it = request;
+    else
+      requests.push_back(request);
+  }
+
+  QJsonArray requestArray;
+  for(const auto& request : requests)
+  {
+    QJsonArray sourceArray;
+    for(const auto& source : request.sources)
+    {
+      QJsonObject sourceObj;
+      sourceObj.insert("identity", QString::fromStdString(source.identity));
+      sourceObj.insert("xmin", source.footprint.getLowerLeftX());
+      sourceObj.insert("ymin", source.footprint.getLowerLeftY());
+      sourceObj.insert("xmax", source.footprint.getUpperRightX());
+      sourceObj.insert("ymax", source.footprint.getUpperRightY());
+      sourceArray.push_back(sourceObj);
+    }
+
+    QJsonObject requestObj;
+    requestObj.insert("data_series_id", static_cast<qint32>(request.key.objectId_));
+    requestObj.insert("date_filter_begin", QString::fromStdString(request.key.dateFilterBegin_));
+    requestObj.insert("date_filter_end", QString::fromStdString(request.key.dateFilterEnd_));
+    requestObj.insert("sources", sourceArray);
+    requestArray.push_back(requestObj);
+  }
+
+  QJsonObject record;
+  record.insert("configuration", QString::fromStdString(configurationHash()));
+  record.insert("requests", requestArray);
+
+  const std::size_t nCols = outputRaster->getNumberOfColumns();
+  const std::size_t nRows = outputRaster->getNumberOfRows();
+  const std::size_t nBands = outputRaster->getNumberOfBands();
+
+  std::vector<double> values(nCols * nRows * nBands);
+  for(std::size_t bandIdx = 0; bandIdx < nBands; ++bandIdx)
+  {
+    const te::rst::Band* band = outputRaster->getBand(bandIdx);
+    for(std::size_t row = 0; row < nRows; ++row)
+    {
+      for(std::size_t col = 0; col < nCols; ++col)
+        band->getValue(static_cast<unsigned int>(col), static_cast<unsigned int>(row), values[(bandIdx * nRows + row) * nCols + col]);
+    }
+  }
+
+  // the record is removed while the values are replaced,
+  // an interrupted save never pairs the new values with the old record
+  QFile::remove(folder + "/" + RECORD_FILE);
+
+  QByteArray recordData = QJsonDocument(record).toJson(QJsonDocument::Compact);
+  if(!QDir().mkpath(folder)
+     || !writeFile(folder + "/" + VALUES_FILE, reinterpret_cast<const char*>(values.data()), static_cast<qint64>(values.size() * sizeof(double)))
+     || !writeFile(folder + "/" + RECORD_FILE, recordData.constData(), recordData.size()))
+  {
+    // the record is an optimization, the next execution evaluates all tiles
+    TERRAMA2_LOG_WARNING() << QObject::tr("Could not save the provenance record of the analysis %1.").arg(analysis->id);
+  }
+}
+
+std::vector<te::gm::Envelope>
+terrama2::services::analysis::core::GridProvenance::changedRegions(const std::vector<Source>& previous, const std::vector<Source>& current)
+{
+  std::multimap<std::string, const Source*> unmatched;
+  for(const auto& source : previous)
+    unmatched.emplace(source.identity, &source);
+
+  std::vector<te::gm::Envelope> regions;
+  for(const auto& source : current)
+  {
+    auto it = unmatched.find(source.identity);
+    if(it != unmatched.end())
+      unmatched.erase(it);
+    else
+      regions.push_back(source.footprint);
+  }
+
+  // grids that are no longer read
+  for(const auto& item : unmatched)
+    regions.push_back(item.second->footprint);
+
+  return regions;
+}
+
+bool terrama2::services::analysis::core::GridProvenance::isAffected(const GridTile& tile, const te::rst::Grid& grid, const std::vector<te::gm::Envelope>& regions)
+{
+  const te::gm::Envelope* extent = grid.getExtent();
+  const double resX = grid.getResolutionX();
+  const double resY = grid.getResolutionY();
+
+  // rows grow from the upper left corner downwards
+  te::gm::Envelope footprint(extent->getLowerLeftX() + (static_cast<double>(tile.firstColumn) - 1) * resX,
+                             extent->getUpperRightY() - (static_cast<double>(tile.lastRow) + 1) * resY,
+                             extent->getLowerLeftX() + (static_cast<double>(tile.lastColumn) + 1) * resX,
+                             extent->getUpperRightY() - (static_cast<double>(tile.firstRow) - 1) * resY);
+
+  return std::any_of(regions.begin(), regions.end(),
+                     [&footprint](const te::gm::Envelope& region){ return footprint.intersects(region); });
+}
+
+terrama2::services::analysis::core::GridProvenance::Source
+terrama2::services::analysis::core::GridProvenance::toSource(const terrama2::core::GridInfo& gridInfo) const
+{
+  Source source;
+  if(!gridInfo.uri.empty())
+  {
+    std::string content = terrama2::core::DecodedRasterCache::sourceIdentity(gridInfo.uri);
+    if(!content.empty())
+      source.identity = content + "@" + (gridInfo.timestamp ? gridInfo.timestamp->toString() : "");
+  }
+
+  auto outputRaster = context_->getOutputRaster();
+  if(!gridInfo.extent)
+  {
+    source.footprint = *outputRaster->getExtent();
+    return source;
+  }
+
+  // interpolations read the neighbour pixels
+  const double marginX = terrama2::core::RasterHandle::windowMargin * gridInfo.resolutionX;
+  const double marginY = terrama2::core::RasterHandle::windowMargin * gridInfo.resolutionY;
+  source.footprint = te::gm::Envelope(gridInfo.extent->getLowerLeftX() - marginX, gridInfo.extent->getLowerLeftY() - marginY,
+                                      gridInfo.extent->getUpperRightX() + marginX, gridInfo.extent->getUpperRightY() + marginY);
+
+  const Srid outputSrid = outputRaster->getSRID();
+  if(gridInfo.srid != 0 && outputSrid != 0 && gridInfo.srid != outputSrid)
+  {
+    try
+    {
+      source.footprint.transform(gridInfo.srid, outputSrid);
+    }
+    catch(const std::exception&)
+    {
+      // a change of the grid affects the whole output
+      source.footprint = *outputRaster->getExtent();
+    }
+  }
+
+  return source;
+}
+
+std::string terrama2::services::analysis::core::GridProvenance::configurationHash() const
+{
+  auto analysis = context_->getAnalysis();
+  auto outputRaster = context_->getOutputRaster();
+
+  QCryptographicHash hash(QCryptographicHash::Md5);
+  hash.addData(analysis->script.c_str(), static_cast<int>(analysis->script.size()));
+  hash.addData(QJsonDocument(toJson(analysis->outputGridPtr)).toJson(QJsonDocument::Compact));
+
+  for(const auto& analysisDataSeries : analysis->analysisDataSeriesList)
+  {
+    QString item = QString("%1|%2|%3").arg(analysisDataSeries.dataSeriesId)
+                                      .arg(static_cast<int>(analysisDataSeries.type))
+                                      .arg(QString::fromStdString(analysisDataSeries.alias));
+    for(const auto& metadata : analysisDataSeries.metadata)
+      item += QString("|%1=%2").arg(QString::fromStdString(metadata.first), QString::fromStdString(metadata.second));
+
+    hash.addData(item.toUtf8());
+  }
+
+  const te::gm::Envelope* extent = outputRaster->getExtent();
+  QString geometry = QString("%1|%2|%3|%4|%5|%6|%7|%8")
+                     .arg(outputRaster->getNumberOfColumns())
+                     .arg(outputRaster->getNumberOfRows())
+                     .arg(outputRaster->getNumberOfBands())
+                     .arg(outputRaster->getSRID())
+                     .arg(QString::number(extent->getLowerLeftX(), 'g', 17))
+                     .arg(QString::number(extent->getLowerLeftY(), 'g', 17))
+                     .arg(QString::number(extent->getUpperRightX(), 'g', 17))
+                     .arg(QString::number(extent->getUpperRightY(), 'g', 17));
+  hash.addData(geometry.toUtf8());
+
+  return hash.result().toHex().toStdString();
+}
@@ -0,0 +1,156 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/services/analysis/core/GridProvenance.hpp
+
+  \brief Tile-level provenance of the output of grid analyses, used to reuse unchanged tiles.
+
+  \author Jano Simas
+*/
+
+#ifndef __TERRAMA2_ANALYSIS_CORE_GRID_PROVENANCE_HPP__
+#define __TERRAMA2_ANALYSIS_CORE_GRID_PROVENANCE_HPP__
+
+#include "Analysis.hpp"
+#include "BaseContext.hpp"
+#include "GridContext.hpp"
+#include "../../../core/data-access/DataAccessorGrid.hpp"
+
+// TerraLib
+#include <terralib/geometry/Envelope.h>
+
+// Qt
+#include <QString>
+
+// STL
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Forward declaration
+namespace te
+{
+  namespace rst
+  {
+    class Grid;
+  }
+}
+
+namespace terrama2
+{
+  namespace services
+  {
+    namespace analysis
+    {
+      namespace core
+      {
+        /*!
+          \brief Provenance record of the output of a grid analysis.
+
+          The record keeps the grids read by each request of the previous execution and its output values.
+          Before a new execution the requests are listed again, without reading the pixels,
+          the regions of the grids that were added, removed or modified are the changed regions.
+          Only the tiles whose footprint intersects a changed region are evaluated,
+          the other tiles are restored from the previous output.
+
+          The record is only valid for the same script and output grid,
+          and for grids that are files, as their content identifies the version of the data.
+        */
+        class GridProvenance
+        {
+          public:
+            //! A grid read by the analysis.
+            struct Source
+            {
+              std::string identity; //!< Content and timestamp of the grid, empty if unknown.
+              te::gm::Envelope footprint; //!< Extent of the grid in the output SRID, with the interpolation margin.
+            };
+
+            //! Grids read by a request to a grid data series.
+            struct Request
+            {
+              ObjectKey key; //!< Data series and date filter of the request.
+              std::vector<Source> sources; //!< Grids of the request.
+            };
+
+            explicit GridProvenance(std::shared_ptr<GridContext> context);
+
+            //! Returns true if the analysis only reads grids, other inputs are not tracked.
+            static bool isSupported(AnalysisPtr analysis);
+
+            //! Sets the folder of the records, by default analysis-provenance in the data folder of the service.
+            static void setFolder(const std::string& folder);
+
+            //! Removes the record of the analysis, called when the analysis is removed.
+            static void removeAnalysis(AnalysisId analysisId);
+
+            /*!
+              \brief Restores the tiles not affected by changes since the previous execution.
+
+              The output raster of the context must be created.
+
+              \param tiles Tiles of a complete execution.
+              \param reusedTiles Receives the tiles restored from the previous output.
+              \return The tiles that must be evaluated, all tiles if there is no valid record.
+            */
+            std::vector<GridTile> restore(const std::vector<GridTile>& tiles, std::vector<GridTile>& reusedTiles);
+
+            /*!
+              \brief Returns true if the grids read during the execution are the grids listed by restore.
+
+              If the script made other requests, or new data arrived, the restored tiles must be evaluated.
+            */
+            bool isValid() const;
+
+            /*!
+              \brief Saves the record of the execution.
+
+              If a grid read can't be identified the record is removed.
+            */
+            void save() const;
+
+            //! Returns the footprints of the sources that are not in both lists.
+            static std::vector<te::gm::Envelope> changedRegions(const std::vector<Source>& previous, const std::vector<Source>& current);
+
+            //! Returns true if the tile, with a margin of one cell, intersects one of the regions.
+            static bool isAffected(const GridTile& tile, const te::rst::Grid& grid, const std::vector<te::gm::Envelope>& regions);
+
+          private:
+            //! Identifies the grid and computes its footprint in the output grid.
+            Source toSource(const terrama2::core::GridInfo& gridInfo) const;
+
+            //! Hash of the configuration that defines the output of the analysis.
+            std::string configurationHash() const;
+
+            //! Folder of the record of the analysis.
+            QString recordFolder() const;
+
+            std::shared_ptr<GridContext> context_;
+            std::vector<Request> replayed_; //!< Requests listed by restore.
+        };
+      } // end namespace core
+    }   // end namespace analysis
+  }     // end namespace services
+}       // end namespace terrama2
+
+#endif //__TERRAMA2_ANALYSIS_CORE_GRID_PROVENANCE_HPP__
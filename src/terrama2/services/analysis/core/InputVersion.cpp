@@ -0,0 +1,267 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/services/analysis/core/InputVersion.cpp
+
+  \brief Record of the version of the inputs of an analysis execution.
+
+  \author Jano Simas
+*/
+
+#include "InputVersion.hpp"
+#include "DataManager.hpp"
+#include "JSonUtils.hpp"
+#include "../../../core/data-access/DataAccessor.hpp"
+#include "../../../core/data-model/DataProvider.hpp"
+#include "../../../core/data-model/DataSeries.hpp"
+#include "../../../core/utility/DataAccessorFactory.hpp"
+#include "../../../core/utility/Logger.hpp"
+#include "../../../core/utility/ServiceManager.hpp"
+#include "../../../Exception.hpp"
+
+// Qt
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QObject>
+#include <QRegularExpression>
+#include <QSaveFile>
+
+// STL
+#include <algorithm>
+#include <mutex>
+#include <set>
+
+namespace
+{
+  std::mutex folderMutex;
+
+  //! Folder set by the service configuration, empty for the default folder.
+  QString& configuredInputVersionFolder()
+  {
+    static QString folder;
+    return folder;
+  }
+
+  //! Returns the folder of the records, by default analysis-input-version in the data folder of the service.
+  QString inputVersionFolder()
+  {
+    if(!configuredInputVersionFolder().isEmpty())
+      return configuredInputVersionFolder();
+
+    return QDir(QString::fromStdString(terrama2::core::ServiceManager::getInstance().dataFolder())).absoluteFilePath("analysis-input-version");
+  }
+
+  //! Hash of the configuration of the analysis, the results change with any change of the configuration.
+  QString configurationHash(terrama2::services::analysis::core::AnalysisPtr analysis)
+  {
+    QByteArray data = QJsonDocument(terrama2::services::analysis::core::toJson(analysis)).toJson(QJsonDocument::Compact);
+    return QCryptographicHash::hash(data, QCryptographicHash::Md5).toHex();
+  }
+
+  //! Version of a data series produced by another analysis, the last data timestamp of the producer.
+  std::string analysisDataVersion(terrama2::services::analysis::core::AnalysisPtr producer,
+                                  std::shared_ptr<terrama2::services::analysis::core::AnalysisLogger> logger)
+  {
+    if(!logger)
+      return "";
+
+    auto lastTimestamp = logger->getDataLastTimestamp(producer->id);
+    if(!lastTimestamp)
+      return "";
+
+    return "analysis:" + lastTimestamp->toString();
+  }
+}
+
+terrama2::services::analysis::core::InputVersion::InputVersion(AnalysisPtr analysis, const std::map<DataSeriesId, std::string>& versions)
+  : analysis_(analysis),
+    versions_(versions)
+{
+}
+
+std::map<DataSeriesId, std::string>
+terrama2::services::analysis::core::InputVersion::readVersions(DataManagerPtr dataManager, AnalysisPtr analysis,
+                                                               std::shared_ptr<AnalysisLogger> logger)
+{
+  std::set<DataSeriesId> dataSeriesIds;
+  for(const auto& analysisDataSeries : analysis->analysisDataSeriesList)
+    dataSeriesIds.insert(analysisDataSeries.dataSeriesId);
+
+  if(analysis->outputGridPtr)
+  {
+    if(analysis->outputGridPtr->resolutionType == ResolutionType::SAME_FROM_DATASERIES)
+      dataSeriesIds.insert(analysis->outputGridPtr->resolutionDataSeriesId);
+    if(analysis->outputGridPtr->interestAreaType == InterestAreaType::SAME_FROM_DATASERIES)
+      dataSeriesIds.insert(analysis->outputGridPtr->interestAreaDataSeriesId);
+  }
+
+  std::map<DataSeriesId, std::string> versions;
+  for(DataSeriesId dataSeriesId : dataSeriesIds)
+  {
+    std::string version;
+    try
+    {
+      auto producer = dataManager->findProducerAnalysis(dataSeriesId);
+      if(producer)
+      {
+        version = analysisDataVersion(producer, logger);
+      }
+      else
+      {
+        auto dataSeries = dataManager->findDataSeries(dataSeriesId);
+        auto dataProvider = dataManager->findDataProvider(dataSeries->dataProviderId);
+        auto accessor = terrama2::core::DataAccessorFactory::getInstance().make(dataProvider, dataSeries);
+        version = accessor->dataVersion();
+      }
+    }
+    catch(const terrama2::Exception& e)
+    {
+      TERRAMA2_LOG_WARNING() << QObject::tr("Could not read the version of data series %1: %2")
+                                .arg(dataSeriesId).arg(*boost::get_error_info<terrama2::ErrorDescription>(e));
+    }
+    catch(const std::exception& e)
+    {
+      TERRAMA2_LOG_WARNING() << QObject::tr("Could not read the version of data series %1: %2").arg(dataSeriesId).arg(e.what());
+    }
+    catch(...)
+    {
+      TERRAMA2_LOG_WARNING() << QObject::tr("Could not read the version of data series %1.").arg(dataSeriesId);
+    }
+
+    versions.emplace(dataSeriesId, version);
+  }
+
+  return versions;
+}
+
+bool terrama2::services::analysis::core::InputVersion::isEligible(DataManagerPtr dataManager, AnalysisPtr analysis)
+{
+  if(analysis->reprocessingHistoricalData)
+    return false;
+
+  auto it = analysis->metadata.find("skip_unchanged");
+  if(it != analysis->metadata.end() && it->second == "false")
+    return false;
+
+  // grid history and forecast operators read a date window relative to the execution date
+  static const QRegularExpression windowOperator("\\bgrid\\s*\\.\\s*(zonal\\s*\\.\\s*)?(history|forecast)\\b");
+  if(windowOperator.match(QString::fromStdString(analysis->script)).hasMatch())
+    return false;
+
+  // DCP and occurrence data are read in a date window relative to the execution date
+  for(const auto& analysisDataSeries : analysis->analysisDataSeriesList)
+  {
+    auto dataSeries = dataManager->findDataSeries(analysisDataSeries.dataSeriesId);
+    auto type = dataSeries->semantics.dataSeriesType;
+    if(type == terrama2::core::DataSeriesType::DCP || type == terrama2::core::DataSeriesType::OCCURRENCE)
+      return false;
+  }
+
+  return true;
+}
+
+void terrama2::services::analysis::core::InputVersion::setFolder(const std::string& folder)
+{
+  std::lock_guard<std::mutex> lock(folderMutex);
+  configuredInputVersionFolder() = QString::fromStdString(folder);
+}
+
+void terrama2::services::analysis::core::InputVersion::removeAnalysis(AnalysisId analysisId)
+{
+  std::lock_guard<std::mutex> lock(folderMutex);
+  QFile::remove(inputVersionFolder() + "/" + QString::number(analysisId) + ".json");
+}
+
+QString terrama2::services::analysis::core::InputVersion::recordPath() const
+{
+  std::lock_guard<std::mutex> lock(folderMutex);
+  return inputVersionFolder() + "/" + QString::number(analysis_->id) + ".json";
+}
+
+bool terrama2::services::analysis::core::InputVersion::isKnown() const
+{
+  return std::none_of(versions_.begin(), versions_.end(),
+                      [](const std::pair<DataSeriesId, std::string>& version)
+                      {
+                        return version.second.empty();
+                      });
+}
+
+bool terrama2::services::analysis::core::InputVersion::isUnchanged() const
+{
+  if(!isKnown())
+    return false;
+
+  QFile file(recordPath());
+  if(!file.open(QIODevice::ReadOnly))
+    return false;
+
+  QJsonObject record = QJsonDocument::fromJson(file.readAll()).object();
+  if(record["configuration"].toString() != configurationHash(analysis_))
+    return false;
+
+  QJsonObject versions = record["versions"].toObject();
+  if(static_cast<std::size_t>(versions.size()) != versions_.size())
+    return false;
+
+  for(const auto& version : versions_)
+  {
+    if(versions[QString::number(version.first)].toString().toStdString() != version.second)
+      return false;
+  }
+
+  return true;
+}
+
+void terrama2::services::analysis::core::InputVersion::save() const
+{
+  if(!isKnown())
+  {
+    remove();
+    return;
+  }
+
+  QJsonObject versions;
+  for(const auto& version : versions_)
+    versions[QString::number(version.first)] = QString::fromStdString(version.second);
+
+  QJsonObject record;
+  record["configuration"] = configurationHash(analysis_);
+  record["versions"] = versions;
+
+  const QString path = recordPath();
+  QDir().mkpath(QFileInfo(path).absolutePath());
+
+  QByteArray data = QJsonDocument(record).toJson(QJsonDocument::Compact);
+  QSaveFile file(path);
+  if(!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit())
+    TERRAMA2_LOG_WARNING() << QObject::tr("Could not save the input version of analysis %1.").arg(analysis_->id);
+}
+
+void terrama2::services::analysis::core::InputVersion::remove() const
+{
+  QFile::remove(recordPath());
+}
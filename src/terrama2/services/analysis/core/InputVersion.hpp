@@ -0,0 +1,128 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/services/analysis/core/InputVersion.hpp
+
+  \brief Record of the version of the inputs of an analysis execution.
+
+  \author Jano Simas
+*/
+
+#ifndef __TERRAMA2_ANALYSIS_CORE_INPUT_VERSION_HPP__
+#define __TERRAMA2_ANALYSIS_CORE_INPUT_VERSION_HPP__
+
+#include "Analysis.hpp"
+#include "AnalysisLogger.hpp"
+#include "Shared.hpp"
+#include "Typedef.hpp"
+
+// Qt
+#include <QString>
+
+// STL
+#include <map>
+#include <memory>
+#include <string>
+
+namespace terrama2
+{
+  namespace services
+  {
+    namespace analysis
+    {
+      namespace core
+      {
+        /*!
+          \brief Version of the inputs of an analysis execution.
+
+          The version of a data series produced by another analysis is its last data timestamp in the analysis log,
+          the version of other data series is the version of the stored data given by its data accessor.
+
+          The versions of the last successful execution are recorded with the configuration of the analysis,
+          an execution with the same versions and configuration would produce the same results.
+        */
+        class InputVersion
+        {
+          public:
+            /*!
+              \param analysis Analysis being executed.
+              \param versions Version of each input data series, an empty version if unknown.
+            */
+            InputVersion(AnalysisPtr analysis, const std::map<DataSeriesId, std::string>& versions);
+
+            /*!
+              \brief Reads the version of all data series used by the analysis.
+
+              Errors reading a version are logged and the version is unknown.
+            */
+            static std::map<DataSeriesId, std::string> readVersions(DataManagerPtr dataManager, AnalysisPtr analysis,
+                                                                    std::shared_ptr<AnalysisLogger> logger);
+
+            /*!
+              \brief Returns true if the results of the analysis only depend on the version of its inputs.
+
+              Reprocessing of historical data, analyses with DCP or occurrence inputs
+              and scripts with grid history or forecast operators,
+              read in a date window relative to the execution date, always run.
+              The metadata "skip_unchanged" equal to "false" disables the skip.
+            */
+            static bool isEligible(DataManagerPtr dataManager, AnalysisPtr analysis);
+
+            //! Sets the folder of the records, by default analysis-input-version in the data folder of the service.
+            static void setFolder(const std::string& folder);
+
+            //! Removes the record of the analysis, called when the analysis is removed.
+            static void removeAnalysis(AnalysisId analysisId);
+
+            /*!
+              \brief Returns true if the inputs and configuration are the same of the last recorded execution.
+
+              If the version of any input is unknown the inputs are considered changed.
+            */
+            bool isUnchanged() const;
+
+            /*!
+              \brief Records the versions as the versions of the last successful execution.
+
+              If the version of any input is unknown the record is removed.
+            */
+            void save() const;
+
+            //! Removes the record, the next execution always runs.
+            void remove() const;
+
+          private:
+            //! Returns true if all versions are known.
+            bool isKnown() const;
+
+            //! Path of the record of the analysis.
+            QString recordPath() const;
+
+            AnalysisPtr analysis_;
+            std::map<DataSeriesId, std::string> versions_;
+        };
+      } // end namespace core
+    }   // end namespace analysis
+  }     // end namespace services
+}       // end namespace terrama2
+
+#endif //__TERRAMA2_ANALYSIS_CORE_INPUT_VERSION_HPP__
@@ -44,6 +44,9 @@
 // TerraLib
 #include <terralib/geometry/Utils.h>
 
+// STL
+#include <algorithm>
+
 terrama2::services::analysis::core::AnalysisPtr terrama2::services::analysis::core::fromAnalysisJson(const QJsonObject& json)
 {
   if(json["class"].toString() != "Analysis")
@@ -229,6 +232,21 @@ QJsonObject terrama2::services::analysis::core::toJson(AnalysisOutputGridPtr out
   }
 
   obj.insert("area_of_interest_box", QString::fromStdString(strBox));
+  obj.insert("sparse_execution", outputGrid->sparseExecution);
+  obj.insert("incremental_execution", outputGrid->incrementalExecution);
+  obj.insert("data_type", static_cast<qint32>(outputGrid->dataType));
+  obj.insert("scale", QJsonValue(outputGrid->scale));
+  obj.insert("offset", QJsonValue(outputGrid->offset));
+
+  QJsonArray bandNames;
+  for(const auto& bandName : outputGrid->bandNames)
+    bandNames.push_back(QString::fromStdString(bandName));
+  obj.insert("output_bands", bandNames);
+
+  QJsonObject bandDataSeries;
+  for(const auto& item : outputGrid->bandDataSeries)
+    bandDataSeries.insert(QString::fromStdString(item.first), static_cast<qint32>(item.second));
+  obj.insert("output_band_data_series", bandDataSeries);
 
 
   return obj;
@@ -272,7 +290,7 @@ terrama2::services::analysis::core::AnalysisOutputGridPtr terrama2::services::an
 
   outputGrid->analysisId = json["analysis_id"].toInt();
   outputGrid->interpolationMethod = ToInterpolationMethod(json["interpolation_method"].toInt());
-  outputGrid->interpolationDummy = json["script_language"].toDouble();
+  outputGrid->interpolationDummy = json["interpolation_dummy"].toDouble();
   outputGrid->resolutionType =  ToResolutionType(json["resolution_type"].toInt());
   if(!json["resolution_data_series_id"].isNull())
     outputGrid->resolutionDataSeriesId = json["resolution_data_series_id"].toInt();
@@ -291,6 +309,56 @@ terrama2::services::analysis::core::AnalysisOutputGridPtr terrama2::services::an
     std::string ewkt = json["area_of_interest_box"].toString().toStdString();
     outputGrid->interestAreaBox = terrama2::core::ewktToGeom(ewkt);
   }
+  if(json.contains("sparse_execution"))
+    outputGrid->sparseExecution = json["sparse_execution"].toBool();
+  if(json.contains("incremental_execution"))
+    outputGrid->incrementalExecution = json["incremental_execution"].toBool();
+  if(json.contains("data_type") && !json["data_type"].isNull())
+    outputGrid->dataType = ToOutputDataType(json["data_type"].toInt());
+  if(json.contains("scale") && !json["scale"].isNull())
+    outputGrid->scale = json["scale"].toDouble();
+  if(json.contains("offset") && !json["offset"].isNull())
+    outputGrid->offset = json["offset"].toDouble();
+
+  if(outputGrid->scale == 0)
+  {
+    QString errMsg(QObject::tr("Invalid scale of the output grid."));
+    TERRAMA2_LOG_ERROR() << errMsg;
+    throw terrama2::core::JSonParserException() << ErrorDescription(errMsg);
+  }
+
+  if(json.contains("output_bands"))
+  {
+    for(const auto& bandName : json["output_bands"].toArray())
+    {
+      std::string name = bandName.toString().toStdString();
+      if(name.empty() || std::find(outputGrid->bandNames.begin(), outputGrid->bandNames.end(), name) != outputGrid->bandNames.end())
+      {
+        QString errMsg(QObject::tr("Invalid output band name: %1.").arg(bandName.toString()));
+        TERRAMA2_LOG_ERROR() << errMsg;
+        throw terrama2::core::JSonParserException() << ErrorDescription(errMsg);
+      }
+
+      outputGrid->bandNames.push_back(name);
+    }
+  }
+
+  if(json.contains("output_band_data_series"))
+  {
+    auto bandDataSeries = json["output_band_data_series"].toObject();
+    for(auto it = bandDataSeries.begin(); it != bandDataSeries.end(); ++it)
+    {
+      std::string name = it.key().toStdString();
+      if(std::find(outputGrid->bandNames.begin(), outputGrid->bandNames.end(), name) == outputGrid->bandNames.end())
+      {
+        QString errMsg(QObject::tr("Unknown output band: %1.").arg(it.key()));
+        TERRAMA2_LOG_ERROR() << errMsg;
+        throw terrama2::core::JSonParserException() << ErrorDescription(errMsg);
+      }
+
+      outputGrid->bandDataSeries[name] = it.value().toInt();
+    }
+  }
 
   return outputGridPtr;
 }
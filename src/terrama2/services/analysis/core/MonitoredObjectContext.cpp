@@ -400,6 +400,14 @@ void terrama2::services::analysis::core::MonitoredObjectContext::setAnalysisResu
   attributeMap[attribute] = result;
 }
 
+void terrama2::services::analysis::core::MonitoredObjectContext::visitAnalysisResult(const std::function<void(const std::string&, const std::map<std::string, double>&)>& visitor) const
+{
+  std::lock_guard<std::recursive_mutex> lock(mutex_);
+
+  for(const auto& result : analysisResult_)
+    visitor(result.first, result.second);
+}
+
 std::shared_ptr<terrama2::services::analysis::core::ContextDataSeries>
 terrama2::services::analysis::core::MonitoredObjectContext::getMonitoredObjectContextDataSeries(std::shared_ptr<DataManager>& dataManagerPtr)
 {
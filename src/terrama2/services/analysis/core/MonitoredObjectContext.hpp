@@ -39,6 +39,10 @@
 #include <terralib/geometry/Coord2D.h>
 #include <terralib/sam/kdtree.h>
 
+// STL
+#include <functional>
+#include <map>
+
 // Forward declaration
 namespace te
 {
@@ -129,6 +133,13 @@ namespace terrama2
             */
             inline std::unordered_map<std::string, std::map<std::string, double> > analysisResult() const { return analysisResult_; }
 
+            /*!
+              \brief Calls the visitor with the result of each geometry, without copying the results.
+
+              The context is locked while the results are visited.
+            */
+            void visitAnalysisResult(const std::function<void(const std::string& geomId, const std::map<std::string, double>& result)>& visitor) const;
+
             /*!
             \brief Sets the analysis result for a geometry and a given attribute.
 
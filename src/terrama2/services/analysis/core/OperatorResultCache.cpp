@@ -0,0 +1,171 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/services/analysis/core/OperatorResultCache.cpp
+
+  \brief Cache of operator results shared by all analyses of the service.
+
+  \author Jano Simas
+*/
+
+#include "OperatorResultCache.hpp"
+
+//STL
+#include <iterator>
+#include <sstream>
+
+std::string terrama2::services::analysis::core::OperatorResultKey::toString() const
+{
+  std::stringstream ss;
+  ss.precision(17);
+  ss << operatorName << "|" << dataSeriesId << "|" << dataVersion
+     << "|" << dateWindow
+     << "|" << static_cast<int>(buffer.bufferType) << ":" << buffer.distance << buffer.unit
+     << ":" << buffer.distance2 << buffer.unit2
+     << "|" << monitoredObjectId << "|" << geometryId;
+
+  return ss.str();
+}
+
+terrama2::services::analysis::core::OperatorCache
+terrama2::services::analysis::core::OperatorResultCache::get(const OperatorResultKey& key, const std::function<OperatorCache()>& compute)
+{
+  std::string keyStr = key.toString();
+
+  std::promise<OperatorCache> promise;
+  std::shared_future<OperatorCache> future;
+  bool computeResult = false;
+  uint64_t generation = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(keyStr);
+    if(it != entries_.end())
+    {
+      lru_.splice(lru_.begin(), lru_, it->second.lruPosition);
+      future = it->second.result;
+    }
+    else
+    {
+      future = promise.get_future().share();
+      lru_.push_front(keyStr);
+
+      Entry entry;
+      entry.result = future;
+      entry.lruPosition = lru_.begin();
+      entry.dataSeriesId = key.dataSeriesId;
+      entry.monitoredObjectId = key.monitoredObjectId;
+      entry.memory = 2*keyStr.size() + sizeof(Entry) + sizeof(OperatorCache);
+      entry.generation = generation = ++generation_;
+      entry.ready = false;
+
+      memory_ += entry.memory;
+      entries_.emplace(keyStr, entry);
+      computeResult = true;
+    }
+  }
+
+  // someone else is computing or has computed the result
+  if(!computeResult)
+    return future.get();
+
+  OperatorCache result;
+  try
+  {
+    result = compute();
+  }
+  catch(...)
+  {
+    promise.set_exception(std::current_exception());
+
+    // failed results are not cached, the next request will try again
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(keyStr);
+    if(it != entries_.end() && it->second.generation == generation)
+      erase(it);
+
+    throw;
+  }
+
+  promise.set_value(result);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.find(keyStr);
+  // the entry may have been invalidated during the computation
+  if(it != entries_.end() && it->second.generation == generation)
+  {
+    it->second.ready = true;
+    evict();
+  }
+
+  return result;
+}
+
+void terrama2::services::analysis::core::OperatorResultCache::invalidate(DataSeriesId dataSeriesId)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = entries_.begin();
+  while(it != entries_.end())
+  {
+    auto current = it++;
+    if(current->second.dataSeriesId == dataSeriesId || current->second.monitoredObjectId == dataSeriesId)
+      erase(current);
+  }
+}
+
+void terrama2::services::analysis::core::OperatorResultCache::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  lru_.clear();
+  memory_ = 0;
+}
+
+void terrama2::services::analysis::core::OperatorResultCache::setMaxMemory(std::size_t maxMemory)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  maxMemory_ = maxMemory;
+  evict();
+}
+
+void terrama2::services::analysis::core::OperatorResultCache::evict()
+{
+  auto it = lru_.end();
+  while(memory_ > maxMemory_ && it != lru_.begin())
+  {
+    --it;
+    auto entry = entries_.find(*it);
+    // results being computed have waiting threads, they stay in the cache
+    if(!entry->second.ready)
+      continue;
+
+    auto next = std::next(it);
+    erase(entry);
+    it = next;
+  }
+}
+
+void terrama2::services::analysis::core::OperatorResultCache::erase(std::unordered_map<std::string, Entry>::iterator it)
+{
+  memory_ -= it->second.memory;
+  lru_.erase(it->second.lruPosition);
+  entries_.erase(it);
+}
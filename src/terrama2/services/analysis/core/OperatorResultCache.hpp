@@ -0,0 +1,137 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/services/analysis/core/OperatorResultCache.hpp
+
+  \brief Cache of operator results shared by all analyses of the service.
+
+  \author Jano Simas
+*/
+
+#ifndef __TERRAMA2_ANALYSIS_CORE_OPERATOR_RESULT_CACHE_HPP__
+#define __TERRAMA2_ANALYSIS_CORE_OPERATOR_RESULT_CACHE_HPP__
+
+#include "OperatorCache.hpp"
+#include "BufferMemory.hpp"
+#include "../../../core/Typedef.hpp"
+
+// TerraLib
+#include <terralib/common/Singleton.h>
+
+//STL
+#include <functional>
+#include <future>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace terrama2
+{
+  namespace services
+  {
+    namespace analysis
+    {
+      namespace core
+      {
+        /*!
+          \brief Identifies an operator result independently of the analysis that computed it.
+
+          All statistics are computed together by the operators,
+          so the statistic is not part of the key, it's selected from the cached OperatorCache.
+        */
+        struct OperatorResultKey
+        {
+          std::string operatorName; //!< Name of the operator, as in the python module.
+          DataSeriesId dataSeriesId = 0; //!< Identifier of the data series read by the operator.
+          std::string dataVersion; //!< Version of the data read, changes when new data is collected.
+          std::string dateWindow; //!< Absolute date window read, see BaseContext::getDateWindow().
+          Buffer buffer; //!< Buffer applied to the monitored object.
+          DataSeriesId monitoredObjectId = 0; //!< Identifier of the monitored object data series.
+          std::string geometryId; //!< Identifier of the monitored object geometry.
+
+          //! Returns a string that uniquely represents the key.
+          std::string toString() const;
+        };
+
+        /*!
+          \brief Memory-bounded LRU cache of operator results.
+
+          Concurrent requests for the same key wait for a single computation.
+          Entries are removed when the data series is updated or removed,
+          new collected data changes the data version and so the key.
+        */
+        class OperatorResultCache : public te::common::Singleton<OperatorResultCache>
+        {
+          public:
+            /*!
+              \brief Returns the cached result for the key, computing it if needed.
+
+              If another thread is computing the same key, waits for its result.
+
+              \note The GIL must be released before calling this method.
+              \exception Any exception thrown by compute is re-thrown to all waiting threads,
+                         failed computations are not cached.
+            */
+            OperatorCache get(const OperatorResultKey& key, const std::function<OperatorCache()>& compute);
+
+            //! Removes all results computed from the data series.
+            void invalidate(DataSeriesId dataSeriesId);
+
+            //! Removes all results.
+            void clear();
+
+            //! Set the maximum memory, in bytes, used by the cached results.
+            void setMaxMemory(std::size_t maxMemory);
+
+          private:
+            //! Cached result and its position in the LRU list.
+            struct Entry
+            {
+              std::shared_future<OperatorCache> result;
+              std::list<std::string>::iterator lruPosition;
+              DataSeriesId dataSeriesId;
+              DataSeriesId monitoredObjectId;
+              std::size_t memory;
+              uint64_t generation; //!< Distinguishes entries recreated after an invalidation.
+              bool ready;
+            };
+
+            //! Removes the least recently used ready entries until the memory limit is respected.
+            void evict();
+
+            //! Removes the entry from all containers.
+            void erase(std::unordered_map<std::string, Entry>::iterator it);
+
+            std::unordered_map<std::string, Entry> entries_;
+            std::list<std::string> lru_; //!< Keys ordered from most recently used to least recently used.
+            uint64_t generation_ = 0;
+            std::size_t memory_ = 0;
+            std::size_t maxMemory_ = 64*1024*1024;
+            mutable std::mutex mutex_; //!< A mutex to synchronize all operations.
+        };
+      } // end namespace core
+    }   // end namespace analysis
+  }     // end namespace services
+}       // end namespace terrama2
+
+#endif //__TERRAMA2_ANALYSIS_CORE_OPERATOR_RESULT_CACHE_HPP__
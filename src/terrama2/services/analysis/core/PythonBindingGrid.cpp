@@ -37,6 +37,7 @@
 #include "grid/zonal/history/Operator.hpp"
 #include "grid/zonal/history/ratio/Operator.hpp"
 #include "grid/zonal/history/prec/Operator.hpp"
+#include "grid/occurrence/Operator.hpp"
 
 void terrama2::services::analysis::core::python::Grid::registerFunctions()
 {
@@ -49,6 +50,7 @@ void terrama2::services::analysis::core::python::Grid::registerFunctions()
   registerGridZonalHistoryFunctions();
   registerGridZonalHistoryRatioFunctions();
   registerGridZonalHistoryPrecFunctions();
+  registerGridOccurrenceFunctions();
 }
 
 void terrama2::services::analysis::core::python::Grid::registerGridFunctions()
@@ -351,3 +353,37 @@ void terrama2::services::analysis::core::python::Grid::registerGridZonalHistoryP
       gridZonalHistoryPrecVariance_overloads(args("dataSeriesName", "buffer"),
           "Variance operator for grid zonal"));
 }
+
+// pragma to silence python macros warnings
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-local-typedef"
+
+// // Declaration needed for default parameter restriction
+BOOST_PYTHON_FUNCTION_OVERLOADS(gridOccurrenceCount_overloads, terrama2::services::analysis::core::grid::occurrence::count, 1, 2)
+BOOST_PYTHON_FUNCTION_OVERLOADS(gridOccurrenceSum_overloads, terrama2::services::analysis::core::grid::occurrence::sum, 2, 3)
+BOOST_PYTHON_FUNCTION_OVERLOADS(gridOccurrenceKernelDensity_overloads, terrama2::services::analysis::core::grid::occurrence::kernelDensity, 2, 5)
+
+// closing "-Wunused-local-typedef" pragma
+#pragma GCC diagnostic pop
+
+void terrama2::services::analysis::core::python::Grid::registerGridOccurrenceFunctions()
+{
+  using namespace boost::python;
+
+  // Register operations for grid.occurrence
+  object gridOccurrenceModule(handle<>(borrowed(PyImport_AddModule("terrama2.grid.occurrence"))));
+  // make "from terrama2.grid import occurrence" work
+  import("terrama2.grid").attr("occurrence") = gridOccurrenceModule;
+  // set the current scope to the new sub-module
+  scope gridOccurrenceScope = gridOccurrenceModule;
+
+  def("count", terrama2::services::analysis::core::grid::occurrence::count,
+      gridOccurrenceCount_overloads(args("dataSeriesName", "dateFilter"),
+                                    "Count operator for grid occurrence"));
+  def("sum", terrama2::services::analysis::core::grid::occurrence::sum,
+      gridOccurrenceSum_overloads(args("dataSeriesName", "attribute", "dateFilter"),
+                                  "Sum operator for grid occurrence"));
+  def("kernel_density", terrama2::services::analysis::core::grid::occurrence::kernelDensity,
+      gridOccurrenceKernelDensity_overloads(args("dataSeriesName", "bandwidth", "kernel", "dateFilter", "attribute"),
+                                            "Kernel density operator for grid occurrence"));
+}
@@ -54,6 +54,7 @@ namespace terrama2
             void registerGridZonalHistoryFunctions();
             void registerGridZonalHistoryRatioFunctions();
             void registerGridZonalHistoryPrecFunctions();
+            void registerGridOccurrenceFunctions();
           } /* MonitoredObject */
         } /* python */
       }
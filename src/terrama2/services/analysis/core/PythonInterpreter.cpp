@@ -39,6 +39,7 @@
 #include "MonitoredObjectContext.hpp"
 #include "PythonBindingGrid.hpp"
 #include "PythonBindingMonitoredObject.hpp"
+#include "Utils.hpp"
 #include "dcp/Operator.hpp"
 #include "dcp/history/Operator.hpp"
 #include "grid/Operator.hpp"
@@ -59,6 +60,8 @@
 #include <terralib/common/UnitsOfMeasureManager.h>
 
 // STL
+#include <algorithm>
+#include <cmath>
 #include <math.h>
 
 // Boost Python
@@ -72,6 +75,49 @@
 
 using namespace boost::python;
 
+void terrama2::services::analysis::core::python::outputBandValues(const object& result, const std::vector<std::string>& bandNames, std::vector<double>& values)
+{
+  values.assign(bandNames.size(), std::nan(""));
+
+  auto toDouble = [](const object& value)
+  {
+    return value.ptr() == Py_None ? std::nan("") : static_cast<double>(extract<double>(value));
+  };
+
+  if(result.ptr() == Py_None)
+    return;
+
+  extract<dict> asDict(result);
+  if(asDict.check())
+  {
+    dict resultDict = asDict();
+    for(std::size_t bandIdx = 0; bandIdx < bandNames.size(); ++bandIdx)
+    {
+      if(resultDict.has_key(bandNames[bandIdx]))
+        values[bandIdx] = toDouble(resultDict[bandNames[bandIdx]]);
+    }
+
+    return;
+  }
+
+  if(PySequence_Check(result.ptr()))
+  {
+    std::size_t size = static_cast<std::size_t>(len(result));
+    if(size != bandNames.size())
+    {
+      QString errMsg = QObject::tr("The analysis returned %1 values for %2 output bands.").arg(size).arg(bandNames.size());
+      throw PythonInterpreterException() << terrama2::ErrorDescription(errMsg);
+    }
+
+    for(std::size_t bandIdx = 0; bandIdx < size; ++bandIdx)
+      values[bandIdx] = toDouble(result[bandIdx]);
+
+    return;
+  }
+
+  if(!values.empty())
+    values[0] = toDouble(result);
+}
 
 std::string terrama2::services::analysis::core::python::extractException()
 {
@@ -198,7 +244,7 @@ void terrama2::services::analysis::core::python::runMonitoredObjectScript(PyThre
 }
 
 
-void terrama2::services::analysis::core::python::runScriptGridAnalysis(PyThreadState* state, terrama2::services::analysis::core::GridContextPtr context, std::vector<uint32_t> rows)
+void terrama2::services::analysis::core::python::runScriptGridAnalysis(PyThreadState* state, terrama2::services::analysis::core::GridContextPtr context, std::vector<GridTile> tiles)
 {
   GILLock lock;
 
@@ -224,8 +270,6 @@ void terrama2::services::analysis::core::python::runScriptGridAnalysis(PyThreadS
       throw terrama2::InvalidArgumentException() << terrama2::ErrorDescription(errMsg);
     }
 
-    int nCols = outputRaster->getNumberOfColumns();
-
     std::string script = prepareScript(context);
     PyObject* pCompiledFn = Py_CompileString(script.c_str() , "" , Py_file_input) ;
     if(pCompiledFn == NULL)
@@ -252,29 +296,45 @@ void terrama2::services::analysis::core::python::runScriptGridAnalysis(PyThreadS
 
     auto pValueAnalysis = PyInt_FromLong(analysisHashCode);
 
-    for(int row : rows)
+    const auto& bandNames = analysis->outputGridPtr->bandNames;
+    std::vector<double> bandValues;
+    for(const auto& tile : tiles)
     {
-      for(int col = 0; col < nCols; ++col)
+      for(uint32_t row = tile.firstRow; row < tile.lastRow; ++row)
       {
-        auto pValueRow = PyInt_FromLong(row);
-        auto pValueColumn = PyInt_FromLong(col);
-
-        PyObject* poDict = PyDict_New();
-
-        PyDict_SetItemString(poDict, "analysisHashCode", pValueAnalysis);
-        PyDict_SetItemString(poDict, "row", pValueRow);
-        PyDict_SetItemString(poDict, "column", pValueColumn);
-        state->dict = poDict;
-
-
-        boost::python::object result = analysisFunction(analysisHashCode, row, col);
-        double value = boost::python::extract<double>(result);
-        if(std::isnan(value))
-          outputRaster->setValue(col, row, analysis->outputGridPtr->interpolationDummy);
-        else
-          outputRaster->setValue(col, row, value);
-
-        Py_DECREF(poDict);
+        for(uint32_t col = tile.firstColumn; col < tile.lastColumn; ++col)
+        {
+          // inactive cells are filled with the dummy value before the execution
+          if(!context->isActive(row, col))
+            continue;
+
+          auto pValueRow = PyInt_FromLong(row);
+          auto pValueColumn = PyInt_FromLong(col);
+
+          PyObject* poDict = PyDict_New();
+
+          PyDict_SetItemString(poDict, "analysisHashCode", pValueAnalysis);
+          PyDict_SetItemString(poDict, "row", pValueRow);
+          PyDict_SetItemString(poDict, "column", pValueColumn);
+          state->dict = poDict;
+
+
+          boost::python::object result = analysisFunction(analysisHashCode, row, col);
+          if(bandNames.empty())
+          {
+            double value = boost::python::extract<double>(result);
+            outputRaster->setValue(col, row, quantizeOutputValue(*analysis->outputGridPtr, value));
+          }
+          else
+          {
+            // all outputs are computed in the same execution, the inputs are sampled once
+            outputBandValues(result, bandNames, bandValues);
+            for(std::size_t bandIdx = 0; bandIdx < bandValues.size(); ++bandIdx)
+              outputRaster->setValue(col, row, quantizeOutputValue(*analysis->outputGridPtr, bandValues[bandIdx]), bandIdx);
+          }
+
+          Py_DECREF(poDict);
+        }
       }
     }
 
@@ -132,9 +132,9 @@ namespace terrama2
             \brief Run Python script for a grid analysis.
             \param state Python thread state.
             \param analysisHashCode Analysis hash code.
-            \param indexes Vector of row indexes to process.
+            \param tiles Vector of output grid tiles to process, inactive cells are skipped.
           */
-          void runScriptGridAnalysis(PyThreadState* state, terrama2::services::analysis::core::GridContextPtr context, std::vector<uint32_t> rows);
+          void runScriptGridAnalysis(PyThreadState* state, terrama2::services::analysis::core::GridContextPtr context, std::vector<GridTile> tiles);
 
           /*!
             \brief Run Python script for a monitored object analysis.
@@ -149,6 +149,16 @@ namespace terrama2
           */
           void readInfoFromDict(OperatorCache& cache);
 
+          /*!
+            \brief Reads the values of the output bands from the result of the script.
+
+            The result may be a dict with the value of each band name or a sequence with the values in the order of the bands,
+            a single value is the value of the first band. Missing values are NaN.
+
+            \exception PythonInterpreterException Raised if a sequence doesn't have a value for each band.
+          */
+          void outputBandValues(const boost::python::object& result, const std::vector<std::string>& bandNames, std::vector<double>& values);
+
           /*!
             \brief Extracts the error message from Python interpreter.
           */
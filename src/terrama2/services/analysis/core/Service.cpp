@@ -30,9 +30,13 @@
 #include "Service.hpp"
 #include "Exception.hpp"
 #include "DataManager.hpp"
+#include "AnalysisCheckpoint.hpp"
 #include "AnalysisExecutor.hpp"
+#include "GridProvenance.hpp"
+#include "InputVersion.hpp"
 #include "PythonInterpreter.hpp"
 #include "MonitoredObjectContext.hpp"
+#include "OperatorResultCache.hpp"
 #include "../../../core/utility/Raii.hpp"
 #include "../../../core/utility/ServiceManager.hpp"
 #include "../../../core/utility/Logger.hpp"
@@ -51,6 +55,7 @@ terrama2::services::analysis::core::Service::Service(DataManagerPtr dataManager)
   dataManager_(dataManager)
 {
   connectDataManager();
+  connect(&terrama2::core::ServiceManager::getInstance(), &terrama2::core::ServiceManager::serviceUpdated, this, &Service::updateConfiguration);
   mainThreadState_ = PyThreadState_Get();
 }
 
@@ -104,6 +109,16 @@ void terrama2::services::analysis::core::Service::addAnalysis(AnalysisId analysi
         terrama2::core::TimerPtr timer = createTimer(analysis->schedule, analysisId, lastProcess);
         timers_.emplace(analysisId, timer);
 
+        // executions interrupted by a stop of the service are resumed with their original start date
+        if(resumedAnalysis_.insert(analysisId).second)
+        {
+          for(const auto& startTime : AnalysisCheckpoint::pendingExecutions(analysis))
+          {
+            TERRAMA2_LOG_INFO() << tr("Resuming the execution of analysis %1 started at %2.").arg(analysisId).arg(QString::fromStdString(startTime->toString()));
+            analysisQueue_.push_back(std::make_pair(analysisId, startTime));
+            mainLoopCondition_.notify_one();
+          }
+        }
       }
 
       //TODO: Should use the timer and pass the right time of execution
@@ -167,6 +182,12 @@ void terrama2::services::analysis::core::Service::removeAnalysis(AnalysisId anal
       ++rit;
     }
 
+    resumedAnalysis_.erase(analysisId);
+
+    GridProvenance::removeAnalysis(analysisId);
+    AnalysisCheckpoint::removeAnalysis(analysisId);
+    InputVersion::removeAnalysis(analysisId);
+
     TERRAMA2_LOG_INFO() << tr("Analysis %1 removed successfully.").arg(analysisId);
   }
   catch(std::exception& e)
@@ -187,6 +208,26 @@ void terrama2::services::analysis::core::Service::removeAnalysis(AnalysisId anal
   }
 }
 
+void terrama2::services::analysis::core::Service::updateConfiguration(const QJsonObject& obj) noexcept
+{
+  try
+  {
+    if(obj.contains("analysis_provenance_folder"))
+      GridProvenance::setFolder(obj["analysis_provenance_folder"].toString().toStdString());
+    if(obj.contains("analysis_checkpoint_folder"))
+      AnalysisCheckpoint::setFolder(obj["analysis_checkpoint_folder"].toString().toStdString());
+    if(obj.contains("analysis_input_version_folder"))
+      InputVersion::setFolder(obj["analysis_input_version_folder"].toString().toStdString());
+    if(obj.contains("analysis_checkpoint_max_age"))
+      AnalysisCheckpoint::setMaxAge(static_cast<int64_t>(obj["analysis_checkpoint_max_age"].toDouble()));
+  }
+  catch(...)
+  {
+    // exception guard, slots should never emit exceptions.
+    TERRAMA2_LOG_ERROR() << QObject::tr("Unknown exception...");
+  }
+}
+
 void terrama2::services::analysis::core::Service::updateAnalysis(AnalysisId analysisId) noexcept
 {
   //TODO: addAnalysis adds to queue, is this expected?
@@ -287,6 +328,16 @@ void terrama2::services::analysis::core::Service::connectDataManager()
   connect(dataManager_.get(), &DataManager::analysisAdded, this, &Service::addAnalysis);
   connect(dataManager_.get(), &DataManager::analysisRemoved, this, &Service::removeAnalysis);
   connect(dataManager_.get(), &DataManager::analysisUpdated, this, &Service::updateAnalysis);
+
+  // cached operator results are no longer valid if the data series changes
+  connect(dataManager_.get(), &DataManager::dataSeriesUpdated, this, [](terrama2::core::DataSeriesPtr dataSeries)
+  {
+    OperatorResultCache::getInstance().invalidate(dataSeries->id);
+  });
+  connect(dataManager_.get(), &DataManager::dataSeriesRemoved, this, [](DataSeriesId dataSeriesId)
+  {
+    OperatorResultCache::getInstance().invalidate(dataSeriesId);
+  });
 }
 
 void terrama2::services::analysis::core::Service::start(size_t threadNumber)
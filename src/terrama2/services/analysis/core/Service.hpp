@@ -35,9 +35,13 @@
 #include "../../../core/utility/Service.hpp"
 #include "ThreadPool.hpp"
 
+//QT
+#include <QJsonObject>
+
 //STL
 #include <memory>
 #include <map>
+#include <set>
 
 namespace terrama2
 {
@@ -70,16 +74,35 @@ namespace terrama2
 
             /*!
               \brief Adds the analysis to the queue of execution and starts the schedule for future executions.
+
+              Executions with a checkpoint, interrupted by a stop of the service, are queued again with their original start date.
+
               \param analysisId Analysis identifier.
             */
             void addAnalysis(AnalysisId analysisId) noexcept;
 
             /*!
               \brief Removes an analysis from the queue of execution.
+
+              The records and checkpoints kept for the next executions of the analysis are removed.
+
               \param analysisId Analysis identifier.
             */
             void removeAnalysis(AnalysisId analysisId) noexcept;
 
+            /*!
+              \brief Applies the tags of the service configuration specific to the analysis service.
+
+              Valid tags are:
+                - analysis_provenance_folder (optional)
+                - analysis_checkpoint_folder (optional)
+                - analysis_input_version_folder (optional)
+                - analysis_checkpoint_max_age (optional), in seconds, checkpoints of executions that never finished are removed after it
+
+              By default the folders are in the data folder of the service.
+            */
+            void updateConfiguration(const QJsonObject& obj) noexcept;
+
             /*!
               \brief Updates an analysis in the queue of execution.
               \param analysisId Analysis identifier.
@@ -136,6 +159,7 @@ namespace terrama2
 
             PyThreadState* mainThreadState_; //!< Main thread state from Python interpreter.
             std::map<AnalysisId, terrama2::core::TimerPtr> timers_; //!< Map of timers by analysis.
+            std::set<AnalysisId> resumedAnalysis_; //!< Analysis whose interrupted executions were already queued.
             std::vector<std::pair<AnalysisId, std::shared_ptr<te::dt::TimeInstantTZ> > > analysisQueue_; //!< Analysis queue.
             std::shared_ptr<AnalysisLogger> logger_; //!< Analysis process logger.
             DataManagerPtr dataManager_; //!< Data manager.
@@ -38,6 +38,7 @@
 
 // TerraLib
 #include <terralib/common/StringUtils.h>
+#include <terralib/datatype/Enums.h>
 #include <terralib/raster/Reprojection.h>
 #include <terralib/memory/Raster.h>
 #include <terralib/rp/Functions.h>
@@ -46,7 +47,10 @@
 #include <QObject>
 
 //STL
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <limits>
 
 
 terrama2::services::analysis::core::AnalysisType terrama2::services::analysis::core::ToAnalysisType(uint32_t type)
@@ -146,6 +150,116 @@ terrama2::services::analysis::core::InterestAreaType terrama2::services::analysi
   }
 }
 
+terrama2::services::analysis::core::OutputDataType terrama2::services::analysis::core::ToOutputDataType(uint32_t dataType)
+{
+  switch(dataType)
+  {
+    case 1:
+      return OutputDataType::FLOAT64;
+    case 2:
+      return OutputDataType::FLOAT32;
+    case 3:
+      return OutputDataType::INT16;
+    case 4:
+      return OutputDataType::UINT8;
+    default:
+      throw terrama2::InvalidArgumentException() << ErrorDescription(QObject::tr("Invalid output data type"));
+  }
+}
+
+int terrama2::services::analysis::core::getTerraLibDataType(OutputDataType dataType)
+{
+  switch(dataType)
+  {
+    case OutputDataType::FLOAT32:
+      return te::dt::FLOAT_TYPE;
+    case OutputDataType::INT16:
+      return te::dt::INT16_TYPE;
+    case OutputDataType::UINT8:
+      return te::dt::UCHAR_TYPE;
+    case OutputDataType::FLOAT64:
+    default:
+      return te::dt::DOUBLE_TYPE;
+  }
+}
+
+namespace
+{
+  //! Returns true if the value is stored exactly in the pixel type.
+  template<class T>
+  bool isRepresentable(double value)
+  {
+    return value >= static_cast<double>(std::numeric_limits<T>::lowest())
+        && value <= static_cast<double>(std::numeric_limits<T>::max())
+        && static_cast<double>(static_cast<T>(value)) == value;
+  }
+
+  /*!
+    \brief Limits the value to the range of the pixel type, the dummy value is reserved for invalid values.
+
+    A valid value that would be stored as the dummy value is moved to the
+    nearest value of the pixel type on its side of the dummy.
+  */
+  template<class T>
+  double storeOutsideDummy(double stored, double dummy)
+  {
+    const double lowest = static_cast<double>(std::numeric_limits<T>::lowest());
+    const double highest = static_cast<double>(std::numeric_limits<T>::max());
+    double rounded = std::numeric_limits<T>::is_integer ? std::round(stored) : stored;
+
+    // compared as stored, a value rounded to the dummy value is also moved
+    double value = static_cast<double>(static_cast<T>(std::max(lowest, std::min(rounded, highest))));
+    if(value != dummy)
+      return value;
+
+    bool up = dummy == lowest || (stored >= dummy && dummy != highest);
+    if(std::numeric_limits<T>::is_integer)
+      return up ? dummy + 1 : dummy - 1;
+
+    return static_cast<double>(std::nextafter(static_cast<T>(dummy), static_cast<T>(up ? highest : lowest)));
+  }
+}
+
+bool terrama2::services::analysis::core::isValidOutputDummy(const AnalysisOutputGrid& outputGrid)
+{
+  switch(outputGrid.dataType)
+  {
+    case OutputDataType::FLOAT32:
+      return isRepresentable<float>(outputGrid.interpolationDummy);
+    case OutputDataType::INT16:
+      return isRepresentable<int16_t>(outputGrid.interpolationDummy);
+    case OutputDataType::UINT8:
+      return isRepresentable<uint8_t>(outputGrid.interpolationDummy);
+    case OutputDataType::FLOAT64:
+    default:
+      return !std::isnan(outputGrid.interpolationDummy);
+  }
+}
+
+double terrama2::services::analysis::core::quantizeOutputValue(const AnalysisOutputGrid& outputGrid, double value)
+{
+  // the default output stores the values as computed
+  if(outputGrid.dataType == OutputDataType::FLOAT64 && outputGrid.scale == 1 && outputGrid.offset == 0)
+    return value;
+
+  if(std::isnan(value) || outputGrid.scale == 0)
+    return outputGrid.interpolationDummy;
+
+  double stored = (value - outputGrid.offset) / outputGrid.scale;
+  switch(outputGrid.dataType)
+  {
+    case OutputDataType::FLOAT32:
+      return storeOutsideDummy<float>(stored, outputGrid.interpolationDummy);
+    case OutputDataType::INT16:
+      return storeOutsideDummy<int16_t>(stored, outputGrid.interpolationDummy);
+    case OutputDataType::UINT8:
+      return storeOutsideDummy<uint8_t>(stored, outputGrid.interpolationDummy);
+    case OutputDataType::FLOAT64:
+    default:
+      return storeOutsideDummy<double>(stored, outputGrid.interpolationDummy);
+  }
+}
+
 std::unordered_multimap<terrama2::core::DataSetGridPtr, std::shared_ptr<te::rst::Raster> >
 terrama2::services::analysis::core::getGridMap(DataManagerPtr dataManager, DataSeriesId dataSeriesId)
 {
@@ -187,6 +301,8 @@ terrama2::services::analysis::core::getOutputRasterInfo(std::map<std::string, st
   double resx = std::stod(rinfo["MEM_RASTER_RES_X"]);
   double resy = std::stod(rinfo["MEM_RASTER_RES_Y"]);
   double nodata = std::stod(rinfo["MEM_RASTER_NODATA"]);
+  double scale = rinfo.count("MEM_RASTER_SCALE") ? std::stod(rinfo["MEM_RASTER_SCALE"]) : 1.;
+  double offset = rinfo.count("MEM_RASTER_OFFSET") ? std::stod(rinfo["MEM_RASTER_OFFSET"]) : 0.;
 
   te::gm::Envelope* mbr = new te::gm::Envelope(minx, miny, maxx, maxy);
 
@@ -204,6 +320,8 @@ terrama2::services::analysis::core::getOutputRasterInfo(std::map<std::string, st
     ibprop->m_nblocksx = 1;
     ibprop->m_nblocksy = nrows;
     ibprop->m_noDataValue = nodata;
+    ibprop->m_valuesScale = scale;
+    ibprop->m_valuesOffset = offset;
 
     bands.push_back(ibprop);
   }
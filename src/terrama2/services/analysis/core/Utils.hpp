@@ -118,6 +118,32 @@ namespace terrama2
          */
         InterestAreaType ToInterestAreaType(uint32_t interestAreaType);
 
+        /*!
+          \brief Returns a enum with the pixel type of the output grid.
+
+          \param dataType Integer containing the pixel type of the output grid.
+
+          \return The pixel type of the output grid.
+         */
+        OutputDataType ToOutputDataType(uint32_t dataType);
+
+        //! Returns the TerraLib data type of the pixel type of the output grid.
+        int getTerraLibDataType(OutputDataType dataType);
+
+        /*!
+          \brief Converts a value computed by the analysis to the value stored in the output grid.
+
+          The value is quantized with the scale and offset of the output grid,
+          rounded for integer pixel types and limited to the range of the pixel type.
+          Invalid values are stored as the dummy value, the dummy value is never used for valid values.
+
+          FLOAT64 outputs without scale and offset store the values unchanged.
+         */
+        double quantizeOutputValue(const AnalysisOutputGrid& outputGrid, double value);
+
+        //! Returns true if the dummy value of the output grid is stored exactly in the pixel type.
+        bool isValidOutputDummy(const AnalysisOutputGrid& outputGrid);
+
 
 
         /*!
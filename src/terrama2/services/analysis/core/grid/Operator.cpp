@@ -46,12 +46,13 @@ double terrama2::services::analysis::core::grid::getValue(std::shared_ptr<te::rs
   interpolator->getValue(column, row, val, bandIdx);
   auto band = raster->getBand(bandIdx);
 
-  double noData = band->getProperty()->m_noDataValue;
+  const te::rst::BandProperty* bandProperty = band->getProperty();
   double value =  val.real();
-  if(value == noData)
+  if(value == bandProperty->m_noDataValue)
     return NAN;
-  else
-    return value;
+
+  // quantized grids store the values with a scale and offset
+  return value * bandProperty->m_valuesScale + bandProperty->m_valuesOffset;
 }
 
 double terrama2::services::analysis::core::grid::sample(const std::string& dataSeriesName)
@@ -0,0 +1,168 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/services/analysis/core/grid/occurrence/Operator.cpp
+
+  \brief Contains grid analysis operators that rasterize occurrence series.
+
+  \author Paulo R. M. Oliveira
+*/
+
+// TerraMA2
+#include "Operator.hpp"
+#include "../../ContextManager.hpp"
+#include "../../Exception.hpp"
+#include "../../PythonInterpreter.hpp"
+#include "../../../../../core/utility/Logger.hpp"
+
+// TerraLib
+#include <terralib/raster/Raster.h>
+
+// Boost
+#include <boost/algorithm/string/case_conv.hpp>
+
+// STL
+#include <cmath>
+
+
+double terrama2::services::analysis::core::grid::occurrence::operatorImpl(terrama2::services::analysis::core::OccurrenceRasterization type,
+                                                                          const std::string& dataSeriesName, const std::string& dateFilter,
+                                                                          const std::string& attribute, double bandwidth)
+{
+  OperatorCache cache;
+  terrama2::services::analysis::core::python::readInfoFromDict(cache);
+
+  terrama2::services::analysis::core::GridContextPtr context;
+  try
+  {
+    context = ContextManager::getInstance().getGridContext(cache.analysisHashCode);
+  }
+  catch(const terrama2::Exception& e)
+  {
+    TERRAMA2_LOG_ERROR() << boost::get_error_info<terrama2::ErrorDescription>(e)->toStdString();
+    return NAN;
+  }
+
+  // In case an error has already occurred, there is nothing to be done
+  if(!context->getErrors().empty())
+  {
+    return NAN;
+  }
+
+  bool exceptionOccurred = false;
+  double value = NAN;
+
+  //////////////////////////////////////////////////////////////////////////////////////
+  // Save thread state and unlock python interpreter before entering multi-thread zone
+  terrama2::services::analysis::core::python::OperatorLock operatorLock;
+  operatorLock.unlock();
+
+  try
+  {
+    auto dataSeries = context->findDataSeries(dataSeriesName);
+    if(!dataSeries)
+    {
+      QString errMsg(QObject::tr("Could not find a data series with the given name: %1"));
+      errMsg = errMsg.arg(QString::fromStdString(dataSeriesName));
+      throw InvalidDataSeriesException() << terrama2::ErrorDescription(errMsg);
+    }
+
+    auto outputRaster = context->getOutputRaster();
+    if(!outputRaster)
+    {
+      QString errMsg(QObject::tr("Invalid output raster"));
+      throw terrama2::InvalidArgumentException() << terrama2::ErrorDescription(errMsg);
+    }
+
+    auto values = context->getOccurrenceGrid(dataSeries, type, dateFilter, attribute, bandwidth);
+    auto nCols = outputRaster->getNumberOfColumns();
+    value = (*values)[static_cast<std::size_t>(cache.row) * nCols + cache.column];
+  }
+  catch(const terrama2::Exception& e)
+  {
+    context->addError(boost::get_error_info<terrama2::ErrorDescription>(e)->toStdString());
+    exceptionOccurred = true;
+  }
+  catch(const std::exception& e)
+  {
+    context->addError(e.what());
+    exceptionOccurred = true;
+  }
+  catch(...)
+  {
+    QString errMsg = QObject::tr("An unknown exception occurred.");
+    context->addError(errMsg.toStdString());
+    exceptionOccurred = true;
+  }
+
+  // All operations are done, acquires the GIL and set the return value
+  operatorLock.lock();
+
+  if(exceptionOccurred)
+    return NAN;
+
+  return value;
+}
+
+double terrama2::services::analysis::core::grid::occurrence::count(const std::string& dataSeriesName, const std::string& dateFilter)
+{
+  return operatorImpl(OccurrenceRasterization::COUNT, dataSeriesName, dateFilter);
+}
+
+double terrama2::services::analysis::core::grid::occurrence::sum(const std::string& dataSeriesName, const std::string& attribute,
+                                                                 const std::string& dateFilter)
+{
+  return operatorImpl(OccurrenceRasterization::SUM, dataSeriesName, dateFilter, attribute);
+}
+
+double terrama2::services::analysis::core::grid::occurrence::kernelDensity(const std::string& dataSeriesName, double bandwidth,
+                                                                           const std::string& kernel, const std::string& dateFilter,
+                                                                           const std::string& attribute)
+{
+  std::string kernelName = boost::to_lower_copy(kernel);
+
+  OccurrenceRasterization type;
+  if(kernelName == "gaussian")
+    type = OccurrenceRasterization::GAUSSIAN_KERNEL;
+  else if(kernelName == "quartic")
+    type = OccurrenceRasterization::QUARTIC_KERNEL;
+  else
+  {
+    // reported once in the errors of the execution instead of logged for every pixel
+    OperatorCache cache;
+    terrama2::services::analysis::core::python::readInfoFromDict(cache);
+    try
+    {
+      auto context = ContextManager::getInstance().getGridContext(cache.analysisHashCode);
+      QString errMsg(QObject::tr("Invalid kernel function: %1").arg(QString::fromStdString(kernel)));
+      context->addError(errMsg.toStdString());
+    }
+    catch(const terrama2::Exception& e)
+    {
+      TERRAMA2_LOG_ERROR() << boost::get_error_info<terrama2::ErrorDescription>(e)->toStdString();
+    }
+
+    return NAN;
+  }
+
+  return operatorImpl(type, dataSeriesName, dateFilter, attribute, bandwidth);
+}
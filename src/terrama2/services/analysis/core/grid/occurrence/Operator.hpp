@@ -0,0 +1,116 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file terrama2/services/analysis/core/grid/occurrence/Operator.hpp
+
+  \brief Contains grid analysis operators that rasterize occurrence series.
+
+  \author Paulo R. M. Oliveira
+*/
+
+
+#ifndef __TERRAMA2_SERVICES_ANALYSIS_CORE_GRID_OCCURRENCE_OPERATOR_HPP__
+#define __TERRAMA2_SERVICES_ANALYSIS_CORE_GRID_OCCURRENCE_OPERATOR_HPP__
+
+// TerraMA2
+#include "../../Analysis.hpp"
+#include "../../GridContext.hpp"
+
+// STL
+#include <string>
+
+
+namespace terrama2
+{
+  namespace services
+  {
+    namespace analysis
+    {
+      namespace core
+      {
+        namespace grid
+        {
+          namespace occurrence
+          {
+            /*!
+              \brief Implementation of grid occurrence operators.
+
+              The occurrence series is rasterized in the output grid in a single pass on the first call
+              and the value of the current pixel is read from the rasterized grid.
+
+              In case of an error it will return NAN(Not A Number).
+
+              \param type The rasterization type.
+              \param dataSeriesName DataSeries name.
+              \param dateFilter Time filter for the data.
+              \param attribute Attribute to be summed or used as weight.
+              \param bandwidth Kernel bandwidth in the units of the output grid SRID.
+
+              \return A double value with the result.
+            */
+            double operatorImpl(terrama2::services::analysis::core::OccurrenceRasterization type,
+                                const std::string& dataSeriesName, const std::string& dateFilter,
+                                const std::string& attribute = "", double bandwidth = 0.);
+
+            /*!
+              \brief Returns the number of occurrences in the current pixel.
+
+              \param dataSeriesName DataSeries name.
+              \param dateFilter Time filter for the data.
+
+              \return The number of occurrences in the current pixel.
+            */
+            double count(const std::string& dataSeriesName, const std::string& dateFilter = "");
+
+            /*!
+              \brief Returns the sum of the attribute of the occurrences in the current pixel.
+
+              \param dataSeriesName DataSeries name.
+              \param attribute Name of the attribute.
+              \param dateFilter Time filter for the data.
+
+              \return The sum of the attribute in the current pixel.
+            */
+            double sum(const std::string& dataSeriesName, const std::string& attribute, const std::string& dateFilter = "");
+
+            /*!
+              \brief Returns the kernel density of the occurrences in the current pixel.
+
+              \param dataSeriesName DataSeries name.
+              \param bandwidth Kernel bandwidth in the units of the output grid SRID.
+              \param kernel Kernel function, "gaussian" or "quartic".
+              \param dateFilter Time filter for the data.
+              \param attribute Attribute used as weight of each occurrence, if empty each occurrence weights one.
+
+              \return The density in the current pixel, per squared unit of the output grid SRID.
+            */
+            double kernelDensity(const std::string& dataSeriesName, double bandwidth, const std::string& kernel = "gaussian",
+                                 const std::string& dateFilter = "", const std::string& attribute = "");
+
+          } // end namespace occurrence
+        }   // end namespace grid
+      }     // end namespace core
+    }       // end namespace analysis
+  }         // end namespace services
+}           // end namespace terrama2
+
+#endif // __TERRAMA2_SERVICES_ANALYSIS_CORE_GRID_OCCURRENCE_OPERATOR_HPP__
@@ -34,6 +34,7 @@
 #include "../../PythonInterpreter.hpp"
 #include "../../ContextManager.hpp"
 #include "../../MonitoredObjectContext.hpp"
+#include "../../OperatorResultCache.hpp"
 
 #include <QTextStream>
 
@@ -47,6 +48,9 @@
 #include <terralib/geometry/Utils.h>
 #include <terralib/raster/PositionIterator.h>
 
+// STL
+#include <exception>
+
 void terrama2::services::analysis::core::grid::zonal::appendValues(te::rst::Raster* raster, te::gm::Polygon* polygon, std::vector<double>& values)
 {
   //raster values can always be read as double
@@ -64,15 +68,74 @@ void terrama2::services::analysis::core::grid::zonal::appendValues(te::rst::Rast
   }
 }
 
+terrama2::services::analysis::core::OperatorCache
+terrama2::services::analysis::core::grid::zonal::computeStatistics(terrama2::services::analysis::core::MonitoredObjectContextPtr context,
+    terrama2::core::DataSeriesPtr dataSeries, std::shared_ptr<te::gm::Geometry> geomResult,
+    const std::string& dateDiscardBefore, const std::string& dateDiscardAfter)
+{
+  OperatorCache cache;
+
+  auto datasets = dataSeries->datasetList;
+  for(auto dataset : datasets)
+  {
+    auto rasterList = context->getRasterList(dataSeries, dataset->id, dateDiscardBefore, dateDiscardAfter);
+
+    //sanity check, if no date range only the last raster should be returned
+    if(dateDiscardBefore.empty() && rasterList.size() > 1)
+    {
+      //FIXME: should not happen, throw?
+      assert(0);
+    }
+
+    if(rasterList.empty())
+    {
+      QString errMsg(QObject::tr("Invalid raster for dataset: %1").arg(dataset->id));
+      throw terrama2::InvalidArgumentException() << terrama2::ErrorDescription(errMsg);
+    }
+
+    std::vector<double> values;
+    for(auto raster : rasterList)
+    {
+      geomResult->transform(raster->getSRID());
+      //no intersection between the raster and the object geometry
+      if(!raster->getExtent()->intersects(*geomResult->getMBR()))
+        continue;
+
+
+      //TODO: check for other valid types
+      auto type = geomResult->getGeomTypeId();
+      if(type == te::gm::PolygonType)
+      {
+        auto polygon = std::static_pointer_cast<te::gm::Polygon>(geomResult);
+        appendValues(raster.get(), polygon.get(), values);
+      }
+      else if(type == te::gm::MultiPolygonType)
+      {
+        auto multiPolygon = std::static_pointer_cast<te::gm::MultiPolygon>(geomResult);
+        for(auto geom : multiPolygon->getGeometries())
+        {
+          auto polygon = static_cast<te::gm::Polygon*>(geom);
+          appendValues(raster.get(), polygon, values);
+        }
+      }
+    }
+
+    if(!values.empty())
+    {
+      terrama2::services::analysis::core::calculateStatistics(values, cache);
+      break;
+    }
+  }
+
+  return cache;
+}
+
 double terrama2::services::analysis::core::grid::zonal::operatorImpl(terrama2::services::analysis::core::StatisticOperation statisticOperation,
     const std::string& dataSeriesName, const std::string& dateDiscardBefore, const std::string& dateDiscardAfter, terrama2::services::analysis::core::Buffer buffer)
 {
 
   OperatorCache cache;
   terrama2::services::analysis::core::python::readInfoFromDict(cache);
-  // After the operator lock is released it's not allowed to return any value because it doesn' have the interpreter lock.
-  // In case an exception is thrown, we need to set this boolean. Once the code left the lock is acquired we should return NAN.
-  bool exceptionOccurred = false;
 
   terrama2::services::analysis::core::MonitoredObjectContextPtr context;
   try
@@ -134,63 +197,52 @@ double terrama2::services::analysis::core::grid::zonal::operatorImpl(terrama2::s
       throw InvalidDataSeriesException() << terrama2::ErrorDescription(errMsg);
     }
 
-    auto datasets = dataSeries->datasetList;
-    for(auto dataset : datasets)
+    terrama2::services::analysis::core::OperatorResultKey key;
+    key.operatorName = "grid.zonal";
+    key.dataSeriesId = dataSeries->id;
+    // relative filters read different data in executions with different start times
+    key.dateWindow = context->getDateWindow(dateDiscardBefore, dateDiscardAfter);
+    key.buffer = buffer;
+    key.monitoredObjectId = moDsContext->series.dataSet->dataSeriesId;
+    key.geometryId = geomId;
+
+    // Frees the GIL, from now on it's not allowed to return any value because it doesn't have the interpreter lock.
+    // In case an exception is thrown, we need to catch it and rethrow it
+    // once the lock is acquired again.
+    std::exception_ptr exceptionPtr;
+    terrama2::services::analysis::core::python::OperatorLock operatorLock;
+    operatorLock.unlock();
+
+    try
     {
-      auto rasterList = context->getRasterList(dataSeries, dataset->id, dateDiscardBefore, dateDiscardAfter);
-
-      //sanity check, if no date range only the last raster should be returned
-      if(dateDiscardBefore.empty() && rasterList.size() > 1)
-      {
-        //FIXME: should not happen, throw?
-        assert(0);
-      }
+      key.dataVersion = context->getDataVersion(dataSeries, dateDiscardBefore, dateDiscardAfter);
 
-      if(rasterList.empty())
+      // analyses with the same inputs share the result
+      auto result = OperatorResultCache::getInstance().get(key, [&]()
       {
-        QString errMsg(QObject::tr("Invalid raster for dataset: %1").arg(dataset->id));
-        throw terrama2::InvalidArgumentException() << terrama2::ErrorDescription(errMsg);
-      }
-
-      std::vector<double> values;
-      for(auto raster : rasterList)
-      {
-        geomResult->transform(raster->getSRID());
-        //no intersection between the raster and the object geometry
-        if(!raster->getExtent()->intersects(*geomResult->getMBR()))
-          continue;
-
-
-        //TODO: check for other valid types
-        auto type = geomResult->getGeomTypeId();
-        if(type == te::gm::PolygonType)
-        {
-          auto polygon = std::static_pointer_cast<te::gm::Polygon>(geomResult);
-          appendValues(raster.get(), polygon.get(), values);
-        }
-        else if(type == te::gm::MultiPolygonType)
-        {
-          auto multiPolygon = std::static_pointer_cast<te::gm::MultiPolygon>(geomResult);
-          for(auto geom : multiPolygon->getGeometries())
-          {
-            auto polygon = static_cast<te::gm::Polygon*>(geom);
-            appendValues(raster.get(), polygon, values);
-          }
-        }
-      }
-
-      if(!values.empty())
-      {
-        terrama2::services::analysis::core::calculateStatistics(values, cache);
-        hasData = true;
-      }
-
-      if(hasData)
-        break;
+        return computeStatistics(context, dataSeries, geomResult, dateDiscardBefore, dateDiscardAfter);
+      });
+
+      cache.sum = result.sum;
+      cache.max = result.max;
+      cache.min = result.min;
+      cache.median = result.median;
+      cache.mean = result.mean;
+      cache.standardDeviation = result.standardDeviation;
+      cache.variance = result.variance;
+      cache.count = result.count;
+      hasData = result.count > 0;
+    }
+    catch(...)
+    {
+      exceptionPtr = std::current_exception();
     }
 
-    if(exceptionOccurred)
-      return NAN;
+    // All operations are done, acquires the GIL and set the return value
+    operatorLock.lock();
+
+    if(exceptionPtr)
+      std::rethrow_exception(exceptionPtr);
 
     if(!hasData && statisticOperation != StatisticOperation::COUNT)
     {
@@ -35,6 +35,8 @@
 #include "../../Analysis.hpp"
 #include "../../Utils.hpp"
 #include "../../BufferMemory.hpp"
+#include "../../OperatorCache.hpp"
+#include "../../Shared.hpp"
 
 // STL
 #include <string>
@@ -166,6 +168,19 @@ namespace terrama2
               \brief Populates the vector \e values with the values of the pixels inside the \e polygon area.
             */
             void appendValues(te::rst::Raster* raster, te::gm::Polygon* polygon, std::vector<double>& values);
+
+            /*!
+              \brief Calculates the statistics of the pixels inside the geometry for the first dataset with data.
+
+              The GIL must not be held when calling this method.
+
+              \return The statistics, count is zero if there is no data.
+            */
+            OperatorCache computeStatistics(MonitoredObjectContextPtr context,
+                                            terrama2::core::DataSeriesPtr dataSeries,
+                                            std::shared_ptr<te::gm::Geometry> geomResult,
+                                            const std::string& dateDiscardBefore,
+                                            const std::string& dateDiscardAfter);
           } /* zonal */
         }   // end namespace grid
       }     // end namespace core
@@ -40,6 +40,7 @@
 #include "../../../core/data-access/DataAccessor.hpp"
 #include "../../../core/data-access/DataAccessorGrid.hpp"
 #include "../../../core/data-access/GridSeries.hpp"
+#include "../../../core/Exception.hpp"
 #include "../../../Exception.hpp"
 
 // QT
@@ -58,6 +59,7 @@
 #include <terralib/memory/DataSetItem.h>
 #include <terralib/memory/DataSet.h>
 #include <terralib/geometry/GeometryProperty.h>
+#include <terralib/geometry/Utils.h>
 #include <terralib/vp/IntersectionOp.h>
 #include <terralib/vp/IntersectionMemory.h>
 #include <terralib/vp/Utils.h>
@@ -357,7 +359,30 @@ terrama2::core::DataSetSeries terrama2::services::collector::core::processGridIn
   terrama2::core::Filter filter;
   filter.lastValue = true;
 
-  auto gridSeries = accessorGrid->getGridSeries(filter);
+  // only the pixels of the grid in the extent of the collected data are read
+  if(collectedData->size() > 0)
+  {
+    std::unique_ptr<te::gm::Envelope> extent(collectedData->dataset()->getExtent(geomPropertyPos).release());
+    if(extent && extent->isValid())
+      filter.region.reset(te::gm::GetGeomFromEnvelope(extent.get(), geomProperty->getSRID()));
+  }
+
+  terrama2::core::GridSeriesPtr gridSeries;
+  try
+  {
+    gridSeries = accessorGrid->getGridSeries(filter);
+  }
+  catch(const terrama2::core::NoDataException&)
+  {
+    if(!filter.region)
+      throw;
+
+    // no grid in the extent of the collected data,
+    // the complete grid is still needed to create the band properties
+    filter.region.reset();
+    gridSeries = accessorGrid->getGridSeries(filter);
+  }
+
   auto gridMap = gridSeries->gridMap();
 
   for(auto it = gridMap.begin(); it != gridMap.end(); ++it)
@@ -45,8 +45,13 @@
 #include "../../../core/utility/Logger.hpp"
 #include "../../../core/utility/DataAccessorFactory.hpp"
 #include "../../../core/utility/DataStoragerFactory.hpp"
+#include "../../../core/utility/FileCatalog.hpp"
+#include "../../../core/utility/FileWatcher.hpp"
 #include "../../../core/utility/ServiceManager.hpp"
 
+// Qt
+#include <QUrl>
+
 terrama2::services::collector::core::Service::Service(std::weak_ptr<terrama2::services::collector::core::DataManager> dataManager)
   : dataManager_(dataManager)
 {
@@ -169,6 +174,10 @@ void terrama2::services::collector::core::Service::collect(CollectorId collector
       filter.discardBefore = lastCollectedDataTimestamp;
 
     auto dataAccessor = terrama2::core::DataAccessorFactory::getInstance().make(inputDataProvider, inputDataSeries);
+    // files collected before are not read again
+    auto fileCatalog = std::make_shared<terrama2::core::FileCatalog>(terrama2::core::FileCatalog::defaultPath(collectorPtr->id));
+    dataAccessor->setFileCatalog(fileCatalog);
+
     auto dataMap = dataAccessor->getSeries(filter);
     if(dataMap.empty())
     {
@@ -201,6 +210,9 @@ void terrama2::services::collector::core::Service::collect(CollectorId collector
       dataStorager->store(item.second, *outputDataSet);
     }
 
+    // the files are registered only after the data is stored
+    fileCatalog->save();
+
     TERRAMA2_LOG_INFO() << tr("Data from collector %1 collected successfully.").arg(collectorId);
 
     if(logger.get())
@@ -292,6 +304,27 @@ void terrama2::services::collector::core::Service::addCollector(CollectorPtr col
       TERRAMA2_LOG_ERROR() << e.what();
     }
 
+    try
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+
+      watchers_.erase(collector->id);
+      if(collector->active)
+      {
+        auto watcher = createFileWatcher(collector);
+        if(watcher)
+          watchers_.emplace(collector->id, watcher);
+      }
+    }
+    catch(const boost::exception& e)
+    {
+      TERRAMA2_LOG_ERROR() << boost::get_error_info<terrama2::ErrorDescription>(e);
+    }
+    catch(const std::exception& e)
+    {
+      TERRAMA2_LOG_ERROR() << e.what();
+    }
+
     addToQueue(collector->id);
   }
   catch(...)
@@ -319,6 +352,8 @@ void terrama2::services::collector::core::Service::removeCollector(CollectorId c
       timers_.erase(collectorId);
     }
 
+    watchers_.erase(collectorId);
+
     // remove from queue
     collectorQueue_.erase(std::remove(collectorQueue_.begin(), collectorQueue_.end(), collectorId), collectorQueue_.end());
 
@@ -347,3 +382,54 @@ void terrama2::services::collector::core::Service::updateCollector(CollectorPtr
   //TODO: addCollector adds to queue, is this expected?
   addCollector(collector);
 }
+
+terrama2::core::FileWatcherPtr terrama2::services::collector::core::Service::createFileWatcher(CollectorPtr collector)
+{
+  auto dataManager = dataManager_.lock();
+  if(!dataManager.get())
+    return nullptr;
+
+  auto lock = dataManager->getLock();
+  auto dataSeries = dataManager->findDataSeries(collector->inputDataSeries);
+  auto dataProvider = dataManager->findDataProvider(dataSeries->dataProviderId);
+  lock.unlock();
+
+  // only local folders can be watched
+  if(dataProvider->dataProviderType != "FILE" || !dataProvider->active)
+    return nullptr;
+
+  QUrl url(QString::fromStdString(dataProvider->uri));
+
+  std::vector<terrama2::core::FileWatcher::Folder> folders;
+  for(const auto& dataSet : dataSeries->datasetList)
+  {
+    if(!dataSet->active)
+      continue;
+
+    auto mask = dataSet->format.find("mask");
+    if(mask == dataSet->format.end())
+      continue;
+
+    terrama2::core::FileWatcher::Folder folder;
+    folder.path = url.path().toStdString();
+    folder.mask = mask->second;
+
+    auto dataSetFolder = dataSet->format.find("folder");
+    if(dataSetFolder != dataSet->format.end() && !dataSetFolder->second.empty())
+      folder.path += "/" + dataSetFolder->second;
+
+    auto timezone = dataSet->format.find("timezone");
+    if(timezone != dataSet->format.end() && !timezone->second.empty())
+      folder.timezone = timezone->second;
+
+    folders.push_back(folder);
+  }
+
+  if(folders.empty())
+    return nullptr;
+
+  auto watcher = std::make_shared<terrama2::core::FileWatcher>(collector->id, folders);
+  connect(watcher.get(), &terrama2::core::FileWatcher::fileReadySignal, this, &terrama2::core::Service::addToQueue, Qt::UniqueConnection);
+
+  return watcher;
+}
@@ -113,9 +113,20 @@ namespace terrama2
             //! Connects signals from DataManager
             void connectDataManager();
 
+            /*!
+              \brief Creates a watcher of the folders of the input data series of the collector.
+
+              New files in local folders are collected as soon as they are complete,
+              the timer remains as a fallback.
+
+              \return The watcher or nullptr if the input data provider is not a local folder.
+            */
+            terrama2::core::FileWatcherPtr createFileWatcher(CollectorPtr collector);
+
             std::weak_ptr<DataManager> dataManager_; //!< Weak pointer to the DataManager
 
             std::map<CollectorId, terrama2::core::TimerPtr> timers_;//!< List of running Collector timers
+            std::map<CollectorId, terrama2::core::FileWatcherPtr> watchers_;//!< List of Collector folder watchers
             std::deque<CollectorId> collectorQueue_;//!< Collector queue
             std::shared_ptr< CollectorLogger > logger_;//!< process logger
         };
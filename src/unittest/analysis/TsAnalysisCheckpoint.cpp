@@ -0,0 +1,259 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file unittest/analysis/TsAnalysisCheckpoint.cpp
+
+  \brief Tests for the checkpoint of analysis executions
+
+  \author Jano Simas
+*/
+
+#include "TsAnalysisCheckpoint.hpp"
+
+//TerraMA2
+#include <terrama2/core/utility/TimeUtils.hpp>
+#include <terrama2/services/analysis/core/Analysis.hpp>
+#include <terrama2/services/analysis/core/AnalysisCheckpoint.hpp>
+#include <terrama2/services/analysis/core/DataManager.hpp>
+#include <terrama2/services/analysis/core/GridContext.hpp>
+#include <terrama2/services/analysis/core/MonitoredObjectContext.hpp>
+
+//TerraLib
+#include <terralib/geometry/LinearRing.h>
+#include <terralib/geometry/Polygon.h>
+
+//QT
+#include <QTemporaryDir>
+
+using namespace terrama2::services::analysis::core;
+
+namespace
+{
+  //! Grid analysis of a 10x10 output with 16 bits integer bands.
+  AnalysisPtr gridAnalysis()
+  {
+    auto ring = new te::gm::LinearRing(5, te::gm::LineStringType, 4326);
+    ring->setPoint(0, 0, 0);
+    ring->setPoint(1, 10, 0);
+    ring->setPoint(2, 10, 10);
+    ring->setPoint(3, 0, 10);
+    ring->setPoint(4, 0, 0);
+
+    auto interestArea = std::make_shared<te::gm::Polygon>(0, te::gm::PolygonType, 4326);
+    interestArea->push_back(ring);
+
+    auto outputGrid = std::make_shared<AnalysisOutputGrid>();
+    outputGrid->interpolationMethod = InterpolationMethod::NEARESTNEIGHBOR;
+    outputGrid->interpolationDummy = -1;
+    outputGrid->resolutionType = ResolutionType::CUSTOM;
+    outputGrid->resolutionDataSeriesId = 0;
+    outputGrid->resolutionX = 1;
+    outputGrid->resolutionY = 1;
+    outputGrid->interestAreaType = InterestAreaType::CUSTOM;
+    outputGrid->interestAreaBox = interestArea;
+    outputGrid->dataType = OutputDataType::INT16;
+    outputGrid->bandNames = {"a", "b"};
+
+    auto analysis = std::make_shared<Analysis>();
+    analysis->id = 4;
+    analysis->script = "return 1";
+    analysis->type = AnalysisType::GRID_TYPE;
+    analysis->outputGridPtr = outputGrid;
+
+    return analysis;
+  }
+}
+
+void TsAnalysisCheckpoint::testChunkSize()
+{
+  // small executions fit in one chunk
+  QVERIFY(AnalysisCheckpoint::chunkSize(100, 8) >= 100);
+
+  // at most 50 chunks
+  std::size_t chunkSize = AnalysisCheckpoint::chunkSize(1000000, 8);
+  QVERIFY((1000000 + chunkSize - 1) / chunkSize <= 50);
+
+  QCOMPARE(AnalysisCheckpoint::chunkSize(0, 0), static_cast<std::size_t>(1));
+}
+
+void TsAnalysisCheckpoint::testResumeObjects()
+{
+  QTemporaryDir folder;
+  QVERIFY(folder.isValid());
+  AnalysisCheckpoint::setFolder(folder.path().toStdString());
+
+  auto analysis = std::make_shared<Analysis>();
+  analysis->id = 3;
+  analysis->script = "add_value(\"max\", 1)";
+  analysis->type = AnalysisType::MONITORED_OBJECT_TYPE;
+
+  auto startTime = terrama2::core::TimeUtils::nowUTC();
+  const std::vector<uint32_t> indexes = {0, 1, 2, 3};
+
+  {
+    auto context = std::make_shared<MonitoredObjectContext>(nullptr, analysis, startTime);
+    AnalysisCheckpoint checkpoint(analysis, startTime);
+    QVERIFY(checkpoint.restoreObjects({"a", "b", "c", "d"}, context) == indexes);
+
+    // the first chunk completed before the interruption
+    context->addAttribute("max");
+    context->setAnalysisResult("a", "max", 1);
+    context->setAnalysisResult("b", "max", 2);
+    context->setAnalysisResult("c", "max", 3);
+    checkpoint.saveObjects({"a", "b"}, context);
+  }
+
+  {
+    // the rows are read in another order
+    auto context = std::make_shared<MonitoredObjectContext>(nullptr, analysis, startTime);
+    AnalysisCheckpoint checkpoint(analysis, startTime);
+    std::vector<uint32_t> remaining = {0, 3};
+    QVERIFY(checkpoint.restoreObjects({"c", "b", "a", "d"}, context) == remaining);
+
+    auto result = context->analysisResult();
+    QCOMPARE(result.size(), static_cast<std::size_t>(2));
+    QCOMPARE(result["b"]["max"], 2.);
+    QVERIFY(context->getAttributes().count("max") == 1);
+  }
+
+  {
+    // objects removed from the dataset are not restored
+    auto context = std::make_shared<MonitoredObjectContext>(nullptr, analysis, startTime);
+    AnalysisCheckpoint checkpoint(analysis, startTime);
+    std::vector<uint32_t> remaining = {0, 2};
+    QVERIFY(checkpoint.restoreObjects({"c", "a", "d"}, context) == remaining);
+
+    auto result = context->analysisResult();
+    QCOMPARE(result.size(), static_cast<std::size_t>(1));
+    QCOMPARE(result["a"]["max"], 1.);
+  }
+
+  {
+    // another configuration can't resume the execution
+    auto changed = std::make_shared<Analysis>(*analysis);
+    changed->script = "add_value(\"max\", 2)";
+
+    auto context = std::make_shared<MonitoredObjectContext>(nullptr, changed, startTime);
+    AnalysisCheckpoint checkpoint(changed, startTime);
+    QVERIFY(checkpoint.restoreObjects({"a", "b", "c", "d"}, context) == indexes);
+    QVERIFY(context->analysisResult().empty());
+
+    checkpoint.remove();
+  }
+}
+
+void TsAnalysisCheckpoint::testResumeTiles()
+{
+  QTemporaryDir folder;
+  QVERIFY(folder.isValid());
+  AnalysisCheckpoint::setFolder(folder.path().toStdString());
+
+  auto dataManager = std::make_shared<DataManager>();
+  auto analysis = gridAnalysis();
+  auto startTime = terrama2::core::TimeUtils::nowUTC();
+
+  std::vector<GridTile> tiles;
+  {
+    auto context = std::make_shared<GridContext>(dataManager, analysis, startTime);
+    tiles = context->getActiveTiles();
+    QCOMPARE(tiles.size(), static_cast<std::size_t>(10));
+
+    AnalysisCheckpoint checkpoint(analysis, startTime);
+    QCOMPARE(checkpoint.restoreTiles(tiles, context).size(), tiles.size());
+
+    // the first five rows completed before the interruption
+    auto outputRaster = context->getOutputRaster();
+    for(std::size_t bandIdx = 0; bandIdx < 2; ++bandIdx)
+      for(uint32_t row = 0; row < 5; ++row)
+        for(uint32_t col = 0; col < 10; ++col)
+          outputRaster->setValue(col, row, 1000. * bandIdx + row * 10 + col + 300, bandIdx);
+
+    checkpoint.saveTiles(std::vector<GridTile>(tiles.begin(), tiles.begin() + 5), context);
+  }
+
+  {
+    auto context = std::make_shared<GridContext>(dataManager, analysis, startTime);
+    AnalysisCheckpoint checkpoint(analysis, startTime);
+    auto remaining = checkpoint.restoreTiles(tiles, context);
+    QCOMPARE(remaining.size(), static_cast<std::size_t>(5));
+    QCOMPARE(remaining.front().firstRow, 5u);
+
+    auto outputRaster = context->getOutputRaster();
+    double value = 0;
+    for(std::size_t bandIdx = 0; bandIdx < 2; ++bandIdx)
+    {
+      for(uint32_t row = 0; row < 5; ++row)
+      {
+        for(uint32_t col = 0; col < 10; ++col)
+        {
+          outputRaster->getValue(col, row, value, bandIdx);
+          QCOMPARE(value, 1000. * bandIdx + row * 10 + col + 300);
+        }
+      }
+    }
+
+    checkpoint.remove();
+  }
+}
+
+void TsAnalysisCheckpoint::testPendingExecutions()
+{
+  QTemporaryDir folder;
+  QVERIFY(folder.isValid());
+  AnalysisCheckpoint::setFolder(folder.path().toStdString());
+
+  auto analysis = std::make_shared<Analysis>();
+  analysis->id = 5;
+  analysis->script = "add_value(\"max\", 1)";
+  analysis->type = AnalysisType::MONITORED_OBJECT_TYPE;
+
+  auto startTime = terrama2::core::TimeUtils::nowUTC();
+  QVERIFY(AnalysisCheckpoint::pendingExecutions(analysis).empty());
+
+  {
+    // an execution interrupted after the first chunk
+    auto context = std::make_shared<MonitoredObjectContext>(nullptr, analysis, startTime);
+    AnalysisCheckpoint checkpoint(analysis, startTime);
+    checkpoint.restoreObjects({"a", "b"}, context);
+    context->addAttribute("max");
+    context->setAnalysisResult("a", "max", 1);
+    checkpoint.saveObjects({"a"}, context);
+  }
+
+  // the execution is resumed with its original start date, restoring the saved chunk
+  auto pending = AnalysisCheckpoint::pendingExecutions(analysis);
+  QCOMPARE(pending.size(), static_cast<std::size_t>(1));
+  QVERIFY(pending.front()->getTimeInstantTZ().utc_time() == startTime->getTimeInstantTZ().utc_time());
+
+  {
+    auto context = std::make_shared<MonitoredObjectContext>(nullptr, analysis, pending.front());
+    AnalysisCheckpoint checkpoint(analysis, pending.front());
+    std::vector<uint32_t> remaining = {1};
+    QVERIFY(checkpoint.restoreObjects({"a", "b"}, context) == remaining);
+  }
+
+  // checkpoints of another configuration are discarded
+  auto changed = std::make_shared<Analysis>(*analysis);
+  changed->script = "add_value(\"max\", 2)";
+  QVERIFY(AnalysisCheckpoint::pendingExecutions(changed).empty());
+  QVERIFY(AnalysisCheckpoint::pendingExecutions(analysis).empty());
+}
@@ -0,0 +1,170 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file unittest/analysis/TsBufferMemory.cpp
+
+  \brief Tests for the aggregation of occurrence buffers
+
+  \author Jano Simas
+*/
+
+#include "TsBufferMemory.hpp"
+
+//TerraMA2
+#include <terrama2/Exception.hpp>
+#include <terrama2/core/data-access/SynchronizedDataSet.hpp>
+#include <terrama2/core/data-model/DataSet.hpp>
+#include <terrama2/services/analysis/core/BufferMemory.hpp>
+#include <terrama2/services/analysis/core/MonitoredObjectContext.hpp>
+#include <terrama2/services/analysis/core/Utils.hpp>
+
+//TerraLib
+#include <terralib/dataaccess/dataset/DataSetType.h>
+#include <terralib/datatype/SimpleProperty.h>
+#include <terralib/geometry/GeometryProperty.h>
+#include <terralib/geometry/Point.h>
+#include <terralib/memory/DataSet.h>
+#include <terralib/memory/DataSetItem.h>
+
+//STL
+#include <cmath>
+#include <vector>
+
+using namespace terrama2::services::analysis::core;
+
+namespace
+{
+  /*!
+    \brief Creates a series of point occurrences on the equator with a value attribute.
+
+    At the equator 0.009 degrees of longitude are about one kilometer.
+  */
+  std::shared_ptr<ContextDataSeries> occurrences(const std::vector<std::pair<double, double> >& lonValues)
+  {
+    std::shared_ptr<te::da::DataSetType> dataSetType(new te::da::DataSetType("occurrences"));
+    auto geomProperty = new te::gm::GeometryProperty("geom", 0, te::gm::PointType, true);
+    geomProperty->setSRID(4326);
+    dataSetType->add(geomProperty);
+    dataSetType->add(new te::dt::SimpleProperty("value", te::dt::DOUBLE_TYPE, true));
+
+    std::shared_ptr<te::mem::DataSet> dataSet(new te::mem::DataSet(dataSetType.get()));
+    for(const auto& lonValue : lonValues)
+    {
+      auto item = new te::mem::DataSetItem(dataSet.get());
+      item->setGeometry(0, new te::gm::Point(lonValue.first, 0., 4326));
+      item->setDouble(1, lonValue.second);
+      dataSet->add(item);
+    }
+
+    auto contextDataSeries = std::make_shared<ContextDataSeries>();
+    contextDataSeries->series.dataSet = std::make_shared<terrama2::core::DataSet>();
+    contextDataSeries->series.syncDataSet = std::make_shared<terrama2::core::SynchronizedDataSet>(dataSet);
+    contextDataSeries->series.teDataSetType = dataSetType;
+    contextDataSeries->geometryPos = 0;
+
+    return contextDataSeries;
+  }
+
+  std::vector<double> aggregatedValues(std::shared_ptr<te::mem::DataSet> dataSet)
+  {
+    std::vector<double> values;
+    dataSet->moveBeforeFirst();
+    while(dataSet->moveNext())
+    {
+      // an aggregation without geometry fails the comparisons
+      values.push_back(dataSet->isNull(0) ? std::nan("") : dataSet->getDouble(1));
+    }
+
+    return values;
+  }
+}
+
+void TsBufferMemory::testAggregation()
+{
+  // the first two occurrences are one kilometer apart, the third is far away
+  auto contextDataSeries = occurrences({{-45., 1.}, {-44.991, 2.}, {-44., 4.}});
+  std::vector<uint32_t> indexes = {0, 1, 2};
+
+  Buffer buffer(ONLY_BUFFER, 1, "km");
+  auto dataSet = createAggregationBuffer(indexes, contextDataSeries, buffer, StatisticOperation::SUM, "value");
+
+  auto values = aggregatedValues(dataSet);
+  QCOMPARE(values.size(), static_cast<std::size_t>(2));
+  QCOMPARE(values[0], 3.);
+  QCOMPARE(values[1], 4.);
+
+  dataSet = createAggregationBuffer(indexes, contextDataSeries, buffer, StatisticOperation::MAX, "value");
+  values = aggregatedValues(dataSet);
+  QCOMPARE(values[0], 2.);
+  QCOMPARE(values[1], 4.);
+
+  // buffers of 400m don't intersect
+  Buffer smallBuffer(ONLY_BUFFER, 400, "m");
+  dataSet = createAggregationBuffer(indexes, contextDataSeries, smallBuffer, StatisticOperation::COUNT, "");
+  values = aggregatedValues(dataSet);
+  QCOMPARE(values, std::vector<double>({1., 1., 1.}));
+}
+
+void TsBufferMemory::testBridgedAggregation()
+{
+  // the first two occurrences are more than two kilometers apart,
+  // the third one is close to both and merges their aggregations
+  auto contextDataSeries = occurrences({{-45., 1.}, {-44.97, 2.}, {-44.985, 3.}});
+  std::vector<uint32_t> indexes = {0, 1, 2};
+
+  Buffer buffer(ONLY_BUFFER, 1, "km");
+  auto dataSet = createAggregationBuffer(indexes, contextDataSeries, buffer, StatisticOperation::COUNT, "");
+  QCOMPARE(aggregatedValues(dataSet), std::vector<double>({3.}));
+
+  dataSet = createAggregationBuffer(indexes, contextDataSeries, buffer, StatisticOperation::MEDIAN, "value");
+  QCOMPARE(aggregatedValues(dataSet), std::vector<double>({2.}));
+
+  indexes = {0, 1};
+  dataSet = createAggregationBuffer(indexes, contextDataSeries, buffer, StatisticOperation::COUNT, "");
+  QCOMPARE(aggregatedValues(dataSet), std::vector<double>({1., 1.}));
+}
+
+void TsBufferMemory::testIndexes()
+{
+  auto contextDataSeries = occurrences({{-45., 1.}, {-44., 2.}, {-43., 5.}});
+  Buffer buffer(ONLY_BUFFER, 1, "km");
+
+  // values come from the dataset rows listed, not from the position in the list
+  std::vector<uint32_t> indexes = {2};
+  auto dataSet = createAggregationBuffer(indexes, contextDataSeries, buffer, StatisticOperation::SUM, "value");
+  QCOMPARE(aggregatedValues(dataSet), std::vector<double>({5.}));
+
+  indexes.clear();
+  QVERIFY(!createAggregationBuffer(indexes, contextDataSeries, buffer, StatisticOperation::SUM, "value"));
+}
+
+void TsBufferMemory::testInvalidAttribute()
+{
+  auto contextDataSeries = occurrences({{-45., 1.}});
+  std::vector<uint32_t> indexes = {0};
+  Buffer buffer(ONLY_BUFFER, 1, "km");
+
+  QVERIFY_EXCEPTION_THROWN(createAggregationBuffer(indexes, contextDataSeries, buffer, StatisticOperation::SUM, ""),
+                           terrama2::InvalidArgumentException);
+  QVERIFY_EXCEPTION_THROWN(createAggregationBuffer(indexes, contextDataSeries, buffer, StatisticOperation::SUM, "missing"),
+                           terrama2::InvalidArgumentException);
+}
@@ -0,0 +1,166 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file unittest/analysis/TsGridContext.cpp
+
+  \brief Tests for the sparse execution of grid analyses
+
+  \author Jano Simas
+*/
+
+#include "TsGridContext.hpp"
+
+//TerraMA2
+#include <terrama2/core/utility/TimeUtils.hpp>
+#include <terrama2/services/analysis/core/Analysis.hpp>
+#include <terrama2/services/analysis/core/DataManager.hpp>
+#include <terrama2/services/analysis/core/GridContext.hpp>
+
+//TerraLib
+#include <terralib/geometry/LinearRing.h>
+#include <terralib/geometry/Polygon.h>
+#include <terralib/raster/Raster.h>
+
+using namespace terrama2::services::analysis::core;
+
+namespace
+{
+  /*!
+    \brief Creates a grid analysis with an L shaped interest area in a 10x10 grid of one degree cells.
+
+    The cells with center inside the area are the ones in the four bottom rows or in the four left columns.
+  */
+  AnalysisPtr sparseAnalysis()
+  {
+    auto ring = new te::gm::LinearRing(7, te::gm::LineStringType, 4326);
+    ring->setPoint(0, 0, 0);
+    ring->setPoint(1, 10, 0);
+    ring->setPoint(2, 10, 4);
+    ring->setPoint(3, 4, 4);
+    ring->setPoint(4, 4, 10);
+    ring->setPoint(5, 0, 10);
+    ring->setPoint(6, 0, 0);
+
+    auto interestArea = std::make_shared<te::gm::Polygon>(0, te::gm::PolygonType, 4326);
+    interestArea->push_back(ring);
+
+    auto outputGrid = std::make_shared<AnalysisOutputGrid>();
+    outputGrid->interpolationMethod = InterpolationMethod::NEARESTNEIGHBOR;
+    outputGrid->interpolationDummy = -1;
+    outputGrid->resolutionType = ResolutionType::CUSTOM;
+    outputGrid->resolutionDataSeriesId = 0;
+    outputGrid->resolutionX = 1;
+    outputGrid->resolutionY = 1;
+    outputGrid->interestAreaType = InterestAreaType::CUSTOM;
+    outputGrid->interestAreaBox = interestArea;
+    outputGrid->sparseExecution = true;
+    outputGrid->bandNames = {"a", "b"};
+
+    // additional data doesn't restrict the active cells to the cells with grid data
+    AnalysisDataSeries additionalData;
+    additionalData.dataSeriesId = 1;
+    additionalData.type = AnalysisDataSeriesType::ADDITIONAL_DATA_TYPE;
+
+    auto analysis = std::make_shared<Analysis>();
+    analysis->id = 1;
+    analysis->type = AnalysisType::GRID_TYPE;
+    analysis->outputGridPtr = outputGrid;
+    analysis->analysisDataSeriesList.push_back(additionalData);
+
+    return analysis;
+  }
+
+  bool insideArea(uint32_t row, uint32_t col)
+  {
+    return row >= 6 || col < 4;
+  }
+}
+
+void TsGridContext::testRowTiles()
+{
+  auto dataManager = std::make_shared<DataManager>();
+  GridContext context(dataManager, sparseAnalysis(), terrama2::core::TimeUtils::nowUTC());
+
+  // without the validity mask all cells are active and each row is a tile
+  auto tiles = context.getActiveTiles();
+  QCOMPARE(tiles.size(), static_cast<std::size_t>(10));
+  QCOMPARE(tiles[3].firstRow, 3u);
+  QCOMPARE(tiles[3].lastRow, 4u);
+  QCOMPARE(tiles[3].firstColumn, 0u);
+  QCOMPARE(tiles[3].lastColumn, 10u);
+  QVERIFY(context.isActive(0, 9));
+}
+
+void TsGridContext::testValidityMask()
+{
+  auto dataManager = std::make_shared<DataManager>();
+  GridContext context(dataManager, sparseAnalysis(), terrama2::core::TimeUtils::nowUTC());
+  context.createValidityMask(4);
+
+  for(uint32_t row = 0; row < 10; ++row)
+    for(uint32_t col = 0; col < 10; ++col)
+      QCOMPARE(context.isActive(row, col), insideArea(row, col));
+
+  // the two tiles of the top right corner are outside the interest area
+  auto tiles = context.getActiveTiles();
+  QCOMPARE(tiles.size(), static_cast<std::size_t>(7));
+  for(const auto& tile : tiles)
+  {
+    QVERIFY(tile.lastRow <= 10 && tile.lastColumn <= 10);
+    QVERIFY(!(tile.firstRow == 0 && tile.firstColumn >= 4));
+  }
+}
+
+void TsGridContext::testFillInactiveCells()
+{
+  auto dataManager = std::make_shared<DataManager>();
+  GridContext context(dataManager, sparseAnalysis(), terrama2::core::TimeUtils::nowUTC());
+
+  auto outputRaster = context.getOutputRaster();
+  QCOMPARE(outputRaster->getNumberOfBands(), static_cast<std::size_t>(2));
+
+  for(std::size_t bandIdx = 0; bandIdx < outputRaster->getNumberOfBands(); ++bandIdx)
+    for(uint32_t row = 0; row < 10; ++row)
+      for(uint32_t col = 0; col < 10; ++col)
+        outputRaster->setValue(col, row, 7., bandIdx);
+
+  // without the mask nothing changes
+  context.fillInactiveCells(-1);
+  double value = 0;
+  outputRaster->getValue(9, 0, value, 1);
+  QCOMPARE(value, 7.);
+
+  context.createValidityMask(4);
+  context.fillInactiveCells(-1);
+
+  for(std::size_t bandIdx = 0; bandIdx < outputRaster->getNumberOfBands(); ++bandIdx)
+  {
+    for(uint32_t row = 0; row < 10; ++row)
+    {
+      for(uint32_t col = 0; col < 10; ++col)
+      {
+        outputRaster->getValue(col, row, value, bandIdx);
+        QCOMPARE(value, insideArea(row, col) ? 7. : -1.);
+      }
+    }
+  }
+}
@@ -0,0 +1,124 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file unittest/analysis/TsGridProvenance.cpp
+
+  \brief Tests for the tile-level provenance of grid analyses
+
+  \author Jano Simas
+*/
+
+#include "TsGridProvenance.hpp"
+
+//TerraMA2
+#include <terrama2/services/analysis/core/Analysis.hpp>
+#include <terrama2/services/analysis/core/GridProvenance.hpp>
+#include <terrama2/services/analysis/core/JSonUtils.hpp>
+
+//TerraLib
+#include <terralib/geometry/Envelope.h>
+#include <terralib/raster/Grid.h>
+
+//QT
+#include <QJsonObject>
+#include <QJsonValue>
+
+using namespace terrama2::services::analysis::core;
+
+namespace
+{
+  GridProvenance::Source source(const std::string& identity, double xmin, double ymin, double xmax, double ymax)
+  {
+    GridProvenance::Source result;
+    result.identity = identity;
+    result.footprint = te::gm::Envelope(xmin, ymin, xmax, ymax);
+    return result;
+  }
+}
+
+void TsGridProvenance::testChangedRegions()
+{
+  std::vector<GridProvenance::Source> previous = {source("a", 0, 0, 10, 10), source("b", 20, 20, 30, 30)};
+
+  // same grids, in any order
+  std::vector<GridProvenance::Source> current = {source("b", 20, 20, 30, 30), source("a", 0, 0, 10, 10)};
+  QVERIFY(GridProvenance::changedRegions(previous, current).empty());
+
+  // a grid was replaced, both the old and the new extent changed
+  current = {source("a", 0, 0, 10, 10), source("c", 40, 40, 50, 50)};
+  auto regions = GridProvenance::changedRegions(previous, current);
+  QCOMPARE(regions.size(), static_cast<std::size_t>(2));
+  QCOMPARE(regions[0].getLowerLeftX(), 40.);
+  QCOMPARE(regions[1].getLowerLeftX(), 20.);
+
+  // no data anymore
+  regions = GridProvenance::changedRegions(previous, {});
+  QCOMPARE(regions.size(), static_cast<std::size_t>(2));
+}
+
+void TsGridProvenance::testAffectedTiles()
+{
+  // 10x10 cells of size 1, upper left corner at (0, 10)
+  te::rst::Grid grid(10, 10, new te::gm::Envelope(0, 0, 10, 10), 4326);
+
+  GridTile upperLeft;
+  upperLeft.firstRow = 0;
+  upperLeft.lastRow = 2;
+  upperLeft.firstColumn = 0;
+  upperLeft.lastColumn = 2;
+
+  GridTile lowerRight;
+  lowerRight.firstRow = 8;
+  lowerRight.lastRow = 10;
+  lowerRight.firstColumn = 8;
+  lowerRight.lastColumn = 10;
+
+  std::vector<te::gm::Envelope> regions = {te::gm::Envelope(1, 8.5, 1.5, 9)};
+  QVERIFY(GridProvenance::isAffected(upperLeft, grid, regions));
+  QVERIFY(!GridProvenance::isAffected(lowerRight, grid, regions));
+
+  // the margin of one cell includes the neighbours of the tile
+  regions = {te::gm::Envelope(2.5, 7.5, 2.9, 7.9)};
+  QVERIFY(GridProvenance::isAffected(upperLeft, grid, regions));
+
+  QVERIFY(!GridProvenance::isAffected(upperLeft, grid, {}));
+}
+
+void TsGridProvenance::testJSON()
+{
+  auto outputGrid = std::make_shared<AnalysisOutputGrid>();
+  outputGrid->interpolationMethod = InterpolationMethod::NEARESTNEIGHBOR;
+  outputGrid->resolutionType = ResolutionType::CUSTOM;
+  outputGrid->resolutionDataSeriesId = 0;
+  outputGrid->interestAreaType = InterestAreaType::UNION;
+  outputGrid->incrementalExecution = true;
+
+  QJsonObject json = toJson(outputGrid);
+  json["area_of_interest_box"] = QJsonValue();
+
+  auto decoded = fromAnalysisOutputGrid(json);
+  QVERIFY(decoded->incrementalExecution);
+
+  json.remove("incremental_execution");
+  decoded = fromAnalysisOutputGrid(json);
+  QVERIFY(!decoded->incrementalExecution);
+}
@@ -0,0 +1,143 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file unittest/analysis/TsInputVersion.cpp
+
+  \brief Tests for the record of the input versions of analyses
+
+  \author Jano Simas
+*/
+
+#include "TsInputVersion.hpp"
+
+//TerraMA2
+#include <terrama2/core/data-model/DataProvider.hpp>
+#include <terrama2/core/data-model/DataSeries.hpp>
+#include <terrama2/services/analysis/core/Analysis.hpp>
+#include <terrama2/services/analysis/core/DataManager.hpp>
+#include <terrama2/services/analysis/core/InputVersion.hpp>
+
+//QT
+#include <QTemporaryDir>
+
+using namespace terrama2::services::analysis::core;
+
+void TsInputVersion::testEligible()
+{
+  auto dataManager = std::make_shared<DataManager>();
+
+  auto dataProvider = std::make_shared<terrama2::core::DataProvider>();
+  dataProvider->id = 1;
+  dataProvider->name = "provider";
+  dataManager->add(dataProvider);
+
+  auto addDataSeries = [&dataManager](DataSeriesId id, terrama2::core::DataSeriesType type)
+  {
+    auto dataSeries = std::make_shared<terrama2::core::DataSeries>();
+    dataSeries->id = id;
+    dataSeries->name = "series " + std::to_string(id);
+    dataSeries->dataProviderId = 1;
+    dataSeries->semantics.dataSeriesType = type;
+    dataManager->add(dataSeries);
+
+    AnalysisDataSeries analysisDataSeries;
+    analysisDataSeries.dataSeriesId = id;
+    return analysisDataSeries;
+  };
+
+  auto analysis = std::make_shared<Analysis>();
+  analysis->script = "add_value(\"max\", grid.zonal.max(\"temperature\"))";
+  analysis->analysisDataSeriesList.push_back(addDataSeries(1, terrama2::core::DataSeriesType::STATIC));
+  analysis->analysisDataSeriesList.push_back(addDataSeries(2, terrama2::core::DataSeriesType::GRID));
+  QVERIFY(InputVersion::isEligible(dataManager, analysis));
+
+  analysis->metadata["skip_unchanged"] = "false";
+  QVERIFY(!InputVersion::isEligible(dataManager, analysis));
+  analysis->metadata.clear();
+
+  // grid history and forecast operators are read relative to the execution date
+  for(const std::string& script : {"x = grid.history.max(\"temperature\", \"2d\")",
+                                   "x = grid.forecast.min(\"temperature\", \"2d\")",
+                                   "add_value(\"x\", grid.zonal.history.sum(\"temperature\", \"2d\"))",
+                                   "add_value(\"x\", grid.zonal.forecast.max(\"temperature\", \"2d\"))"})
+  {
+    analysis->script = script;
+    QVERIFY(!InputVersion::isEligible(dataManager, analysis));
+  }
+  analysis->script = "add_value(\"max\", grid.zonal.max(\"temperature\"))";
+
+  // occurrences and DCP data are read relative to the execution date
+  analysis->analysisDataSeriesList.push_back(addDataSeries(3, terrama2::core::DataSeriesType::OCCURRENCE));
+  QVERIFY(!InputVersion::isEligible(dataManager, analysis));
+
+  analysis->analysisDataSeriesList.back() = addDataSeries(4, terrama2::core::DataSeriesType::DCP);
+  QVERIFY(!InputVersion::isEligible(dataManager, analysis));
+
+  analysis->analysisDataSeriesList.pop_back();
+  analysis->reprocessingHistoricalData = std::make_shared<ReprocessingHistoricalData>();
+  QVERIFY(!InputVersion::isEligible(dataManager, analysis));
+}
+
+void TsInputVersion::testUnchanged()
+{
+  QTemporaryDir folder;
+  QVERIFY(folder.isValid());
+  InputVersion::setFolder(folder.path().toStdString());
+
+  auto analysis = std::make_shared<Analysis>();
+  analysis->id = 5;
+  analysis->script = "return grid.sample(\"temperature\")";
+  analysis->type = AnalysisType::GRID_TYPE;
+
+  const std::map<DataSeriesId, std::string> versions = {{1, "a"}, {2, "b"}};
+
+  // no previous execution
+  QVERIFY(!InputVersion(analysis, versions).isUnchanged());
+
+  InputVersion(analysis, versions).save();
+  QVERIFY(InputVersion(analysis, versions).isUnchanged());
+
+  // new data
+  QVERIFY(!InputVersion(analysis, {{1, "a"}, {2, "c"}}).isUnchanged());
+  QVERIFY(!InputVersion(analysis, {{1, "a"}}).isUnchanged());
+
+  // unknown versions are never unchanged
+  QVERIFY(!InputVersion(analysis, {{1, "a"}, {2, ""}}).isUnchanged());
+
+  // new script
+  analysis->script = "return grid.sample(\"temperature\") * 2";
+  QVERIFY(!InputVersion(analysis, versions).isUnchanged());
+
+  InputVersion(analysis, versions).save();
+  QVERIFY(InputVersion(analysis, versions).isUnchanged());
+
+  // a failed execution removes the record
+  InputVersion(analysis, versions).remove();
+  QVERIFY(!InputVersion(analysis, versions).isUnchanged());
+
+  // records of removed analyses are removed
+  InputVersion(analysis, versions).save();
+  InputVersion::removeAnalysis(analysis->id + 1);
+  QVERIFY(InputVersion(analysis, versions).isUnchanged());
+  InputVersion::removeAnalysis(analysis->id);
+  QVERIFY(!InputVersion(analysis, versions).isUnchanged());
+}
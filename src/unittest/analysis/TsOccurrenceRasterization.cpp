@@ -0,0 +1,134 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file unittest/analysis/TsOccurrenceRasterization.cpp
+
+  \brief Tests for the rasterization of occurrences in grid analyses
+
+  \author Jano Simas
+*/
+
+#include "TsOccurrenceRasterization.hpp"
+
+//TerraMA2
+#include <terrama2/Exception.hpp>
+#include <terrama2/services/analysis/core/GridContext.hpp>
+
+//STL
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+using namespace terrama2::services::analysis::core;
+
+namespace
+{
+  GridOccurrence occurrence(double column, double row, double weight = 1.)
+  {
+    GridOccurrence result;
+    result.column = column;
+    result.row = row;
+    result.weight = weight;
+    return result;
+  }
+
+  double cellValue(const std::vector<double>& values, int nCols, int row, int column)
+  {
+    return values[static_cast<std::size_t>(row) * nCols + column];
+  }
+}
+
+void TsOccurrenceRasterization::testCount()
+{
+  std::vector<GridOccurrence> occurrences = {occurrence(1.2, 2.4), occurrence(0.8, 1.6), occurrence(3, 0, 5.),
+                                             occurrence(-2, 1), occurrence(1, 7)};
+
+  auto values = rasterizeGridOccurrences(occurrences, OccurrenceRasterization::COUNT, 0., 5, 4, 1., 1.);
+  QCOMPARE(values.size(), static_cast<std::size_t>(20));
+
+  // occurrences are counted in the nearest cell, the ones outside the grid are ignored
+  QCOMPARE(cellValue(values, 4, 2, 1), 2.);
+  QCOMPARE(cellValue(values, 4, 0, 3), 5.);
+  QCOMPARE(std::accumulate(values.begin(), values.end(), 0.), 7.);
+
+  occurrences.clear();
+  values = rasterizeGridOccurrences(occurrences, OccurrenceRasterization::SUM, 0., 3, 3, 1., 1.);
+  QCOMPARE(values, std::vector<double>(9, 0.));
+}
+
+void TsOccurrenceRasterization::testGaussianKernel()
+{
+  const int size = 81;
+  const double resolution = 0.5;
+  const double bandwidth = 2.;
+  const double pi = std::acos(-1.);
+
+  std::vector<GridOccurrence> occurrences = {occurrence(40, 40, 2.)};
+  auto values = rasterizeGridOccurrences(occurrences, OccurrenceRasterization::GAUSSIAN_KERNEL, bandwidth,
+                                         size, size, resolution, resolution);
+
+  QVERIFY(std::abs(cellValue(values, size, 40, 40) - 2. / (2 * pi * bandwidth * bandwidth)) < 1e-12);
+
+  // the kernel is symmetric, also across the bands of rows of the workers
+  for(int offset = 1; offset < 12; ++offset)
+  {
+    double value = cellValue(values, size, 40 + offset, 40);
+    QVERIFY(value > 0);
+    QVERIFY(std::abs(value - cellValue(values, size, 40, 40 + offset)) < 1e-15);
+    QVERIFY(std::abs(value - cellValue(values, size, 40 - offset, 40)) < 1e-15);
+  }
+
+  // truncated at three times the bandwidth
+  QCOMPARE(cellValue(values, size, 40 + 13, 40), 0.);
+
+  // the density integrates to the weight, minus the truncated tail
+  double integral = std::accumulate(values.begin(), values.end(), 0.) * resolution * resolution;
+  QVERIFY(integral < 2.);
+  QVERIFY(integral > 2. * (1 - std::exp(-4.5)) - 1e-2);
+}
+
+void TsOccurrenceRasterization::testQuarticKernel()
+{
+  const int size = 61;
+  const double bandwidth = 10.;
+  const double pi = std::acos(-1.);
+
+  std::vector<GridOccurrence> occurrences = {occurrence(30, 30), occurrence(30, 30)};
+  auto values = rasterizeGridOccurrences(occurrences, OccurrenceRasterization::QUARTIC_KERNEL, bandwidth,
+                                         size, size, 1., 1.);
+
+  QVERIFY(std::abs(cellValue(values, size, 30, 30) - 2 * 3. / (pi * bandwidth * bandwidth)) < 1e-12);
+  QCOMPARE(cellValue(values, size, 30, 40), 0.);
+  QVERIFY(cellValue(values, size, 30, 39) > 0.);
+
+  double integral = std::accumulate(values.begin(), values.end(), 0.);
+  QVERIFY(std::abs(integral - 2.) < 2e-2);
+}
+
+void TsOccurrenceRasterization::testInvalidBandwidth()
+{
+  std::vector<GridOccurrence> occurrences = {occurrence(1, 1)};
+  QVERIFY_EXCEPTION_THROWN(rasterizeGridOccurrences(occurrences, OccurrenceRasterization::GAUSSIAN_KERNEL, 0., 3, 3, 1., 1.),
+                           terrama2::InvalidArgumentException);
+  QVERIFY_EXCEPTION_THROWN(rasterizeGridOccurrences(occurrences, OccurrenceRasterization::QUARTIC_KERNEL, -1., 3, 3, 1., 1.),
+                           terrama2::InvalidArgumentException);
+}
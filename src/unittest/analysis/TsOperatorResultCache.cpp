@@ -0,0 +1,171 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file unittest/analysis/TsOperatorResultCache.cpp
+
+  \brief Tests for the operator result cache
+
+  \author Jano Simas
+*/
+
+#include "TsOperatorResultCache.hpp"
+
+//TerraMA2
+#include <terrama2/services/analysis/core/OperatorResultCache.hpp>
+
+//STL
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace terrama2::services::analysis::core;
+
+namespace
+{
+  OperatorResultKey createKey(const std::string& geometryId)
+  {
+    OperatorResultKey key;
+    key.operatorName = "grid.zonal";
+    key.dataSeriesId = 1;
+    key.dataVersion = "1@2016-Aug-10 10:00:00 UTC";
+    key.monitoredObjectId = 2;
+    key.geometryId = geometryId;
+    return key;
+  }
+
+  OperatorCache createResult(double mean)
+  {
+    OperatorCache result;
+    result.mean = mean;
+    result.count = 1;
+    return result;
+  }
+}
+
+void TsOperatorResultCache::init()
+{
+  OperatorResultCache::getInstance().clear();
+  OperatorResultCache::getInstance().setMaxMemory(64*1024*1024);
+}
+
+void TsOperatorResultCache::testCacheHit()
+{
+  auto& resultCache = OperatorResultCache::getInstance();
+
+  int computed = 0;
+  auto compute = [&computed]() { ++computed; return createResult(10.); };
+
+  QCOMPARE(resultCache.get(createKey("a"), compute).mean, 10.);
+  QCOMPARE(resultCache.get(createKey("a"), compute).mean, 10.);
+  QCOMPARE(computed, 1);
+
+  auto key = createKey("a");
+  key.buffer = Buffer(ONLY_BUFFER, 2., "km");
+  resultCache.get(key, compute);
+  QCOMPARE(computed, 2);
+
+  // the same relative filter in another execution reads another window
+  key = createKey("a");
+  key.dateWindow = "20160810T070000/20160810T100000";
+  resultCache.get(key, compute);
+  key.dateWindow = "20160810T080000/20160810T110000";
+  resultCache.get(key, compute);
+  QCOMPARE(computed, 4);
+}
+
+void TsOperatorResultCache::testDataVersion()
+{
+  auto& resultCache = OperatorResultCache::getInstance();
+
+  resultCache.get(createKey("a"), []() { return createResult(10.); });
+
+  // new data collected
+  auto key = createKey("a");
+  key.dataVersion = "2@2016-Aug-10 11:00:00 UTC";
+  QCOMPARE(resultCache.get(key, []() { return createResult(20.); }).mean, 20.);
+}
+
+void TsOperatorResultCache::testInvalidate()
+{
+  auto& resultCache = OperatorResultCache::getInstance();
+
+  resultCache.get(createKey("a"), []() { return createResult(10.); });
+  resultCache.invalidate(2);
+
+  QCOMPARE(resultCache.get(createKey("a"), []() { return createResult(20.); }).mean, 20.);
+}
+
+void TsOperatorResultCache::testFailedComputation()
+{
+  auto& resultCache = OperatorResultCache::getInstance();
+
+  try
+  {
+    resultCache.get(createKey("a"), []() -> OperatorCache { throw std::runtime_error("failed"); });
+    QFAIL("Exception expected!");
+  }
+  catch(const std::runtime_error&)
+  {
+  }
+
+  QCOMPARE(resultCache.get(createKey("a"), []() { return createResult(10.); }).mean, 10.);
+}
+
+void TsOperatorResultCache::testConcurrentRequests()
+{
+  auto& resultCache = OperatorResultCache::getInstance();
+
+  std::atomic<int> computed(0);
+  auto compute = [&computed]()
+  {
+    ++computed;
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    return createResult(10.);
+  };
+
+  std::vector<double> results(8, 0.);
+  std::vector<std::thread> threads;
+  for(std::size_t i = 0; i < results.size(); ++i)
+    threads.emplace_back([&, i]() { results[i] = resultCache.get(createKey("a"), compute).mean; });
+
+  for(auto& thread : threads)
+    thread.join();
+
+  QCOMPARE(computed.load(), 1);
+  for(double result : results)
+    QCOMPARE(result, 10.);
+}
+
+void TsOperatorResultCache::testEviction()
+{
+  auto& resultCache = OperatorResultCache::getInstance();
+  resultCache.setMaxMemory(1);
+
+  int computed = 0;
+  auto compute = [&computed]() { ++computed; return createResult(10.); };
+
+  resultCache.get(createKey("a"), compute);
+  resultCache.get(createKey("a"), compute);
+  QCOMPARE(computed, 2);
+}
@@ -0,0 +1,299 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file unittest/analysis/TsOutputGrid.cpp
+
+  \brief Tests for the output grid pixel types and bands
+
+  \author Jano Simas
+*/
+
+#include "TsOutputGrid.hpp"
+
+//TerraMA2
+#include <terrama2/Exception.hpp>
+#include <terrama2/core/Exception.hpp>
+#include <terrama2/services/analysis/core/Analysis.hpp>
+#include <terrama2/services/analysis/core/AnalysisExecutor.hpp>
+#include <terrama2/services/analysis/core/Exception.hpp>
+#include <terrama2/services/analysis/core/JSonUtils.hpp>
+#include <terrama2/services/analysis/core/PythonInterpreter.hpp>
+#include <terrama2/services/analysis/core/Utils.hpp>
+
+//TerraLib
+#include <terralib/datatype/Enums.h>
+#include <terralib/geometry/Envelope.h>
+#include <terralib/raster/Band.h>
+#include <terralib/raster/BandProperty.h>
+#include <terralib/raster/Grid.h>
+#include <terralib/raster/Raster.h>
+#include <terralib/raster/RasterFactory.h>
+
+//QT
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+
+//STL
+#include <cmath>
+#include <limits>
+
+using namespace terrama2::services::analysis::core;
+
+void TsOutputGrid::initTestCase()
+{
+  // the main thread holds the GIL while the tests run
+  Py_Initialize();
+}
+
+void TsOutputGrid::cleanupTestCase()
+{
+  Py_Finalize();
+}
+
+void TsOutputGrid::testQuantizeFloat()
+{
+  AnalysisOutputGrid outputGrid;
+  outputGrid.interpolationDummy = -9999;
+
+  // the default output stores the values unchanged
+  QCOMPARE(quantizeOutputValue(outputGrid, 1.25), 1.25);
+  QCOMPARE(quantizeOutputValue(outputGrid, -9999.), -9999.);
+  QVERIFY(std::isnan(quantizeOutputValue(outputGrid, std::nan(""))));
+  QCOMPARE(getTerraLibDataType(outputGrid.dataType), static_cast<int>(te::dt::DOUBLE_TYPE));
+
+  // with a scale the dummy value is reserved
+  outputGrid.scale = 2;
+  QCOMPARE(quantizeOutputValue(outputGrid, 2.5), 1.25);
+  QCOMPARE(quantizeOutputValue(outputGrid, std::nan("")), -9999.);
+  QVERIFY(quantizeOutputValue(outputGrid, -19998.) != -9999.);
+  outputGrid.scale = 1;
+
+  outputGrid.dataType = OutputDataType::FLOAT32;
+  QCOMPARE(getTerraLibDataType(outputGrid.dataType), static_cast<int>(te::dt::FLOAT_TYPE));
+  QCOMPARE(quantizeOutputValue(outputGrid, 1e300), static_cast<double>(std::numeric_limits<float>::max()));
+
+  // valid values are never stored as the dummy value
+  QVERIFY(quantizeOutputValue(outputGrid, -9999.) != -9999.);
+  QVERIFY(quantizeOutputValue(outputGrid, -9999.) > -9999.);
+  QVERIFY(quantizeOutputValue(outputGrid, -10000.) == -10000.);
+}
+
+void TsOutputGrid::testQuantizeInteger()
+{
+  AnalysisOutputGrid outputGrid;
+  outputGrid.dataType = OutputDataType::UINT8;
+  outputGrid.interpolationDummy = 255;
+  outputGrid.scale = 0.5;
+  outputGrid.offset = 10;
+
+  QCOMPARE(getTerraLibDataType(outputGrid.dataType), static_cast<int>(te::dt::UCHAR_TYPE));
+  // (value - offset) / scale, rounded
+  QCOMPARE(quantizeOutputValue(outputGrid, 12.3), 5.);
+  QCOMPARE(quantizeOutputValue(outputGrid, 0.), 0.);
+  // the dummy value is reserved, values above the range are limited to 254
+  QCOMPARE(quantizeOutputValue(outputGrid, 1000.), 254.);
+  QCOMPARE(quantizeOutputValue(outputGrid, std::nan("")), 255.);
+  QVERIFY(isValidOutputDummy(outputGrid));
+
+  outputGrid.interpolationDummy = 0;
+  QCOMPARE(quantizeOutputValue(outputGrid, 0.), 1.);
+  QCOMPARE(quantizeOutputValue(outputGrid, 1000.), 255.);
+
+  // dummy values not representable in the pixel type are rejected
+  outputGrid.interpolationDummy = -9999;
+  QVERIFY(!isValidOutputDummy(outputGrid));
+  outputGrid.interpolationDummy = 2.5;
+  QVERIFY(!isValidOutputDummy(outputGrid));
+
+  outputGrid.dataType = OutputDataType::INT16;
+  outputGrid.interpolationDummy = -9999;
+  outputGrid.scale = 1;
+  outputGrid.offset = 0;
+  QVERIFY(isValidOutputDummy(outputGrid));
+  QCOMPARE(getTerraLibDataType(outputGrid.dataType), static_cast<int>(te::dt::INT16_TYPE));
+  QCOMPARE(quantizeOutputValue(outputGrid, -2.6), -3.);
+  QCOMPARE(quantizeOutputValue(outputGrid, -1e6), -32768.);
+  // values rounded to an interior dummy value move to the side of the value
+  QCOMPARE(quantizeOutputValue(outputGrid, -9999.2), -10000.);
+  QCOMPARE(quantizeOutputValue(outputGrid, -9998.8), -9998.);
+
+  outputGrid.interpolationDummy = -32768;
+  QCOMPARE(quantizeOutputValue(outputGrid, -1e6), -32767.);
+  outputGrid.interpolationDummy = 100000;
+  QVERIFY(!isValidOutputDummy(outputGrid));
+}
+
+void TsOutputGrid::testJSON()
+{
+  auto outputGrid = std::make_shared<AnalysisOutputGrid>();
+  outputGrid->analysisId = 1;
+  outputGrid->interpolationMethod = InterpolationMethod::NEARESTNEIGHBOR;
+  outputGrid->interpolationDummy = 255;
+  outputGrid->resolutionType = ResolutionType::CUSTOM;
+  outputGrid->resolutionDataSeriesId = 0;
+  outputGrid->interestAreaType = InterestAreaType::UNION;
+  outputGrid->dataType = OutputDataType::UINT8;
+  outputGrid->scale = 0.25;
+  outputGrid->offset = -5;
+
+  QJsonObject json = toJson(outputGrid);
+  // no custom box
+  json["area_of_interest_box"] = QJsonValue();
+
+  auto decoded = fromAnalysisOutputGrid(json);
+  QVERIFY(decoded->dataType == OutputDataType::UINT8);
+  QCOMPARE(decoded->scale, 0.25);
+  QCOMPARE(decoded->offset, -5.);
+  QCOMPARE(decoded->interpolationDummy, 255.);
+
+  QVERIFY_EXCEPTION_THROWN(ToOutputDataType(5), terrama2::InvalidArgumentException);
+}
+
+void TsOutputGrid::testOutputBandsJSON()
+{
+  auto outputGrid = std::make_shared<AnalysisOutputGrid>();
+  outputGrid->interpolationMethod = InterpolationMethod::NEARESTNEIGHBOR;
+  outputGrid->resolutionType = ResolutionType::CUSTOM;
+  outputGrid->resolutionDataSeriesId = 0;
+  outputGrid->interestAreaType = InterestAreaType::UNION;
+  outputGrid->bandNames = {"mean", "max", "anomaly"};
+  outputGrid->bandDataSeries["anomaly"] = 7;
+
+  QJsonObject json = toJson(outputGrid);
+  json["area_of_interest_box"] = QJsonValue();
+
+  auto decoded = fromAnalysisOutputGrid(json);
+  QVERIFY(decoded->bandNames == outputGrid->bandNames);
+  QVERIFY(decoded->bandDataSeries == outputGrid->bandDataSeries);
+
+  // bands stored in other data series must be output bands
+  QJsonObject bandDataSeries;
+  bandDataSeries.insert("min", 8);
+  json["output_band_data_series"] = bandDataSeries;
+  QVERIFY_EXCEPTION_THROWN(fromAnalysisOutputGrid(json), terrama2::core::JSonParserException);
+
+  // band names are unique
+  json.remove("output_band_data_series");
+  json["output_bands"] = QJsonArray({"mean", "mean"});
+  QVERIFY_EXCEPTION_THROWN(fromAnalysisOutputGrid(json), terrama2::core::JSonParserException);
+}
+
+void TsOutputGrid::testOutputBandValues()
+{
+  const std::vector<std::string> bandNames = {"mean", "max", "anomaly"};
+  std::vector<double> values;
+
+  // dict with the value of each band, missing bands are NaN
+  boost::python::dict resultDict;
+  resultDict["max"] = 3.5;
+  resultDict["mean"] = 1.5;
+  resultDict["other"] = 10.;
+  python::outputBandValues(resultDict, bandNames, values);
+  QCOMPARE(values.size(), bandNames.size());
+  QCOMPARE(values[0], 1.5);
+  QCOMPARE(values[1], 3.5);
+  QVERIFY(std::isnan(values[2]));
+
+  // sequence with the values in the order of the bands, None is NaN
+  boost::python::list resultList;
+  resultList.append(1.);
+  resultList.append(boost::python::object());
+  resultList.append(-2.);
+  python::outputBandValues(resultList, bandNames, values);
+  QCOMPARE(values[0], 1.);
+  QVERIFY(std::isnan(values[1]));
+  QCOMPARE(values[2], -2.);
+
+  // a single value is the first band
+  python::outputBandValues(boost::python::object(4.), bandNames, values);
+  QCOMPARE(values[0], 4.);
+  QVERIFY(std::isnan(values[1]));
+
+  python::outputBandValues(boost::python::object(), bandNames, values);
+  QVERIFY(std::isnan(values[0]));
+
+  // sequences must have a value for each band
+  resultList.append(5.);
+  QVERIFY_EXCEPTION_THROWN(python::outputBandValues(resultList, bandNames, values), PythonInterpreterException);
+  QVERIFY_EXCEPTION_THROWN(python::outputBandValues(boost::python::make_tuple(1., 2.), bandNames, values), PythonInterpreterException);
+}
+
+void TsOutputGrid::testOutputBandsByDataSeries()
+{
+  Analysis analysis;
+  analysis.outputDataSeriesId = 1;
+  analysis.outputGridPtr = std::make_shared<AnalysisOutputGrid>();
+
+  // a single band without names is stored in the output data series
+  auto bands = outputBandsByDataSeries(analysis, 1);
+  QCOMPARE(bands.size(), static_cast<std::size_t>(1));
+  QVERIFY(bands[1] == std::vector<std::size_t>({0}));
+
+  auto outputGrid = std::make_shared<AnalysisOutputGrid>();
+  outputGrid->bandNames = {"mean", "anomaly", "max", "trend"};
+  outputGrid->bandDataSeries["anomaly"] = 7;
+  outputGrid->bandDataSeries["trend"] = 8;
+  analysis.outputGridPtr = outputGrid;
+
+  bands = outputBandsByDataSeries(analysis, 4);
+  QCOMPARE(bands.size(), static_cast<std::size_t>(3));
+  QVERIFY(bands[1] == std::vector<std::size_t>({0, 2}));
+  QVERIFY(bands[7] == std::vector<std::size_t>({1}));
+  QVERIFY(bands[8] == std::vector<std::size_t>({3}));
+}
+
+void TsOutputGrid::testSelectBands()
+{
+  std::vector<te::rst::BandProperty*> bands;
+  for(std::size_t bandIdx = 0; bandIdx < 3; ++bandIdx)
+  {
+    te::rst::BandProperty* bandProperty = new te::rst::BandProperty(bandIdx, te::dt::INT16_TYPE);
+    bandProperty->m_noDataValue = -9999;
+    bandProperty->m_valuesScale = 0.5;
+    bands.push_back(bandProperty);
+  }
+
+  te::rst::Grid* grid = new te::rst::Grid(4u, 3u, 1., 1., new te::gm::Envelope(0, 0, 4, 3), 4326);
+  std::unique_ptr<te::rst::Raster> raster(te::rst::RasterFactory::make("MEM", grid, bands, {}));
+  QVERIFY(raster.get());
+  for(std::size_t bandIdx = 0; bandIdx < 3; ++bandIdx)
+    for(unsigned int row = 0; row < 3; ++row)
+      for(unsigned int col = 0; col < 4; ++col)
+        raster->setValue(col, row, static_cast<double>(bandIdx * 100 + row * 4 + col), bandIdx);
+
+  auto selected = selectBands(*raster, {2, 0});
+  QCOMPARE(selected->getNumberOfBands(), static_cast<std::size_t>(2));
+  QCOMPARE(selected->getNumberOfColumns(), 4u);
+  QCOMPARE(selected->getNumberOfRows(), 3u);
+
+  // the bands keep their properties and values, in the order of the selection
+  QCOMPARE(selected->getBandDataType(0), static_cast<int>(te::dt::INT16_TYPE));
+  QCOMPARE(selected->getBand(0)->getProperty()->m_noDataValue, -9999.);
+  QCOMPARE(selected->getBand(1)->getProperty()->m_valuesScale, 0.5);
+
+  double value = 0;
+  selected->getValue(3, 2, value, 0);
+  QCOMPARE(value, 211.);
+  selected->getValue(1, 0, value, 1);
+  QCOMPARE(value, 1.);
+}
@@ -1,7 +1,15 @@
 //TerraMA2
 #include <terrama2/core/utility/Utils.hpp>
 
+#include "TsAnalysisCheckpoint.hpp"
+#include "TsBufferMemory.hpp"
+#include "TsGridContext.hpp"
+#include "TsGridProvenance.hpp"
+#include "TsInputVersion.hpp"
 #include "TsJSONUtils.hpp"
+#include "TsOccurrenceRasterization.hpp"
+#include "TsOperatorResultCache.hpp"
+#include "TsOutputGrid.hpp"
 
 
 int main(int argc, char **argv)
@@ -11,6 +19,30 @@ int main(int argc, char **argv)
   TsJSONUtils testJSONUtils;
   int ret = QTest::qExec(&testJSONUtils, argc, argv);
 
+  TsOperatorResultCache testOperatorResultCache;
+  ret += QTest::qExec(&testOperatorResultCache, argc, argv);
+
+  TsOutputGrid testOutputGrid;
+  ret += QTest::qExec(&testOutputGrid, argc, argv);
+
+  TsGridProvenance testGridProvenance;
+  ret += QTest::qExec(&testGridProvenance, argc, argv);
+
+  TsAnalysisCheckpoint testAnalysisCheckpoint;
+  ret += QTest::qExec(&testAnalysisCheckpoint, argc, argv);
+
+  TsInputVersion testInputVersion;
+  ret += QTest::qExec(&testInputVersion, argc, argv);
+
+  TsBufferMemory testBufferMemory;
+  ret += QTest::qExec(&testBufferMemory, argc, argv);
+
+  TsOccurrenceRasterization testOccurrenceRasterization;
+  ret += QTest::qExec(&testOccurrenceRasterization, argc, argv);
+
+  TsGridContext testGridContext;
+  ret += QTest::qExec(&testGridContext, argc, argv);
+
 
   terrama2::core::finalizeTerraMA();
 
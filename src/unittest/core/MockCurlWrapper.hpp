@@ -46,6 +46,8 @@ public:
                              size_t(*write_vector)(void *ptr, size_t size, size_t nmemb, void *data),
                              std::string block));
 
+  MOCK_METHOD1(getFileSize, int64_t(std::string url));
+
   MOCK_METHOD3(getDownloadFiles, CURLcode(std::string url,
                                  size_t(*write_response)(void *ptr, size_t size, size_t nmemb, void *data),
                                  std::string filePath));
@@ -0,0 +1,326 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file unittest/core/TsCsvParser.cpp
+
+  \brief Tests for Class CsvParser
+
+  \author Jano Simas
+*/
+
+#include "TsCsvParser.hpp"
+
+//TerraMA2
+#include <terrama2/core/Exception.hpp>
+#include <terrama2/core/utility/CsvParser.hpp>
+
+//TerraLib
+#include <terralib/datatype/TimeInstantTZ.h>
+#include <terralib/geometry/Point.h>
+
+//QT
+#include <QFile>
+#include <QTemporaryDir>
+
+//STL
+#include <memory>
+#include <string>
+
+using terrama2::core::CsvParser;
+
+namespace
+{
+  void writeFile(const QString& path, const std::string& content, bool append = false)
+  {
+    QFile file(path);
+    QVERIFY(file.open(append ? QIODevice::Append : QIODevice::WriteOnly));
+    QCOMPARE(file.write(content.data(), static_cast<qint64>(content.size())), static_cast<qint64>(content.size()));
+  }
+
+  //! Format of a DCP file: id, date, longitude, latitude, count, value and an ignored column.
+  CsvParser::Format dcpFormat()
+  {
+    CsvParser::Format format;
+    format.timezone = "UTC-03";
+    format.geometryName = "geom";
+    format.srid = 4326;
+    format.column = [](const std::string& header)
+    {
+      CsvParser::Column column;
+      column.name = header;
+      if(header == "id")
+        column.type = CsvParser::ColumnType::STRING;
+      else if(header == "date")
+        column.type = CsvParser::ColumnType::TIMESTAMP;
+      else if(header == "lon")
+        column.type = CsvParser::ColumnType::LONGITUDE;
+      else if(header == "lat")
+        column.type = CsvParser::ColumnType::LATITUDE;
+      else if(header == "count")
+        column.type = CsvParser::ColumnType::INT32;
+      else if(header == "value")
+        column.type = CsvParser::ColumnType::DOUBLE;
+      return column;
+    };
+
+    return format;
+  }
+
+  boost::posix_time::ptime utcTime(int hour, int minute = 0)
+  {
+    return boost::posix_time::ptime(boost::gregorian::date(2016, 7, 21),
+                                    boost::posix_time::hours(hour) + boost::posix_time::minutes(minute));
+  }
+}
+
+void TsCsvParser::testTypedColumns()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  QString path = dir.path() + "/dcp.csv";
+  writeFile(path, "id,date,lon,lat,count,value,comment\n"
+                  "a,2016-07-21 10:00:00,-45.5,-23.25,3,1.5,first\n"
+                  "b,2016-07-21 10:10:00,-46,-23,x,nan,second\r\n"
+                  "c,invalid,,-23,2147483648,,third");
+
+  auto result = CsvParser(dcpFormat()).parse(path.toStdString());
+
+  // the point is created at the position of the last coordinate column
+  QCOMPARE(result.dataSetType->size(), static_cast<std::size_t>(5));
+  QVERIFY(result.dataSetType->getProperty("comment") == nullptr);
+  QCOMPARE(result.dataSetType->getPropertyPosition("geom"), static_cast<std::size_t>(2));
+  QCOMPARE(result.dataSet->size(), static_cast<std::size_t>(3));
+
+  result.dataSet->moveFirst();
+  QCOMPARE(result.dataSet->getString("id"), std::string("a"));
+  QCOMPARE(result.dataSet->getInt32("count"), 3);
+  QCOMPARE(result.dataSet->getDouble("value"), 1.5);
+
+  // timestamps are in the timezone of the format
+  std::unique_ptr<te::dt::DateTime> dateTime(result.dataSet->getDateTime("date"));
+  auto timeInstant = dynamic_cast<te::dt::TimeInstantTZ*>(dateTime.get());
+  QVERIFY(timeInstant);
+  QCOMPARE(timeInstant->getTimeInstantTZ().utc_time(), utcTime(13));
+
+  std::unique_ptr<te::gm::Geometry> geometry(result.dataSet->getGeometry("geom"));
+  auto point = dynamic_cast<te::gm::Point*>(geometry.get());
+  QVERIFY(point);
+  QCOMPARE(point->getX(), -45.5);
+  QCOMPARE(point->getY(), -23.25);
+  QCOMPARE(point->getSRID(), 4326);
+
+  // values that can't be converted are null
+  result.dataSet->moveNext();
+  QCOMPARE(result.dataSet->getString("id"), std::string("b"));
+  QVERIFY(result.dataSet->isNull("count"));
+  QVERIFY(result.dataSet->isNull("value"));
+  QVERIFY(!result.dataSet->isNull("geom"));
+
+  result.dataSet->moveNext();
+  QVERIFY(result.dataSet->isNull("date"));
+  QVERIFY(result.dataSet->isNull("geom"));
+  QVERIFY(result.dataSet->isNull("count"));
+
+  QCOMPARE(result.end.lastTimestamp, utcTime(13, 10));
+  QCOMPARE(result.end.offset, QFile(path).size());
+}
+
+void TsCsvParser::testHeaderAndQuotes()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  QString path = dir.path() + "/toa5.dat";
+  writeFile(path, "\"TOA5\",\"station\"\n"
+                  "\"TIMESTAMP\";\"name\";\"value\"\n"
+                  "\"TS\";\"\";\"mm\"\n"
+                  "\"2016-07-21 10:00:00.5\";\"a;b \"\"quoted\"\"\";1\n"
+                  "\n"
+                  "\"2016-07-21 10:15:00\";\"c\";2\n");
+
+  CsvParser::Format format;
+  format.delimiter = ';';
+  format.headerLine = 1;
+  format.ignoredLines = 1;
+  format.column = [](const std::string& header)
+  {
+    CsvParser::Column column;
+    column.name = header;
+    if(header == "TIMESTAMP")
+      column.type = CsvParser::ColumnType::TIMESTAMP;
+    else if(header == "name")
+      column.type = CsvParser::ColumnType::STRING;
+    else
+      column.type = CsvParser::ColumnType::INT32;
+    return column;
+  };
+
+  auto result = CsvParser(format).parse(path.toStdString());
+  QCOMPARE(result.dataSet->size(), static_cast<std::size_t>(2));
+
+  result.dataSet->moveFirst();
+  QCOMPARE(result.dataSet->getString("name"), std::string("a;b \"quoted\""));
+  QCOMPARE(result.dataSet->getInt32("value"), 1);
+
+  result.dataSet->moveNext();
+  QCOMPARE(result.dataSet->getString("name"), std::string("c"));
+  QCOMPARE(result.end.lastTimestamp, utcTime(10, 15));
+}
+
+void TsCsvParser::testAppendedLines()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  QString path = dir.path() + "/dcp.csv";
+  writeFile(path, "id,date,value\n"
+                  "a,2016-07-21 10:00:00,1\n"
+                  "b,2016-07-21 10:10:00,2\n"
+                  "c,2016-07-21 10:2");
+
+  // the last line is still being written
+  auto format = dcpFormat();
+  format.completeLinesOnly = true;
+  CsvParser parser(format);
+
+  auto result = parser.parse(path.toStdString());
+  QCOMPARE(result.dataSet->size(), static_cast<std::size_t>(2));
+  QCOMPARE(result.end.lastTimestamp, utcTime(13, 10));
+
+  writeFile(path, "0:00,3\n", true);
+
+  // only the appended lines are read
+  result = parser.parse(path.toStdString(), result.end);
+  QCOMPARE(result.dataSet->size(), static_cast<std::size_t>(1));
+  result.dataSet->moveFirst();
+  QCOMPARE(result.dataSet->getString("id"), std::string("c"));
+  QCOMPARE(result.end.offset, QFile(path).size());
+
+  // the file was rewritten, the lines up to the last timestamp are ignored
+  writeFile(path, "id,date,value\n"
+                  "b,2016-07-21 10:10:00,2\n"
+                  "c,2016-07-21 10:20:00,3\n"
+                  "d,2016-07-21 10:30:00,4\n");
+
+  CsvParser::Position position;
+  position.lastTimestamp = result.end.lastTimestamp;
+  result = parser.parse(path.toStdString(), position);
+  QCOMPARE(result.dataSet->size(), static_cast<std::size_t>(1));
+  result.dataSet->moveFirst();
+  QCOMPARE(result.dataSet->getString("id"), std::string("d"));
+  QCOMPARE(result.end.lastTimestamp, utcTime(13, 30));
+}
+
+void TsCsvParser::testLargeFile()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+  QString path = dir.path() + "/large.csv";
+
+  // big enough to be split in chunks parsed in parallel
+  const int lines = 100000;
+  std::string content = "id,date,lon,lat,count,value\n";
+  for(int i = 0; i < lines; ++i)
+  {
+    int minute = i % (24*60);
+    content += "id" + std::to_string(i) + ",2016-07-21 "
+               + (minute/60 < 10 ? "0" : "") + std::to_string(minute/60) + ":"
+               + (minute%60 < 10 ? "0" : "") + std::to_string(minute%60) + ":00,-45,-23,"
+               + std::to_string(i) + ",0.5\n";
+  }
+  QVERIFY(content.size() > 2*1024*1024);
+  writeFile(path, content);
+
+  auto format = dcpFormat();
+  format.timezone = "UTC+00";
+  auto result = CsvParser(format).parse(path.toStdString());
+  QCOMPARE(result.dataSet->size(), static_cast<std::size_t>(lines));
+
+  // the lines keep the order of the file
+  long long sum = 0;
+  int expected = 0;
+  bool ordered = true;
+  result.dataSet->moveBeforeFirst();
+  while(result.dataSet->moveNext())
+  {
+    int count = result.dataSet->getInt32("count");
+    ordered = ordered && count == expected++;
+    sum += count;
+  }
+  QVERIFY(ordered);
+  QCOMPARE(sum, static_cast<long long>(lines) * (lines - 1) / 2);
+  QCOMPARE(result.end.lastTimestamp, utcTime(23, 59));
+}
+
+void TsCsvParser::testParseTimestamp()
+{
+  auto parse = [](const std::string& text, const std::string& format, boost::posix_time::ptime& result)
+  {
+    return CsvParser::parseTimestamp(text.data(), text.data() + text.size(), format, result);
+  };
+
+  boost::posix_time::ptime result;
+  QVERIFY(parse(" 2016-07-21 10:00:00 ", "%Y-%m-%d %H:%M:%S", result));
+  QCOMPARE(result, utcTime(10));
+
+  QVERIFY(parse("21/07/2016 10:20:30.25", "%d/%m/%Y %H:%M:%S", result));
+  QCOMPARE(result, utcTime(10, 20) + boost::posix_time::seconds(30) + boost::posix_time::milliseconds(250));
+
+  QVERIFY(parse("2016072110", "%Y%m%d%H", result));
+  QCOMPARE(result, utcTime(10));
+
+  QVERIFY(!parse("2016-07-21", "%Y-%m-%d %H:%M:%S", result));
+  QVERIFY(!parse("2016-02-30 10:00:00", "%Y-%m-%d %H:%M:%S", result));
+  QVERIFY(!parse("2016-07-21 10:00:00x", "%Y-%m-%d %H:%M:%S", result));
+  QVERIFY(!parse("2016-07-21", "%Y-%j", result));
+}
+
+void TsCsvParser::testPosition()
+{
+  CsvParser::Position position;
+  position.offset = 1234;
+  position.lastTimestamp = utcTime(10, 30);
+
+  auto readPosition = CsvParser::toReadPosition(position);
+  QCOMPARE(readPosition.offset, static_cast<qint64>(1234));
+
+  auto converted = CsvParser::toPosition(readPosition);
+  QCOMPARE(converted.offset, position.offset);
+  QCOMPARE(converted.lastTimestamp, position.lastTimestamp);
+
+  // an invalid timestamp reads the whole file again
+  readPosition.lastTimestamp = "invalid";
+  converted = CsvParser::toPosition(readPosition);
+  QCOMPARE(converted.offset, static_cast<qint64>(0));
+  QVERIFY(converted.lastTimestamp.is_special());
+}
+
+void TsCsvParser::testInvalidFile()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+
+  CsvParser parser(dcpFormat());
+  QVERIFY_EXCEPTION_THROWN(parser.parse((dir.path() + "/missing.csv").toStdString()), terrama2::core::DataAccessorException);
+
+  QString path = dir.path() + "/empty.csv";
+  writeFile(path, "");
+  QVERIFY_EXCEPTION_THROWN(parser.parse(path.toStdString()), terrama2::core::DataAccessorException);
+}
@@ -28,6 +28,9 @@
 #include <terralib/dataaccess/dataset/DataSetAdapter.h>
 #include <terralib/dataaccess/utils/Utils.h>
 #include <terralib/datatype/DateTimeProperty.h>
+#include <terralib/datatype/SimpleProperty.h>
+#include <terralib/datatype/TimeInstantTZ.h>
+#include <terralib/memory/DataSet.h>
 #include <terralib/memory/DataSetItem.h>
 #include <terralib/ogr/Config.h>
 #include <terralib/ogr/DataSource.h>
@@ -35,6 +38,7 @@
 // TerraMA2
 #include <terrama2/core/Shared.hpp>
 #include <terrama2/core/utility/Utils.hpp>
+#include <terrama2/core/utility/TimeUtils.hpp>
 #include <terrama2/core/utility/SemanticsManager.hpp>
 #include <terrama2/core/data-model/DataProvider.hpp>
 #include <terrama2/core/data-model/DataSeries.hpp>
@@ -111,6 +115,23 @@ class RaiiDataSourceTsDataAccessorDcpInpe
 };
 
 
+namespace
+{
+  //! Exposes the dataset filters of the file accessor.
+  class FilterDataAccessorDcpInpe : public terrama2::core::DataAccessorDcpInpe
+  {
+    public:
+      FilterDataAccessorDcpInpe(terrama2::core::DataProviderPtr dataProvider, terrama2::core::DataSeriesPtr dataSeries)
+        : DataAccessor(dataProvider, dataSeries),
+          DataAccessorDcp(dataProvider, dataSeries),
+          DataAccessorFile(dataProvider, dataSeries),
+          DataAccessorDcpInpe(dataProvider, dataSeries)
+      {}
+
+      using DataAccessorFile::filterDataSetByLastValue;
+  };
+}
+
 te::da::MockDataSet* create_MockDataSet()
 {
   te::da::MockDataSet* mockDataSet(new ::testing::NiceMock<te::da::MockDataSet>());
@@ -569,3 +590,55 @@ void TsDataAccessorDcpInpe::TestOK()
 
   return;
 }
+
+void TsDataAccessorDcpInpe::TestLastValueCompaction()
+{
+  terrama2::core::DataProviderPtr dataProvider = std::make_shared<terrama2::core::DataProvider>();
+  terrama2::core::DataSeriesPtr dataSeries = std::make_shared<terrama2::core::DataSeries>();
+  dataSeries->semantics.code = "DCP-inpe";
+
+  FilterDataAccessorDcpInpe accessor(dataProvider, dataSeries);
+
+  std::unique_ptr<te::da::DataSetType> dataSetType(new te::da::DataSetType("dcp"));
+  dataSetType->add(new te::dt::DateTimeProperty("DateTime", te::dt::TIME_INSTANT_TZ));
+  dataSetType->add(new te::dt::SimpleProperty("value", te::dt::DOUBLE_TYPE));
+  auto dataSet = std::make_shared<te::mem::DataSet>(dataSetType.get());
+
+  auto first = terrama2::core::TimeUtils::stringToTimestamp("2016-07-21 10:00:00UTM+00", "%Y-%m-%d %H:%M:%S%ZP");
+  auto last = terrama2::core::TimeUtils::stringToTimestamp("2016-07-21 11:00:00UTM+00", "%Y-%m-%d %H:%M:%S%ZP");
+
+  // rows of the last date interleaved with older rows, a row without date
+  std::vector<std::shared_ptr<te::dt::TimeInstantTZ> > timestamps = {first, last, last, nullptr, first, last};
+  for(std::size_t i = 0; i < timestamps.size(); ++i)
+  {
+    auto item = new te::mem::DataSetItem(dataSet.get());
+    if(timestamps[i])
+      item->setDateTime(0, static_cast<te::dt::DateTime*>(timestamps[i]->clone()));
+    item->setDouble(1, static_cast<double>(i));
+    dataSet->add(item);
+  }
+
+  // without last value nothing is removed
+  terrama2::core::Filter filter;
+  accessor.filterDataSetByLastValue(dataSet, filter, last);
+  QCOMPARE(dataSet->size(), timestamps.size());
+
+  // the rows of the last date and without date are kept in order
+  filter.lastValue = true;
+  accessor.filterDataSetByLastValue(dataSet, filter, last);
+  QCOMPARE(dataSet->size(), static_cast<std::size_t>(4));
+
+  std::vector<double> values;
+  dataSet->moveBeforeFirst();
+  while(dataSet->moveNext())
+  {
+    values.push_back(dataSet->getDouble(1));
+    if(!dataSet->isNull(0))
+    {
+      std::unique_ptr<te::dt::DateTime> dateTime(dataSet->getDateTime(0));
+      QVERIFY(*dynamic_cast<te::dt::TimeInstantTZ*>(dateTime.get()) == *last);
+    }
+  }
+
+  QCOMPARE(values, std::vector<double>({1., 2., 3., 5.}));
+}
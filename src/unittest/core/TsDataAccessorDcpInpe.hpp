@@ -53,6 +53,7 @@ class TsDataAccessorDcpInpe: public QObject
     void TestFailDataSourceInvalid();
     void TestFailDataSetInvalid(); // TestFailDataSetEmpty()
     void TestOK();
+    void TestLastValueCompaction();
 
 };
 
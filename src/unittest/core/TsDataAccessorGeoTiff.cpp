@@ -34,6 +34,10 @@
 #include <terrama2/Config.hpp>
 #include <terrama2/core/Exception.hpp>
 #include <terrama2/core/utility/DataRetrieverFactory.hpp>
+#include <terrama2/core/data-access/RasterHandle.hpp>
+
+//TerraLib
+#include <terralib/geometry/Utils.h>
 
 #include "TsDataAccessorGeoTiff.hpp"
 #include "MockDataRetriever.hpp"
@@ -333,3 +337,127 @@ void TsDataAccessorGeoTiff::TestOK()
   return;
 
 }
+
+void TsDataAccessorGeoTiff::TestGridInfo()
+{
+  try
+  {
+    //DataProvider information
+    terrama2::core::DataProvider* dataProvider = new terrama2::core::DataProvider();
+    terrama2::core::DataProviderPtr dataProviderPtr(dataProvider);
+    dataProvider->uri = "file://";
+    dataProvider->uri += TERRAMA2_DATA_DIR;
+    dataProvider->uri += "/geotiff";
+
+    dataProvider->intent = terrama2::core::DataProviderIntent::COLLECTOR_INTENT;
+    dataProvider->dataProviderType = "FILE";
+    dataProvider->active = true;
+
+    //DataSeries information
+    terrama2::core::DataSeries* dataSeries = new terrama2::core::DataSeries();
+    terrama2::core::DataSeriesPtr dataSeriesPtr(dataSeries);
+    dataSeries->semantics.code = "GRID-geotiff";
+
+    terrama2::core::DataSetGrid* dataSet = new terrama2::core::DataSetGrid();
+    dataSet->active = true;
+    dataSet->format.emplace("mask", "L5219076_07620040908_r3g2b1.tif");
+
+    dataSeries->datasetList.emplace_back(dataSet);
+
+    //empty filter
+    terrama2::core::Filter filter;
+    //accessing data
+    terrama2::core::DataAccessorGeoTiff accessor(dataProviderPtr, dataSeriesPtr);
+    auto gridInfoList = accessor.getGridInfo(filter);
+    QCOMPARE(gridInfoList.size(), static_cast<std::size_t>(1));
+
+    terrama2::core::GridSeriesPtr gridSeries = accessor.getGridSeries(filter);
+    auto raster = gridSeries->gridMap().begin()->second;
+
+    const auto& gridInfo = gridInfoList.front();
+    QCOMPARE(gridInfo.numberOfColumns, raster->getNumberOfColumns());
+    QCOMPARE(gridInfo.numberOfRows, raster->getNumberOfRows());
+    QCOMPARE(gridInfo.resolutionX, raster->getResolutionX());
+    QCOMPARE(gridInfo.resolutionY, raster->getResolutionY());
+    QCOMPARE(gridInfo.srid, raster->getSRID());
+    QCOMPARE(gridInfo.numberOfBands, raster->getNumberOfBands());
+    QVERIFY(gridInfo.extent->equals(*raster->getExtent()));
+  }
+  catch(...)
+  {
+    QFAIL("Unexpected exception!");
+  }
+
+  return;
+
+}
+
+void TsDataAccessorGeoTiff::TestWindow()
+{
+  try
+  {
+    //DataProvider information
+    terrama2::core::DataProvider* dataProvider = new terrama2::core::DataProvider();
+    terrama2::core::DataProviderPtr dataProviderPtr(dataProvider);
+    dataProvider->uri = "file://";
+    dataProvider->uri += TERRAMA2_DATA_DIR;
+    dataProvider->uri += "/geotiff";
+
+    dataProvider->intent = terrama2::core::DataProviderIntent::COLLECTOR_INTENT;
+    dataProvider->dataProviderType = "FILE";
+    dataProvider->active = true;
+
+    //DataSeries information
+    terrama2::core::DataSeries* dataSeries = new terrama2::core::DataSeries();
+    terrama2::core::DataSeriesPtr dataSeriesPtr(dataSeries);
+    dataSeries->semantics.code = "GRID-geotiff";
+
+    terrama2::core::DataSetGrid* dataSet = new terrama2::core::DataSetGrid();
+    dataSet->active = true;
+    dataSet->format.emplace("mask", "L5219076_07620040908_r3g2b1.tif");
+
+    dataSeries->datasetList.emplace_back(dataSet);
+
+    terrama2::core::Filter filter;
+    terrama2::core::DataAccessorGeoTiff accessor(dataProviderPtr, dataSeriesPtr);
+    auto completeRaster = accessor.getGridSeries(filter)->gridMap().begin()->second;
+
+    // a quarter of the grid in the center
+    const te::gm::Envelope* extent = completeRaster->getExtent();
+    double width = extent->getWidth();
+    double height = extent->getHeight();
+    te::gm::Envelope window(extent->getLowerLeftX() + width*3/8, extent->getLowerLeftY() + height*3/8,
+                            extent->getLowerLeftX() + width*5/8, extent->getLowerLeftY() + height*5/8);
+    filter.region.reset(te::gm::GetGeomFromEnvelope(&window, completeRaster->getSRID()));
+
+    auto gridSeries = accessor.getGridSeries(filter);
+    QCOMPARE(gridSeries->handleMap().size(), static_cast<std::size_t>(1));
+
+    // only the window is read
+    auto handle = gridSeries->handleMap().begin()->second;
+    QCOMPARE(handle->gridInfo().numberOfColumns, completeRaster->getNumberOfColumns());
+    auto raster = handle->raster();
+    QVERIFY(raster->getNumberOfColumns() < completeRaster->getNumberOfColumns()/2);
+    QVERIFY(raster->getNumberOfRows() < completeRaster->getNumberOfRows()/2);
+    QVERIFY(raster->getExtent()->contains(window));
+
+    // the pixels are the same of the complete raster
+    te::gm::Coord2D center = window.getCenter();
+    double col, row, completeCol, completeRow;
+    raster->getGrid()->geoToGrid(center.getX(), center.getY(), col, row);
+    completeRaster->getGrid()->geoToGrid(center.getX(), center.getY(), completeCol, completeRow);
+    for(std::size_t band = 0; band < raster->getNumberOfBands(); ++band)
+    {
+      double value, completeValue;
+      raster->getValue(static_cast<unsigned int>(col), static_cast<unsigned int>(row), value, band);
+      completeRaster->getValue(static_cast<unsigned int>(completeCol), static_cast<unsigned int>(completeRow), completeValue, band);
+      QCOMPARE(value, completeValue);
+    }
+  }
+  catch(...)
+  {
+    QFAIL("Unexpected exception!");
+  }
+
+  return;
+}
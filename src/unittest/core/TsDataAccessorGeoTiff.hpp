@@ -50,6 +50,8 @@ class TsDataAccessorGeoTiff: public QObject
     void TestOKDataRetrieverValid();
     void TestFailDataRetrieverInvalid();
     void TestOK();
+    void TestGridInfo();
+    void TestWindow();
 };
 
 #endif //__TERRAMA2_UNITTEST_CORE_DATA_ACCESSOR_GEO_TIFF_HPP__
@@ -0,0 +1,192 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file unittest/core/TsDataAccessorGrADS.cpp
+
+  \brief Tests for Core DataAccessorGrADS class
+
+  \author Jano Simas
+*/
+
+//TerraMA2
+#include <terrama2/core/data-model/DataProvider.hpp>
+#include <terrama2/core/data-model/DataSeries.hpp>
+#include <terrama2/impl/DataAccessorGrADS.hpp>
+
+#include "TsDataAccessorGrADS.hpp"
+
+//TerraLib
+#include <terralib/raster/Band.h>
+#include <terralib/raster/BandProperty.h>
+#include <terralib/raster/Raster.h>
+
+//QT
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtEndian>
+
+//STL
+#include <cstring>
+#include <memory>
+
+namespace
+{
+  //! A 3x2 grid with a surface variable and a variable with 2 levels.
+  const char* ctl =
+      "DSET ^data_%y4%m2%d2.bin\n"
+      "TITLE test\n"
+      "UNDEF -999.0\n"
+      "%1"
+      "XDEF 3 LINEAR -50.0 1.0\n"
+      "YDEF 2 LINEAR -20.0 1.0\n"
+      "ZDEF 2 LEVELS 1000 500\n"
+      "TDEF 2 LINEAR 00Z01JAN2016 1dy\n"
+      "VARS 2\n"
+      "prec 0 99 precipitation\n"
+      "temp 2 99 temperature\n"
+      "ENDVARS\n";
+
+  std::unique_ptr<terrama2::core::DataAccessorGrADS> makeAccessor()
+  {
+    terrama2::core::DataProviderPtr dataProvider = std::make_shared<terrama2::core::DataProvider>();
+    terrama2::core::DataSeriesPtr dataSeries = std::make_shared<terrama2::core::DataSeries>();
+    dataSeries->semantics.code = "GRID-grads";
+
+    return std::unique_ptr<terrama2::core::DataAccessorGrADS>(new terrama2::core::DataAccessorGrADS(dataProvider, dataSeries));
+  }
+
+  void writeFile(const QString& path, const QByteArray& data)
+  {
+    QFile file(path);
+    if(!file.open(QIODevice::WriteOnly))
+      QFAIL("Unable to write file!");
+
+    file.write(data);
+    file.close();
+  }
+
+  /*!
+    \brief Writes the grids of the binary file, the value of each cell identifies it.
+
+    The value is grid*100 + fileRow*10 + col, the file rows are from south to north.
+  */
+  QByteArray binaryData(int grids, bool bigEndian)
+  {
+    QByteArray data;
+    for(int grid = 0; grid < grids; ++grid)
+    {
+      for(int row = 0; row < 2; ++row)
+      {
+        for(int col = 0; col < 3; ++col)
+        {
+          float value = grid*100 + row*10 + col;
+          quint32 word;
+          std::memcpy(&word, &value, sizeof(float));
+
+          uchar bytes[4];
+          if(bigEndian)
+            qToBigEndian(word, bytes);
+          else
+            qToLittleEndian(word, bytes);
+          data.append(reinterpret_cast<const char*>(bytes), 4);
+        }
+      }
+    }
+
+    return data;
+  }
+}
+
+void TsDataAccessorGrADS::testReadDataDescriptor()
+{
+  QTemporaryDir dir;
+  QString ctlPath = dir.path()+"/data.ctl";
+  writeFile(ctlPath, QString(ctl).arg("OPTIONS yrev\n").toUtf8());
+
+  auto accessor = makeAccessor();
+  auto descriptor = accessor->readDataDescriptor(ctlPath.toStdString());
+
+  QCOMPARE(descriptor.datasetFilename_, std::string("^data_%y4%m2%d2.bin"));
+  QCOMPARE(descriptor.undef_, -999.);
+  QVERIFY(descriptor.hasOption("YREV"));
+  QCOMPARE(descriptor.vecVars_.size(), static_cast<std::size_t>(2));
+  QCOMPARE(descriptor.gridsPerTimeStep(), static_cast<std::size_t>(3));
+  QCOMPARE(descriptor.gridSize(), static_cast<std::size_t>(3*2*4));
+
+  // the cached descriptor is replaced when the file changes
+  writeFile(ctlPath, QString(ctl).arg("").toUtf8()+"\n");
+  descriptor = accessor->readDataDescriptor(ctlPath.toStdString());
+  QVERIFY(!descriptor.hasOption("yrev"));
+}
+
+void TsDataAccessorGrADS::testReadBinaryFile()
+{
+  QTemporaryDir dir;
+  QString ctlPath = dir.path()+"/data.ctl";
+  writeFile(ctlPath, QString(ctl).arg("").toUtf8());
+
+  // 2 time steps with 3 grids, the last time step is incomplete
+  QString binPath = dir.path()+"/data_20160101.bin";
+  writeFile(binPath, binaryData(8, Q_BYTE_ORDER == Q_BIG_ENDIAN));
+
+  auto accessor = makeAccessor();
+  auto descriptor = accessor->readDataDescriptor(ctlPath.toStdString());
+  descriptor.srid_ = 4326;
+
+  auto raster = accessor->readBinaryFile(descriptor, binPath.toStdString());
+  QCOMPARE(raster->getNumberOfBands(), static_cast<std::size_t>(6));
+  QCOMPARE(raster->getNumberOfColumns(), static_cast<unsigned int>(3));
+  QCOMPARE(raster->getNumberOfRows(), static_cast<unsigned int>(2));
+  QCOMPARE(raster->getSRID(), 4326);
+  QCOMPARE(raster->getBand(4)->getProperty()->m_description, std::string("temp:1:1"));
+
+  // the extent is built from the centers of the cells
+  QCOMPARE(raster->getExtent()->getLowerLeftX(), -50.5);
+  QCOMPARE(raster->getExtent()->getUpperRightY(), -18.5);
+
+  // the first raster row is the north row, the last row of the file
+  double value = 0;
+  raster->getBand(4)->getValue(2, 0, value);
+  QCOMPARE(value, 412.);
+  raster->getBand(0)->getValue(0, 1, value);
+  QCOMPARE(value, 0.);
+}
+
+void TsDataAccessorGrADS::testReadByteswappedFile()
+{
+  QTemporaryDir dir;
+  QString ctlPath = dir.path()+"/data.ctl";
+  writeFile(ctlPath, QString(ctl).arg("OPTIONS big_endian yrev\n").toUtf8());
+
+  QString binPath = dir.path()+"/data_20160101.bin";
+  writeFile(binPath, binaryData(6, true));
+
+  auto accessor = makeAccessor();
+  auto descriptor = accessor->readDataDescriptor(ctlPath.toStdString());
+
+  auto raster = accessor->readBinaryFile(descriptor, binPath.toStdString());
+  QCOMPARE(raster->getNumberOfBands(), static_cast<std::size_t>(6));
+
+  double value = 0;
+  raster->getBand(5)->getValue(1, 1, value);
+  QCOMPARE(value, 511.);
+}
@@ -0,0 +1,53 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file unittest/core/TsDataAccessorPostGis.cpp
+
+  \brief Tests for Class DataAccessorPostGis
+
+  \author Jano Simas
+*/
+
+#include "TsDataAccessorPostGis.hpp"
+
+//TerraMA2
+#include <terrama2/impl/DataAccessorPostGis.hpp>
+
+//TerraLib
+#include <terralib/geometry/Point.h>
+
+using terrama2::core::DataAccessorPostGis;
+
+void TsDataAccessorPostGis::testIntersectsCondition()
+{
+  te::gm::Point region(-45., -23., 4326);
+  const std::string wkt = region.asText();
+
+  // the region is transformed to the SRID of the column
+  std::string condition = DataAccessorPostGis::intersectsCondition("occurrence", "geom", region);
+  QCOMPARE(condition, "ST_Intersects(geom, ST_Transform(ST_GeomFromText('"+wkt+"', 4326), "
+                      "Find_SRID(current_schema()::varchar, 'occurrence', 'geom')))");
+
+  condition = DataAccessorPostGis::intersectsCondition("Monitoring.Occurrence", "geom", region);
+  QCOMPARE(condition, "ST_Intersects(geom, ST_Transform(ST_GeomFromText('"+wkt+"', 4326), "
+                      "Find_SRID('monitoring', 'occurrence', 'geom')))");
+}
@@ -0,0 +1,127 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file unittest/core/TsDataStoragerCsv.cpp
+
+  \brief Tests for Class DataStoragerCsv
+
+  \author Jano Simas
+*/
+
+#include "TsDataStoragerCsv.hpp"
+
+//TerraMA2
+#include <terrama2/core/data-model/DataProvider.hpp>
+#include <terrama2/core/data-model/DataSet.hpp>
+#include <terrama2/core/utility/CsvParser.hpp>
+#include <terrama2/impl/DataStoragerCsv.hpp>
+
+//QT
+#include <QTemporaryDir>
+
+//Boost
+#include <boost/date_time/local_time/local_time.hpp>
+
+//STL
+#include <limits>
+
+namespace
+{
+  terrama2::core::DataStoragerCsv::Table createTable()
+  {
+    terrama2::core::DataStoragerCsv::Table table;
+    table.keyName = "geom_id";
+    table.keys = {"a", "b,c"};
+    table.names = {"max", "mean"};
+    table.columns = {{1.5, 2}, {std::numeric_limits<double>::quiet_NaN(), 0.1}};
+
+    return table;
+  }
+}
+
+void TsDataStoragerCsv::testStoreTable()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+
+  auto dataProvider = std::make_shared<terrama2::core::DataProvider>();
+  dataProvider->uri = "file://" + dir.path().toStdString();
+  dataProvider->dataProviderType = "FILE";
+
+  auto dataSet = std::make_shared<terrama2::core::DataSet>();
+  dataSet->format["mask"] = "analysis_yyyyMMdd_hhmmss";
+  dataSet->format["timezone"] = "UTC+00";
+
+  boost::local_time::time_zone_ptr zone(new boost::local_time::posix_time_zone("UTC+00"));
+  boost::posix_time::ptime executionTime(boost::gregorian::date(2016, 7, 21), boost::posix_time::hours(10));
+  auto timestamp = std::make_shared<te::dt::TimeInstantTZ>(boost::local_time::local_date_time(executionTime, zone));
+
+  terrama2::core::DataStoragerCsv storager(dataProvider);
+  std::string path = storager.storeTable(createTable(), timestamp, "execution_date", dataSet);
+  QCOMPARE(QString::fromStdString(path), dir.path()+"/analysis_20160721_100000.csv");
+
+  // the file is read back with typed columns
+  terrama2::core::CsvParser::Format format;
+  format.column = [](const std::string& header)
+  {
+    terrama2::core::CsvParser::Column column;
+    column.name = header;
+    if(header == "geom_id")
+      column.type = terrama2::core::CsvParser::ColumnType::STRING;
+    else if(header == "execution_date")
+      column.type = terrama2::core::CsvParser::ColumnType::TIMESTAMP;
+    else
+      column.type = terrama2::core::CsvParser::ColumnType::DOUBLE;
+    return column;
+  };
+
+  auto result = terrama2::core::CsvParser(format).parse(path);
+  QCOMPARE(result.dataSet->size(), static_cast<std::size_t>(2));
+  QCOMPARE(result.end.lastTimestamp, executionTime);
+
+  result.dataSet->moveFirst();
+  QCOMPARE(result.dataSet->getString("geom_id"), std::string("a"));
+  QCOMPARE(result.dataSet->getDouble("max"), 1.5);
+  QVERIFY(result.dataSet->isNull("mean"));
+
+  result.dataSet->moveNext();
+  QCOMPARE(result.dataSet->getString("geom_id"), std::string("b,c"));
+  QCOMPARE(result.dataSet->getDouble("max"), 2.);
+  QCOMPARE(result.dataSet->getDouble("mean"), 0.1);
+}
+
+void TsDataStoragerCsv::testInvalidTable()
+{
+  auto table = createTable();
+  table.columns[1].pop_back();
+
+  try
+  {
+    terrama2::core::DataStoragerCsv::toCsv(table, "execution_date", "2016-07-21 10:00:00");
+
+    QFAIL("Should not be here!");
+  }
+  catch(const terrama2::core::DataStoragerException&)
+  {
+
+  }
+}
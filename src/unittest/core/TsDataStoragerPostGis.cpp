@@ -0,0 +1,76 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file unittest/core/TsDataStoragerPostGis.cpp
+
+  \brief Tests for Class DataStoragerPostGis
+
+  \author Jano Simas
+*/
+
+#include "TsDataStoragerPostGis.hpp"
+
+//TerraMA2
+#include <terrama2/impl/DataStoragerPostGis.hpp>
+
+using terrama2::core::DataStoragerPostGis;
+
+void TsDataStoragerPostGis::testPartitionStart()
+{
+  // thursday
+  boost::gregorian::date day(2016, 7, 21);
+
+  QCOMPARE(DataStoragerPostGis::partitionStart(day, DataStoragerPostGis::PartitionInterval::DAY), day);
+  QCOMPARE(DataStoragerPostGis::partitionStart(day, DataStoragerPostGis::PartitionInterval::WEEK), boost::gregorian::date(2016, 7, 18));
+  QCOMPARE(DataStoragerPostGis::partitionStart(day, DataStoragerPostGis::PartitionInterval::MONTH), boost::gregorian::date(2016, 7, 1));
+  QCOMPARE(DataStoragerPostGis::partitionStart(day, DataStoragerPostGis::PartitionInterval::YEAR), boost::gregorian::date(2016, 1, 1));
+
+  // sunday belongs to the week of the previous monday
+  QCOMPARE(DataStoragerPostGis::partitionStart(boost::gregorian::date(2016, 7, 24), DataStoragerPostGis::PartitionInterval::WEEK),
+           boost::gregorian::date(2016, 7, 18));
+
+  QCOMPARE(DataStoragerPostGis::nextPartitionStart(boost::gregorian::date(2016, 12, 1), DataStoragerPostGis::PartitionInterval::MONTH),
+           boost::gregorian::date(2017, 1, 1));
+  QCOMPARE(DataStoragerPostGis::nextPartitionStart(boost::gregorian::date(2016, 2, 29), DataStoragerPostGis::PartitionInterval::DAY),
+           boost::gregorian::date(2016, 3, 1));
+}
+
+void TsDataStoragerPostGis::testCreatePartitionSql()
+{
+  std::string sql = DataStoragerPostGis::createPartitionSql("analysis_result", boost::gregorian::date(2016, 7, 1),
+                                                            DataStoragerPostGis::PartitionInterval::MONTH, true);
+  QCOMPARE(sql, std::string("CREATE TABLE IF NOT EXISTS \"analysis_result_20160701\" PARTITION OF \"analysis_result\""
+                            " FOR VALUES FROM ('2016-07-01 00:00:00+00') TO ('2016-08-01 00:00:00+00')"));
+
+  // the partition is created in the schema of the table
+  sql = DataStoragerPostGis::createPartitionSql("monitoring.dcp", boost::gregorian::date(2016, 7, 21),
+                                                DataStoragerPostGis::PartitionInterval::DAY, false);
+  QCOMPARE(sql, std::string("CREATE TABLE IF NOT EXISTS \"monitoring\".\"dcp_20160721\" PARTITION OF \"monitoring\".\"dcp\""
+                            " FOR VALUES FROM ('2016-07-21 00:00:00') TO ('2016-07-22 00:00:00')"));
+}
+
+void TsDataStoragerPostGis::testQuoteTableName()
+{
+  QCOMPARE(DataStoragerPostGis::quoteTableName("dcp"), std::string("\"dcp\""));
+  QCOMPARE(DataStoragerPostGis::quoteTableName("Monitoring.Order"), std::string("\"monitoring\".\"order\""));
+  QCOMPARE(DataStoragerPostGis::quoteTableName("a\"b"), std::string("\"a\"\"b\""));
+}
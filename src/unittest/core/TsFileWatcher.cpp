@@ -0,0 +1,124 @@
+/*
+  Copyright (C) 2007 National Institute For Space Research (INPE) - Brazil.
+
+  This file is part of TerraMA2 - a free and open source computational
+  platform for analysis, monitoring, and alert of geo-environmental extremes.
+
+  TerraMA2 is free software: you can redistribute it and/or modify
+  it under the terms of the GNU Lesser General Public License as published by
+  the Free Software Foundation, either version 3 of the License,
+  or (at your option) any later version.
+
+  TerraMA2 is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+  GNU Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public License
+  along with TerraMA2. See LICENSE. If not, write to
+  TerraMA2 Team at <terrama2-team@dpi.inpe.br>.
+*/
+
+/*!
+  \file unittest/core/TsFileWatcher.cpp
+
+  \brief Tests for Core FileWatcher class
+
+  \author Jano Simas
+*/
+
+//TerraMA2
+#include <terrama2/core/utility/FileWatcher.hpp>
+
+#include "TsFileWatcher.hpp"
+
+//QT
+#include <QFile>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+namespace
+{
+  void writeFile(const QString& path, const QByteArray& data)
+  {
+    QFile file(path);
+    if(!file.open(QIODevice::Append))
+      QFAIL("Unable to write file!");
+
+    file.write(data);
+    file.close();
+  }
+
+  std::vector<terrama2::core::FileWatcher::Folder> folders(const QTemporaryDir& dir)
+  {
+    terrama2::core::FileWatcher::Folder folder;
+    folder.path = dir.path().toStdString();
+    folder.mask = "file_yyyyMMdd.csv";
+    return {folder};
+  }
+}
+
+void TsFileWatcher::testNewFile()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+
+  terrama2::core::FileWatcher watcher(1, folders(dir), 200);
+  QSignalSpy spy(&watcher, SIGNAL(fileReadySignal(ProcessId)));
+
+  writeFile(dir.path()+"/file_20160721.csv", "a,b\n1,2\n");
+
+  QVERIFY(spy.wait(5000));
+  QCOMPARE(spy.count(), 1);
+  QCOMPARE(spy.at(0).at(0).toUInt(), 1u);
+}
+
+void TsFileWatcher::testIgnoreExistingFiles()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+
+  writeFile(dir.path()+"/file_20160720.csv", "a,b\n1,2\n");
+
+  terrama2::core::FileWatcher watcher(1, folders(dir), 200);
+  QSignalSpy spy(&watcher, SIGNAL(fileReadySignal(ProcessId)));
+
+  QVERIFY(!spy.wait(1000));
+}
+
+void TsFileWatcher::testIgnoreOtherFiles()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+
+  terrama2::core::FileWatcher watcher(1, folders(dir), 200);
+  QSignalSpy spy(&watcher, SIGNAL(fileReadySignal(ProcessId)));
+
+  writeFile(dir.path()+"/other.csv", "a,b\n1,2\n");
+
+  QVERIFY(!spy.wait(1000));
+}
+
+void TsFileWatcher::testGrowingFile()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+
+  QString path = dir.path()+"/file_20160721.csv";
+  writeFile(path, "a,b\n1,2\n");
+
+  // appended data doesn't change the folder, it's found by the rescan
+  terrama2::core::FileWatcher watcher(1, folders(dir), 500, 100);
+  QSignalSpy spy(&watcher, SIGNAL(fileReadySignal(ProcessId)));
+
+  // appends in a burst are debounced in a single signal
+  for(int i = 0; i < 5; ++i)
+  {
+    writeFile(path, "3,4\n");
+    QTest::qWait(50);
+  }
+
+  QVERIFY(spy.wait(5000));
+  QTest::qWait(1000);
+  QCOMPARE(spy.count(), 1);
+}
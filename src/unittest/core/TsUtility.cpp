@@ -33,6 +33,15 @@
 #include <terrama2/core/utility/Timer.hpp>
 #include <terrama2/core/utility/TimeUtils.hpp>
 #include <terrama2/core/utility/FilterUtils.hpp>
+#include <terrama2/core/utility/CsvParser.hpp>
+#include <terrama2/core/utility/FileCatalog.hpp>
+#include <terrama2/core/utility/MaskMatcher.hpp>
+#include <terrama2/core/utility/Utils.hpp>
+#include <terrama2/core/utility/Unpack.hpp>
+#include <terrama2/core/utility/ScratchSpace.hpp>
+#include <terrama2/core/utility/RasterBlockCache.hpp>
+#include <terrama2/core/utility/DecodedRasterCache.hpp>
+#include <terrama2/core/Exception.hpp>
 
 
 #include "MockProcessLogger.hpp"
@@ -41,6 +50,25 @@
 // GMock
 #include <gtest/gtest.h>
 
+// Qt
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+//Boost
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+
+//STL
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
 
 void TsUtility::testTimerNoFrequencyException()
 {
@@ -396,3 +424,566 @@ void TsUtility::testIgnoreArchiveExtension()
   if(!terrama2::core::isValidDataSetName(mask, filter, timezone, name, fileTimestamp))
     QFAIL("Should not be here!");
 }
+
+void TsUtility::testCsvParseTimestamp()
+{
+  std::string value = "07/21/2016 15:30:12";
+  boost::posix_time::ptime result;
+  if(!terrama2::core::CsvParser::parseTimestamp(value.data(), value.data()+value.size(), "%m/%d/%Y %H:%M:%S", result))
+    QFAIL("Should not be here!");
+
+  QCOMPARE(result, boost::posix_time::ptime(boost::gregorian::date(2016, 7, 21), boost::posix_time::time_duration(15, 30, 12)));
+
+  // fractional seconds
+  value = "2016-07-21 15:30:12.5";
+  if(!terrama2::core::CsvParser::parseTimestamp(value.data(), value.data()+value.size(), "%Y-%m-%d %H:%M:%S", result))
+    QFAIL("Should not be here!");
+
+  QCOMPARE(result, boost::posix_time::ptime(boost::gregorian::date(2016, 7, 21),
+                                            boost::posix_time::time_duration(15, 30, 12) + boost::posix_time::milliseconds(500)));
+}
+
+void TsUtility::testCsvParseInvalidTimestamp()
+{
+  std::string value = "2016/07/21 15:30";
+  boost::posix_time::ptime result;
+  if(terrama2::core::CsvParser::parseTimestamp(value.data(), value.data()+value.size(), "%Y-%m-%d %H:%M:%S", result))
+    QFAIL("Should not be here!");
+}
+
+void TsUtility::testCsvParseAppendedLines()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+
+  QFile file(dir.path()+"/dcp.csv");
+  QVERIFY(file.open(QIODevice::WriteOnly));
+  file.write("timestamp,value\n2016-07-21 10:00:00,1\n2016-07-21 11:00:00,2\n2016-07-21 12:00");
+  file.close();
+
+  terrama2::core::CsvParser::Format format;
+  format.completeLinesOnly = true;
+  format.column = [](const std::string& header)
+  {
+    terrama2::core::CsvParser::Column column;
+    column.name = header;
+    column.type = header == "timestamp" ? terrama2::core::CsvParser::ColumnType::TIMESTAMP : terrama2::core::CsvParser::ColumnType::DOUBLE;
+    return column;
+  };
+
+  terrama2::core::CsvParser parser(format);
+  auto result = parser.parse(file.fileName().toStdString());
+
+  // the incomplete line is not read
+  QCOMPARE(result.dataSet->size(), static_cast<std::size_t>(2));
+  QCOMPARE(result.end.offset, static_cast<qint64>(std::string("timestamp,value\n2016-07-21 10:00:00,1\n2016-07-21 11:00:00,2\n").size()));
+  QCOMPARE(result.end.lastTimestamp, boost::posix_time::ptime(boost::gregorian::date(2016, 7, 21), boost::posix_time::hours(11)));
+
+  // line completed and a repeated line appended
+  QVERIFY(file.open(QIODevice::Append));
+  file.write(":00,3\n2016-07-21 11:00:00,2\n2016-07-21 13:00:00,4\n");
+  file.close();
+
+  auto position = terrama2::core::CsvParser::toPosition(terrama2::core::CsvParser::toReadPosition(result.end));
+  auto tail = parser.parse(file.fileName().toStdString(), position);
+  QCOMPARE(tail.dataSet->size(), static_cast<std::size_t>(2));
+  QCOMPARE(tail.end.offset, file.size());
+  QCOMPARE(tail.end.lastTimestamp, boost::posix_time::ptime(boost::gregorian::date(2016, 7, 21), boost::posix_time::hours(13)));
+
+  tail.dataSet->moveFirst();
+  QCOMPARE(tail.dataSet->getDouble("value"), 3.);
+}
+
+void TsUtility::testParallelFor()
+{
+  const std::size_t size = 100;
+  const std::size_t innerSize = 10;
+  std::vector<std::thread::id> outerThreads(size);
+  std::vector<std::thread::id> innerThreads(size*innerSize);
+  std::atomic<std::size_t> running(0);
+  std::atomic<std::size_t> maxRunning(0);
+
+  terrama2::core::parallelFor(size, 4, [&](std::size_t i)
+  {
+    std::size_t current = ++running;
+    std::size_t previous = maxRunning;
+    while(current > previous && !maxRunning.compare_exchange_weak(previous, current));
+
+    outerThreads[i] = std::this_thread::get_id();
+    // nested calls run inline in the thread of the outer task
+    terrama2::core::parallelFor(innerSize, 4, [&, i](std::size_t j)
+    {
+      innerThreads[i*innerSize+j] = std::this_thread::get_id();
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    --running;
+  });
+
+  std::set<std::thread::id> threads;
+  for(std::size_t i = 0; i < size; ++i)
+  {
+    threads.insert(outerThreads[i]);
+    for(std::size_t j = 0; j < innerSize; ++j)
+      QCOMPARE(innerThreads[i*innerSize+j], outerThreads[i]);
+  }
+
+  // the nested calls don't spawn threads, at most the requested number runs at the same time
+  QVERIFY(threads.size() <= 4);
+  QVERIFY(maxRunning <= 4);
+
+  // outside a task the calling thread runs in parallel again
+  std::vector<std::thread::id> afterThreads(size);
+  terrama2::core::parallelFor(size, 4, [&](std::size_t i)
+  {
+    afterThreads[i] = std::this_thread::get_id();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  });
+  QVERIFY(std::set<std::thread::id>(afterThreads.begin(), afterThreads.end()).size() > 1);
+}
+
+void TsUtility::testParallelForLimit()
+{
+  // a single helper thread is shared by all calls
+  terrama2::core::setParallelForThreads(1);
+
+  std::vector<std::thread::id> threads(20);
+  terrama2::core::parallelFor(threads.size(), 4, [&](std::size_t i)
+  {
+    threads[i] = std::this_thread::get_id();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  });
+  QVERIFY(std::set<std::thread::id>(threads.begin(), threads.end()).size() <= 2);
+
+  terrama2::core::setParallelForThreads(0);
+}
+
+void TsUtility::testParallelForException()
+{
+  try
+  {
+    terrama2::core::parallelFor(100, 4, [](std::size_t i)
+    {
+      if(i == 10 || i == 50)
+        throw std::runtime_error(std::to_string(i));
+    });
+  }
+  catch(const std::runtime_error& e)
+  {
+    QCOMPARE(std::string(e.what()), std::string("10"));
+    return;
+  }
+
+  QFAIL("Should not be here!");
+}
+
+void TsUtility::testFileCatalog()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+
+  QFile file(dir.path()+"/data.csv");
+  QVERIFY(file.open(QIODevice::WriteOnly));
+  file.write("a,b\n1,2\n");
+  file.close();
+
+  std::string catalogPath = (dir.path()+"/catalog/1.catalog").toStdString();
+  {
+    terrama2::core::FileCatalog catalog(catalogPath);
+    QVERIFY(!catalog.isProcessed("1/data.csv", QFileInfo(file)));
+
+    catalog.setProcessed("1/data.csv", QFileInfo(file), "2016-07-21 15:30:12");
+    QVERIFY(catalog.isProcessed("1/data.csv", QFileInfo(file)));
+    catalog.save();
+  }
+
+  // loaded from the file
+  terrama2::core::FileCatalog catalog(catalogPath);
+  QCOMPARE(catalog.size(), static_cast<std::size_t>(1));
+  QVERIFY(catalog.isProcessed("1/data.csv", QFileInfo(file)));
+
+  // changed file
+  QVERIFY(file.open(QIODevice::Append));
+  file.write("3,4\n");
+  file.close();
+  QVERIFY(!catalog.isProcessed("1/data.csv", QFileInfo(file)));
+
+  // invalid catalog file is rebuilt
+  QFile catalogFile(QString::fromStdString(catalogPath));
+  QVERIFY(catalogFile.open(QIODevice::WriteOnly));
+  catalogFile.write("invalid");
+  catalogFile.close();
+
+  terrama2::core::FileCatalog invalidCatalog(catalogPath);
+  QCOMPARE(invalidCatalog.size(), static_cast<std::size_t>(0));
+}
+
+void TsUtility::testFileCatalogReadPosition()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+
+  QFile file(dir.path()+"/dcp.csv");
+  QVERIFY(file.open(QIODevice::WriteOnly));
+  file.write("a,b\n1,2\n");
+  file.close();
+
+  terrama2::core::FileCatalog catalog((dir.path()+"/1.catalog").toStdString());
+  QCOMPARE(catalog.readPosition("1/dcp.csv", QFileInfo(file)).offset, static_cast<qint64>(0));
+
+  terrama2::core::FileCatalog::ReadPosition position;
+  position.offset = file.size();
+  position.lastTimestamp = "20160721T150000";
+  catalog.setProcessed("1/dcp.csv", QFileInfo(file), "", position);
+  catalog.save();
+
+  // appended data
+  QVERIFY(file.open(QIODevice::Append));
+  file.write("3,4\n");
+  file.close();
+
+  terrama2::core::FileCatalog loadedCatalog((dir.path()+"/1.catalog").toStdString());
+  QVERIFY(!loadedCatalog.isProcessed("1/dcp.csv", QFileInfo(file)));
+  auto readPosition = loadedCatalog.readPosition("1/dcp.csv", QFileInfo(file));
+  QCOMPARE(readPosition.offset, position.offset);
+  QCOMPARE(readPosition.lastTimestamp, position.lastTimestamp);
+  QVERIFY(!readPosition.finished);
+
+  // last line without line break not read, the file didn't change since
+  QVERIFY(file.open(QIODevice::Append));
+  file.write("5,6");
+  file.close();
+  position.offset = file.size() - 3;
+  loadedCatalog.setProcessed("1/dcp.csv", QFileInfo(file), "", position);
+  QVERIFY(!loadedCatalog.isProcessed("1/dcp.csv", QFileInfo(file)));
+  readPosition = loadedCatalog.readPosition("1/dcp.csv", QFileInfo(file));
+  QCOMPARE(readPosition.offset, position.offset);
+  QVERIFY(readPosition.finished);
+
+  position.offset = file.size();
+  loadedCatalog.setProcessed("1/dcp.csv", QFileInfo(file), "", position);
+  QVERIFY(loadedCatalog.isProcessed("1/dcp.csv", QFileInfo(file)));
+
+  // rewritten file
+  QVERIFY(file.open(QIODevice::WriteOnly));
+  file.write("a,b\n5,6\n7,8\n");
+  file.close();
+  QCOMPARE(loadedCatalog.readPosition("1/dcp.csv", QFileInfo(file)).offset, static_cast<qint64>(0));
+
+  // truncated file
+  QVERIFY(file.open(QIODevice::WriteOnly));
+  file.write("a,b\n");
+  file.close();
+  QCOMPARE(loadedCatalog.readPosition("1/dcp.csv", QFileInfo(file)).offset, static_cast<qint64>(0));
+}
+
+void TsUtility::testMaskMatcherIndex()
+{
+  std::vector<std::string> names = {"file2016-04-21.tif", "file2016-04-19.tif", "other.tif", "file2016-04-20.tif", "file2016-04.tif"};
+  auto matcher = terrama2::core::MaskMatcher::get("fileyyyy-MM-dd.tif", "UTC+00");
+  auto index = matcher->index(names);
+
+  QCOMPARE(index.dated.size(), static_cast<std::size_t>(3));
+  QCOMPARE(index.dated.front().position, static_cast<std::size_t>(1));
+  QCOMPARE(index.dated.back().position, static_cast<std::size_t>(0));
+
+  terrama2::core::Filter filter;
+  boost::local_time::time_zone_ptr zone(new boost::local_time::posix_time_zone("UTC+00"));
+  boost::local_time::local_date_time before(boost::gregorian::date(2016, 4, 19), boost::posix_time::time_duration(0, 0, 0), zone, true);
+  filter.discardBefore = std::make_shared<te::dt::TimeInstantTZ>(before);
+
+  // files in listing order
+  auto files = terrama2::core::MaskMatcher::select(index, filter, false);
+  QCOMPARE(files.size(), static_cast<std::size_t>(2));
+  QCOMPARE(files.at(0).position, static_cast<std::size_t>(0));
+  QCOMPARE(files.at(1).position, static_cast<std::size_t>(3));
+
+  files = terrama2::core::MaskMatcher::select(index, filter, true);
+  QCOMPARE(files.size(), static_cast<std::size_t>(1));
+  QCOMPARE(files.at(0).position, static_cast<std::size_t>(0));
+}
+
+namespace
+{
+  void writeGzip(const std::string& path, const std::string& content)
+  {
+    std::ofstream file(path, std::ios_base::out | std::ios_base::binary);
+    boost::iostreams::filtering_ostream out;
+    out.push(boost::iostreams::gzip_compressor());
+    out.push(file);
+    out << content;
+  }
+}
+
+void TsUtility::testUnpackCache()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+
+  terrama2::core::Unpack::setCacheFolder((dir.path()+"/cache").toStdString());
+
+  std::string gzPath = (dir.path()+"/data.csv.gz").toStdString();
+  writeGzip(gzPath, "a,b\n1,2\n");
+
+  auto unpackedFolder = terrama2::core::Unpack::unpackList(gzPath);
+  QString folder = QString::fromStdString(unpackedFolder->path());
+  QFile unpacked(folder+"/data.csv");
+  QVERIFY(unpacked.open(QIODevice::ReadOnly));
+  QCOMPARE(unpacked.readAll(), QByteArray("a,b\n1,2\n"));
+  unpacked.close();
+
+  // the same content is not unpacked again
+  QVERIFY(unpacked.remove());
+  QCOMPARE(QString::fromStdString(terrama2::core::Unpack::unpackList(gzPath)->path()), folder);
+  QVERIFY(!QFile::exists(folder+"/data.csv"));
+
+  // only the unpacked files are listed
+  QCOMPARE(QDir(folder).entryList(QDir::Files | QDir::NoDotAndDotDot).size(), 0);
+
+  terrama2::core::Unpack::setCacheFolder(QDir::temp().absoluteFilePath("terrama2-unpack").toStdString());
+}
+
+void TsUtility::testUnpackCachePinnedFolders()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+
+  terrama2::core::Unpack::setCacheFolder((dir.path()+"/cache").toStdString());
+  // every unpack exceeds the cache size
+  terrama2::core::Unpack::setCacheMaxSize(0);
+
+  std::string firstPath = (dir.path()+"/first.csv.gz").toStdString();
+  writeGzip(firstPath, "a,b\n1,2\n");
+  std::string secondPath = (dir.path()+"/second.csv.gz").toStdString();
+  writeGzip(secondPath, "a,b\n3,4\n");
+
+  // folders in use are kept
+  auto firstFolder = terrama2::core::Unpack::unpackList(firstPath);
+  auto secondFolder = terrama2::core::Unpack::unpackList(secondPath);
+  QString firstPathUnpacked = QString::fromStdString(firstFolder->path());
+  QVERIFY(QFile::exists(firstPathUnpacked+"/first.csv"));
+  QVERIFY(QFile::exists(QString::fromStdString(secondFolder->path())+"/second.csv"));
+
+  // released folders are removed on the next unpack
+  firstFolder.reset();
+  secondFolder = terrama2::core::Unpack::unpackList(secondPath);
+  QVERIFY(!QDir(firstPathUnpacked).exists());
+  QVERIFY(QFile::exists(QString::fromStdString(secondFolder->path())+"/second.csv"));
+
+  terrama2::core::Unpack::setCacheMaxSize(2LL*1024*1024*1024);
+  terrama2::core::Unpack::setCacheFolder(QDir::temp().absoluteFilePath("terrama2-unpack").toStdString());
+}
+
+void TsUtility::testScratchSpace()
+{
+  QTemporaryDir dir;
+  QVERIFY(dir.isValid());
+
+  auto& scratchSpace = terrama2::core::ScratchSpace::getInstance();
+  scratchSpace.setRootFolder(dir.path().toStdString());
+  scratchSpace.setExpiration(std::chrono::seconds(0));
+
+  auto folder1 = scratchSpace.createFolder("test");
+  auto folder2 = scratchSpace.createFolder("test");
+  QVERIFY(folder1->path() != folder2->path());
+  QVERIFY(QDir(QString::fromStdString(folder1->path())).exists());
+
+  // same content is stored once
+  for(const auto& folder : {folder1, folder2})
+  {
+    QFile file(QString::fromStdString(folder->path())+"/data.csv");
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("a,b\n1,2\n");
+    file.close();
+    scratchSpace.shareFile(file.fileName().toStdString());
+  }
+  QCOMPARE(scratchSpace.usage(), static_cast<qint64>(8));
+
+  scratchSpace.setQuota(4);
+  try
+  {
+    scratchSpace.checkQuota();
+    QFAIL("Should not be here!");
+  }
+  catch(const terrama2::core::ScratchSpaceException&)
+  {
+  }
+
+  // the size of the incoming data is checked
+  scratchSpace.setQuota(12);
+  scratchSpace.checkQuota(4);
+  try
+  {
+    scratchSpace.checkQuota(5);
+    QFAIL("Should not be here!");
+  }
+  catch(const terrama2::core::ScratchSpaceException&)
+  {
+  }
+
+  // data written is tracked without scanning the folder
+  scratchSpace.addUsage(4);
+  try
+  {
+    scratchSpace.checkQuota(1);
+    QFAIL("Should not be here!");
+  }
+  catch(const terrama2::core::ScratchSpaceException&)
+  {
+  }
+  scratchSpace.setQuota(0);
+
+  // released folders are removed
+  std::string path = folder1->path();
+  folder1.reset();
+  scratchSpace.removeExpired();
+  QVERIFY(!QDir(QString::fromStdString(path)).exists());
+  QVERIFY(QDir(QString::fromStdString(folder2->path())).exists());
+
+  folder2.reset();
+  scratchSpace.removeExpired();
+  scratchSpace.setExpiration(std::chrono::seconds(60));
+  scratchSpace.setRootFolder(QDir::temp().absoluteFilePath("terrama2-scratch").toStdString());
+}
+
+void TsUtility::testRasterBlockCache()
+{
+  auto& cache = terrama2::core::RasterBlockCache::getInstance();
+  cache.clear();
+  // room for about two blocks
+  cache.setMaxMemory(2*(1000*sizeof(double)+512));
+
+  int loads = 0;
+  auto load = [&loads]()
+  {
+    ++loads;
+    terrama2::core::RasterBlock block(te::dt::DOUBLE_TYPE, 1000);
+    for(std::size_t i = 0; i < block.size(); ++i)
+      block.setValue(i, 1.);
+    return block;
+  };
+
+  // blocks are stored in the data type of the band
+  terrama2::core::RasterBlock byteBlock(te::dt::UCHAR_TYPE, 1000);
+  byteBlock.setValue(0, 200.);
+  QCOMPARE(byteBlock.byteSize(), static_cast<std::size_t>(1000));
+  QCOMPARE(byteBlock.value(0), 200.);
+  terrama2::core::RasterBlock complexBlock(te::dt::CDOUBLE_TYPE, 10);
+  QCOMPARE(complexBlock.dataType(), static_cast<int>(te::dt::DOUBLE_TYPE));
+
+  terrama2::core::RasterBlockKey key;
+  key.fileIdentity = "file";
+  key.band = 0;
+  key.block = 0;
+
+  auto block = cache.get(key, load);
+  QCOMPARE(block->size(), static_cast<std::size_t>(1000));
+  QCOMPARE(block->value(999), 1.);
+  cache.get(key, load);
+  QCOMPARE(loads, 1);
+
+  auto statistics = cache.statistics();
+  QCOMPARE(statistics.hits, static_cast<uint64_t>(1));
+  QCOMPARE(statistics.misses, static_cast<uint64_t>(1));
+
+  // the first block is pinned while it is held
+  for(std::size_t i = 1; i <= 3; ++i)
+  {
+    key.block = i;
+    cache.get(key, load);
+  }
+
+  key.block = 0;
+  cache.get(key, load);
+  QCOMPARE(loads, 4);
+
+  // released blocks are evicted
+  block.reset();
+  key.block = 1;
+  cache.get(key, load);
+  QCOMPARE(loads, 5);
+  QVERIFY(cache.statistics().evictions >= 2);
+  QVERIFY(cache.statistics().blocks <= 2);
+
+  // failed loads are not cached
+  key.block = 10;
+  try
+  {
+    cache.get(key, []() -> terrama2::core::RasterBlock { throw std::runtime_error("load error"); });
+    QFAIL("Exception expected!");
+  }
+  catch(const std::runtime_error&)
+  {
+  }
+  cache.get(key, load);
+  QCOMPARE(loads, 6);
+
+  cache.clear();
+  cache.setMaxMemory(512*1024*1024);
+}
+
+void TsUtility::testDecodedRasterCache()
+{
+  QTemporaryDir cacheDir;
+  QTemporaryDir dataDir;
+  auto& cache = terrama2::core::DecodedRasterCache::getInstance();
+  cache.setFolder(cacheDir.path().toStdString());
+
+  QString sourcePath = dataDir.path()+"/source.bin";
+  {
+    QFile source(sourcePath);
+    QVERIFY(source.open(QIODevice::WriteOnly));
+    source.write("encoded content");
+  }
+
+  // the identity depends on the content and on the layout
+  std::string identity = terrama2::core::DecodedRasterCache::sourceIdentity(sourcePath.toStdString());
+  QVERIFY(!identity.empty());
+  QVERIFY(identity != terrama2::core::DecodedRasterCache::sourceIdentity(sourcePath.toStdString(), "layout"));
+  QVERIFY(terrama2::core::DecodedRasterCache::sourceIdentity(dataDir.path().toStdString()+"/missing.bin").empty());
+
+  int loads = 0;
+  auto load = [&loads]()
+  {
+    ++loads;
+    terrama2::core::RasterBlock block(te::dt::FLOAT_TYPE, 1000);
+    for(std::size_t i = 0; i < block.size(); ++i)
+      block.setValue(i, i * 0.5);
+    return block;
+  };
+
+  terrama2::core::RasterBlockKey key;
+  key.fileIdentity = identity;
+  key.band = 1;
+  key.block = 2;
+
+  auto values = cache.get(key, te::dt::FLOAT_TYPE, load);
+  QCOMPARE(loads, 1);
+
+  // the block is read from the disk in its data type
+  auto stored = cache.get(key, te::dt::FLOAT_TYPE, load);
+  QCOMPARE(loads, 1);
+  QCOMPARE(stored.dataType(), static_cast<int>(te::dt::FLOAT_TYPE));
+  QCOMPARE(stored.size(), values.size());
+  QVERIFY(std::memcmp(stored.data(), values.data(), values.byteSize()) == 0);
+
+  // blocks of other sources are decoded
+  key.fileIdentity = terrama2::core::DecodedRasterCache::sourceIdentity(sourcePath.toStdString(), "layout");
+  cache.get(key, te::dt::FLOAT_TYPE, load);
+  QCOMPARE(loads, 2);
+
+  // the least recently used sources are removed
+  cache.setMaxSize(1000*sizeof(float) + 1024);
+  QCOMPARE(QDir(cacheDir.path()).entryList(QDir::Dirs | QDir::NoDotAndDotDot).size(), 1);
+
+  // sources older than the maximum age are removed
+  cache.setMaxAge(-1);
+  QCOMPARE(QDir(cacheDir.path()).entryList(QDir::Dirs | QDir::NoDotAndDotDot).size(), 0);
+  cache.get(key, te::dt::FLOAT_TYPE, load);
+  QCOMPARE(loads, 3);
+
+  cache.setMaxAge(7*24*60*60);
+  cache.setMaxSize(4LL*1024*1024*1024);
+  cache.clear();
+  cache.setFolder(QDir::temp().absoluteFilePath("terrama2-decoded").toStdString());
+}
@@ -63,4 +63,26 @@ private slots:
   void testValidDataSetName2DigitsYear();
   void testValidDataSetName2DigitsYear1900();
   void testIgnoreArchiveExtension();
+
+  void testCsvParseTimestamp();
+  void testCsvParseInvalidTimestamp();
+  void testCsvParseAppendedLines();
+
+  void testParallelFor();
+  void testParallelForLimit();
+  void testParallelForException();
+
+  void testFileCatalog();
+  void testFileCatalogReadPosition();
+
+  void testMaskMatcherIndex();
+
+  void testUnpackCache();
+  void testUnpackCachePinnedFolders();
+
+  void testScratchSpace();
+
+  void testRasterBlockCache();
+
+  void testDecodedRasterCache();
 };
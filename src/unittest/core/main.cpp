@@ -41,12 +41,18 @@
 #include <gtest/gtest.h>
 
 #include "TsUtility.hpp"
+#include "TsCsvParser.hpp"
+#include "TsFileWatcher.hpp"
 #include "TsProcessLogger.hpp"
 #include "TsDataRetrieverFTP.hpp"
 #include "TsDataAccessorDcpInpe.hpp"
 #include "TsDataAccessorDcpToa5.hpp"
 #include "TsDataAccessorGeoTiff.hpp"
+#include "TsDataAccessorGrADS.hpp"
 #include "TsDataAccessorOccurrenceWfp.hpp"
+#include "TsDataAccessorPostGis.hpp"
+#include "TsDataStoragerCsv.hpp"
+#include "TsDataStoragerPostGis.hpp"
 
 int main(int argc, char** argv)
 {
@@ -71,6 +77,16 @@ int main(int argc, char** argv)
 
     }
 
+    try
+    {
+      TsFileWatcher testFileWatcher;
+      ret += QTest::qExec(&testFileWatcher, argc, argv);
+    }
+    catch(...)
+    {
+
+    }
+
     try
     {
       TsDataRetrieverFTP testDataRetrieverFTP;
@@ -81,6 +97,16 @@ int main(int argc, char** argv)
 
     }
 
+    try
+    {
+      TsCsvParser testCsvParser;
+      ret += QTest::qExec(&testCsvParser, argc, argv);
+    }
+    catch(...)
+    {
+
+    }
+
     try
     {
       TsDataAccessorDcpInpe testDataAccessorDcpInpe;
@@ -111,6 +137,16 @@ int main(int argc, char** argv)
 
     }
 
+    try
+    {
+      TsDataAccessorGrADS testDataAccessorGrADS;
+      ret += QTest::qExec(&testDataAccessorGrADS, argc, argv);
+    }
+    catch(...)
+    {
+
+    }
+
     try
     {
       TsDataAccessorOccurrenceWfp testDataAccessorOccurrenceWfp;
@@ -121,6 +157,36 @@ int main(int argc, char** argv)
 
     }
 
+    try
+    {
+      TsDataAccessorPostGis testDataAccessorPostGis;
+      ret += QTest::qExec(&testDataAccessorPostGis, argc, argv);
+    }
+    catch(...)
+    {
+
+    }
+
+    try
+    {
+      TsDataStoragerCsv testDataStoragerCsv;
+      ret += QTest::qExec(&testDataStoragerCsv, argc, argv);
+    }
+    catch(...)
+    {
+
+    }
+
+    try
+    {
+      TsDataStoragerPostGis testDataStoragerPostGis;
+      ret += QTest::qExec(&testDataStoragerPostGis, argc, argv);
+    }
+    catch(...)
+    {
+
+    }
+
     try
     {
       TsUtility testUtility;